@@ -183,6 +183,9 @@ unsigned long pulseInLong(uint8_t pin, uint8_t state, unsigned long timeout);
 
 uint8_t shiftIn(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder);  // codespell:ignore shiftin
 void shiftOut(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder, uint8_t val);
+// Same as shiftIn()/shiftOut() on the GPIO registers, the clock pulses are only tens of ns wide
+uint8_t shiftInFast(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder);
+void shiftOutFast(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder, uint8_t val);
 
 #ifdef __cplusplus
 }
@@ -202,6 +205,9 @@ void shiftOut(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder, uint8_t val);
 #include "HardwareSerial.h"
 #include "Esp.h"
 #include "freertos_stats.h"
+#include "loop_monitor.h"
+#include "boot_profile.h"
+#include "GPIOBundle.h"
 
 // Use float-compatible stl abs() and round(), we don't use Arduino macros to avoid issues with the C++ libraries
 using std::abs;
@@ -0,0 +1,147 @@
+// Copyright 2025 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "GPIOBundle.h"
+#include "esp32-hal.h"
+#include "esp32-hal-periman.h"
+#if SOC_DEDICATED_GPIO_SUPPORTED
+#include "esp_rom_gpio.h"
+#include "soc/gpio_sig_map.h"
+#endif
+
+GPIOBundle::GPIOBundle() : _count(0), _mode(0), _mask(0), _out_mask(0) {
+#if SOC_DEDICATED_GPIO_SUPPORTED
+  _bundle = NULL;
+  _out_offset = 0;
+  _in_offset = 0;
+#endif
+}
+
+GPIOBundle::~GPIOBundle() {
+  end();
+}
+
+bool GPIOBundle::begin(const uint8_t *pins, size_t count, uint8_t mode) {
+  if (pins == NULL || count == 0 || count > GPIO_BUNDLE_MAX_PINS || !(mode & INPUT)) {
+    log_e("Bad Parameters");
+    return false;
+  }
+  end();
+  for (size_t i = 0; i < count; i++) {
+    if (!digitalPinIsValid(pins[i]) || ((mode & OUTPUT) == OUTPUT && !digitalPinCanOutput(pins[i]))) {
+      log_e("IO %u can not be used in a bundle", pins[i]);
+      return false;
+    }
+  }
+  // pinMode() registers the pins with the peripheral manager and sets pulls and open drain
+  for (size_t i = 0; i < count; i++) {
+    pinMode(pins[i], mode);
+    if (perimanGetPinBus(pins[i], ESP32_BUS_TYPE_GPIO) == NULL) {
+      log_e("IO %u could not be set as GPIO", pins[i]);
+      return false;
+    }
+    _pins[i] = pins[i];
+  }
+
+#if SOC_DEDICATED_GPIO_SUPPORTED
+  int gpio_array[GPIO_BUNDLE_MAX_PINS];
+  for (size_t i = 0; i < count; i++) {
+    gpio_array[i] = pins[i];
+  }
+  dedic_gpio_bundle_config_t config = {};
+  config.gpio_array = gpio_array;
+  config.array_size = count;
+  config.flags.in_en = 1;
+  config.flags.out_en = (mode & OUTPUT) == OUTPUT;
+  esp_err_t err = dedic_gpio_new_bundle(&config, &_bundle);
+  if (err != ESP_OK) {
+    log_e("dedic_gpio_new_bundle failed: 0x%x (%s)", err, esp_err_to_name(err));
+    _bundle = NULL;
+    return false;
+  }
+  if (config.flags.out_en) {
+    dedic_gpio_get_out_offset(_bundle, &_out_offset);
+  }
+  dedic_gpio_get_in_offset(_bundle, &_in_offset);
+#endif
+
+  _count = count;
+  _mode = mode;
+  _mask = (1UL << count) - 1;
+  _out_mask = ((mode & OUTPUT) == OUTPUT) ? _mask : 0;
+  for (size_t i = 0; i < count; i++) {
+    perimanSetPinBusExtraType(_pins[i], "GPIO_BUNDLE");
+  }
+  return true;
+}
+
+void GPIOBundle::end() {
+  if (_count == 0) {
+    return;
+  }
+#if SOC_DEDICATED_GPIO_SUPPORTED
+  if (_bundle != NULL) {
+    dedic_gpio_del_bundle(_bundle);
+    _bundle = NULL;
+  }
+  // route the outputs back to the GPIO registers so that digitalWrite() works again
+  if ((_mode & OUTPUT) == OUTPUT) {
+    for (size_t i = 0; i < _count; i++) {
+      esp_rom_gpio_connect_out_signal(_pins[i], SIG_GPIO_OUT_IDX, false, false);
+    }
+  }
+#endif
+  for (size_t i = 0; i < _count; i++) {
+    perimanSetPinBusExtraType(_pins[i], NULL);
+  }
+  _count = 0;
+  _mask = 0;
+  _out_mask = 0;
+}
+
+void GPIOBundle::shiftOut(uint8_t dataBit, uint8_t clockBit, uint8_t bitOrder, const uint8_t *data, size_t len) {
+  if (dataBit >= _count || clockBit >= _count || data == NULL) {
+    log_e("Bad Parameters");
+    return;
+  }
+  uint32_t d = 1UL << dataBit;
+  uint32_t c = 1UL << clockBit;
+  for (size_t n = 0; n < len; n++) {
+    uint8_t val = data[n];
+    for (uint8_t i = 0; i < 8; i++) {
+      bool bit = (bitOrder == LSBFIRST) ? (val & (1 << i)) : (val & (1 << (7 - i)));
+      write(d | c, bit ? d : 0);  // clock low and next data in the same write
+      set(c);
+    }
+  }
+  clear(c);
+}
+
+void GPIOBundle::shiftIn(GPIOBundle &input, uint8_t dataBit, uint8_t clockBit, uint8_t bitOrder, uint8_t *data, size_t len) {
+  if (dataBit >= input._count || clockBit >= _count || data == NULL) {
+    log_e("Bad Parameters");
+    return;
+  }
+  uint32_t c = 1UL << clockBit;
+  for (size_t n = 0; n < len; n++) {
+    uint8_t value = 0;
+    for (uint8_t i = 0; i < 8; i++) {
+      uint8_t bit = (input.read() >> dataBit) & 1;
+      value |= (bitOrder == LSBFIRST) ? (bit << i) : (bit << (7 - i));
+      set(c);
+      clear(c);
+    }
+    data[n] = value;
+  }
+}
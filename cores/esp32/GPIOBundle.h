@@ -0,0 +1,130 @@
+// Copyright 2025 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp32-hal-gpio.h"
+#include "soc/soc_caps.h"
+#if SOC_DEDICATED_GPIO_SUPPORTED
+#include "driver/dedic_gpio.h"
+#include "hal/dedic_gpio_cpu_ll.h"
+#else
+#include "hal/gpio_ll.h"
+#endif
+
+/*
+ * GPIO bundle
+ *
+ * Up to 8 pins that are written and read together, pins[n] being bit n. On the SoCs with
+ * dedicated GPIO (all but the ESP32) write() and read() are single CPU instructions, so all
+ * the pins of the bundle change in the same cycle and a pin toggles at tens of MHz. The ESP32
+ * falls back to the GPIO set/clear registers, one write per register bank.
+ *
+ * Dedicated GPIO channels belong to the CPU core that called begin(): use the bundle only from
+ * tasks that run on that core (the loop task is pinned). digitalWrite() has no effect on the
+ * outputs of a bundle until end().
+ *
+ *   const uint8_t pins[] = {4, 5};  // data, clock
+ *   GPIOBundle bus;
+ *   bus.begin(pins, 2, OUTPUT);
+ *   bus.write(0b11, 0b01);  // data high and clock low at once
+ *   bus.shiftOut(0, 1, MSBFIRST, buf, len);
+ */
+#define GPIO_BUNDLE_MAX_PINS 8
+
+class GPIOBundle {
+public:
+  GPIOBundle();
+  ~GPIOBundle();
+
+  // mode is applied to every pin like pinMode(): OUTPUT, OUTPUT_OPEN_DRAIN, INPUT, INPUT_PULLUP...
+  bool begin(const uint8_t *pins, size_t count, uint8_t mode = OUTPUT);
+  void end();
+
+  size_t count() const {
+    return _count;
+  }
+  uint8_t pin(size_t bit) const {
+    return (bit < _count) ? _pins[bit] : 0xFF;
+  }
+
+  // Sets the pins in mask to the bits of value, the other pins keep their level.
+  // Does nothing on a bundle that was not opened with OUTPUT
+  inline void write(uint32_t mask, uint32_t value) {
+#if SOC_DEDICATED_GPIO_SUPPORTED
+    dedic_gpio_cpu_ll_write_mask((mask & _out_mask) << _out_offset, value << _out_offset);
+#else
+    writeRegisters(mask & _out_mask, value);
+#endif
+  }
+  inline void set(uint32_t mask) {
+    write(mask, mask);
+  }
+  inline void clear(uint32_t mask) {
+    write(mask, 0);
+  }
+  // Input levels of all the pins. For outputs, this is the level on the pad
+  inline uint32_t read() {
+#if SOC_DEDICATED_GPIO_SUPPORTED
+    return (dedic_gpio_cpu_ll_read_in() >> _in_offset) & _mask;
+#else
+    return readRegisters();
+#endif
+  }
+
+  // shiftOut() of len bytes over two pins of the bundle. Data changes with the falling edge
+  // of the clock, the clock is left low
+  void shiftOut(uint8_t dataBit, uint8_t clockBit, uint8_t bitOrder, const uint8_t *data, size_t len);
+  // shiftIn() of len bytes, the clock is a pin of this bundle and the data a pin of the input bundle
+  void shiftIn(GPIOBundle &input, uint8_t dataBit, uint8_t clockBit, uint8_t bitOrder, uint8_t *data, size_t len);
+
+private:
+  uint8_t _pins[GPIO_BUNDLE_MAX_PINS];
+  size_t _count;
+  uint8_t _mode;
+  uint32_t _mask;      // one bit per pin
+  uint32_t _out_mask;  // same as _mask if the pins are outputs, 0 otherwise
+#if SOC_DEDICATED_GPIO_SUPPORTED
+  dedic_gpio_bundle_handle_t _bundle;
+  uint32_t _out_offset;  // first dedicated channel of the bundle
+  uint32_t _in_offset;
+#else
+  inline void writeRegisters(uint32_t mask, uint32_t value) {
+    uint32_t set[2] = {0, 0}, clr[2] = {0, 0};
+    for (size_t i = 0; i < _count; i++) {
+      if (mask & (1UL << i)) {
+        uint8_t pin = _pins[i];
+        uint32_t *regs = (value & (1UL << i)) ? set : clr;
+        regs[pin >> 5] |= 1UL << (pin & 31);
+      }
+    }
+    gpio_dev_t *hw = GPIO_LL_GET_HW(GPIO_PORT_0);
+    hw->out_w1ts = set[0];
+    hw->out_w1tc = clr[0];
+    hw->out1_w1ts.val = set[1];
+    hw->out1_w1tc.val = clr[1];
+  }
+  inline uint32_t readRegisters() {
+    gpio_dev_t *hw = GPIO_LL_GET_HW(GPIO_PORT_0);
+    uint64_t in = ((uint64_t)hw->in1.val << 32) | hw->in;
+    uint32_t value = 0;
+    for (size_t i = 0; i < _count; i++) {
+      value |= ((in >> _pins[i]) & 1) << i;
+    }
+    return value;
+  }
+#endif
+};
@@ -0,0 +1,55 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <Arduino.h>
+#include <HashBuilder.h>
+
+bool HashBuilder::addStream(Stream &stream, const size_t maxLen) {
+  const int buf_size = HASH_BUILDER_STREAM_BUFFER_SIZE;
+  int maxLengthLeft = maxLen;
+
+  if (!_streamBuffer) {
+    _streamBuffer = (uint8_t *)malloc(buf_size);
+    if (!_streamBuffer) {
+      return false;
+    }
+  }
+
+  int bytesAvailable = stream.available();
+  while ((bytesAvailable > 0) && (maxLengthLeft > 0)) {
+
+    // determine number of bytes to read
+    int readBytes = bytesAvailable;
+    if (readBytes > maxLengthLeft) {
+      readBytes = maxLengthLeft;  // read only until max_len
+    }
+    if (readBytes > buf_size) {
+      readBytes = buf_size;  // not read more the buffer can handle
+    }
+
+    // read data and check if we got something
+    int numBytesRead = stream.readBytes(_streamBuffer, readBytes);
+    if (numBytesRead < 1) {
+      return false;
+    }
+
+    // Update the hash with buffer payload
+    add(_streamBuffer, numBytesRead);
+
+    // update available number of bytes
+    maxLengthLeft -= numBytesRead;
+    bytesAvailable = stream.available();
+  }
+  return true;
+}
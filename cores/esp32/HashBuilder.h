@@ -20,9 +20,25 @@
 
 #include "HEXBuilder.h"
 
+// Size of the buffer used by addStream(), allocated on first use and kept until the builder is destroyed
+#ifndef HASH_BUILDER_STREAM_BUFFER_SIZE
+#define HASH_BUILDER_STREAM_BUFFER_SIZE 1024
+#endif
+
 class HashBuilder : public HEXBuilder {
+private:
+  uint8_t *_streamBuffer = nullptr;
+
 public:
-  virtual ~HashBuilder() {}
+  HashBuilder() {}
+  // copies get their own stream buffer
+  HashBuilder(const HashBuilder &) : HEXBuilder(), _streamBuffer(nullptr) {}
+  HashBuilder &operator=(const HashBuilder &) {
+    return *this;
+  }
+  virtual ~HashBuilder() {
+    free(_streamBuffer);
+  }
   virtual void begin() = 0;
 
   virtual void add(const uint8_t *data, size_t len) = 0;
@@ -38,7 +54,7 @@ public:
     addHexString(data.c_str());
   }
 
-  virtual bool addStream(Stream &stream, const size_t maxLen) = 0;
+  virtual bool addStream(Stream &stream, const size_t maxLen);
   virtual void calculate() = 0;
   virtual void getBytes(uint8_t *output) = 0;
   virtual void getChars(char *output) = 0;
@@ -43,7 +43,6 @@ public:
   using HashBuilder::addHexString;
   void addHexString(const char *data) override;
 
-  bool addStream(Stream &stream, const size_t maxLen) override;
   void calculate(void) override;
   void getBytes(uint8_t *output) override;
   void getChars(char *output) override;
@@ -25,6 +25,8 @@
 #include <stdio.h>
 #include <string.h>
 #include <math.h>
+#include <wchar.h>
+#include <sys/types.h>
 #include "Arduino.h"
 
 #include "Print.h"
@@ -43,31 +45,457 @@ size_t Print::write(const uint8_t *buffer, size_t size) {
   return n;
 }
 
-size_t Print::vprintf(const char *format, va_list arg) {
-  char loc_buf[64];
-  char *temp = loc_buf;
-  va_list copy;
-  va_copy(copy, arg);
-  int len = vsnprintf(temp, sizeof(loc_buf), format, copy);
-  va_end(copy);
-  if (len < 0) {
-    va_end(arg);
-    return 0;
-  }
-  if (len >= (int)sizeof(loc_buf)) {  // comparison of same sign type for the compiler
-    temp = (char *)malloc(len + 1);
-    if (temp == NULL) {
-      va_end(arg);
-      return 0;
+// Size of the stack buffer used by printf() to collect output before writing it to the target
+#ifndef PRINTF_CHUNK_SIZE
+#define PRINTF_CHUNK_SIZE 128
+#endif
+
+namespace {
+
+enum {
+  FMT_LEFT = 0x01,   // '-'
+  FMT_PLUS = 0x02,   // '+'
+  FMT_SPACE = 0x04,  // ' '
+  FMT_ALT = 0x08,    // '#'
+  FMT_ZERO = 0x10,   // '0'
+};
+
+enum {
+  FMT_LEN_NONE,
+  FMT_LEN_HH,
+  FMT_LEN_H,
+  FMT_LEN_L,
+  FMT_LEN_LL,
+  FMT_LEN_Z,
+  FMT_LEN_J,
+  FMT_LEN_T,
+  FMT_LEN_LD,
+};
+
+// Collects formatted output in a small stack buffer and writes it to the Print target in chunks
+class PrintChunkWriter {
+public:
+  explicit PrintChunkWriter(Print &out) : _out(out), _len(0), _count(0), _written(0) {}
+
+  void put(char c) {
+    if (_len == sizeof(_buf)) {
+      flush();
     }
-    len = vsnprintf(temp, len + 1, format, arg);
+    _buf[_len++] = c;
+    _count++;
   }
-  va_end(arg);
-  len = write((uint8_t *)temp, len);
-  if (temp != loc_buf) {
-    free(temp);
+
+  void put(const char *str, size_t size) {
+    _count += size;
+    if (size >= sizeof(_buf)) {
+      // large fragments skip the buffer
+      flush();
+      _written += _out.write((const uint8_t *)str, size);
+      return;
+    }
+    while (size) {
+      if (_len == sizeof(_buf)) {
+        flush();
+      }
+      size_t n = sizeof(_buf) - _len;
+      if (n > size) {
+        n = size;
+      }
+      memcpy(_buf + _len, str, n);
+      _len += n;
+      str += n;
+      size -= n;
+    }
   }
-  return len;
+
+  void pad(char c, int n) {
+    while (n-- > 0) {
+      put(c);
+    }
+  }
+
+  void flush() {
+    if (_len) {
+      _written += _out.write((const uint8_t *)_buf, _len);
+      _len = 0;
+    }
+  }
+
+  size_t count() const {
+    return _count;
+  }
+
+  size_t written() const {
+    return _written;
+  }
+
+private:
+  Print &_out;
+  char _buf[PRINTF_CHUNK_SIZE];
+  size_t _len;
+  size_t _count;
+  size_t _written;
+};
+
+}  // namespace
+
+// Writes the digits of value backwards, ending at end. Returns a pointer to the first digit.
+static char *formatDigits(char *end, unsigned long long value, unsigned base, bool upper) {
+  // print(n, base) accepts bases up to 36
+  const char *xdigits = upper ? "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ" : "0123456789abcdefghijklmnopqrstuvwxyz";
+  char *p = end;
+  if (base == 10) {
+    // 64 bit division is a library call on 32 bit cores, peel off 9 digits at a time
+    while (value > UINT32_MAX) {
+      unsigned long long q = value / 1000000000ULL;
+      uint32_t r = value - q * 1000000000ULL;
+      for (int i = 0; i < 9; i++) {
+        *--p = '0' + r % 10;
+        r /= 10;
+      }
+      value = q;
+    }
+    uint32_t v = value;
+    do {
+      *--p = '0' + v % 10;
+      v /= 10;
+    } while (v);
+  } else if (base == 16 || base == 8 || base == 2) {
+    unsigned shift = (base == 16) ? 4 : (base == 8) ? 3 : 1;
+    do {
+      *--p = xdigits[value & (base - 1)];
+      value >>= shift;
+    } while (value);
+  } else {
+    do {
+      unsigned long long m = value;
+      value /= base;
+      *--p = xdigits[m - base * value];
+    } while (value);
+  }
+  return p;
+}
+
+static void formatInteger(PrintChunkWriter &w, unsigned long long value, char sign, unsigned base, bool upper, int flags, int width, int precision, bool hexPrefix) {
+  char buf[8 * sizeof(value)];
+  char *end = buf + sizeof(buf);
+  char *digits = end;
+  if (value != 0 || precision != 0) {
+    digits = formatDigits(end, value, base, upper);
+  }
+  int ndigits = end - digits;
+
+  char prefix[3];
+  int nprefix = 0;
+  if (sign) {
+    prefix[nprefix++] = sign;
+  }
+  if (hexPrefix) {
+    prefix[nprefix++] = '0';
+    prefix[nprefix++] = upper ? 'X' : 'x';
+  }
+  if (base == 8 && (flags & FMT_ALT) && (ndigits == 0 || *digits != '0') && precision <= ndigits) {
+    precision = ndigits + 1;  // '#' forces a leading zero for octal
+  }
+
+  int zeros = (precision > ndigits) ? precision - ndigits : 0;
+  int total = nprefix + zeros + ndigits;
+  if (!(flags & FMT_LEFT) && (flags & FMT_ZERO) && precision < 0 && width > total) {
+    zeros += width - total;
+    total = width;
+  }
+  if (!(flags & FMT_LEFT)) {
+    w.pad(' ', width - total);
+  }
+  w.put(prefix, nprefix);
+  w.pad('0', zeros);
+  w.put(digits, ndigits);
+  if (flags & FMT_LEFT) {
+    w.pad(' ', width - total);
+  }
+}
+
+static void formatString(PrintChunkWriter &w, const char *str, int flags, int width, int precision) {
+  if (str == NULL) {
+    str = "(null)";
+  }
+  size_t len = (precision >= 0) ? strnlen(str, precision) : strlen(str);
+  if (!(flags & FMT_LEFT)) {
+    w.pad(' ', width - (int)len);
+  }
+  w.put(str, len);
+  if (flags & FMT_LEFT) {
+    w.pad(' ', width - (int)len);
+  }
+}
+
+// Conversions that are rarely used and hard to get identical to the C library (floating point,
+// wide characters) are formatted by snprintf() one at a time. Only results larger than the stack
+// buffer need the heap.
+template<typename T> static void formatDelegated(PrintChunkWriter &w, const char *spec, int width, int precision, T value) {
+  char buf[64];
+  int len = (precision >= 0) ? snprintf(buf, sizeof(buf), spec, width, precision, value) : snprintf(buf, sizeof(buf), spec, width, value);
+  if (len < 0) {
+    return;
+  }
+  if (len < (int)sizeof(buf)) {
+    w.put(buf, len);
+    return;
+  }
+  char *temp = (char *)malloc(len + 1);
+  if (temp == NULL) {
+    return;
+  }
+  if (precision >= 0) {
+    snprintf(temp, len + 1, spec, width, precision, value);
+  } else {
+    snprintf(temp, len + 1, spec, width, value);
+  }
+  w.put(temp, len);
+  free(temp);
+}
+
+size_t Print::vprintf(const char *format, va_list arg) {
+  PrintChunkWriter w(*this);
+  const char *f = format;
+
+  while (*f) {
+    if (*f != '%') {
+      const char *start = f;
+      while (*f && *f != '%') {
+        f++;
+      }
+      w.put(start, f - start);
+      continue;
+    }
+    const char *specStart = f++;
+
+    // flags
+    int flags = 0;
+    for (;; f++) {
+      if (*f == '-') {
+        flags |= FMT_LEFT;
+      } else if (*f == '+') {
+        flags |= FMT_PLUS;
+      } else if (*f == ' ') {
+        flags |= FMT_SPACE;
+      } else if (*f == '#') {
+        flags |= FMT_ALT;
+      } else if (*f == '0') {
+        flags |= FMT_ZERO;
+      } else {
+        break;
+      }
+    }
+
+    // width
+    int width = 0;
+    if (*f == '*') {
+      width = va_arg(arg, int);
+      if (width < 0) {
+        flags |= FMT_LEFT;
+        width = -width;
+      }
+      f++;
+    } else {
+      while (*f >= '0' && *f <= '9') {
+        width = width * 10 + (*f++ - '0');
+      }
+    }
+
+    // precision
+    int precision = -1;
+    if (*f == '.') {
+      f++;
+      precision = 0;
+      if (*f == '*') {
+        precision = va_arg(arg, int);
+        if (precision < 0) {
+          precision = -1;
+        }
+        f++;
+      } else {
+        while (*f >= '0' && *f <= '9') {
+          precision = precision * 10 + (*f++ - '0');
+        }
+      }
+    }
+
+    // length
+    int length = FMT_LEN_NONE;
+    switch (*f) {
+      case 'h':
+        f++;
+        length = FMT_LEN_H;
+        if (*f == 'h') {
+          f++;
+          length = FMT_LEN_HH;
+        }
+        break;
+      case 'l':
+        f++;
+        length = FMT_LEN_L;
+        if (*f == 'l') {
+          f++;
+          length = FMT_LEN_LL;
+        }
+        break;
+      case 'z': f++; length = FMT_LEN_Z; break;
+      case 'j': f++; length = FMT_LEN_J; break;
+      case 't': f++; length = FMT_LEN_T; break;
+      case 'L': f++; length = FMT_LEN_LD; break;
+      default:  break;
+    }
+
+    char conv = *f;
+    if (conv == 0) {
+      w.put(specStart, f - specStart);  // incomplete specification at the end of the format
+      break;
+    }
+    f++;
+
+    switch (conv) {
+      case '%': w.put('%'); break;
+
+      case 'd':
+      case 'i':
+      {
+        long long v;
+        switch (length) {
+          case FMT_LEN_HH: v = (signed char)va_arg(arg, int); break;
+          case FMT_LEN_H:  v = (short)va_arg(arg, int); break;
+          case FMT_LEN_L:  v = va_arg(arg, long); break;
+          case FMT_LEN_LL: v = va_arg(arg, long long); break;
+          case FMT_LEN_Z:  v = va_arg(arg, ssize_t); break;
+          case FMT_LEN_J:  v = va_arg(arg, intmax_t); break;
+          case FMT_LEN_T:  v = va_arg(arg, ptrdiff_t); break;
+          default:         v = va_arg(arg, int); break;
+        }
+        char sign = (v < 0) ? '-' : (flags & FMT_PLUS) ? '+' : (flags & FMT_SPACE) ? ' ' : 0;
+        unsigned long long u = (v < 0) ? 0ULL - (unsigned long long)v : (unsigned long long)v;
+        formatInteger(w, u, sign, 10, false, flags, width, precision, false);
+        break;
+      }
+
+      case 'u':
+      case 'x':
+      case 'X':
+      case 'o':
+      {
+        unsigned long long v;
+        switch (length) {
+          case FMT_LEN_HH: v = (unsigned char)va_arg(arg, unsigned int); break;
+          case FMT_LEN_H:  v = (unsigned short)va_arg(arg, unsigned int); break;
+          case FMT_LEN_L:  v = va_arg(arg, unsigned long); break;
+          case FMT_LEN_LL: v = va_arg(arg, unsigned long long); break;
+          case FMT_LEN_Z:  v = va_arg(arg, size_t); break;
+          case FMT_LEN_J:  v = va_arg(arg, uintmax_t); break;
+          case FMT_LEN_T:  v = va_arg(arg, ptrdiff_t); break;
+          default:         v = va_arg(arg, unsigned int); break;
+        }
+        unsigned base = (conv == 'u') ? 10 : (conv == 'o') ? 8 : 16;
+        bool hexPrefix = base == 16 && (flags & FMT_ALT) && v != 0;
+        formatInteger(w, v, 0, base, conv == 'X', flags, width, precision, hexPrefix);
+        break;
+      }
+
+      case 'p': formatInteger(w, (uintptr_t)va_arg(arg, void *), 0, 16, false, flags, width, precision, true); break;
+
+      case 'c':
+        if (length == FMT_LEN_L) {
+          formatDelegated(w, (flags & FMT_LEFT) ? "%-*lc" : "%*lc", width, -1, va_arg(arg, wint_t));
+        } else {
+          char c = (char)va_arg(arg, int);
+          if (!(flags & FMT_LEFT)) {
+            w.pad(' ', width - 1);
+          }
+          w.put(c);
+          if (flags & FMT_LEFT) {
+            w.pad(' ', width - 1);
+          }
+        }
+        break;
+
+      case 's':
+        if (length == FMT_LEN_L) {
+          const wchar_t *ws = va_arg(arg, const wchar_t *);
+          formatDelegated(w, (precision >= 0) ? ((flags & FMT_LEFT) ? "%-*.*ls" : "%*.*ls") : ((flags & FMT_LEFT) ? "%-*ls" : "%*ls"), width, precision, ws);
+        } else {
+          formatString(w, va_arg(arg, const char *), flags, width, precision);
+        }
+        break;
+
+      case 'f':
+      case 'F':
+      case 'e':
+      case 'E':
+      case 'g':
+      case 'G':
+      case 'a':
+      case 'A':
+      {
+        // rebuild the specification with '*' for width and precision
+        char spec[12];
+        int n = 0;
+        spec[n++] = '%';
+        if (flags & FMT_LEFT) {
+          spec[n++] = '-';
+        }
+        if (flags & FMT_PLUS) {
+          spec[n++] = '+';
+        }
+        if (flags & FMT_SPACE) {
+          spec[n++] = ' ';
+        }
+        if (flags & FMT_ALT) {
+          spec[n++] = '#';
+        }
+        if (flags & FMT_ZERO) {
+          spec[n++] = '0';
+        }
+        spec[n++] = '*';
+        if (precision >= 0) {
+          spec[n++] = '.';
+          spec[n++] = '*';
+        }
+        if (length == FMT_LEN_LD) {
+          spec[n++] = 'L';
+          spec[n++] = conv;
+          spec[n] = 0;
+          formatDelegated(w, spec, width, precision, va_arg(arg, long double));
+        } else {
+          spec[n++] = conv;
+          spec[n] = 0;
+          formatDelegated(w, spec, width, precision, va_arg(arg, double));
+        }
+        break;
+      }
+
+      case 'n':
+      {
+        size_t count = w.count();
+        switch (length) {
+          case FMT_LEN_HH: *va_arg(arg, signed char *) = count; break;
+          case FMT_LEN_H:  *va_arg(arg, short *) = count; break;
+          case FMT_LEN_L:  *va_arg(arg, long *) = count; break;
+          case FMT_LEN_LL: *va_arg(arg, long long *) = count; break;
+          case FMT_LEN_Z:  *va_arg(arg, ssize_t *) = count; break;
+          case FMT_LEN_J:  *va_arg(arg, intmax_t *) = count; break;
+          case FMT_LEN_T:  *va_arg(arg, ptrdiff_t *) = count; break;
+          default:         *va_arg(arg, int *) = count; break;
+        }
+        break;
+      }
+
+      default:
+        // unknown conversion, print the specification as is
+        w.put(specStart, f - specStart);
+        break;
+    }
+  }
+
+  w.flush();
+  return w.written();
 }
 
 size_t Print::printf(const __FlashStringHelper *ifsh, ...) {
@@ -251,51 +679,23 @@ size_t Print::println(struct tm *timeinfo, const char *format) {
 // Private Methods /////////////////////////////////////////////////////////////
 
 size_t Print::printNumber(unsigned long n, uint8_t base) {
-  char buf[8 * sizeof(n) + 1];  // Assumes 8-bit chars plus zero byte.
-  char *str = &buf[sizeof(buf) - 1];
-
-  *str = '\0';
-
-  // prevent crash if called with base == 1
-  if (base < 2) {
-    base = 10;
-  }
-
-  do {
-    char c = n % base;
-    n /= base;
-
-    *--str = c < 10 ? c + '0' : c + 'A' - 10;
-  } while (n);
-
-  return write(str);
+  return printNumber(static_cast<unsigned long long>(n), base);
 }
 
 size_t Print::printNumber(unsigned long long n, uint8_t base) {
-  char buf[8 * sizeof(n) + 1];  // Assumes 8-bit chars plus zero byte.
-  char *str = &buf[sizeof(buf) - 1];
+  char buf[8 * sizeof(n)];  // Assumes 8-bit chars.
+  char *end = &buf[sizeof(buf)];
 
-  *str = '\0';
-
-  // prevent crash if called with base == 1
-  if (base < 2) {
+  // prevent crash if called with base == 1, and there are digits up to base 36
+  if (base < 2 || base > 36) {
     base = 10;
   }
 
-  do {
-    auto m = n;
-    n /= base;
-    char c = m - base * n;
-
-    *--str = c < 10 ? c + '0' : c + 'A' - 10;
-  } while (n);
-
-  return write(str);
+  char *str = formatDigits(end, n, base, true);
+  return write(str, end - str);
 }
 
 size_t Print::printFloat(double number, uint8_t digits) {
-  size_t n = 0;
-
   if (isnan(number)) {
     return print("nan");
   }
@@ -309,9 +709,14 @@ size_t Print::printFloat(double number, uint8_t digits) {
     return print("ovf");  // constant determined empirically
   }
 
+  // The number is built in a local buffer and written at once
+  char buf[32];
+  size_t len = 0;
+  size_t n = 0;
+
   // Handle negative numbers
   if (number < 0.0) {
-    n += print('-');
+    buf[len++] = '-';
     number = -number;
   }
 
@@ -323,23 +728,31 @@ size_t Print::printFloat(double number, uint8_t digits) {
 
   number += rounding;
 
-  // Extract the integer part of the number and print it
+  // Extract the integer part of the number
   unsigned long int_part = (unsigned long)number;
   double remainder = number - (double)int_part;
-  n += print(int_part);
+  char int_buf[3 * sizeof(int_part)];
+  char *int_end = &int_buf[sizeof(int_buf)];
+  char *int_str = formatDigits(int_end, int_part, 10, false);
+  memcpy(buf + len, int_str, int_end - int_str);
+  len += int_end - int_str;
 
-  // Print the decimal point, but only if there are digits beyond
+  // Add the decimal point, but only if there are digits beyond
   if (digits > 0) {
-    n += print(".");
+    buf[len++] = '.';
   }
 
   // Extract digits from the remainder one at a time
   while (digits-- > 0) {
+    if (len == sizeof(buf)) {
+      n += write(buf, len);
+      len = 0;
+    }
     remainder *= 10.0;
     int toPrint = int(remainder);
-    n += print(toPrint);
+    buf[len++] = '0' + toPrint;
     remainder -= toPrint;
   }
 
-  return n;
+  return n + write(buf, len);
 }
@@ -200,7 +200,33 @@ void SHA1Builder::process(const uint8_t *data) {
 
 // Public methods
 
+SHA1Builder::SHA1Builder(bool accelerated) {
+#if SHA1_BUILDER_USE_MBEDTLS
+  _accelerated = accelerated;
+  mbedtls_sha1_init(&_ctx);
+#else
+  (void)accelerated;
+#endif
+  begin();
+}
+
+SHA1Builder::~SHA1Builder() {
+#if SHA1_BUILDER_USE_MBEDTLS
+  mbedtls_sha1_free(&_ctx);
+#endif
+}
+
 void SHA1Builder::begin(void) {
+#if SHA1_BUILDER_USE_MBEDTLS
+  if (_accelerated) {
+    memset(hash, 0x00, sizeof(hash));
+    // releases the peripheral if a previous digest was not finished
+    mbedtls_sha1_free(&_ctx);
+    mbedtls_sha1_init(&_ctx);
+    mbedtls_sha1_starts(&_ctx);
+    return;
+  }
+#endif
   total[0] = 0;
   total[1] = 0;
 
@@ -215,6 +241,16 @@ void SHA1Builder::begin(void) {
 }
 
 void SHA1Builder::add(const uint8_t *data, size_t len) {
+#if SHA1_BUILDER_USE_MBEDTLS
+  if (_accelerated) {
+    mbedtls_sha1_update(&_ctx, data, len);
+    return;
+  }
+#endif
+  addSoftware(data, len);
+}
+
+void SHA1Builder::addSoftware(const uint8_t *data, size_t len) {
   size_t fill;
   uint32_t left;
 
@@ -262,46 +298,13 @@ void SHA1Builder::addHexString(const char *data) {
   free(tmp);
 }
 
-bool SHA1Builder::addStream(Stream &stream, const size_t maxLen) {
-  const int buf_size = 512;
-  int maxLengthLeft = maxLen;
-  uint8_t *buf = (uint8_t *)malloc(buf_size);
-
-  if (!buf) {
-    return false;
-  }
-
-  int bytesAvailable = stream.available();
-  while ((bytesAvailable > 0) && (maxLengthLeft > 0)) {
-
-    // determine number of bytes to read
-    int readBytes = bytesAvailable;
-    if (readBytes > maxLengthLeft) {
-      readBytes = maxLengthLeft;  // read only until max_len
-    }
-    if (readBytes > buf_size) {
-      readBytes = buf_size;  // not read more the buffer can handle
-    }
-
-    // read data and check if we got something
-    int numBytesRead = stream.readBytes(buf, readBytes);
-    if (numBytesRead < 1) {
-      free(buf);
-      return false;
-    }
-
-    // Update SHA1 with buffer payload
-    add(buf, numBytesRead);
-
-    // update available number of bytes
-    maxLengthLeft -= numBytesRead;
-    bytesAvailable = stream.available();
-  }
-  free(buf);
-  return true;
-}
-
 void SHA1Builder::calculate(void) {
+#if SHA1_BUILDER_USE_MBEDTLS
+  if (_accelerated) {
+    mbedtls_sha1_finish(&_ctx, hash);
+    return;
+  }
+#endif
   uint32_t last, padn;
   uint32_t high, low;
   uint8_t msglen[8];
@@ -315,8 +318,8 @@ void SHA1Builder::calculate(void) {
   last = total[0] & 0x3F;
   padn = (last < 56) ? (56 - last) : (120 - last);
 
-  add((uint8_t *)sha1_padding, padn);
-  add(msglen, 8);
+  addSoftware(sha1_padding, padn);
+  addSoftware(msglen, 8);
 
   PUT_UINT32_BE(state[0], hash, 0);
   PUT_UINT32_BE(state[1], hash, 4);
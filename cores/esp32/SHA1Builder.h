@@ -20,6 +20,15 @@
 
 #include "HashBuilder.h"
 
+// mbedtls uses the SHA peripheral when CONFIG_MBEDTLS_HARDWARE_SHA is enabled
+#if !defined(SHA1_BUILDER_USE_MBEDTLS) && defined(ESP_PLATFORM) && __has_include("mbedtls/sha1.h")
+#define SHA1_BUILDER_USE_MBEDTLS 1
+#endif
+
+#if SHA1_BUILDER_USE_MBEDTLS
+#include "mbedtls/sha1.h"
+#endif
+
 #define SHA1_HASH_SIZE 20
 
 class SHA1Builder : public HashBuilder {
@@ -28,10 +37,23 @@ private:
   uint32_t state[5];            /* intermediate digest state  */
   unsigned char buffer[64];     /* data block being processed */
   uint8_t hash[SHA1_HASH_SIZE]; /* SHA-1 result               */
+#if SHA1_BUILDER_USE_MBEDTLS
+  mbedtls_sha1_context _ctx;
+  bool _accelerated;
+#endif
 
   void process(const uint8_t *data);
+  void addSoftware(const uint8_t *data, size_t len);
 
 public:
+  // accelerated selects mbedtls (and with it the SHA peripheral) over the portable implementation
+  SHA1Builder(bool accelerated = true);
+  ~SHA1Builder();
+
+  // not copyable, the destructor frees the mbedtls context
+  SHA1Builder(const SHA1Builder &) = delete;
+  SHA1Builder &operator=(const SHA1Builder &) = delete;
+
   void begin() override;
 
   using HashBuilder::add;
@@ -40,7 +62,6 @@ public:
   using HashBuilder::addHexString;
   void addHexString(const char *data) override;
 
-  bool addStream(Stream &stream, const size_t maxLen) override;
   void calculate() override;
   void getBytes(uint8_t *output) override;
   void getChars(char *output) override;
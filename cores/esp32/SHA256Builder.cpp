@@ -0,0 +1,66 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <Arduino.h>
+#include <SHA256Builder.h>
+
+SHA256Builder::SHA256Builder() {
+  mbedtls_sha256_init(&_ctx);
+  begin();
+}
+
+SHA256Builder::~SHA256Builder() {
+  mbedtls_sha256_free(&_ctx);
+}
+
+void SHA256Builder::begin(void) {
+  memset(hash, 0x00, sizeof(hash));
+  // releases the peripheral if a previous digest was not finished
+  mbedtls_sha256_free(&_ctx);
+  mbedtls_sha256_init(&_ctx);
+  mbedtls_sha256_starts(&_ctx, 0);
+}
+
+void SHA256Builder::add(const uint8_t *data, size_t len) {
+  mbedtls_sha256_update(&_ctx, data, len);
+}
+
+void SHA256Builder::addHexString(const char *data) {
+  size_t len = strlen(data);
+  uint8_t *tmp = (uint8_t *)malloc(len / 2);
+  if (tmp == NULL) {
+    return;
+  }
+  hex2bytes(tmp, len / 2, data);
+  add(tmp, len / 2);
+  free(tmp);
+}
+
+void SHA256Builder::calculate(void) {
+  mbedtls_sha256_finish(&_ctx, hash);
+}
+
+void SHA256Builder::getBytes(uint8_t *output) {
+  memcpy(output, hash, SHA256_HASH_SIZE);
+}
+
+void SHA256Builder::getChars(char *output) {
+  bytes2hex(output, SHA256_HASH_SIZE * 2 + 1, hash, SHA256_HASH_SIZE);
+}
+
+String SHA256Builder::toString(void) {
+  char out[(SHA256_HASH_SIZE * 2) + 1];
+  getChars(out);
+  return String(out);
+}
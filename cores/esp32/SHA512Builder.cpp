@@ -0,0 +1,66 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <Arduino.h>
+#include <SHA512Builder.h>
+
+SHA512Builder::SHA512Builder() {
+  mbedtls_sha512_init(&_ctx);
+  begin();
+}
+
+SHA512Builder::~SHA512Builder() {
+  mbedtls_sha512_free(&_ctx);
+}
+
+void SHA512Builder::begin(void) {
+  memset(hash, 0x00, sizeof(hash));
+  // releases the peripheral if a previous digest was not finished
+  mbedtls_sha512_free(&_ctx);
+  mbedtls_sha512_init(&_ctx);
+  mbedtls_sha512_starts(&_ctx, 0);
+}
+
+void SHA512Builder::add(const uint8_t *data, size_t len) {
+  mbedtls_sha512_update(&_ctx, data, len);
+}
+
+void SHA512Builder::addHexString(const char *data) {
+  size_t len = strlen(data);
+  uint8_t *tmp = (uint8_t *)malloc(len / 2);
+  if (tmp == NULL) {
+    return;
+  }
+  hex2bytes(tmp, len / 2, data);
+  add(tmp, len / 2);
+  free(tmp);
+}
+
+void SHA512Builder::calculate(void) {
+  mbedtls_sha512_finish(&_ctx, hash);
+}
+
+void SHA512Builder::getBytes(uint8_t *output) {
+  memcpy(output, hash, SHA512_HASH_SIZE);
+}
+
+void SHA512Builder::getChars(char *output) {
+  bytes2hex(output, SHA512_HASH_SIZE * 2 + 1, hash, SHA512_HASH_SIZE);
+}
+
+String SHA512Builder::toString(void) {
+  char out[(SHA512_HASH_SIZE * 2) + 1];
+  getChars(out);
+  return String(out);
+}
@@ -0,0 +1,54 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SHA512Builder_h
+#define SHA512Builder_h
+
+#include <WString.h>
+#include <Stream.h>
+
+#include "mbedtls/sha512.h"
+
+#include "HashBuilder.h"
+
+#define SHA512_HASH_SIZE 64
+
+// SHA-512 through mbedtls, which uses the SHA peripheral when CONFIG_MBEDTLS_HARDWARE_SHA is enabled
+class SHA512Builder : public HashBuilder {
+private:
+  mbedtls_sha512_context _ctx;
+  uint8_t hash[SHA512_HASH_SIZE];
+
+public:
+  SHA512Builder();
+  ~SHA512Builder();
+
+  SHA512Builder(const SHA512Builder &) = delete;
+  SHA512Builder &operator=(const SHA512Builder &) = delete;
+
+  void begin() override;
+
+  using HashBuilder::add;
+  void add(const uint8_t *data, size_t len) override;
+
+  using HashBuilder::addHexString;
+  void addHexString(const char *data) override;
+
+  void calculate() override;
+  void getBytes(uint8_t *output) override;
+  void getChars(char *output) override;
+  String toString() override;
+};
+
+#endif
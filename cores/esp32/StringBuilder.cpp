@@ -0,0 +1,185 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <Arduino.h>
+#include "StringBuilder.h"
+
+StringBuilder::StringBuilder(size_t fragments) : _length(0), _valid(true) {
+  if (fragments) {
+    _fragments.reserve(fragments);
+  }
+}
+
+bool StringBuilder::reserve(size_t fragments, size_t copiedBytes) {
+  _fragments.reserve(fragments);
+  if (copiedBytes && !_copied.reserve(copiedBytes)) {
+    log_e("Unable to reserve %u bytes", copiedBytes);
+    return false;
+  }
+  return true;
+}
+
+void StringBuilder::clear() {
+  _fragments.clear();
+  _copied = emptyString;
+  _length = 0;
+  _valid = true;
+}
+
+StringBuilder &StringBuilder::add(const char *str, size_t length) {
+  if (!str) {
+    _valid = false;
+    return *this;
+  }
+  if (!length) {
+    return *this;
+  }
+  // Adjacent views of the same buffer are joined into one fragment
+  if (!_fragments.empty()) {
+    Fragment &last = _fragments.back();
+    if (last.data && last.data + last.length == str) {
+      last.length += length;
+      _length += length;
+      return *this;
+    }
+  }
+  _fragments.push_back({str, 0, length});
+  _length += length;
+  return *this;
+}
+
+StringBuilder &StringBuilder::add(const char *str) {
+  return add(str, str ? strlen(str) : 0);
+}
+
+StringBuilder &StringBuilder::add(const String &str) {
+  return add(str.c_str(), str.length());
+}
+
+StringBuilder &StringBuilder::add(const __FlashStringHelper *str) {
+  const char *p = reinterpret_cast<const char *>(str);
+  return add(p, p ? strlen_P(p) : 0);
+}
+
+StringBuilder &StringBuilder::addCopy(const char *str, size_t length) {
+  if (!str) {
+    _valid = false;
+    return *this;
+  }
+  if (!length) {
+    return *this;
+  }
+  size_t offset = _copied.length();
+  if (!_copied.concat(str, length)) {
+    log_e("Unable to store %u bytes", length);
+    _valid = false;
+    return *this;
+  }
+  // Consecutive copies share one fragment
+  if (!_fragments.empty()) {
+    Fragment &last = _fragments.back();
+    if (!last.data && last.offset + last.length == offset) {
+      last.length += length;
+      _length += length;
+      return *this;
+    }
+  }
+  _fragments.push_back({nullptr, offset, length});
+  _length += length;
+  return *this;
+}
+
+StringBuilder &StringBuilder::add(String &&str) {
+  return addCopy(str.c_str(), str.length());
+}
+
+StringBuilder &StringBuilder::add(char c) {
+  return addCopy(&c, 1);
+}
+
+StringBuilder &StringBuilder::add(int value, unsigned char base) {
+  return add((long)value, base);
+}
+
+StringBuilder &StringBuilder::add(unsigned int value, unsigned char base) {
+  return add((unsigned long)value, base);
+}
+
+StringBuilder &StringBuilder::add(long value, unsigned char base) {
+  char buf[2 + 8 * sizeof(long)];
+  ltoa(value, buf, base);
+  return addCopy(buf, strlen(buf));
+}
+
+StringBuilder &StringBuilder::add(unsigned long value, unsigned char base) {
+  char buf[1 + 8 * sizeof(unsigned long)];
+  ultoa(value, buf, base);
+  return addCopy(buf, strlen(buf));
+}
+
+StringBuilder &StringBuilder::add(long long value, unsigned char base) {
+  char buf[2 + 8 * sizeof(long long)];
+  lltoa(value, buf, base);
+  return addCopy(buf, strlen(buf));
+}
+
+StringBuilder &StringBuilder::add(unsigned long long value, unsigned char base) {
+  char buf[1 + 8 * sizeof(unsigned long long)];
+  ulltoa(value, buf, base);
+  return addCopy(buf, strlen(buf));
+}
+
+StringBuilder &StringBuilder::add(double value, unsigned int decimalPlaces) {
+  // Same output as String(double), without the temporary heap buffer for common values
+  char buf[64];
+  if (decimalPlaces < 16 && !(value > 1e30 || value < -1e30)) {
+    dtostrf(value, (decimalPlaces + 2), decimalPlaces, buf);
+    return addCopy(buf, strlen(buf));
+  }
+  return add(String(value, decimalPlaces));
+}
+
+bool StringBuilder::appendTo(String &dest) const {
+  if (!_valid) {
+    return false;
+  }
+  if (!dest.reserve(dest.length() + _length)) {
+    log_e("Unable to allocate %u bytes", dest.length() + _length);
+    return false;
+  }
+  for (const Fragment &f : _fragments) {
+    dest.concat(fragmentData(f), f.length);
+  }
+  return true;
+}
+
+String StringBuilder::toString() const {
+  String result;
+  if (!appendTo(result)) {
+    return String();
+  }
+  return result;
+}
+
+size_t StringBuilder::printTo(Print &p) const {
+  size_t n = 0;
+  for (const Fragment &f : _fragments) {
+    size_t written = p.write(reinterpret_cast<const uint8_t *>(fragmentData(f)), f.length);
+    n += written;
+    if (written != f.length) {
+      break;
+    }
+  }
+  return n;
+}
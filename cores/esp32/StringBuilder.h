@@ -0,0 +1,93 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <vector>
+#include <utility>
+#include "WString.h"
+#include "Printable.h"
+
+/*
+ * StringBuilder collects fragments and joins them once.
+ *
+ * C strings, flash strings and String lvalues are kept by reference and must
+ * stay alive and unchanged until the builder is materialized. Numbers,
+ * characters and String temporaries are copied into an internal buffer.
+ * toString() and appendTo() allocate the result exactly once; printTo() streams
+ * the fragments to any Print without building the joined string at all.
+ */
+class StringBuilder : public Printable {
+public:
+  StringBuilder(size_t fragments = 0);
+
+  // Reserves room for the given number of fragments and bytes of copied data
+  bool reserve(size_t fragments, size_t copiedBytes = 0);
+  void clear();
+
+  // Referenced fragments
+  StringBuilder &add(const char *str);
+  StringBuilder &add(const char *str, size_t length);
+  StringBuilder &add(const String &str);
+  StringBuilder &add(const __FlashStringHelper *str);
+
+  // Copied fragments
+  StringBuilder &add(String &&str);
+  StringBuilder &add(char c);
+  StringBuilder &add(int value, unsigned char base = 10);
+  StringBuilder &add(unsigned int value, unsigned char base = 10);
+  StringBuilder &add(long value, unsigned char base = 10);
+  StringBuilder &add(unsigned long value, unsigned char base = 10);
+  StringBuilder &add(long long value, unsigned char base = 10);
+  StringBuilder &add(unsigned long long value, unsigned char base = 10);
+  StringBuilder &add(double value, unsigned int decimalPlaces = 2);
+  StringBuilder &addCopy(const char *str, size_t length);
+
+  template<typename T> StringBuilder &operator<<(T &&value) {
+    return add(std::forward<T>(value));
+  }
+
+  // Total length of the joined string
+  size_t length() const {
+    return _length;
+  }
+  size_t fragments() const {
+    return _fragments.size();
+  }
+  // False if a fragment could not be stored
+  bool valid() const {
+    return _valid;
+  }
+
+  String toString() const;
+  bool appendTo(String &dest) const;
+  size_t printTo(Print &p) const override;
+
+private:
+  struct Fragment {
+    const char *data;  // nullptr when stored in _copied
+    size_t offset;
+    size_t length;
+  };
+
+  const char *fragmentData(const Fragment &f) const {
+    return f.data ? f.data : _copied.c_str() + f.offset;
+  }
+
+  std::vector<Fragment> _fragments;
+  String _copied;
+  size_t _length;
+  bool _valid;
+};
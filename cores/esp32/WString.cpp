@@ -818,20 +818,34 @@ void String::replace(const String &find, const String &replace) {
     if (size == len()) {
       return;
     }
+    if (this == &find || this == &replace) {
+      // the buffer below is moved, so work from stable copies
+      String findCopy(find), replaceCopy(replace);
+      this->replace(findCopy, replaceCopy);
+      return;
+    }
     if (size > capacity() && !changeBuffer(size)) {
       log_w("String.Replace() Insufficient space to replace string");
       return;
     }
-    int index = len() - 1;
-    while (index >= 0 && (index = lastIndexOf(find, index)) >= 0) {
-      readFrom = wbuffer() + index + find.len();
-      memmove(readFrom + diff, readFrom, len() - (readFrom - buffer()));
-      int newLen = len() + diff;
-      memmove(wbuffer() + index, replace.buffer(), replace.len());
-      setLen(newLen);
-      wbuffer()[newLen] = 0;
-      index--;
+    // Move the original text to the end of the buffer and rebuild it from
+    // the front in a single pass. The write position trails the read position
+    // by the growth still to come, so it never overtakes unread text.
+    unsigned int l = len();
+    unsigned int shift = size - l;
+    memmove(wbuffer() + shift, buffer(), l + 1);
+    readFrom = wbuffer() + shift;
+    char *writeTo = wbuffer();
+    while ((foundAt = strstr(readFrom, find.buffer())) != NULL) {
+      unsigned int n = foundAt - readFrom;
+      memmove(writeTo, readFrom, n);
+      writeTo += n;
+      memcpy(writeTo, replace.buffer(), replace.len());
+      writeTo += replace.len();
+      readFrom = foundAt + find.len();
     }
+    memmove(writeTo, readFrom, strlen(readFrom) + 1);
+    setLen(size);
   }
 }
 
@@ -23,12 +23,117 @@
  */
 
 #include "Arduino.h"
-extern "C" {
-#include "libb64/cdecode.h"
-#include "libb64/cencode.h"
-}
 #include "base64.h"
 
+static const char base64_alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Sextet value of every character, -1 for characters outside of the alphabet
+static const int8_t base64_values[256] = {
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1, -1, 63,
+  52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,
+  -1,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
+  15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1,
+  -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+  41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+};
+
+// Encodes groups of 3 bytes into 4 characters each
+static void base64_encode_groups(const uint8_t *in, size_t groups, char *out) {
+  while (groups--) {
+    uint32_t v = ((uint32_t)in[0] << 16) | ((uint32_t)in[1] << 8) | in[2];
+    out[0] = base64_alphabet[v >> 18];
+    out[1] = base64_alphabet[(v >> 12) & 0x3f];
+    out[2] = base64_alphabet[(v >> 6) & 0x3f];
+    out[3] = base64_alphabet[v & 0x3f];
+    in += 3;
+    out += 4;
+  }
+}
+
+// Encodes the last 1 or 2 bytes with padding
+static void base64_encode_tail(const uint8_t *in, size_t length, char *out) {
+  uint32_t v = (uint32_t)in[0] << 16;
+  if (length > 1) {
+    v |= (uint32_t)in[1] << 8;
+  }
+  out[0] = base64_alphabet[v >> 18];
+  out[1] = base64_alphabet[(v >> 12) & 0x3f];
+  out[2] = (length > 1) ? base64_alphabet[(v >> 6) & 0x3f] : '=';
+  out[3] = '=';
+}
+
+// Decodes length characters, carrying an incomplete group in bits/count.
+// out must have room for ((count + length) / 4) * 3 bytes.
+static size_t base64_decode_chars(const uint8_t *in, size_t length, uint32_t &bits, uint8_t &count, uint8_t *out) {
+  const uint8_t *end = in + length;
+  uint8_t *o = out;
+  uint32_t b = bits;
+  uint8_t c = count;
+  while (in < end) {
+    if (c == 0) {
+      // complete groups without padding or whitespace
+      while (end - in >= 4) {
+        int32_t v0 = base64_values[in[0]];
+        int32_t v1 = base64_values[in[1]];
+        int32_t v2 = base64_values[in[2]];
+        int32_t v3 = base64_values[in[3]];
+        if ((v0 | v1 | v2 | v3) < 0) {
+          break;
+        }
+        uint32_t v = (v0 << 18) | (v1 << 12) | (v2 << 6) | v3;
+        o[0] = v >> 16;
+        o[1] = v >> 8;
+        o[2] = v;
+        o += 3;
+        in += 4;
+      }
+      if (in == end) {
+        break;
+      }
+    }
+    int8_t v = base64_values[*in++];
+    if (v < 0) {
+      continue;
+    }
+    b = (b << 6) | v;
+    if (++c == 4) {
+      o[0] = b >> 16;
+      o[1] = b >> 8;
+      o[2] = b;
+      o += 3;
+      b = 0;
+      c = 0;
+    }
+  }
+  bits = b;
+  count = c;
+  return o - out;
+}
+
+// Writes the bytes of an incomplete final group, at most 2
+static size_t base64_decode_end(uint32_t bits, uint8_t count, uint8_t *out) {
+  if (count == 2) {
+    out[0] = bits >> 4;
+    return 1;
+  }
+  if (count == 3) {
+    out[0] = bits >> 10;
+    out[1] = bits >> 2;
+    return 2;
+  }
+  return 0;
+}
+
 /**
  * convert input data to base64
  * @param data const uint8_t *
@@ -36,19 +141,11 @@ extern "C" {
  * @return String
  */
 String base64::encode(const uint8_t *data, size_t length) {
-  size_t size = base64_encode_expected_len(length) + 1;
-  char *buffer = (char *)malloc(size);
-  if (buffer) {
-    base64_encodestate _state;
-    base64_init_encodestate(&_state);
-    int len = base64_encode_block((const char *)&data[0], length, &buffer[0], &_state);
-    len = base64_encode_blockend((buffer + len), &_state);
-
-    String base64 = String(buffer);
-    free(buffer);
-    return base64;
+  String base64;
+  if (!encode(data, length, base64)) {
+    return String("-FAIL-");
   }
-  return String("-FAIL-");
+  return base64;
 }
 
 /**
@@ -59,3 +156,298 @@ String base64::encode(const uint8_t *data, size_t length) {
 String base64::encode(const String &text) {
   return base64::encode((uint8_t *)text.c_str(), text.length());
 }
+
+/**
+ * convert input data to base64 into a caller buffer
+ * @param data const uint8_t *
+ * @param length size_t
+ * @param out char * receives the NUL terminated text
+ * @param outSize size_t
+ * @return size_t encoded length, 0 if out is too small
+ */
+size_t base64::encode(const uint8_t *data, size_t length, char *out, size_t outSize) {
+  size_t needed = encodedLength(length);
+  if (!out || outSize < needed + 1 || (!data && length)) {
+    return 0;
+  }
+  size_t groups = length / 3;
+  base64_encode_groups(data, groups, out);
+  if (length % 3) {
+    base64_encode_tail(data + groups * 3, length % 3, out + groups * 4);
+  }
+  out[needed] = 0;
+  return needed;
+}
+
+/**
+ * append base64 of input data to a String
+ * @param data const uint8_t *
+ * @param length size_t
+ * @param out String&
+ * @return bool false if memory could not be reserved
+ */
+bool base64::encode(const uint8_t *data, size_t length, String &out) {
+  if (!data && length) {
+    return false;
+  }
+  if (!out.reserve(out.length() + encodedLength(length))) {
+    log_e("Unable to reserve %u bytes", out.length() + encodedLength(length));
+    return false;
+  }
+  char chunk[BASE64_CHUNK_SIZE];
+  const size_t groupsPerChunk = BASE64_CHUNK_SIZE / 4;
+  size_t groups = length / 3;
+  while (groups) {
+    size_t n = (groups < groupsPerChunk) ? groups : groupsPerChunk;
+    base64_encode_groups(data, n, chunk);
+    out.concat(chunk, n * 4);
+    data += n * 3;
+    groups -= n;
+  }
+  if (length % 3) {
+    base64_encode_tail(data, length % 3, chunk);
+    out.concat(chunk, 4);
+  }
+  return true;
+}
+
+/**
+ * write base64 of input data to a Print
+ * @param data const uint8_t *
+ * @param length size_t
+ * @param out Print&
+ * @return size_t number of characters written
+ */
+size_t base64::encode(const uint8_t *data, size_t length, Print &out) {
+  Encoder encoder(out);
+  encoder.write(data, length);
+  return encoder.end();
+}
+
+/**
+ * write base64 of up to length bytes read from a Stream to a Print
+ * @param in Stream&
+ * @param out Print&
+ * @param length size_t
+ * @return size_t number of characters written
+ */
+size_t base64::encode(Stream &in, Print &out, size_t length) {
+  Encoder encoder(out);
+  uint8_t buf[(BASE64_CHUNK_SIZE / 4) * 3];
+  while (length) {
+    size_t n = in.readBytes(buf, (length < sizeof(buf)) ? length : sizeof(buf));
+    if (!n) {
+      break;
+    }
+    if (encoder.write(buf, n) != n) {
+      break;
+    }
+    length -= n;
+  }
+  return encoder.end();
+}
+
+/**
+ * decode base64 text into a caller buffer
+ * @param data const char *
+ * @param length size_t
+ * @param out uint8_t *
+ * @param outSize size_t
+ * @return int decoded length, -1 if out is too small
+ */
+int base64::decode(const char *data, size_t length, uint8_t *out, size_t outSize) {
+  if (!data || !out) {
+    return -1;
+  }
+  const uint8_t *in = (const uint8_t *)data;
+  if (outSize < decodedLength(length)) {
+    // padding and whitespace may still make it fit
+    size_t valid = 0;
+    for (size_t i = 0; i < length; i++) {
+      valid += base64_values[in[i]] >= 0;
+    }
+    if (outSize < decodedLength(valid)) {
+      return -1;
+    }
+  }
+  uint32_t bits = 0;
+  uint8_t count = 0;
+  size_t len = base64_decode_chars(in, length, bits, count, out);
+  return len + base64_decode_end(bits, count, out + len);
+}
+
+/**
+ * decode base64 text into a String
+ * @param text const String&
+ * @return String, empty if memory could not be allocated
+ */
+String base64::decode(const String &text) {
+  String decoded;
+  if (!decoded.reserve(decodedLength(text.length()))) {
+    log_e("Unable to reserve %u bytes", decodedLength(text.length()));
+    return decoded;
+  }
+  uint8_t chunk[BASE64_CHUNK_SIZE];
+  const size_t charsPerChunk = ((BASE64_CHUNK_SIZE / 3) * 4);
+  const uint8_t *in = (const uint8_t *)text.c_str();
+  size_t length = text.length();
+  uint32_t bits = 0;
+  uint8_t count = 0;
+  while (length) {
+    // leave room for the group carried over from the previous chunk
+    size_t n = (length < charsPerChunk - count) ? length : charsPerChunk - count;
+    decoded.concat((const char *)chunk, base64_decode_chars(in, n, bits, count, chunk));
+    in += n;
+    length -= n;
+  }
+  decoded.concat((const char *)chunk, base64_decode_end(bits, count, chunk));
+  return decoded;
+}
+
+/**
+ * write decoded base64 text to a Print
+ * @param data const char *
+ * @param length size_t
+ * @param out Print&
+ * @return size_t number of bytes written
+ */
+size_t base64::decode(const char *data, size_t length, Print &out) {
+  Decoder decoder(out);
+  decoder.write((const uint8_t *)data, length);
+  return decoder.end();
+}
+
+base64::Encoder::Encoder(Print &out) : _out(out), _pendingLen(0), _chunkLen(0), _encoded(0) {}
+
+bool base64::Encoder::flushChunk() {
+  if (!_chunkLen) {
+    return true;
+  }
+  size_t written = _out.write((const uint8_t *)_chunk, _chunkLen);
+  _encoded += written;
+  bool ok = (written == _chunkLen);
+  _chunkLen = 0;
+  return ok;
+}
+
+size_t base64::Encoder::write(uint8_t c) {
+  return write(&c, 1);
+}
+
+size_t base64::Encoder::write(const uint8_t *buffer, size_t size) {
+  if (!buffer) {
+    return 0;
+  }
+  size_t consumed = 0;
+  // complete the group left over from the previous write
+  while (_pendingLen && consumed < size) {
+    _pending[_pendingLen++] = buffer[consumed++];
+    if (_pendingLen == 3) {
+      if (_chunkLen + 4 > sizeof(_chunk) && !flushChunk()) {
+        return consumed;
+      }
+      base64_encode_groups(_pending, 1, _chunk + _chunkLen);
+      _chunkLen += 4;
+      _pendingLen = 0;
+    }
+  }
+  while (size - consumed >= 3) {
+    size_t room = (sizeof(_chunk) - _chunkLen) / 4;
+    if (!room) {
+      if (!flushChunk()) {
+        return consumed;
+      }
+      continue;
+    }
+    size_t groups = (size - consumed) / 3;
+    if (groups > room) {
+      groups = room;
+    }
+    base64_encode_groups(buffer + consumed, groups, _chunk + _chunkLen);
+    _chunkLen += groups * 4;
+    consumed += groups * 3;
+  }
+  while (consumed < size) {
+    _pending[_pendingLen++] = buffer[consumed++];
+  }
+  return consumed;
+}
+
+void base64::Encoder::flush() {
+  flushChunk();
+  _out.flush();
+}
+
+size_t base64::Encoder::end() {
+  if (_pendingLen) {
+    if (_chunkLen + 4 > sizeof(_chunk)) {
+      flushChunk();
+    }
+    base64_encode_tail(_pending, _pendingLen, _chunk + _chunkLen);
+    _chunkLen += 4;
+    _pendingLen = 0;
+  }
+  flushChunk();
+  size_t encoded = _encoded;
+  _encoded = 0;
+  return encoded;
+}
+
+base64::Decoder::Decoder(Print &out) : _out(out), _bits(0), _count(0), _chunkLen(0), _decoded(0) {}
+
+bool base64::Decoder::flushChunk() {
+  if (!_chunkLen) {
+    return true;
+  }
+  size_t written = _out.write(_chunk, _chunkLen);
+  _decoded += written;
+  bool ok = (written == _chunkLen);
+  _chunkLen = 0;
+  return ok;
+}
+
+size_t base64::Decoder::write(uint8_t c) {
+  return write(&c, 1);
+}
+
+size_t base64::Decoder::write(const uint8_t *buffer, size_t size) {
+  if (!buffer) {
+    return 0;
+  }
+  size_t consumed = 0;
+  while (consumed < size) {
+    size_t room = (sizeof(_chunk) - _chunkLen) / 3;
+    if (!room) {
+      if (!flushChunk()) {
+        return consumed;
+      }
+      continue;
+    }
+    // characters that decode into at most room groups
+    size_t n = room * 4 - _count;
+    if (n > size - consumed) {
+      n = size - consumed;
+    }
+    _chunkLen += base64_decode_chars(buffer + consumed, n, _bits, _count, _chunk + _chunkLen);
+    consumed += n;
+  }
+  return consumed;
+}
+
+void base64::Decoder::flush() {
+  flushChunk();
+  _out.flush();
+}
+
+size_t base64::Decoder::end() {
+  if (_chunkLen + 2 > sizeof(_chunk)) {
+    flushChunk();
+  }
+  _chunkLen += base64_decode_end(_bits, _count, _chunk + _chunkLen);
+  _bits = 0;
+  _count = 0;
+  flushChunk();
+  size_t decoded = _decoded;
+  _decoded = 0;
+  return decoded;
+}
@@ -1,11 +1,101 @@
 #ifndef CORE_BASE64_H_
 #define CORE_BASE64_H_
 
+#include <stdint.h>
+#include "WString.h"
+#include "Print.h"
+#include "Stream.h"
+
+// Size of the stack buffer used when streaming to a Print (multiple of 4)
+#ifndef BASE64_CHUNK_SIZE
+#define BASE64_CHUNK_SIZE 128
+#endif
+
 class base64 {
 public:
   static String encode(const uint8_t *data, size_t length);
   static String encode(const String &text);
 
+  // Encoded length of length bytes, without the terminating NUL
+  static size_t encodedLength(size_t length) {
+    return ((length + 2) / 3) * 4;
+  }
+  // Largest decoded size of length base64 characters
+  static size_t decodedLength(size_t length) {
+    return (length / 4) * 3 + ((length % 4) * 3) / 4;
+  }
+
+  // Encodes into out and terminates it with NUL.
+  // Returns the encoded length or 0 if out cannot hold encodedLength(length) + 1 characters
+  static size_t encode(const uint8_t *data, size_t length, char *out, size_t outSize);
+  // Appends the encoded text to out, allocating once
+  static bool encode(const uint8_t *data, size_t length, String &out);
+  // Writes the encoded text to out in chunks. Returns the number of characters written
+  static size_t encode(const uint8_t *data, size_t length, Print &out);
+  // Encodes up to length bytes read from in. Returns the number of characters written
+  static size_t encode(Stream &in, Print &out, size_t length = SIZE_MAX);
+
+  // Characters outside of the base64 alphabet (padding, whitespace) are skipped.
+  // Returns the decoded length or -1 if out is too small
+  static int decode(const char *data, size_t length, uint8_t *out, size_t outSize);
+  static String decode(const String &text);
+  // Writes the decoded bytes to out in chunks. Returns the number of bytes written
+  static size_t decode(const char *data, size_t length, Print &out);
+
+  // Print that base64 encodes everything written to it and forwards the text to out.
+  // end() writes the final group with padding and returns the number of characters written.
+  class Encoder : public Print {
+  public:
+    Encoder(Print &out);
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+    void flush() override;
+    size_t end();
+
+    // Number of encoded characters forwarded so far
+    size_t encoded() const {
+      return _encoded;
+    }
+
+  private:
+    bool flushChunk();
+
+    Print &_out;
+    uint8_t _pending[3];
+    uint8_t _pendingLen;
+    size_t _chunkLen;
+    size_t _encoded;
+    char _chunk[BASE64_CHUNK_SIZE];
+  };
+
+  // Print that decodes base64 text written to it and forwards the bytes to out.
+  // end() writes the last partial group and returns the number of bytes written.
+  class Decoder : public Print {
+  public:
+    Decoder(Print &out);
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+    void flush() override;
+    size_t end();
+
+    // Number of decoded bytes forwarded so far
+    size_t decoded() const {
+      return _decoded;
+    }
+
+  private:
+    bool flushChunk();
+
+    Print &_out;
+    uint32_t _bits;
+    uint8_t _count;
+    size_t _chunkLen;
+    size_t _decoded;
+    uint8_t _chunk[BASE64_CHUNK_SIZE];
+  };
+
 private:
 };
 
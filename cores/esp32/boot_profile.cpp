@@ -0,0 +1,72 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "boot_profile.h"
+#include <string.h>
+#include "esp_timer.h"
+#include "esp_sleep.h"
+#include "freertos/FreeRTOS.h"
+#include "esp32-hal.h"
+
+static boot_phase_t boot_phases[BOOT_PROFILE_MAX_PHASES];
+static size_t boot_phase_count = 0;
+static portMUX_TYPE boot_mux = portMUX_INITIALIZER_UNLOCKED;
+
+void bootProfileMark(const char *name) {
+  uint32_t now = (uint32_t)esp_timer_get_time();
+  portENTER_CRITICAL(&boot_mux);
+  if (boot_phase_count < BOOT_PROFILE_MAX_PHASES) {
+    boot_phase_t &phase = boot_phases[boot_phase_count];
+    phase.name = name;
+    phase.end_us = now;
+    phase.duration_us = now - (boot_phase_count ? boot_phases[boot_phase_count - 1].end_us : 0);
+    boot_phase_count++;
+  }
+  portEXIT_CRITICAL(&boot_mux);
+}
+
+size_t bootProfileCount(void) {
+  return boot_phase_count;
+}
+
+bool bootProfileGet(size_t index, boot_phase_t *phase) {
+  if (phase == NULL || index >= boot_phase_count) {
+    return false;
+  }
+  portENTER_CRITICAL(&boot_mux);
+  *phase = boot_phases[index];
+  portEXIT_CRITICAL(&boot_mux);
+  return true;
+}
+
+uint32_t bootProfileTime(const char *name) {
+  for (size_t i = 0; i < boot_phase_count; i++) {
+    if (boot_phases[i].name && name && strcmp(boot_phases[i].name, name) == 0) {
+      return boot_phases[i].end_us;
+    }
+  }
+  return 0;
+}
+
+bool bootProfileIsWake(void) {
+  return esp_sleep_get_wakeup_cause() != ESP_SLEEP_WAKEUP_UNDEFINED;
+}
+
+void printBootProfile(Print &printer) {
+  printer.printf("Boot profile (%s boot, NVS %s):\n", bootProfileIsWake() ? "wake" : "cold", deferNvsInit() ? "deferred" : "at boot");
+  boot_phase_t phase;
+  for (size_t i = 0; bootProfileGet(i, &phase); i++) {
+    printer.printf("  %-16s %8lu us  +%lu us\n", phase.name ? phase.name : "?", phase.end_us, phase.duration_us);
+  }
+}
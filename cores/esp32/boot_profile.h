@@ -0,0 +1,58 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Boot phase profiler
+ *
+ * The core marks the end of every step from app_main() to the return of setup().
+ * Times are taken from esp_timer, so they start when the application starts and do not
+ * include the ROM and second stage bootloaders. Sketches can add their own marks.
+ */
+#ifndef BOOT_PROFILE_MAX_PHASES
+#define BOOT_PROFILE_MAX_PHASES 24
+#endif
+
+typedef struct {
+  const char *name;
+  uint32_t end_us;       // esp_timer time at the end of the phase
+  uint32_t duration_us;  // time since the previous mark
+} boot_phase_t;
+
+// Records the end of a phase, name is not copied. Marks past BOOT_PROFILE_MAX_PHASES are dropped
+void bootProfileMark(const char *name);
+size_t bootProfileCount(void);
+bool bootProfileGet(size_t index, boot_phase_t *phase);
+// end_us of the phase called name, 0 if it was not marked
+uint32_t bootProfileTime(const char *name);
+// true if this boot is a wake up from deep sleep
+bool bootProfileIsWake(void);
+
+#ifdef __cplusplus
+}
+
+#include "Print.h"
+
+void printBootProfile(Print &printer);
+
+#endif
@@ -71,6 +71,7 @@ bool btStartMode(bt_mode mode) {
   }
   esp_err_t ret;
   if (esp_bt_controller_get_status() == ESP_BT_CONTROLLER_STATUS_IDLE) {
+    initNvs();  // the controller keeps its PHY calibration in NVS
     if ((ret = esp_bt_controller_init(&cfg)) != ESP_OK) {
       log_e("initialize controller failed: %s", esp_err_to_name(ret));
       return false;
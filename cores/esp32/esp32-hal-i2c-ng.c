@@ -23,8 +23,10 @@
 #include "freertos/task.h"
 #include "freertos/semphr.h"
 #endif
+#include "freertos/queue.h"
 #include "esp_attr.h"
 #include "esp_system.h"
+#include "esp_timer.h"
 #include "soc/soc_caps.h"
 #include "driver/i2c_master.h"
 #include "esp32-hal-periman.h"
@@ -43,6 +45,36 @@ typedef volatile struct {
 
 static i2c_bus_t bus[SOC_I2C_NUM];
 
+typedef struct {
+  const uint8_t *wbuff;  // NULL when the data is in wdata
+  uint8_t wdata[I2C_ASYNC_INLINE_WRITE];
+  size_t wsize;
+  uint8_t *rbuff;
+  size_t rsize;
+  uint16_t address;
+  uint32_t timeout;
+  i2c_transaction_cb_t cb;
+  void *arg;
+  int64_t queued_us;
+} i2c_async_item_t;
+
+typedef struct {
+  QueueHandle_t queue;
+  TaskHandle_t task;
+  SemaphoreHandle_t idle;     // given when the last pending transaction completes
+  SemaphoreHandle_t stopped;  // given by the worker before it exits
+  portMUX_TYPE mux;
+  uint32_t pending;
+  i2c_async_stats_t stats;
+  uint64_t latency_total_us;
+  int64_t since_us;
+  uint8_t i2c_num;
+} i2c_async_t;
+
+#define I2C_ASYNC_STOP 0xFFFF  // address of the item that stops the worker
+
+static i2c_async_t *async_bus[SOC_I2C_NUM];
+
 static bool i2cDetachBus(void *bus_i2c_num) {
   uint8_t i2c_num = (int)bus_i2c_num - 1;
   if (!bus[i2c_num].initialized) {
@@ -169,6 +201,10 @@ esp_err_t i2cDeinit(uint8_t i2c_num) {
   if (i2c_num >= SOC_I2C_NUM) {
     return ESP_ERR_INVALID_ARG;
   }
+  // queued transactions are executed before the bus goes away
+  if (i2cAsyncEnd(i2c_num) != ESP_OK) {
+    return ESP_ERR_INVALID_STATE;
+  }
 #if !CONFIG_DISABLE_HAL_LOCKS
   //acquire lock
   if (bus[i2c_num].lock == NULL || xSemaphoreTake(bus[i2c_num].lock, portMAX_DELAY) != pdTRUE) {
@@ -448,5 +484,286 @@ esp_err_t i2cGetClock(uint8_t i2c_num, uint32_t *frequency) {
   return ESP_OK;
 }
 
+static void i2cAsyncTask(void *arg) {
+  i2c_async_t *async = (i2c_async_t *)arg;
+  i2c_async_item_t item;
+  uint8_t i2c_num = async->i2c_num;
+
+  while (xQueueReceive(async->queue, &item, portMAX_DELAY) == pdTRUE) {
+    if (item.address == I2C_ASYNC_STOP) {
+      break;
+    }
+    const uint8_t *wbuff = (item.wbuff != NULL) ? item.wbuff : item.wdata;
+    size_t count = 0;
+    esp_err_t err;
+    int64_t start = esp_timer_get_time();
+    if (item.rsize == 0) {
+      err = i2cWrite(i2c_num, item.address, wbuff, item.wsize, item.timeout);
+    } else if (item.wsize == 0) {
+      err = i2cRead(i2c_num, item.address, item.rbuff, item.rsize, item.timeout, &count);
+    } else {
+      err = i2cWriteReadNonStop(i2c_num, item.address, wbuff, item.wsize, item.rbuff, item.rsize, item.timeout, &count);
+    }
+    int64_t end = esp_timer_get_time();
+    uint32_t bus_us = (uint32_t)(end - start);
+    uint32_t latency_us = (uint32_t)(end - item.queued_us);
+
+    portENTER_CRITICAL(&async->mux);
+    if (err == ESP_OK) {
+      async->stats.completed++;
+    } else {
+      async->stats.failed++;
+    }
+    async->stats.busy_us += bus_us;
+    if (bus_us > async->stats.bus_max_us) {
+      async->stats.bus_max_us = bus_us;
+    }
+    async->latency_total_us += latency_us;
+    if (async->stats.latency_min_us == 0 || latency_us < async->stats.latency_min_us) {
+      async->stats.latency_min_us = latency_us;
+    }
+    if (latency_us > async->stats.latency_max_us) {
+      async->stats.latency_max_us = latency_us;
+    }
+    portEXIT_CRITICAL(&async->mux);
+
+    if (item.cb != NULL) {
+      item.cb(i2c_num, item.address, err, item.rbuff, count, item.arg);
+    }
+
+    portENTER_CRITICAL(&async->mux);
+    bool idle = (--async->pending == 0);
+    portEXIT_CRITICAL(&async->mux);
+    if (idle) {
+      xSemaphoreGive(async->idle);
+    }
+  }
+  xSemaphoreGive(async->stopped);
+  vTaskDelete(NULL);
+}
+
+// Waiting for the worker from one of its own callbacks would never return
+static bool i2cAsyncInWorker(i2c_async_t *async) {
+  if (xTaskGetCurrentTaskHandle() == async->task) {
+    log_e("can not be called from a transaction callback");
+    return true;
+  }
+  return false;
+}
+
+esp_err_t i2cAsyncBegin(uint8_t i2c_num, size_t queue_depth, uint32_t stack_size, uint8_t priority, int core) {
+  if (i2c_num >= SOC_I2C_NUM || queue_depth == 0) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (async_bus[i2c_num] != NULL) {
+    return ESP_OK;
+  }
+  if (!bus[i2c_num].initialized) {
+    log_e("bus is not initialized");
+    return ESP_FAIL;
+  }
+  i2c_async_t *async = (i2c_async_t *)calloc(1, sizeof(i2c_async_t));
+  if (async == NULL) {
+    log_e("Failed to allocate async context");
+    return ESP_ERR_NO_MEM;
+  }
+  async->i2c_num = i2c_num;
+  portMUX_INITIALIZE(&async->mux);
+  async->since_us = esp_timer_get_time();
+  async->queue = xQueueCreate(queue_depth, sizeof(i2c_async_item_t));
+  async->idle = xSemaphoreCreateBinary();
+  async->stopped = xSemaphoreCreateBinary();
+  if (async->queue == NULL || async->idle == NULL || async->stopped == NULL) {
+    log_e("Failed to create async queue");
+    goto fail;
+  }
+  if (xTaskCreateUniversal(i2cAsyncTask, "i2c_async", stack_size, async, priority, &async->task, core) != pdPASS) {
+    log_e("Failed to create async task");
+    goto fail;
+  }
+  async_bus[i2c_num] = async;
+  log_v("Async transactions started: bus=%u depth=%u", i2c_num, queue_depth);
+  return ESP_OK;
+
+fail:
+  if (async->queue != NULL) {
+    vQueueDelete(async->queue);
+  }
+  if (async->idle != NULL) {
+    vSemaphoreDelete(async->idle);
+  }
+  if (async->stopped != NULL) {
+    vSemaphoreDelete(async->stopped);
+  }
+  free(async);
+  return ESP_ERR_NO_MEM;
+}
+
+esp_err_t i2cAsyncEnd(uint8_t i2c_num) {
+  if (i2c_num >= SOC_I2C_NUM) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  i2c_async_t *async = async_bus[i2c_num];
+  if (async == NULL) {
+    return ESP_OK;
+  }
+  if (i2cAsyncInWorker(async)) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  // the worker finishes everything queued before the stop item
+  i2c_async_item_t stop;
+  memset(&stop, 0, sizeof(stop));
+  stop.address = I2C_ASYNC_STOP;
+  xQueueSend(async->queue, &stop, portMAX_DELAY);
+  xSemaphoreTake(async->stopped, portMAX_DELAY);
+  async_bus[i2c_num] = NULL;
+  vQueueDelete(async->queue);
+  vSemaphoreDelete(async->idle);
+  vSemaphoreDelete(async->stopped);
+  free(async);
+  return ESP_OK;
+}
+
+bool i2cAsyncIsActive(uint8_t i2c_num) {
+  if (i2c_num >= SOC_I2C_NUM) {
+    return false;
+  }
+  return async_bus[i2c_num] != NULL;
+}
+
+esp_err_t i2cQueueWriteRead(
+  uint8_t i2c_num, uint16_t address, const uint8_t *wbuff, size_t wsize, uint8_t *rbuff, size_t rsize, uint32_t timeOutMillis, i2c_transaction_cb_t cb,
+  void *arg
+) {
+  if (i2c_num >= SOC_I2C_NUM) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (address >= 128) {
+    log_e("Only 7bit I2C addresses are supported");
+    return ESP_ERR_INVALID_ARG;
+  }
+  if ((wsize && wbuff == NULL) || (rsize && rbuff == NULL)) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  i2c_async_t *async = async_bus[i2c_num];
+  if (async == NULL) {
+    log_e("async transactions are not started");
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  i2c_async_item_t item;
+  item.wsize = wsize;
+  if (wsize <= I2C_ASYNC_INLINE_WRITE) {
+    item.wbuff = NULL;
+    if (wsize) {
+      memcpy(item.wdata, wbuff, wsize);
+    }
+  } else {
+    item.wbuff = wbuff;
+  }
+  item.rbuff = rbuff;
+  item.rsize = rsize;
+  item.address = address;
+  item.timeout = timeOutMillis;
+  item.cb = cb;
+  item.arg = arg;
+  item.queued_us = esp_timer_get_time();
+
+  portENTER_CRITICAL(&async->mux);
+  uint32_t pending = ++async->pending;
+  portEXIT_CRITICAL(&async->mux);
+
+  if (xQueueSend(async->queue, &item, 0) != pdTRUE) {
+    portENTER_CRITICAL(&async->mux);
+    async->pending--;
+    async->stats.rejected++;
+    portEXIT_CRITICAL(&async->mux);
+    log_v("async queue is full: bus=%u addr=0x%x", i2c_num, address);
+    return ESP_ERR_TIMEOUT;
+  }
+
+  portENTER_CRITICAL(&async->mux);
+  async->stats.queued++;
+  if (pending > async->stats.queue_high_water) {
+    async->stats.queue_high_water = pending;
+  }
+  portEXIT_CRITICAL(&async->mux);
+  return ESP_OK;
+}
+
+esp_err_t i2cAsyncWait(uint8_t i2c_num, uint32_t timeOutMillis) {
+  if (i2c_num >= SOC_I2C_NUM) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  i2c_async_t *async = async_bus[i2c_num];
+  if (async == NULL) {
+    return ESP_OK;
+  }
+  if (i2cAsyncInWorker(async)) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  TickType_t start = xTaskGetTickCount();
+  TickType_t timeout = (timeOutMillis == UINT32_MAX) ? portMAX_DELAY : pdMS_TO_TICKS(timeOutMillis);
+  while (i2cAsyncPending(i2c_num)) {
+    TickType_t wait = portMAX_DELAY;
+    if (timeout != portMAX_DELAY) {
+      TickType_t waited = xTaskGetTickCount() - start;
+      if (waited >= timeout) {
+        return ESP_ERR_TIMEOUT;
+      }
+      wait = timeout - waited;
+    }
+    // a give from an earlier idle period only causes another check
+    if (xSemaphoreTake(async->idle, wait) != pdTRUE) {
+      return ESP_ERR_TIMEOUT;
+    }
+  }
+  return ESP_OK;
+}
+
+size_t i2cAsyncPending(uint8_t i2c_num) {
+  if (i2c_num >= SOC_I2C_NUM || async_bus[i2c_num] == NULL) {
+    return 0;
+  }
+  i2c_async_t *async = async_bus[i2c_num];
+  portENTER_CRITICAL(&async->mux);
+  size_t pending = async->pending;
+  portEXIT_CRITICAL(&async->mux);
+  return pending;
+}
+
+esp_err_t i2cAsyncGetStats(uint8_t i2c_num, i2c_async_stats_t *stats) {
+  if (i2c_num >= SOC_I2C_NUM || stats == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  i2c_async_t *async = async_bus[i2c_num];
+  if (async == NULL) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  portENTER_CRITICAL(&async->mux);
+  *stats = async->stats;
+  uint64_t latency_total_us = async->latency_total_us;
+  int64_t since_us = async->since_us;
+  portEXIT_CRITICAL(&async->mux);
+
+  uint32_t done = stats->completed + stats->failed;
+  stats->latency_avg_us = done ? (uint32_t)(latency_total_us / done) : 0;
+  stats->elapsed_us = esp_timer_get_time() - since_us;
+  stats->utilization = stats->elapsed_us ? (float)stats->busy_us / stats->elapsed_us : 0;
+  return ESP_OK;
+}
+
+void i2cAsyncResetStats(uint8_t i2c_num) {
+  if (i2c_num >= SOC_I2C_NUM || async_bus[i2c_num] == NULL) {
+    return;
+  }
+  i2c_async_t *async = async_bus[i2c_num];
+  portENTER_CRITICAL(&async->mux);
+  memset(&async->stats, 0, sizeof(async->stats));
+  async->latency_total_us = 0;
+  async->since_us = esp_timer_get_time();
+  portEXIT_CRITICAL(&async->mux);
+}
+
 #endif /* ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 4, 0) */
 #endif /* SOC_I2C_SUPPORTED */
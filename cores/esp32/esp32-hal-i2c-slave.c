@@ -102,8 +102,28 @@ typedef struct i2c_slave_struct_t {
 #else
   RingbufHandle_t rx_ring_buf;
 #endif
-  QueueHandle_t tx_queue;
   uint32_t rx_data_count;
+  uint8_t *rx_buf;  // handed to receive_callback, avoids an allocation per transaction
+  size_t rx_size;
+  // bytes that did not fit in the TX FIFO, copied to the FIFO in bulk by the ISR
+  uint8_t *tx_buf;
+  size_t tx_size;
+  size_t tx_len;
+  size_t tx_pos;  // next byte of tx_buf, or of the register map while reg_reading >= 0
+  // register map: the ISR answers master reads from reg_map[reg_front] at reg_addr
+  uint8_t *reg_map[2];
+  size_t reg_map_size;
+  uint8_t reg_front;
+  int8_t reg_reading;  // map the ISR is sending from, -1 when idle
+  bool reg_sync;       // the back map has to be refreshed from the front map
+  uint8_t reg_addr;
+#if CONFIG_IDF_TARGET_ESP32
+  // TX FIFO space and tx_pos right after a preload, a master read changes at least one of them
+  uint32_t reg_loaded_space;
+  size_t reg_loaded_pos;
+#endif
+  i2c_slave_stats_t stats;
+  portMUX_TYPE spinlock;
 #if !CONFIG_DISABLE_HAL_LOCKS
   SemaphoreHandle_t lock;
 #endif
@@ -119,19 +139,9 @@ typedef union {
 } i2c_slave_queue_event_t;
 
 static i2c_slave_struct_t _i2c_bus_array[SOC_HP_I2C_NUM] = {
-  {&I2C0, 0, -1, -1, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, 0
-#if !CONFIG_DISABLE_HAL_LOCKS
-   ,
-   NULL
-#endif
-  },
+  {.dev = &I2C0, .num = 0, .sda = -1, .scl = -1, .reg_reading = -1, .spinlock = portMUX_INITIALIZER_UNLOCKED},
 #if SOC_HP_I2C_NUM > 1
-  {&I2C1, 1, -1, -1, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, 0
-#if !CONFIG_DISABLE_HAL_LOCKS
-   ,
-   NULL
-#endif
-  }
+  {.dev = &I2C1, .num = 1, .sda = -1, .scl = -1, .reg_reading = -1, .spinlock = portMUX_INITIALIZER_UNLOCKED},
 #endif
 };
 
@@ -217,7 +227,13 @@ static bool i2c_slave_attach_gpio(i2c_slave_struct_t *i2c, int8_t sda, int8_t sc
 static bool i2c_slave_detach_gpio(i2c_slave_struct_t *i2c);
 static bool i2c_slave_set_frequency(i2c_slave_struct_t *i2c, uint32_t clk_speed);
 static bool i2c_slave_send_event(i2c_slave_struct_t *i2c, i2c_slave_queue_event_t *event);
-static bool i2c_slave_handle_tx_fifo_empty(i2c_slave_struct_t *i2c);
+static bool i2c_slave_fill_tx_fifo(i2c_slave_struct_t *i2c, size_t *written);
+static void i2c_slave_handle_tx_fifo_empty(i2c_slave_struct_t *i2c, bool stretched);
+static void i2c_slave_load_reg_map(i2c_slave_struct_t *i2c);
+#if CONFIG_IDF_TARGET_ESP32
+static bool i2c_slave_preload_reg_map_locked(i2c_slave_struct_t *i2c);
+#endif
+static esp_err_t i2c_slave_sync_reg_map(i2c_slave_struct_t *i2c, uint32_t timeout_ms);
 static bool i2c_slave_handle_rx_fifo_full(i2c_slave_struct_t *i2c, uint32_t len);
 static size_t i2c_slave_read_rx(i2c_slave_struct_t *i2c, uint8_t *data, size_t len);
 static void i2c_slave_isr_handler(void *arg);
@@ -300,12 +316,21 @@ esp_err_t i2cSlaveInit(uint8_t num, int sda, int scl, uint16_t slaveID, uint32_t
   }
 #endif
 
-  i2c->tx_queue = xQueueCreate(tx_len, sizeof(uint8_t));
-  if (i2c->tx_queue == NULL) {
-    log_e("TX queue create failed");
+  i2c->rx_buf = (uint8_t *)malloc(rx_len);
+  if (i2c->rx_buf == NULL) {
+    log_e("RX buffer alloc failed");
+    ret = ESP_ERR_NO_MEM;
+    goto fail;
+  }
+  i2c->rx_size = rx_len;
+
+  i2c->tx_buf = (uint8_t *)malloc(tx_len);
+  if (i2c->tx_buf == NULL) {
+    log_e("TX buffer alloc failed");
     ret = ESP_ERR_NO_MEM;
     goto fail;
   }
+  i2c->tx_size = tx_len;
 
   i2c->event_queue = xQueueCreate(16, sizeof(i2c_slave_queue_event_t));
   if (i2c->event_queue == NULL) {
@@ -440,7 +465,7 @@ size_t i2cSlaveWrite(uint8_t num, const uint8_t *buf, uint32_t len, uint32_t tim
     log_e("Invalid port num: %u", num);
     return 0;
   }
-  uint32_t to_queue = 0, to_fifo = 0;
+  uint32_t to_buf = 0, to_fifo = 0;
   i2c_slave_struct_t *i2c = &_i2c_bus_array[num];
 #if !CONFIG_DISABLE_HAL_LOCKS
   if (!i2c->lock) {
@@ -448,9 +473,10 @@ size_t i2cSlaveWrite(uint8_t num, const uint8_t *buf, uint32_t len, uint32_t tim
     return ESP_ERR_NO_MEM;
   }
 #endif
-  if (!i2c->tx_queue) {
+  if (!i2c->tx_buf) {
     return 0;
   }
+  (void)timeout_ms;  // the buffer never blocks, it is replaced by every write
   I2C_SLAVE_MUTEX_LOCK();
 #if CONFIG_IDF_TARGET_ESP32
   i2c_ll_slave_disable_tx_it(i2c->dev);
@@ -465,32 +491,173 @@ size_t i2cSlaveWrite(uint8_t num, const uint8_t *buf, uint32_t len, uint32_t tim
     if (len < to_fifo) {
       to_fifo = len;
     }
+    //drop what is left of the previous write
+    portENTER_CRITICAL(&i2c->spinlock);
+    i2c->tx_len = 0;
+    i2c->tx_pos = 0;
+    i2c->stats.tx_bytes += to_fifo;
+    portEXIT_CRITICAL(&i2c->spinlock);
     i2c_ll_write_txfifo(i2c->dev, (uint8_t *)buf, to_fifo);
     buf += to_fifo;
     len -= to_fifo;
-    //reset tx_queue
-    xQueueReset(i2c->tx_queue);
-    //write the rest of the bytes to the queue
+    //the ISR moves the rest to the FIFO as it drains
     if (len) {
-      to_queue = uxQueueSpacesAvailable(i2c->tx_queue);
-      if (len < to_queue) {
-        to_queue = len;
-      }
-      for (size_t i = 0; i < to_queue; i++) {
-        if (xQueueSend(i2c->tx_queue, &buf[i], timeout_ms / portTICK_PERIOD_MS) != pdTRUE) {
-          xQueueReset(i2c->tx_queue);
-          to_queue = 0;
-          break;
-        }
-      }
-      //no need to enable TX_EMPTY if tx_queue is empty
-      if (to_queue) {
-        i2c_ll_slave_enable_tx_it(i2c->dev);
-      }
+      to_buf = (len < i2c->tx_size) ? len : i2c->tx_size;
+      memcpy(i2c->tx_buf, buf, to_buf);
+      portENTER_CRITICAL(&i2c->spinlock);
+      i2c->tx_len = to_buf;
+      portEXIT_CRITICAL(&i2c->spinlock);
+      i2c_ll_slave_enable_tx_it(i2c->dev);
+    }
+  }
+  I2C_SLAVE_MUTEX_UNLOCK();
+  return to_buf + to_fifo;
+}
+
+esp_err_t i2cSlaveSetRegisterMap(uint8_t num, size_t size) {
+  if (num >= SOC_HP_I2C_NUM) {
+    log_e("Invalid port num: %u", num);
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (size > 256) {
+    log_e("Register map of %u bytes does not fit 8 bit register addresses", size);
+    return ESP_ERR_INVALID_ARG;
+  }
+  i2c_slave_struct_t *i2c = &_i2c_bus_array[num];
+  if (!i2c->tx_buf) {
+    log_e("I2C Slave is not initialized");
+    return ESP_ERR_INVALID_STATE;
+  }
+  uint8_t *map = NULL;
+  if (size) {
+    map = (uint8_t *)calloc(2, size);
+    if (map == NULL) {
+      log_e("Register map alloc failed");
+      return ESP_ERR_NO_MEM;
+    }
+  }
+  I2C_SLAVE_MUTEX_LOCK();
+  portENTER_CRITICAL(&i2c->spinlock);
+  uint8_t *old = i2c->reg_map[0];
+  i2c->reg_map[0] = map;
+  i2c->reg_map[1] = map ? map + size : NULL;
+  i2c->reg_map_size = size;
+  i2c->reg_front = 0;
+  i2c->reg_reading = -1;
+  i2c->reg_sync = false;
+  i2c->reg_addr = 0;
+  i2c->tx_len = 0;
+  i2c->tx_pos = 0;
+#if CONFIG_IDF_TARGET_ESP32
+  if (map) {
+    i2c_slave_preload_reg_map_locked(i2c);
+  }
+#endif
+  portEXIT_CRITICAL(&i2c->spinlock);
+  I2C_SLAVE_MUTEX_UNLOCK();
+  free(old);
+  return ESP_OK;
+}
+
+// Brings the back map up to date with the front map once the ISR stopped sending from it
+static esp_err_t i2c_slave_sync_reg_map(i2c_slave_struct_t *i2c, uint32_t timeout_ms) {
+  if (!i2c->reg_sync) {
+    return ESP_OK;
+  }
+  uint8_t back = i2c->reg_front ^ 1;
+  TickType_t start = xTaskGetTickCount();
+  while (i2c->reg_reading == back) {
+#if CONFIG_IDF_TARGET_ESP32
+    // a preloaded FIFO that no master read started from is idle, it is loaded from the front map again
+    portENTER_CRITICAL(&i2c->spinlock);
+    i2c_slave_preload_reg_map_locked(i2c);
+    portEXIT_CRITICAL(&i2c->spinlock);
+    if (i2c->reg_reading != back) {
+      break;
+    }
+#endif
+    if ((xTaskGetTickCount() - start) >= pdMS_TO_TICKS(timeout_ms)) {
+      return ESP_ERR_TIMEOUT;
+    }
+    vTaskDelay(1);
+  }
+  memcpy(i2c->reg_map[back], i2c->reg_map[i2c->reg_front], i2c->reg_map_size);
+  i2c->reg_sync = false;
+  return ESP_OK;
+}
+
+esp_err_t i2cSlaveWriteRegisterMap(uint8_t num, size_t offset, const uint8_t *data, size_t len, uint32_t timeout_ms) {
+  if (num >= SOC_HP_I2C_NUM) {
+    log_e("Invalid port num: %u", num);
+    return ESP_ERR_INVALID_ARG;
+  }
+  i2c_slave_struct_t *i2c = &_i2c_bus_array[num];
+  if (!i2c->reg_map_size) {
+    log_e("No register map");
+    return ESP_ERR_INVALID_STATE;
+  }
+  if (data == NULL || offset + len > i2c->reg_map_size) {
+    log_e("Invalid register range %u + %u", offset, len);
+    return ESP_ERR_INVALID_ARG;
+  }
+  I2C_SLAVE_MUTEX_LOCK();
+  esp_err_t err = i2c_slave_sync_reg_map(i2c, timeout_ms);
+  if (err == ESP_OK) {
+    memcpy(i2c->reg_map[i2c->reg_front ^ 1] + offset, data, len);
+  }
+  I2C_SLAVE_MUTEX_UNLOCK();
+  return err;
+}
+
+esp_err_t i2cSlaveCommitRegisterMap(uint8_t num, uint32_t timeout_ms) {
+  if (num >= SOC_HP_I2C_NUM) {
+    log_e("Invalid port num: %u", num);
+    return ESP_ERR_INVALID_ARG;
+  }
+  i2c_slave_struct_t *i2c = &_i2c_bus_array[num];
+  if (!i2c->reg_map_size) {
+    log_e("No register map");
+    return ESP_ERR_INVALID_STATE;
+  }
+  I2C_SLAVE_MUTEX_LOCK();
+  // a pending sync means the back map is stale, committing it would lose earlier writes
+  esp_err_t err = i2c_slave_sync_reg_map(i2c, timeout_ms);
+  if (err == ESP_OK) {
+    portENTER_CRITICAL(&i2c->spinlock);
+    i2c->reg_front ^= 1;
+    i2c->reg_sync = true;
+#if CONFIG_IDF_TARGET_ESP32
+    i2c_slave_preload_reg_map_locked(i2c);
+#endif
+    portEXIT_CRITICAL(&i2c->spinlock);
+    err = i2c_slave_sync_reg_map(i2c, timeout_ms);
+    if (err == ESP_ERR_TIMEOUT) {
+      err = ESP_OK;  // committed, the copy is retried by the next call
     }
   }
   I2C_SLAVE_MUTEX_UNLOCK();
-  return to_queue + to_fifo;
+  return err;
+}
+
+esp_err_t i2cSlaveGetStats(uint8_t num, i2c_slave_stats_t *stats) {
+  if (num >= SOC_HP_I2C_NUM || stats == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  i2c_slave_struct_t *i2c = &_i2c_bus_array[num];
+  portENTER_CRITICAL(&i2c->spinlock);
+  *stats = i2c->stats;
+  portEXIT_CRITICAL(&i2c->spinlock);
+  return ESP_OK;
+}
+
+void i2cSlaveResetStats(uint8_t num) {
+  if (num >= SOC_HP_I2C_NUM) {
+    return;
+  }
+  i2c_slave_struct_t *i2c = &_i2c_bus_array[num];
+  portENTER_CRITICAL(&i2c->spinlock);
+  memset(&i2c->stats, 0, sizeof(i2c->stats));
+  portEXIT_CRITICAL(&i2c->spinlock);
 }
 
 //=====================================================================================================================
@@ -525,10 +692,24 @@ static void i2c_slave_free_resources(i2c_slave_struct_t *i2c) {
   }
 #endif
 
-  if (i2c->tx_queue) {
-    vQueueDelete(i2c->tx_queue);
-    i2c->tx_queue = NULL;
-  }
+  free(i2c->rx_buf);
+  i2c->rx_buf = NULL;
+  i2c->rx_size = 0;
+
+  free(i2c->tx_buf);
+  i2c->tx_buf = NULL;
+  i2c->tx_size = 0;
+  i2c->tx_len = 0;
+  i2c->tx_pos = 0;
+
+  free(i2c->reg_map[0]);
+  i2c->reg_map[0] = NULL;
+  i2c->reg_map[1] = NULL;
+  i2c->reg_map_size = 0;
+  i2c->reg_front = 0;
+  i2c->reg_reading = -1;
+  i2c->reg_sync = false;
+  i2c->reg_addr = 0;
 
   if (i2c->event_queue) {
     vQueueDelete(i2c->event_queue);
@@ -681,28 +862,102 @@ static bool i2c_slave_send_event(i2c_slave_struct_t *i2c, i2c_slave_queue_event_
   bool pxHigherPriorityTaskWoken = false;
   if (i2c->event_queue) {
     if (xQueueSendFromISR(i2c->event_queue, event, (BaseType_t *const)&pxHigherPriorityTaskWoken) != pdTRUE) {
-      //log_e("event_queue_full");
+      i2c->stats.events_dropped++;
     }
   }
   return pxHigherPriorityTaskWoken;
 }
 
-static bool i2c_slave_handle_tx_fifo_empty(i2c_slave_struct_t *i2c) {
-  bool pxHigherPriorityTaskWoken = false;
-  uint32_t d = 0, moveCnt = 0;
-  i2c_ll_get_txfifo_len(i2c->dev, &moveCnt);
-  while (moveCnt > 0) {  // read tx queue until Fifo is full or queue is empty
-    if (xQueueReceiveFromISR(i2c->tx_queue, &d, (BaseType_t *const)&pxHigherPriorityTaskWoken) == pdTRUE) {
-      i2c_ll_write_txfifo(i2c->dev, (uint8_t *)&d, 1);
-      moveCnt--;
+// Copies as much as fits from tx_buf or the register map to the TX FIFO, called with the spinlock held.
+// Returns true while there is more to send
+static bool i2c_slave_fill_tx_fifo_locked(i2c_slave_struct_t *i2c, size_t *written) {
+  uint32_t space = 0;
+  size_t total = 0;
+  bool more = true;
+  i2c_ll_get_txfifo_len(i2c->dev, &space);
+  while (space) {
+    const uint8_t *src = NULL;
+    size_t left = 0;
+    if (i2c->reg_reading >= 0) {
+      if (i2c->tx_pos >= i2c->reg_map_size) {
+        i2c->tx_pos = 0;  // wrap around like most register mapped devices
+      }
+      src = i2c->reg_map[i2c->reg_reading] + i2c->tx_pos;
+      left = i2c->reg_map_size - i2c->tx_pos;
     } else {
-      i2c_ll_slave_disable_tx_it(i2c->dev);
+      src = i2c->tx_buf + i2c->tx_pos;
+      left = i2c->tx_len - i2c->tx_pos;
+    }
+    if (!left) {
+      more = false;
       break;
     }
+    size_t n = (left < space) ? left : space;
+    i2c_ll_write_txfifo(i2c->dev, (uint8_t *)src, n);
+    i2c->tx_pos += n;
+    space -= n;
+    total += n;
   }
-  return pxHigherPriorityTaskWoken;
+  i2c->stats.tx_bytes += total;
+  if (written) {
+    *written = total;
+  }
+  return more;
+}
+
+static bool i2c_slave_fill_tx_fifo(i2c_slave_struct_t *i2c, size_t *written) {
+  portENTER_CRITICAL_ISR(&i2c->spinlock);
+  bool more = i2c_slave_fill_tx_fifo_locked(i2c, written);
+  portEXIT_CRITICAL_ISR(&i2c->spinlock);
+  return more;
+}
+
+static void i2c_slave_handle_tx_fifo_empty(i2c_slave_struct_t *i2c, bool stretched) {
+  size_t written = 0;
+  if (!i2c_slave_fill_tx_fifo(i2c, &written)) {
+    i2c_ll_slave_disable_tx_it(i2c->dev);
+  }
+  if (stretched && !written) {
+    i2c->stats.tx_underruns++;
+  }
+}
+
+// Starts answering a master read from the committed register map, called with the spinlock held
+static void i2c_slave_load_reg_map_locked(i2c_slave_struct_t *i2c) {
+  i2c_ll_txfifo_rst(i2c->dev);
+  i2c->reg_reading = i2c->reg_front;
+  i2c->tx_pos = i2c->reg_addr;
+  i2c_slave_fill_tx_fifo_locked(i2c, NULL);
+#if CONFIG_IDF_TARGET_ESP32
+  i2c_ll_get_txfifo_len(i2c->dev, &i2c->reg_loaded_space);
+  i2c->reg_loaded_pos = i2c->tx_pos;
+#endif
+  i2c_ll_slave_enable_tx_it(i2c->dev);
 }
 
+static void i2c_slave_load_reg_map(i2c_slave_struct_t *i2c) {
+  portENTER_CRITICAL_ISR(&i2c->spinlock);
+  i2c_slave_load_reg_map_locked(i2c);
+  portEXIT_CRITICAL_ISR(&i2c->spinlock);
+}
+
+#if CONFIG_IDF_TARGET_ESP32
+// The ESP32 does not stretch master reads, so the FIFO is preloaded from the front map between
+// transactions. Preloads it again from the current front map unless a master read already started
+// taking from it. Called with the spinlock held, returns true if the FIFO was loaded
+static bool i2c_slave_preload_reg_map_locked(i2c_slave_struct_t *i2c) {
+  if (i2c->reg_reading >= 0) {
+    uint32_t space = 0;
+    i2c_ll_get_txfifo_len(i2c->dev, &space);
+    if (i2c->dev->status_reg.bus_busy || space != i2c->reg_loaded_space || i2c->tx_pos != i2c->reg_loaded_pos) {
+      return false;
+    }
+  }
+  i2c_slave_load_reg_map_locked(i2c);
+  return true;
+}
+#endif
+
 static bool i2c_slave_handle_rx_fifo_full(i2c_slave_struct_t *i2c, uint32_t len) {
 #if I2C_SLAVE_USE_RX_QUEUE
   uint32_t d = 0;
@@ -713,10 +968,14 @@ static bool i2c_slave_handle_rx_fifo_full(i2c_slave_struct_t *i2c, uint32_t len)
 #if I2C_SLAVE_USE_RX_QUEUE
   while (len > 0) {
     i2c_ll_read_rxfifo(i2c->dev, (uint8_t *)&d, 1);
+    if (i2c->reg_map_size && !i2c->rx_data_count) {
+      i2c->reg_addr = d;  // first byte of a write selects the register
+    }
     if (xQueueSendFromISR(i2c->rx_queue, &d, (BaseType_t *const)&pxHigherPriorityTaskWoken) != pdTRUE) {
-      log_e("rx_queue_full");
+      i2c->stats.rx_overflows++;
     } else {
       i2c->rx_data_count++;
+      i2c->stats.rx_bytes++;
     }
     if (--len == 0) {
       len = i2c_ll_get_rxfifo_cnt(i2c->dev);
@@ -724,10 +983,14 @@ static bool i2c_slave_handle_rx_fifo_full(i2c_slave_struct_t *i2c, uint32_t len)
 #else
   if (len) {
     i2c_ll_read_rxfifo(i2c->dev, data, len);
+    if (i2c->reg_map_size && !i2c->rx_data_count) {
+      i2c->reg_addr = data[0];  // first byte of a write selects the register
+    }
     if (xRingbufferSendFromISR(i2c->rx_ring_buf, (void *)data, len, (BaseType_t *const)&pxHigherPriorityTaskWoken) != pdTRUE) {
-      log_e("rx_ring_buf_full");
+      i2c->stats.rx_overflows += len;
     } else {
       i2c->rx_data_count += len;
+      i2c->stats.rx_bytes += len;
     }
 #endif
   }
@@ -766,36 +1029,52 @@ static void i2c_slave_isr_handler(void *arg) {
     }
     if (slave_rw) {  // READ
 #if CONFIG_IDF_TARGET_ESP32
-      if (i2c->dev->status_reg.scl_main_state_last == 6) {
+      if (!i2c->reg_map_size && i2c->dev->status_reg.scl_main_state_last == 6) {
         //SEND TX Event
         i2c_slave_queue_event_t event;
         event.event = I2C_SLAVE_EVT_TX;
         pxHigherPriorityTaskWoken |= i2c_slave_send_event(i2c, &event);
       }
 #else
-      //reset TX data
+      //reset TX data and drop a partial write
       i2c_ll_txfifo_rst(i2c->dev);
-      uint8_t d;
-      while (xQueueReceiveFromISR(i2c->tx_queue, &d, (BaseType_t *const)&pxHigherPriorityTaskWoken) == pdTRUE);  //flush partial write
+      portENTER_CRITICAL_ISR(&i2c->spinlock);
+      i2c->tx_len = 0;
+      i2c->tx_pos = 0;
+      i2c->reg_reading = -1;
+      portEXIT_CRITICAL_ISR(&i2c->spinlock);
 #endif
     }
+#if CONFIG_IDF_TARGET_ESP32
+    if (i2c->reg_map_size) {
+      //master reads are not stretched here, preload the FIFO for the next one
+      i2c_slave_load_reg_map(i2c);
+    }
+#endif
   }
 
 #ifndef CONFIG_IDF_TARGET_ESP32
   if (activeInt & I2C_SLAVE_STRETCH_INT_ENA) {  // STRETCH
     i2c_stretch_cause_t cause = i2c_ll_stretch_cause(i2c->dev);
+    i2c->stats.stretches++;
     if (cause == I2C_STRETCH_CAUSE_MASTER_READ) {
       //on C3 RX data disappears with repeated start, so we need to get it here
       if (rx_fifo_len) {
         pxHigherPriorityTaskWoken |= i2c_slave_handle_rx_fifo_full(i2c, rx_fifo_len);
       }
-      //SEND TX Event
-      i2c_slave_queue_event_t event;
-      event.event = I2C_SLAVE_EVT_TX;
-      pxHigherPriorityTaskWoken |= i2c_slave_send_event(i2c, &event);
-      //will clear after execution
+      if (i2c->reg_map_size) {
+        //answer from the register map without waking the task
+        i2c_slave_load_reg_map(i2c);
+        i2c_ll_stretch_clr(i2c->dev);
+      } else {
+        //SEND TX Event
+        i2c_slave_queue_event_t event;
+        event.event = I2C_SLAVE_EVT_TX;
+        pxHigherPriorityTaskWoken |= i2c_slave_send_event(i2c, &event);
+        //will clear after execution
+      }
     } else if (cause == I2C_STRETCH_CAUSE_TX_FIFO_EMPTY) {
-      pxHigherPriorityTaskWoken |= i2c_slave_handle_tx_fifo_empty(i2c);
+      i2c_slave_handle_tx_fifo_empty(i2c, true);
       i2c_ll_stretch_clr(i2c->dev);
     } else if (cause == I2C_STRETCH_CAUSE_RX_FIFO_FULL) {
       pxHigherPriorityTaskWoken |= i2c_slave_handle_rx_fifo_full(i2c, rx_fifo_len);
@@ -805,7 +1084,7 @@ static void i2c_slave_isr_handler(void *arg) {
 #endif
 
   if (activeInt & I2C_TXFIFO_WM_INT_ENA) {  // TX FiFo Empty
-    pxHigherPriorityTaskWoken |= i2c_slave_handle_tx_fifo_empty(i2c);
+    i2c_slave_handle_tx_fifo_empty(i2c, false);
   }
 
   if (pxHigherPriorityTaskWoken) {
@@ -866,23 +1145,19 @@ static void i2c_slave_task(void *pv_args) {
   i2c_slave_queue_event_t event;
   size_t len = 0;
   bool stop = false;
-  uint8_t *data = NULL;
   for (;;) {
     if (xQueueReceive(i2c->event_queue, &event, portMAX_DELAY) == pdTRUE) {
       // Write
       if (event.event == I2C_SLAVE_EVT_RX) {
         len = event.param;
         stop = event.stop;
-        data = (len > 0) ? (uint8_t *)malloc(len) : NULL;
-
-        if (len && data == NULL) {
-          log_e("Malloc (%u) Failed", len);
+        if (len > i2c->rx_size) {
+          len = i2c->rx_size;
         }
-        len = i2c_slave_read_rx(i2c, data, len);
+        len = i2c_slave_read_rx(i2c, i2c->rx_buf, len);
         if (i2c->receive_callback) {
-          i2c->receive_callback(i2c->num, data, len, stop, i2c->arg);
+          i2c->receive_callback(i2c->num, i2c->rx_buf, len, stop, i2c->arg);
         }
-        free(data);
 
         // Read
       } else if (event.event == I2C_SLAVE_EVT_TX) {
@@ -33,6 +33,27 @@ esp_err_t i2cSlaveInit(uint8_t num, int sda, int scl, uint16_t slaveID, uint32_t
 esp_err_t i2cSlaveDeinit(uint8_t num);
 size_t i2cSlaveWrite(uint8_t num, const uint8_t *buf, uint32_t len, uint32_t timeout_ms);
 
+typedef struct {
+  uint32_t rx_bytes;        // bytes received
+  uint32_t rx_overflows;    // bytes dropped because the RX buffer was full
+  uint32_t tx_bytes;        // bytes loaded into the TX FIFO
+  uint32_t tx_underruns;    // master kept reading after the data ran out
+  uint32_t stretches;       // clock stretch interrupts
+  uint32_t events_dropped;  // transactions not reported because the event queue was full
+} i2c_slave_stats_t;
+
+esp_err_t i2cSlaveGetStats(uint8_t num, i2c_slave_stats_t *stats);
+void i2cSlaveResetStats(uint8_t num);
+
+// Register addressed slave: the first byte of every master write selects a register, master
+// reads are answered from the map by the ISR without calling request_callback. Writes go to a
+// back map that i2cSlaveCommitRegisterMap() publishes at once, so a read never sees a partial
+// update. Call after i2cSlaveInit(), size 0 disables the map. On ESP32 the FIFO is preloaded
+// when a transaction ends, as the master read cannot be stretched there.
+esp_err_t i2cSlaveSetRegisterMap(uint8_t num, size_t size);
+esp_err_t i2cSlaveWriteRegisterMap(uint8_t num, size_t offset, const uint8_t *data, size_t len, uint32_t timeout_ms);
+esp_err_t i2cSlaveCommitRegisterMap(uint8_t num, uint32_t timeout_ms);
+
 #ifdef __cplusplus
 }
 #endif
@@ -42,6 +42,40 @@ bool i2cIsInit(uint8_t i2c_num);
 
 #if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 4, 0)
 void *i2cBusHandle(uint8_t i2c_num);
+
+// Queued transactions are executed back to back by a worker task of the bus.
+// The write data is copied when it fits in I2C_ASYNC_INLINE_WRITE bytes, otherwise wbuff
+// and rbuff must stay valid until the callback has been called (from the worker task).
+#define I2C_ASYNC_INLINE_WRITE 8
+
+typedef void (*i2c_transaction_cb_t)(uint8_t i2c_num, uint16_t address, esp_err_t err, uint8_t *rbuff, size_t rsize, void *arg);
+
+typedef struct {
+  uint32_t queued;            // transactions accepted
+  uint32_t completed;         // transactions that succeeded
+  uint32_t failed;            // transactions that returned an error
+  uint32_t rejected;          // transactions refused because the queue was full
+  uint32_t queue_high_water;  // most transactions pending at once
+  uint32_t latency_min_us;    // queued to completed
+  uint32_t latency_avg_us;
+  uint32_t latency_max_us;
+  uint32_t bus_max_us;        // longest time on the bus for a single transaction
+  uint64_t busy_us;           // time spent on the bus
+  uint64_t elapsed_us;        // time since the statistics were reset
+  float utilization;          // busy_us / elapsed_us
+} i2c_async_stats_t;
+
+esp_err_t i2cAsyncBegin(uint8_t i2c_num, size_t queue_depth, uint32_t stack_size, uint8_t priority, int core);
+esp_err_t i2cAsyncEnd(uint8_t i2c_num);
+bool i2cAsyncIsActive(uint8_t i2c_num);
+esp_err_t i2cQueueWriteRead(
+  uint8_t i2c_num, uint16_t address, const uint8_t *wbuff, size_t wsize, uint8_t *rbuff, size_t rsize, uint32_t timeOutMillis, i2c_transaction_cb_t cb,
+  void *arg
+);
+esp_err_t i2cAsyncWait(uint8_t i2c_num, uint32_t timeOutMillis);
+size_t i2cAsyncPending(uint8_t i2c_num);
+esp_err_t i2cAsyncGetStats(uint8_t i2c_num, i2c_async_stats_t *stats);
+void i2cAsyncResetStats(uint8_t i2c_num);
 #endif
 
 #ifdef __cplusplus
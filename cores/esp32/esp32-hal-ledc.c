@@ -22,6 +22,8 @@
 #include "soc/gpio_sig_map.h"
 #include "esp_rom_gpio.h"
 #include "hal/ledc_ll.h"
+#include "esp_timer.h"
+#include "freertos/timers.h"
 #if SOC_LEDC_GAMMA_CURVE_FADE_SUPPORTED
 #include <math.h>
 #endif
@@ -137,6 +139,8 @@ static void remove_channel_from_timer(uint8_t speed_mode, uint8_t timer_num, uin
 
 static bool fade_initialized = false;
 
+static void ledc_sequence_cancel(uint8_t channel);
+
 static ledc_clk_cfg_t clock_source = LEDC_DEFAULT_CLK;
 
 ledc_clk_cfg_t ledcGetClockSource(void) {
@@ -171,6 +175,7 @@ static bool ledcDetachBus(void *bus) {
   }
   pinMatrixOutDetach(handle->pin, false, false);
   if (!channel_found) {
+    ledc_sequence_cancel(handle->channel);
     uint8_t group = (handle->channel / SOC_LEDC_CHANNEL_NUM);
     remove_channel_from_timer(group, handle->timer_num, handle->channel % SOC_LEDC_CHANNEL_NUM);
     ledc_handle.used_channels &= ~(1UL << handle->channel);
@@ -513,6 +518,83 @@ bool ledcOutputInvert(uint8_t pin, bool out_invert) {
   return false;
 }
 
+// Duties waiting for ledcCommit(), full on fix already applied
+static uint32_t ledc_staged_duty[LEDC_CHANNELS];
+static uint32_t ledc_staged_mask = 0;
+static portMUX_TYPE ledc_stage_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static uint32_t ledcFullOnDuty(uint32_t duty, uint8_t resolution) {
+  //Fixing if all bits in resolution is set = LEDC FULL ON
+  uint32_t max_duty = (1 << resolution) - 1;
+  if ((duty == max_duty) && (max_duty != 1)) {
+    duty = max_duty + 1;
+  }
+  return duty;
+}
+
+static void ledcStageDuty(uint8_t channel, uint32_t duty) {
+  portENTER_CRITICAL(&ledc_stage_mux);
+  ledc_staged_duty[channel] = duty;
+  ledc_staged_mask |= (1UL << channel);
+  portEXIT_CRITICAL(&ledc_stage_mux);
+}
+
+bool ledcStage(uint8_t pin, uint32_t duty) {
+  ledc_channel_handle_t *bus = (ledc_channel_handle_t *)perimanGetPinBus(pin, ESP32_BUS_TYPE_LEDC);
+  if (bus == NULL) {
+    log_e("Pin %u is not attached to LEDC. Call ledcAttach first!", pin);
+    return false;
+  }
+  ledcStageDuty(bus->channel, ledcFullOnDuty(duty, bus->channel_resolution));
+  return true;
+}
+
+bool ledcStageChannel(uint8_t channel, uint32_t duty) {
+  if (channel >= LEDC_CHANNELS || !(ledc_handle.used_channels & (1UL << channel))) {
+    log_e("Channel %u is not available (maximum %u) or not used!", channel, LEDC_CHANNELS);
+    return false;
+  }
+  uint8_t group = (channel / SOC_LEDC_CHANNEL_NUM);
+  ledc_timer_t timer;
+  uint32_t resolution = 0;
+  ledc_ll_get_channel_timer(LEDC_LL_GET_HW(), group, (channel % SOC_LEDC_CHANNEL_NUM), &timer);
+  ledc_ll_get_duty_resolution(LEDC_LL_GET_HW(), group, timer, &resolution);
+  ledcStageDuty(channel, ledcFullOnDuty(duty, resolution));
+  return true;
+}
+
+uint32_t ledcCommit(void) {
+  uint32_t duty[LEDC_CHANNELS];
+  portENTER_CRITICAL(&ledc_stage_mux);
+  // skip the channels detached since they were staged
+  uint32_t mask = ledc_staged_mask & ledc_handle.used_channels;
+  ledc_staged_mask = 0;
+  memcpy(duty, ledc_staged_duty, sizeof(duty));
+  portEXIT_CRITICAL(&ledc_stage_mux);
+
+  // ledc_set_duty() only fills the duty registers, the output keeps the old duty until
+  // ledc_update_duty(). Doing all the slow part first leaves the latches back to back.
+  uint32_t todo = mask;
+  while (todo) {
+    uint8_t ch = __builtin_ctz(todo);
+    todo &= todo - 1;
+    if (ledc_set_duty(ch / SOC_LEDC_CHANNEL_NUM, ch % SOC_LEDC_CHANNEL_NUM, duty[ch]) != ESP_OK) {
+      log_e("ledc_set_duty failed for channel %u", ch);
+      mask &= ~(1UL << ch);
+    }
+  }
+  uint32_t count = 0;
+  todo = mask;
+  while (todo) {
+    uint8_t ch = __builtin_ctz(todo);
+    todo &= todo - 1;
+    if (ledc_update_duty(ch / SOC_LEDC_CHANNEL_NUM, ch % SOC_LEDC_CHANNEL_NUM) == ESP_OK) {
+      count++;
+    }
+  }
+  return count;
+}
+
 static IRAM_ATTR bool ledcFnWrapper(const ledc_cb_param_t *param, void *user_arg) {
   if (param->event == LEDC_FADE_END_EVT) {
     ledc_channel_handle_t *bus = (ledc_channel_handle_t *)user_arg;
@@ -560,6 +642,7 @@ static bool ledcFadeConfig(uint8_t pin, uint32_t start_duty, uint32_t target_dut
       fade_initialized = true;
     }
 
+    ledc_sequence_cancel(bus->channel);
     bus->fn = (voidFuncPtr)userFunc;
     bus->arg = arg;
 
@@ -609,6 +692,257 @@ bool ledcFadeWithInterruptArg(uint8_t pin, uint32_t start_duty, uint32_t target_
   return ledcFadeConfig(pin, start_duty, target_duty, max_fade_time_ms, userFunc, arg);
 }
 
+/*
+ * Fade sequences
+ *
+ * Every keyframe is one hardware fade. The fade end interrupt can not start the next fade itself,
+ * the driver takes the fade semaphore and mutex of the channel in ledc_set_fade_time_and_start(),
+ * so it hands the step over to the FreeRTOS timer service task, which runs it as soon as the ISR
+ * returns, or to the hold timer when the timer command queue is full. Keyframes that keep the duty
+ * are holds, timed by an esp_timer.
+ * Sequences are allocated on first use and never freed: a pending step may still point to them.
+ */
+typedef struct {
+  const ledc_keyframe_t *keyframes;
+  size_t count;
+  uint32_t loops;
+} ledc_sequence_list_t;
+
+typedef struct {
+  uint8_t channel;
+  uint8_t resolution;
+  bool running;
+  volatile uint32_t gen;  // bumped on start and stop, drops the steps of a previous run
+  ledc_sequence_list_t lists[LEDC_SEQUENCE_QUEUE_LEN];
+  uint8_t head;
+  uint8_t len;
+  size_t step;
+  uint32_t loop;
+  esp_timer_handle_t hold_timer;
+  uint32_t lost;  // steps that could not be handed over by the ISR, each one stopped the sequence
+  void (*fn)(void *);
+  void *arg;
+} ledc_sequence_t;
+
+static ledc_sequence_t *ledc_sequences[LEDC_CHANNELS] = {NULL};
+static portMUX_TYPE ledc_sequence_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static void ledc_sequence_step(void *arg, uint32_t gen) {
+  ledc_sequence_t *seq = (ledc_sequence_t *)arg;
+  ledc_keyframe_t kf = {0, 0};
+  bool done = false;
+
+  portENTER_CRITICAL(&ledc_sequence_mux);
+  if (!seq->running || gen != seq->gen) {
+    portEXIT_CRITICAL(&ledc_sequence_mux);
+    return;
+  }
+  ledc_sequence_list_t *list = &seq->lists[seq->head];
+  if (seq->step >= list->count) {
+    seq->step = 0;
+    seq->loop++;
+    // an endless list gives way to the next queued one at the end of a loop
+    if ((list->loops && seq->loop >= list->loops) || (!list->loops && seq->len > 1)) {
+      seq->head = (seq->head + 1) % LEDC_SEQUENCE_QUEUE_LEN;
+      seq->len--;
+      seq->loop = 0;
+      if (seq->len == 0) {
+        seq->running = false;
+        done = true;
+      }
+    }
+  }
+  if (!done) {
+    kf = seq->lists[seq->head].keyframes[seq->step++];
+  }
+  portEXIT_CRITICAL(&ledc_sequence_mux);
+
+  if (done) {
+    if (seq->fn) {
+      seq->fn(seq->arg);
+    }
+    return;
+  }
+
+  uint8_t group = (seq->channel / SOC_LEDC_CHANNEL_NUM), channel = (seq->channel % SOC_LEDC_CHANNEL_NUM);
+  uint32_t duty = ledcFullOnDuty(kf.duty, seq->resolution);
+  // at least 1 ms, a fade of zero PWM cycles becomes a jump to the target in the driver
+  uint32_t time_ms = kf.time_ms ? kf.time_ms : 1;
+  esp_err_t err;
+  if (duty == ledc_get_duty(group, channel)) {
+    // no fade, so no fade end interrupt
+    err = esp_timer_start_once(seq->hold_timer, (uint64_t)time_ms * 1000);
+  } else {
+    err = ledc_set_fade_time_and_start(group, channel, duty, time_ms, LEDC_FADE_NO_WAIT);
+  }
+  if (err != ESP_OK) {
+    log_e("LEDC channel %u sequence step failed: 0x%x", seq->channel, err);
+    portENTER_CRITICAL(&ledc_sequence_mux);
+    seq->running = false;
+    portEXIT_CRITICAL(&ledc_sequence_mux);
+  }
+}
+
+static IRAM_ATTR bool ledcSequenceIsr(const ledc_cb_param_t *param, void *user_arg) {
+  BaseType_t woken = pdFALSE;
+  if (param->event == LEDC_FADE_END_EVT) {
+    ledc_sequence_t *seq = (ledc_sequence_t *)user_arg;
+    if (xTimerPendFunctionCallFromISR(ledc_sequence_step, seq, seq->gen, &woken) != pdPASS) {
+      // timer command queue full, run the step from the hold timer instead
+      if (esp_timer_start_once(seq->hold_timer, 0) != ESP_OK) {
+        portENTER_CRITICAL_ISR(&ledc_sequence_mux);
+        seq->lost++;
+        seq->running = false;
+        portEXIT_CRITICAL_ISR(&ledc_sequence_mux);
+      }
+    }
+  }
+  return woken == pdTRUE;
+}
+
+static void ledcSequenceHold(void *arg) {
+  ledc_sequence_t *seq = (ledc_sequence_t *)arg;
+  ledc_sequence_step(seq, seq->gen);
+}
+
+static void ledc_sequence_cancel(uint8_t channel) {
+  ledc_sequence_t *seq = (channel < LEDC_CHANNELS) ? ledc_sequences[channel] : NULL;
+  if (seq == NULL) {
+    return;
+  }
+  portENTER_CRITICAL(&ledc_sequence_mux);
+  bool running = seq->running;
+  seq->running = false;
+  seq->gen++;
+  seq->len = 0;
+  portEXIT_CRITICAL(&ledc_sequence_mux);
+  if (running) {
+    esp_timer_stop(seq->hold_timer);
+#if SOC_LEDC_SUPPORT_FADE_STOP
+    ledc_fade_stop(channel / SOC_LEDC_CHANNEL_NUM, channel % SOC_LEDC_CHANNEL_NUM);
+#endif
+  }
+}
+
+bool ledcSequence(uint8_t pin, const ledc_keyframe_t *keyframes, size_t count, uint32_t loops, void (*userFunc)(void *), void *arg) {
+  if (keyframes == NULL || count == 0) {
+    log_e("Bad Parameters");
+    return false;
+  }
+  ledc_channel_handle_t *bus = (ledc_channel_handle_t *)perimanGetPinBus(pin, ESP32_BUS_TYPE_LEDC);
+  if (bus == NULL) {
+    log_e("Pin %u is not attached to LEDC. Call ledcAttach first!", pin);
+    return false;
+  }
+
+#ifndef SOC_LEDC_SUPPORT_FADE_STOP
+#if !CONFIG_DISABLE_HAL_LOCKS
+  // a fade of ledcFade() can not be stopped and its callback would be replaced
+  if (bus->lock != NULL) {
+    if (xSemaphoreTake(bus->lock, 0) != pdTRUE) {
+      log_e("LEDC Fade is still running on pin %u! SoC does not support stopping fade.", pin);
+      return false;
+    }
+    xSemaphoreGive(bus->lock);
+  }
+#endif
+#endif
+
+  ledc_sequence_t *seq = ledc_sequences[bus->channel];
+  if (seq == NULL) {
+    seq = (ledc_sequence_t *)calloc(1, sizeof(ledc_sequence_t));
+    if (seq == NULL) {
+      log_e("No memory for the LEDC sequence");
+      return false;
+    }
+    esp_timer_create_args_t timer_args = {
+      .callback = ledcSequenceHold,
+      .arg = seq,
+      .dispatch_method = ESP_TIMER_TASK,
+      .name = "ledc_seq",
+      .skip_unhandled_events = true,
+    };
+    if (esp_timer_create(&timer_args, &seq->hold_timer) != ESP_OK) {
+      log_e("esp_timer_create failed");
+      free(seq);
+      return false;
+    }
+    seq->channel = bus->channel;
+    ledc_sequences[bus->channel] = seq;
+  }
+
+  portENTER_CRITICAL(&ledc_sequence_mux);
+  uint32_t lost = seq->lost;
+  seq->lost = 0;
+  portEXIT_CRITICAL(&ledc_sequence_mux);
+  if (lost) {
+    log_w("LEDC sequence of pin %u stopped early, %lu steps lost", pin, lost);
+  }
+
+  portENTER_CRITICAL(&ledc_sequence_mux);
+  if (seq->running) {
+    if (seq->len == LEDC_SEQUENCE_QUEUE_LEN) {
+      portEXIT_CRITICAL(&ledc_sequence_mux);
+      log_e("LEDC sequence queue of pin %u is full", pin);
+      return false;
+    }
+    ledc_sequence_list_t *list = &seq->lists[(seq->head + seq->len) % LEDC_SEQUENCE_QUEUE_LEN];
+    list->keyframes = keyframes;
+    list->count = count;
+    list->loops = loops;
+    seq->len++;
+    seq->fn = userFunc;
+    seq->arg = arg;
+    portEXIT_CRITICAL(&ledc_sequence_mux);
+    return true;
+  }
+  portEXIT_CRITICAL(&ledc_sequence_mux);
+
+  uint8_t group = (bus->channel / SOC_LEDC_CHANNEL_NUM), channel = (bus->channel % SOC_LEDC_CHANNEL_NUM);
+  if (!fade_initialized) {
+    ledc_fade_func_install(0);
+    fade_initialized = true;
+  }
+  ledc_cbs_t callbacks = {.fade_cb = ledcSequenceIsr};
+  ledc_cb_register(group, channel, &callbacks, (void *)seq);
+
+  portENTER_CRITICAL(&ledc_sequence_mux);
+  seq->resolution = bus->channel_resolution;
+  seq->lists[0].keyframes = keyframes;
+  seq->lists[0].count = count;
+  seq->lists[0].loops = loops;
+  seq->head = 0;
+  seq->len = 1;
+  seq->step = 0;
+  seq->loop = 0;
+  seq->fn = userFunc;
+  seq->arg = arg;
+  seq->running = true;
+  uint32_t gen = ++seq->gen;
+  portEXIT_CRITICAL(&ledc_sequence_mux);
+
+  ledc_sequence_step(seq, gen);
+  return seq->running;
+}
+
+bool ledcSequenceStop(uint8_t pin) {
+  ledc_channel_handle_t *bus = (ledc_channel_handle_t *)perimanGetPinBus(pin, ESP32_BUS_TYPE_LEDC);
+  if (bus == NULL) {
+    log_e("Pin %u is not attached to LEDC", pin);
+    return false;
+  }
+  ledc_sequence_cancel(bus->channel);
+  return true;
+}
+
+bool ledcSequenceRunning(uint8_t pin) {
+  ledc_channel_handle_t *bus = (ledc_channel_handle_t *)perimanGetPinBus(pin, ESP32_BUS_TYPE_LEDC);
+  if (bus == NULL || ledc_sequences[bus->channel] == NULL) {
+    return false;
+  }
+  return ledc_sequences[bus->channel]->running;
+}
+
 #ifdef SOC_LEDC_GAMMA_CURVE_FADE_SUPPORTED
 // Default gamma factor for gamma correction (common value for LEDs)
 static float ledcGammaFactor = 2.8;
@@ -697,6 +1031,7 @@ static bool ledcFadeGammaConfig(uint8_t pin, uint32_t start_duty, uint32_t targe
       fade_initialized = true;
     }
 
+    ledc_sequence_cancel(bus->channel);
     bus->fn = (voidFuncPtr)userFunc;
     bus->arg = arg;
 
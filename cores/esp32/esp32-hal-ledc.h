@@ -47,6 +47,16 @@ typedef enum {
 typedef void (*voidFuncPtr)(void);
 typedef void (*voidFuncPtrArg)(void *);
 
+typedef struct {
+  uint32_t duty;     // duty cycle at the end of the step
+  uint32_t time_ms;  // fade time to reach it. When duty does not change, time to hold it
+} ledc_keyframe_t;
+
+// Number of keyframe lists that can wait behind the one playing on a channel
+#ifndef LEDC_SEQUENCE_QUEUE_LEN
+#define LEDC_SEQUENCE_QUEUE_LEN 4
+#endif
+
 typedef struct {
   uint8_t pin;                 // Pin assigned to channel
   uint8_t channel;             // Channel number
@@ -192,6 +202,39 @@ uint32_t ledcChangeFrequency(uint8_t pin, uint32_t freq, uint8_t resolution);
  */
 bool ledcOutputInvert(uint8_t pin, bool out_invert);
 
+//Frame functions
+/**
+ * @brief Stage the duty cycle of a given pin for the next ledcCommit().
+ *        The output does not change until then.
+ *
+ * @param pin GPIO pin
+ * @param duty duty cycle to set
+ *
+ * @return true if the duty cycle was staged, false otherwise.
+ */
+bool ledcStage(uint8_t pin, uint32_t duty);
+
+/**
+ * @brief Stage the duty cycle of a given channel for the next ledcCommit().
+ *
+ * @param channel LEDC channel
+ * @param duty duty cycle to set
+ *
+ * @return true if the duty cycle was staged, false otherwise.
+ */
+bool ledcStageChannel(uint8_t channel, uint32_t duty);
+
+/**
+ * @brief Apply all the staged duty cycles at once.
+ *        The duty registers of all the channels are written first, then the channels are
+ *        latched back to back. A channel takes its new duty at the end of its current PWM
+ *        period, so the channels sharing a timer change in the same period instead of one
+ *        ledcWrite() after the other.
+ *
+ * @return number of channels updated.
+ */
+uint32_t ledcCommit(void);
+
 //Fade functions
 /**
  * @brief Setup and start a fade on a given LEDC pin.
@@ -232,6 +275,46 @@ bool ledcFadeWithInterrupt(uint8_t pin, uint32_t start_duty, uint32_t target_dut
  */
 bool ledcFadeWithInterruptArg(uint8_t pin, uint32_t start_duty, uint32_t target_duty, int max_fade_time_ms, void (*userFunc)(void *), void *arg);
 
+//Fade sequence functions
+/**
+ * @brief Play a list of keyframes on a given LEDC pin with the hardware fade engine.
+ *        Each step is a hardware fade, the fade end interrupt schedules the next one: no task
+ *        of the sketch is involved and nothing needs to be polled. If a list is already playing,
+ *        this one is queued behind it (up to LEDC_SEQUENCE_QUEUE_LEN lists).
+ *
+ * @param pin GPIO pin
+ * @param keyframes steps of the list, the array must stay valid while it plays
+ * @param count number of keyframes
+ * @param loops number of times the list is played, 0 repeats it until ledcSequenceStop()
+ *              or until another list is queued
+ * @param userFunc called when the last queued list ends (not from an ISR), can be NULL
+ * @param arg argument to be passed to the callback function
+ *
+ * @return true if the list was started or queued, false otherwise.
+ *
+ * @note Calling ledcFade*() on the pin stops the sequence.
+ */
+bool ledcSequence(uint8_t pin, const ledc_keyframe_t *keyframes, size_t count, uint32_t loops, void (*userFunc)(void *), void *arg);
+
+/**
+ * @brief Stop the sequence of a given LEDC pin and drop its queued lists.
+ *        The current fade is stopped if the SoC supports it, otherwise it ends by itself.
+ *
+ * @param pin GPIO pin
+ *
+ * @return true if the pin is attached to LEDC, false otherwise.
+ */
+bool ledcSequenceStop(uint8_t pin);
+
+/**
+ * @brief Check if a sequence is playing on a given LEDC pin.
+ *
+ * @param pin GPIO pin
+ *
+ * @return true if a sequence is playing, false otherwise.
+ */
+bool ledcSequenceRunning(uint8_t pin);
+
 //Gamma Curve Fade functions - only available on supported chips
 #ifdef SOC_LEDC_GAMMA_CURVE_FADE_SUPPORTED
 
@@ -36,6 +36,8 @@
 #endif
 #include "esp_task_wdt.h"
 #include "esp32-hal.h"
+#include "boot_profile.h"
+#include <sys/lock.h>
 
 #include "esp_system.h"
 #ifdef ESP_IDF_VERSION_MAJOR  // IDF 4+
@@ -263,12 +265,57 @@ ESP_SYSTEM_INIT_FN(init_psram_new, CORE, BIT(0), 99) {
 }
 #endif
 
+bool deferNvsInit() __attribute__((weak));
+bool deferNvsInit() {
+#ifdef CONFIG_ARDUINO_DEFER_NVS_INIT
+  return true;
+#else
+  return false;
+#endif
+}
+
+static _lock_t nvs_init_lock;
+static bool nvs_initialized = false;
+
+bool initNvs() {
+  if (nvs_initialized) {
+    return true;
+  }
+  _lock_acquire(&nvs_init_lock);
+  if (nvs_initialized) {
+    _lock_release(&nvs_init_lock);
+    return true;
+  }
+  esp_err_t err = nvs_flash_init();
+  if (err == ESP_ERR_NVS_NO_FREE_PAGES || err == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+    const esp_partition_t *partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_NVS, NULL);
+    if (partition != NULL) {
+      err = esp_partition_erase_range(partition, 0, partition->size);
+      if (!err) {
+        err = nvs_flash_init();
+      } else {
+        log_e("Failed to format the broken NVS partition!");
+      }
+    } else {
+      log_e("Could not find NVS partition");
+    }
+  }
+  if (err) {
+    log_e("Failed to initialize NVS! Error: %u", err);
+  } else {
+    nvs_initialized = true;
+  }
+  _lock_release(&nvs_init_lock);
+  return nvs_initialized;
+}
+
 void initArduino() {
   //init proper ref tick value for PLL (uncomment if REF_TICK is different than 1MHz)
   //ESP_REG(APB_CTRL_PLL_TICK_CONF_REG) = APB_CLK_FREQ / REF_CLK_FREQ - 1;
 #if CONFIG_SPIRAM_SUPPORT || CONFIG_SPIRAM
 #ifndef CONFIG_SPIRAM_BOOT_INIT
   psramAddToHeap();
+  bootProfileMark("psram");
 #endif
 #endif
 #ifdef CONFIG_APP_ROLLBACK_ENABLE
@@ -286,32 +333,23 @@ void initArduino() {
       }
     }
   }
+  bootProfileMark("ota verify");
 #endif
   esp_log_level_set("*", CONFIG_LOG_DEFAULT_LEVEL);
-  esp_err_t err = nvs_flash_init();
-  if (err == ESP_ERR_NVS_NO_FREE_PAGES || err == ESP_ERR_NVS_NEW_VERSION_FOUND) {
-    const esp_partition_t *partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_NVS, NULL);
-    if (partition != NULL) {
-      err = esp_partition_erase_range(partition, 0, partition->size);
-      if (!err) {
-        err = nvs_flash_init();
-      } else {
-        log_e("Failed to format the broken NVS partition!");
-      }
-    } else {
-      log_e("Could not find NVS partition");
-    }
-  }
-  if (err) {
-    log_e("Failed to initialize NVS! Error: %u", err);
+  if (!deferNvsInit()) {
+    initNvs();
+    bootProfileMark("nvs");
   }
 #if defined(CONFIG_BT_BLUEDROID_ENABLED) && SOC_BT_SUPPORTED
   if (!btInUse()) {
     esp_bt_controller_mem_release(ESP_BT_MODE_BTDM);
+    bootProfileMark("bt mem release");
   }
 #endif
   init();
+  bootProfileMark("init");
   initVariant();
+  bootProfileMark("initVariant");
 }
 
 //used by hal log
@@ -32,6 +32,9 @@ extern TaskHandle_t loopTaskHandle;
 #define RMT_FLAG_RX_DONE (1)
 #define RMT_FLAG_TX_DONE (2)
 
+// DMA buffer of a TX channel initialized with rmtInitDMA()
+#define RMT_DMA_SYMBOLS 1024
+
 /**
    Internal macros
 */
@@ -54,6 +57,7 @@ struct rmt_obj_s {
   // general RMT information
   rmt_channel_handle_t rmt_channel_h;       // IDF RMT channel handler
   rmt_encoder_handle_t rmt_copy_encoder_h;  // RMT simple copy encoder handle
+  rmt_encoder_handle_t rmt_bytes_encoder_h;  // RMT bytes encoder handle, set by rmtSetBytesEncoder()
 
   uint32_t signal_range_min_ns;  // RX Filter data - Low Pass pulse width
   uint32_t signal_range_max_ns;  // RX idle time that defines end of reading
@@ -64,6 +68,7 @@ struct rmt_obj_s {
   rmt_reserve_memsize_t mem_size;  // RMT Memory size
   uint32_t frequency_Hz;           // RMT Frequency
   uint8_t rmt_EOT_Level;           // RMT End of Transmission Level - default is LOW
+  bool with_dma;                   // TX symbols are read by DMA
 
 #if !CONFIG_DISABLE_HAL_LOCKS
   SemaphoreHandle_t g_rmt_objlocks;  // Channel Semaphore Lock
@@ -81,6 +86,66 @@ static SemaphoreHandle_t g_rmt_block_lock = NULL;
    Internal method (private) declarations
 */
 
+// Bytes encoder followed by a fixed symbol, such as the reset time of addressable LEDs (see the IDF led_strip example)
+typedef struct {
+  rmt_encoder_t base;
+  rmt_encoder_handle_t bytes_encoder;
+  rmt_encoder_handle_t copy_encoder;
+  rmt_symbol_word_t trailer;
+  int state;
+} rmt_bytes_trailer_encoder_t;
+
+static size_t _rmt_encode_bytes_trailer(rmt_encoder_t *encoder, rmt_channel_handle_t channel, const void *data, size_t data_size, rmt_encode_state_t *ret_state) {
+  rmt_bytes_trailer_encoder_t *enc = __containerof(encoder, rmt_bytes_trailer_encoder_t, base);
+  rmt_encode_state_t session_state = RMT_ENCODING_RESET;
+  rmt_encode_state_t state = RMT_ENCODING_RESET;
+  size_t encoded_symbols = 0;
+  switch (enc->state) {
+    case 0:  // data bytes
+      encoded_symbols += enc->bytes_encoder->encode(enc->bytes_encoder, channel, data, data_size, &session_state);
+      if (session_state & RMT_ENCODING_COMPLETE) {
+        enc->state = 1;
+      }
+      if (session_state & RMT_ENCODING_MEM_FULL) {
+        state |= RMT_ENCODING_MEM_FULL;
+        break;  // continues when there is room again
+      }
+    // fall through
+    case 1:  // trailer
+      encoded_symbols += enc->copy_encoder->encode(enc->copy_encoder, channel, &enc->trailer, sizeof(enc->trailer), &session_state);
+      if (session_state & RMT_ENCODING_COMPLETE) {
+        enc->state = RMT_ENCODING_RESET;
+        state |= RMT_ENCODING_COMPLETE;
+      }
+      if (session_state & RMT_ENCODING_MEM_FULL) {
+        state |= RMT_ENCODING_MEM_FULL;
+      }
+      break;
+  }
+  *ret_state = state;
+  return encoded_symbols;
+}
+
+static esp_err_t _rmt_reset_bytes_trailer(rmt_encoder_t *encoder) {
+  rmt_bytes_trailer_encoder_t *enc = __containerof(encoder, rmt_bytes_trailer_encoder_t, base);
+  rmt_encoder_reset(enc->bytes_encoder);
+  rmt_encoder_reset(enc->copy_encoder);
+  enc->state = RMT_ENCODING_RESET;
+  return ESP_OK;
+}
+
+static esp_err_t _rmt_del_bytes_trailer(rmt_encoder_t *encoder) {
+  rmt_bytes_trailer_encoder_t *enc = __containerof(encoder, rmt_bytes_trailer_encoder_t, base);
+  if (enc->bytes_encoder != NULL) {
+    rmt_del_encoder(enc->bytes_encoder);
+  }
+  if (enc->copy_encoder != NULL) {
+    rmt_del_encoder(enc->copy_encoder);
+  }
+  free(enc);
+  return ESP_OK;
+}
+
 // This is called from an IDF ISR code, therefore this code is part of an ISR
 static bool _rmt_rx_done_callback(rmt_channel_handle_t channel, const rmt_rx_done_event_data_t *data, void *args) {
   BaseType_t high_task_wakeup = pdFALSE;
@@ -156,6 +221,12 @@ static bool _rmtDetachBus(void *busptr) {
       retCode = false;
     }
   }
+  if (bus->rmt_bytes_encoder_h != NULL) {
+    if (ESP_OK != rmt_del_encoder(bus->rmt_bytes_encoder_h)) {
+      log_w("RMT Bytes Encoder Deletion has failed.");
+      retCode = false;
+    }
+  }
   // disable and deallocate RMT channel
   if (bus->rmt_channel_h != NULL) {
     // force stopping rmt TX/RX processing and unlock Power Management (APB Freq)
@@ -285,7 +356,8 @@ bool rmtDeinit(int pin) {
   return false;
 }
 
-static bool _rmtWrite(int pin, rmt_data_t *data, size_t num_rmt_symbols, bool blocking, bool loop, uint32_t timeout_ms) {
+// <size> is a number of RMT symbols, or of bytes when <bytes> selects the bytes encoder
+static bool _rmtWrite(int pin, const void *data, size_t size, bool bytes, bool blocking, bool loop, uint32_t timeout_ms) {
   rmt_bus_handle_t bus = _rmtGetBus(pin, __FUNCTION__);
   if (bus == NULL) {
     return false;
@@ -293,8 +365,12 @@ static bool _rmtWrite(int pin, rmt_data_t *data, size_t num_rmt_symbols, bool bl
   if (!_rmtCheckDirection(pin, RMT_TX_MODE, __FUNCTION__)) {
     return false;
   }
+  if (bytes && bus->rmt_bytes_encoder_h == NULL) {
+    log_e("GPIO %d - No bytes encoder, call rmtSetBytesEncoder() first.", pin);
+    return false;
+  }
   bool loopCancel = false;  // user wants to cancel the writing loop mode
-  if (data == NULL || num_rmt_symbols == 0) {
+  if (data == NULL || size == 0) {
     if (!loop) {
       log_w("GPIO %d - RMT Write Data NULL pointer or size is zero.", pin);
       return false;
@@ -303,7 +379,7 @@ static bool _rmtWrite(int pin, rmt_data_t *data, size_t num_rmt_symbols, bool bl
     }
   }
 
-  log_v("GPIO: %d - Request: %d RMT Symbols - %s - Timeout: %d", pin, num_rmt_symbols, blocking ? "Blocking" : "Non-Blocking", timeout_ms);
+  log_v("GPIO: %d - Request: %d %s - %s - Timeout: %d", pin, size, bytes ? "Bytes" : "RMT Symbols", blocking ? "Blocking" : "Non-Blocking", timeout_ms);
   log_v(
     "GPIO: %d - Currently in Loop Mode: [%s] | Asked to Loop: %s, LoopCancel: %s", pin, bus->rmt_ch_is_looping ? "YES" : "NO", loop ? "YES" : "NO",
     loopCancel ? "YES" : "NO"
@@ -344,7 +420,9 @@ static bool _rmtWrite(int pin, rmt_data_t *data, size_t num_rmt_symbols, bool bl
       xEventGroupClearBits(bus->rmt_events, RMT_FLAG_TX_DONE);
     }
     // transmits just once or looping data
-    if (ESP_OK != rmt_transmit(bus->rmt_channel_h, bus->rmt_copy_encoder_h, (const void *)data, num_rmt_symbols * sizeof(rmt_data_t), &transmit_cfg)) {
+    rmt_encoder_handle_t encoder = bytes ? bus->rmt_bytes_encoder_h : bus->rmt_copy_encoder_h;
+    size_t data_size = bytes ? size : size * sizeof(rmt_data_t);
+    if (ESP_OK != rmt_transmit(bus->rmt_channel_h, encoder, data, data_size, &transmit_cfg)) {
       retCode = false;
       log_w("GPIO %d - RMT Transmission failed.", pin);
     } else {  // transmit OK
@@ -402,15 +480,78 @@ static bool _rmtRead(int pin, rmt_data_t *data, size_t *num_rmt_symbols, bool wa
 }
 
 bool rmtWrite(int pin, rmt_data_t *data, size_t num_rmt_symbols, uint32_t timeout_ms) {
-  return _rmtWrite(pin, data, num_rmt_symbols, true /*blocks*/, false /*looping*/, timeout_ms);
+  return _rmtWrite(pin, data, num_rmt_symbols, false /*symbols*/, true /*blocks*/, false /*looping*/, timeout_ms);
 }
 
 bool rmtWriteAsync(int pin, rmt_data_t *data, size_t num_rmt_symbols) {
-  return _rmtWrite(pin, data, num_rmt_symbols, false /*blocks*/, false /*looping*/, 0 /*N/A*/);
+  return _rmtWrite(pin, data, num_rmt_symbols, false /*symbols*/, false /*blocks*/, false /*looping*/, 0 /*N/A*/);
 }
 
 bool rmtWriteLooping(int pin, rmt_data_t *data, size_t num_rmt_symbols) {
-  return _rmtWrite(pin, data, num_rmt_symbols, false /*blocks*/, true /*looping*/, 0 /*N/A*/);
+  return _rmtWrite(pin, data, num_rmt_symbols, false /*symbols*/, false /*blocks*/, true /*looping*/, 0 /*N/A*/);
+}
+
+bool rmtSetBytesEncoder(int pin, rmt_data_t bit0, rmt_data_t bit1, const rmt_data_t *trailer) {
+  rmt_bus_handle_t bus = _rmtGetBus(pin, __FUNCTION__);
+  if (bus == NULL) {
+    return false;
+  }
+  if (!_rmtCheckDirection(pin, RMT_TX_MODE, __FUNCTION__)) {
+    return false;
+  }
+  if ((xEventGroupGetBits(bus->rmt_events) & RMT_FLAG_TX_DONE) == 0 || bus->rmt_ch_is_looping) {
+    log_w("GPIO %d - RMT Write still pending, the encoder can't be changed.", pin);
+    return false;
+  }
+
+  rmt_bytes_encoder_config_t bytes_cfg;
+  memset((void *)&bytes_cfg, 0, sizeof(rmt_bytes_encoder_config_t));
+  bytes_cfg.bit0.val = bit0.val;
+  bytes_cfg.bit1.val = bit1.val;
+  bytes_cfg.flags.msb_first = 1;
+
+  rmt_encoder_handle_t encoder = NULL;
+  bool retCode = true;
+  RMT_MUTEX_LOCK(bus);
+  if (trailer == NULL) {
+    retCode = rmt_new_bytes_encoder(&bytes_cfg, &encoder) == ESP_OK;
+  } else {
+    rmt_bytes_trailer_encoder_t *enc = (rmt_bytes_trailer_encoder_t *)heap_caps_calloc(1, sizeof(rmt_bytes_trailer_encoder_t), MALLOC_CAP_DEFAULT);
+    rmt_copy_encoder_config_t copy_cfg;
+    memset((void *)&copy_cfg, 0, sizeof(rmt_copy_encoder_config_t));
+    if (enc == NULL) {
+      retCode = false;
+    } else {
+      enc->base.encode = _rmt_encode_bytes_trailer;
+      enc->base.reset = _rmt_reset_bytes_trailer;
+      enc->base.del = _rmt_del_bytes_trailer;
+      enc->trailer.val = trailer->val;
+      if (rmt_new_bytes_encoder(&bytes_cfg, &enc->bytes_encoder) != ESP_OK || rmt_new_copy_encoder(&copy_cfg, &enc->copy_encoder) != ESP_OK) {
+        _rmt_del_bytes_trailer(&enc->base);
+        retCode = false;
+      } else {
+        encoder = &enc->base;
+      }
+    }
+  }
+  if (retCode) {
+    if (bus->rmt_bytes_encoder_h != NULL) {
+      rmt_del_encoder(bus->rmt_bytes_encoder_h);
+    }
+    bus->rmt_bytes_encoder_h = encoder;
+  } else {
+    log_e("GPIO %d - RMT Bytes Encoder Memory Allocation error.", pin);
+  }
+  RMT_MUTEX_UNLOCK(bus);
+  return retCode;
+}
+
+bool rmtWriteBytes(int pin, const uint8_t *data, size_t len, uint32_t timeout_ms) {
+  return _rmtWrite(pin, data, len, true /*bytes*/, true /*blocks*/, false /*looping*/, timeout_ms);
+}
+
+bool rmtWriteBytesAsync(int pin, const uint8_t *data, size_t len) {
+  return _rmtWrite(pin, data, len, true /*bytes*/, false /*blocks*/, false /*looping*/, 0 /*N/A*/);
 }
 
 bool rmtTransmitCompleted(int pin) {
@@ -429,6 +570,19 @@ bool rmtTransmitCompleted(int pin) {
   return retCode;
 }
 
+bool rmtWaitTransmitCompleted(int pin, uint32_t timeout_ms) {
+  rmt_bus_handle_t bus = _rmtGetBus(pin, __FUNCTION__);
+  if (bus == NULL) {
+    return false;
+  }
+  if (!_rmtCheckDirection(pin, RMT_TX_MODE, __FUNCTION__)) {
+    return false;
+  }
+  // not locked: a blocking write would hold the lock for the whole wait
+  return (xEventGroupWaitBits(bus->rmt_events, RMT_FLAG_TX_DONE, pdFALSE /* do not clear on exit */, pdFALSE /* wait for all bits */, timeout_ms) & RMT_FLAG_TX_DONE)
+         != 0;
+}
+
 bool rmtRead(int pin, rmt_data_t *data, size_t *num_rmt_symbols, uint32_t timeout_ms) {
   return _rmtRead(pin, data, num_rmt_symbols, true /* blocking */, timeout_ms);
 }
@@ -453,7 +607,7 @@ bool rmtReceiveCompleted(int pin) {
   return retCode;
 }
 
-bool rmtInit(int pin, rmt_ch_dir_t channel_direction, rmt_reserve_memsize_t mem_size, uint32_t frequency_Hz) {
+static bool _rmtInit(int pin, rmt_ch_dir_t channel_direction, rmt_reserve_memsize_t mem_size, uint32_t frequency_Hz, bool with_dma) {
   log_v(
     "GPIO %d - %s - MemSize[%d] - Freq=%dHz", pin, channel_direction == RMT_RX_MODE ? "RX MODE" : "TX MODE", mem_size * RMT_SYMBOLS_PER_CHANNEL_BLOCK,
     frequency_Hz
@@ -474,7 +628,7 @@ bool rmtInit(int pin, rmt_ch_dir_t channel_direction, rmt_reserve_memsize_t mem_
   if (rmt_bus_type == ESP32_BUS_TYPE_RMT_TX || rmt_bus_type == ESP32_BUS_TYPE_RMT_RX) {
     rmt_ch_dir_t bus_rmt_dir = rmt_bus_type == ESP32_BUS_TYPE_RMT_TX ? RMT_TX_MODE : RMT_RX_MODE;
     bus = (rmt_bus_handle_t)perimanGetPinBus(pin, rmt_bus_type);
-    if (bus->frequency_Hz == frequency_Hz && bus_rmt_dir == channel_direction && bus->mem_size == mem_size) {
+    if (bus->frequency_Hz == frequency_Hz && bus_rmt_dir == channel_direction && bus->mem_size == mem_size && bus->with_dma == with_dma) {
       return true;  // already initialized with the same parameters
     }
   }
@@ -515,6 +669,7 @@ bool rmtInit(int pin, rmt_ch_dir_t channel_direction, rmt_reserve_memsize_t mem_
   // store the RMT Freq and mem_size to check Initialization, Filter and Idle valid values in the RMT API
   bus->frequency_Hz = frequency_Hz;
   bus->mem_size = mem_size;
+  bus->with_dma = with_dma;
   // pulses with width smaller than min_ns will be ignored (as a glitch)
   //bus->signal_range_min_ns = 0; // disabled  --> not necessary CALLOC set all to ZERO.
   // RMT stops reading if the input stays idle for longer than max_ns
@@ -538,10 +693,11 @@ bool rmtInit(int pin, rmt_ch_dir_t channel_direction, rmt_reserve_memsize_t mem_
     // CLK_APB for ESP32|S2|S3|C3 -- CLK_PLL_F80M for C6 -- CLK_XTAL for H2
     tx_cfg.clk_src = RMT_CLK_SRC_DEFAULT;
     tx_cfg.resolution_hz = frequency_Hz;
-    tx_cfg.mem_block_symbols = SOC_RMT_MEM_WORDS_PER_CHANNEL * mem_size;
+    // with DMA, this is the size of the DMA buffer
+    tx_cfg.mem_block_symbols = with_dma ? RMT_DMA_SYMBOLS : SOC_RMT_MEM_WORDS_PER_CHANNEL * mem_size;
     tx_cfg.trans_queue_depth = 10;  // maximum allowed
     tx_cfg.flags.invert_out = 0;
-    tx_cfg.flags.with_dma = 0;
+    tx_cfg.flags.with_dma = with_dma;
     tx_cfg.flags.io_loop_back = 0;
     tx_cfg.flags.io_od_mode = 0;
 #if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 1, 2)
@@ -633,4 +789,14 @@ Err:
   return false;
 }
 
+bool rmtInit(int pin, rmt_ch_dir_t channel_direction, rmt_reserve_memsize_t mem_size, uint32_t frequency_Hz) {
+  return _rmtInit(pin, channel_direction, mem_size, frequency_Hz, false);
+}
+
+#if SOC_RMT_SUPPORT_DMA
+bool rmtInitDMA(int pin, uint32_t frequency_Hz) {
+  return _rmtInit(pin, RMT_TX_MODE, RMT_MEM_NUM_BLOCKS_1, frequency_Hz, true);
+}
+#endif
+
 #endif /* SOC_RMT_SUPPORTED */
@@ -76,6 +76,17 @@ typedef union {
 */
 bool rmtInit(int pin, rmt_ch_dir_t channel_direction, rmt_reserve_memsize_t memsize, uint32_t frequency_Hz);
 
+#if SOC_RMT_SUPPORT_DMA
+/**
+    Initialize a TX channel that reads its RMT symbols with DMA
+    The CPU does not refill the channel memory during the transmission, which keeps long
+    transmissions steady under interrupt load. Only some SoCs (e.g. ESP32-S3) have a DMA capable
+    RMT channel, and only one.
+    Returns <true> on execution success, <false> otherwise
+*/
+bool rmtInitDMA(int pin, uint32_t frequency_Hz);
+#endif
+
 /**
      Sets the End of Transmission level to be set for the <pin> when the RMT transmission ends.
      This function affects how rmtWrite(), rmtWriteAsync() or rmtWriteLooping() will set the pin after writing the data.
@@ -137,6 +148,30 @@ bool rmtWriteAsync(int pin, rmt_data_t *data, size_t num_rmt_symbols);
 */
 bool rmtWriteLooping(int pin, rmt_data_t *data, size_t num_rmt_symbols);
 
+/**
+     Sets the encoder used by rmtWriteBytes() and rmtWriteBytesAsync() for the TX <pin>.
+     Each bit of the data, most significant bit first, is sent as the RMT symbol <bit0> or <bit1>.
+     The data keeps its compact form (1 byte instead of 8 RMT symbols) and is encoded while it is sent.
+     When <trailer> is not NULL, this symbol is sent after the data of every write, for instance the
+     reset (latch) time of addressable LEDs.
+
+     Returns <true> on execution success, <false> otherwise.
+*/
+bool rmtSetBytesEncoder(int pin, rmt_data_t bit0, rmt_data_t bit1, const rmt_data_t *trailer);
+
+/**
+     Sending <len> bytes of <data> in Blocking Mode, through the encoder set with rmtSetBytesEncoder().
+     Timeout and return value are the same as rmtWrite().
+*/
+bool rmtWriteBytes(int pin, const uint8_t *data, size_t len, uint32_t timeout_ms);
+
+/**
+     Sending <len> bytes of <data> in Async Mode, through the encoder set with rmtSetBytesEncoder().
+     <data> is read during the transmission and must not change until rmtTransmitCompleted() returns <true>.
+     Behaves as rmtWriteAsync() otherwise.
+*/
+bool rmtWriteBytesAsync(int pin, const uint8_t *data, size_t len);
+
 /**
      Checks if transmission is completed and the rmtChannel ready for transmitting new data.
      To be ready for a new transmission, means that the previous transmission is completed.
@@ -149,6 +184,12 @@ bool rmtWriteLooping(int pin, rmt_data_t *data, size_t num_rmt_symbols);
 */
 bool rmtTransmitCompleted(int pin);
 
+/**
+     Waits up to <timeout_ms> for the transmission of the <pin> to complete, without polling.
+     Returns <true> when the channel is ready for new data, <false> otherwise, including on timeout.
+*/
+bool rmtWaitTransmitCompleted(int pin, uint32_t timeout_ms);
+
 /**
      Initiates blocking receive. Read data will be stored in a user provided buffer <*data>
      It will read up to <num_rmt_symbols> RMT Symbols and the value of this variable will
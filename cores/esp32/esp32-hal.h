@@ -111,6 +111,11 @@ float temperatureRead();
 //allows user to bypass SPI RAM test routine
 bool testSPIRAM(void);
 
+//initializes the default NVS partition, formatting it when it is broken. Only the first call does the work
+bool initNvs(void);
+//return true (or enable CONFIG_ARDUINO_DEFER_NVS_INIT) to skip NVS at boot and let the first user initialize it
+bool deferNvsInit(void);
+
 #if CONFIG_AUTOSTART_ARDUINO
 //enable/disable WDT for Arduino's setup and loop functions
 void enableLoopWDT();
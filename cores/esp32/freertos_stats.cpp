@@ -14,10 +14,15 @@
 
 #include "freertos_stats.h"
 #include "sdkconfig.h"
+#include "esp_attr.h"
+#include "esp_cpu.h"
+#include "esp_timer.h"
+#include "esp32-hal.h"
 
 #if CONFIG_FREERTOS_USE_TRACE_FACILITY
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/semphr.h"
 #include "freertos/portable.h"
 #endif /* CONFIG_FREERTOS_USE_TRACE_FACILITY */
 
@@ -110,3 +115,372 @@ void printRunningTasks(Print &printer) {
   printer.println("FreeRTOS trace facility is not enabled.");
 #endif /* CONFIG_FREERTOS_USE_TRACE_FACILITY */
 }
+
+/*
+ * Continuous task profiler
+ */
+
+static volatile bool _isr_accounting = false;
+static uint32_t _isr_start[portNUM_PROCESSORS];
+static uint32_t _isr_cycles[portNUM_PROCESSORS];
+static uint8_t _isr_nesting[portNUM_PROCESSORS];
+static portMUX_TYPE _isr_mux = portMUX_INITIALIZER_UNLOCKED;
+
+void IRAM_ATTR taskProfilerIsrEnter(void) {
+  if (!_isr_accounting) {
+    return;
+  }
+  uint32_t core = xPortGetCoreID();
+  if (_isr_nesting[core]++ == 0) {
+    _isr_start[core] = esp_cpu_get_cycle_count();
+  }
+}
+
+void IRAM_ATTR taskProfilerIsrExit(void) {
+  if (!_isr_accounting) {
+    return;
+  }
+  uint32_t core = xPortGetCoreID();
+  if (_isr_nesting[core] && --_isr_nesting[core] == 0) {
+    uint32_t cycles = esp_cpu_get_cycle_count() - _isr_start[core];
+    portENTER_CRITICAL_ISR(&_isr_mux);
+    _isr_cycles[core] += cycles;
+    portEXIT_CRITICAL_ISR(&_isr_mux);
+  }
+}
+
+#if CONFIG_FREERTOS_USE_TRACE_FACILITY
+
+typedef struct {
+  UBaseType_t number;
+  configRUN_TIME_COUNTER_TYPE counter;
+} task_profile_counter_t;
+
+static esp_timer_handle_t _profiler_timer = NULL;
+static SemaphoreHandle_t _profiler_lock = NULL;
+static uint8_t *_profiler_mem = NULL;
+static TaskStatus_t *_profiler_status = NULL;
+static task_profile_counter_t *_profiler_counters = NULL;
+static task_profile_counter_t *_profiler_counters_next = NULL;
+static uint8_t *_profiler_ring = NULL;
+static task_profile_sample_t *_profiler_export = NULL;  // one slot that taskProfilerExport() copies samples to
+static volatile bool _profiler_running = false;
+static volatile bool _profiler_busy = false;  // a sample is being taken, guarded by _isr_mux
+static size_t _profiler_slot_size = 0;
+static uint16_t _profiler_max_tasks = 0;
+static uint16_t _profiler_depth = 0;
+static uint16_t _profiler_head = 0;
+static uint16_t _profiler_count = 0;
+static uint16_t _profiler_prev_count = 0;
+static uint32_t _profiler_dropped = 0;
+static configRUN_TIME_COUNTER_TYPE _profiler_last_total = 0;
+static int64_t _profiler_last_us = 0;
+
+static inline task_profile_sample_t *profilerSlot(uint16_t index) {
+  return (task_profile_sample_t *)(_profiler_ring + index * _profiler_slot_size);
+}
+
+static inline task_profile_entry_t *profilerEntries(task_profile_sample_t *sample) {
+  return (task_profile_entry_t *)(sample + 1);
+}
+
+// stores a sample in the ring, called with _profiler_lock held
+static void profilerSampleLocked(configRUN_TIME_COUNTER_TYPE total, UBaseType_t n, int64_t now_us, const uint32_t *isr_cycles) {
+  if (_profiler_count == _profiler_depth) {
+    _profiler_count--;  // overwrite the oldest sample
+    _profiler_dropped++;
+  }
+  task_profile_sample_t *sample = profilerSlot(_profiler_head);
+  task_profile_entry_t *entries = profilerEntries(sample);
+  configRUN_TIME_COUNTER_TYPE elapsed = total - _profiler_last_total;
+
+  sample->timestamp_ms = millis();
+  sample->period_us = (uint32_t)(now_us - _profiler_last_us);
+  sample->task_count = n;
+  uint32_t mhz = getCpuFrequencyMhz();
+  for (int c = 0; c < portNUM_PROCESSORS; c++) {
+    sample->idle_permille[c] = 0;
+    sample->isr_us[c] = mhz ? isr_cycles[c] / mhz : 0;
+  }
+
+  for (UBaseType_t i = 0; i < n; i++) {
+    TaskStatus_t *status = &_profiler_status[i];
+    task_profile_entry_t *entry = &entries[i];
+    strncpy(entry->name, status->pcTaskName, configMAX_TASK_NAME_LEN - 1);
+    entry->name[configMAX_TASK_NAME_LEN - 1] = 0;
+    entry->number = status->xTaskNumber;
+    entry->stack_free = status->usStackHighWaterMark;
+    entry->priority = status->uxCurrentPriority;
+#if CONFIG_FREERTOS_VTASKLIST_INCLUDE_COREID
+    entry->core = (status->xCoreID == tskNO_AFFINITY) ? -1 : status->xCoreID;
+#else
+    entry->core = -1;
+#endif
+    entry->load_permille = 0;
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+    for (uint16_t j = 0; j < _profiler_prev_count; j++) {
+      if (_profiler_counters[j].number == status->xTaskNumber) {
+        if (elapsed) {
+          entry->load_permille = (uint64_t)(status->ulRunTimeCounter - _profiler_counters[j].counter) * 1000 / elapsed;
+        }
+        break;
+      }
+    }
+    _profiler_counters_next[i].number = status->xTaskNumber;
+    _profiler_counters_next[i].counter = status->ulRunTimeCounter;
+    for (int c = 0; c < portNUM_PROCESSORS; c++) {
+      if (status->xHandle == xTaskGetIdleTaskHandleForCore(c)) {
+        sample->idle_permille[c] = entry->load_permille;
+      }
+    }
+#endif
+  }
+
+  _profiler_head = (_profiler_head + 1) % _profiler_depth;
+  _profiler_count++;
+
+  task_profile_counter_t *counters = _profiler_counters;
+  _profiler_counters = _profiler_counters_next;
+  _profiler_counters_next = counters;
+  _profiler_prev_count = n;
+  _profiler_last_total = total;
+  _profiler_last_us = now_us;
+}
+
+static void profilerSample(void *arg) {
+  // taskProfilerEnd() waits for a sample in progress before releasing the buffers
+  portENTER_CRITICAL(&_isr_mux);
+  bool running = _profiler_running;
+  _profiler_busy = running;
+  portEXIT_CRITICAL(&_isr_mux);
+  if (!running) {
+    return;
+  }
+
+  configRUN_TIME_COUNTER_TYPE total = 0;
+  UBaseType_t n = uxTaskGetSystemState(_profiler_status, _profiler_max_tasks, &total);
+  if (n == 0) {
+    log_w("More than %u tasks, sample skipped", _profiler_max_tasks);
+  } else {
+    int64_t now_us = esp_timer_get_time();
+    uint32_t isr_cycles[portNUM_PROCESSORS];
+    portENTER_CRITICAL(&_isr_mux);
+    for (int c = 0; c < portNUM_PROCESSORS; c++) {
+      isr_cycles[c] = _isr_cycles[c];
+      _isr_cycles[c] = 0;
+    }
+    portEXIT_CRITICAL(&_isr_mux);
+
+    if (xSemaphoreTake(_profiler_lock, 0) == pdTRUE) {
+      profilerSampleLocked(total, n, now_us, isr_cycles);
+      xSemaphoreGive(_profiler_lock);
+    } else {
+      _profiler_dropped++;  // a reader holds the ring, try again next period
+    }
+  }
+
+  portENTER_CRITICAL(&_isr_mux);
+  _profiler_busy = false;
+  portEXIT_CRITICAL(&_isr_mux);
+}
+
+bool taskProfilerBegin(uint32_t period_ms, uint16_t max_tasks, uint16_t depth, bool isr_accounting) {
+  if (_profiler_timer != NULL) {
+    log_e("Task profiler already running");
+    return false;
+  }
+  if (period_ms == 0 || max_tasks == 0 || depth == 0) {
+    log_e("Invalid task profiler parameters");
+    return false;
+  }
+
+  _profiler_slot_size = sizeof(task_profile_sample_t) + max_tasks * sizeof(task_profile_entry_t);
+  size_t status_size = max_tasks * sizeof(TaskStatus_t);
+  size_t counters_size = max_tasks * sizeof(task_profile_counter_t);
+  _profiler_mem = (uint8_t *)malloc(status_size + 2 * counters_size + (depth + 1) * _profiler_slot_size);
+  _profiler_lock = xSemaphoreCreateMutex();
+  if (_profiler_mem == NULL || _profiler_lock == NULL) {
+    log_e("Task profiler allocation failed");
+    taskProfilerEnd();
+    return false;
+  }
+  _profiler_status = (TaskStatus_t *)_profiler_mem;
+  _profiler_counters = (task_profile_counter_t *)(_profiler_mem + status_size);
+  _profiler_counters_next = (task_profile_counter_t *)(_profiler_mem + status_size + counters_size);
+  _profiler_ring = _profiler_mem + status_size + 2 * counters_size;
+  _profiler_export = (task_profile_sample_t *)(_profiler_ring + depth * _profiler_slot_size);
+  _profiler_max_tasks = max_tasks;
+  _profiler_depth = depth;
+  _profiler_head = 0;
+  _profiler_count = 0;
+  _profiler_prev_count = 0;
+  _profiler_dropped = 0;
+  _profiler_last_total = 0;
+  _profiler_last_us = esp_timer_get_time();
+
+  memset(_isr_cycles, 0, sizeof(_isr_cycles));
+  memset(_isr_nesting, 0, sizeof(_isr_nesting));
+  _isr_accounting = isr_accounting;
+
+  // the first sample only primes the run time counters
+  _profiler_running = true;
+  profilerSample(NULL);
+  _profiler_count = 0;
+  _profiler_head = 0;
+
+  esp_timer_create_args_t args = {};
+  args.callback = profilerSample;
+  args.dispatch_method = ESP_TIMER_TASK;
+  args.name = "task_profiler";
+  if (esp_timer_create(&args, &_profiler_timer) != ESP_OK || esp_timer_start_periodic(_profiler_timer, (uint64_t)period_ms * 1000) != ESP_OK) {
+    log_e("Task profiler timer start failed");
+    taskProfilerEnd();
+    return false;
+  }
+  return true;
+}
+
+void taskProfilerEnd() {
+  _isr_accounting = false;
+  portENTER_CRITICAL(&_isr_mux);
+  _profiler_running = false;
+  portEXIT_CRITICAL(&_isr_mux);
+  if (_profiler_timer != NULL) {
+    esp_timer_stop(_profiler_timer);
+    esp_timer_delete(_profiler_timer);
+    _profiler_timer = NULL;
+  }
+  // a callback dispatched before the timer was stopped may still be running
+  while (_profiler_busy) {
+    vTaskDelay(1);
+  }
+  if (_profiler_lock != NULL) {
+    // wait for a reader to leave the ring
+    xSemaphoreTake(_profiler_lock, portMAX_DELAY);
+  }
+  free(_profiler_mem);
+  _profiler_mem = NULL;
+  _profiler_ring = NULL;
+  _profiler_export = NULL;
+  _profiler_count = 0;
+  if (_profiler_lock != NULL) {
+    xSemaphoreGive(_profiler_lock);
+    vSemaphoreDelete(_profiler_lock);
+    _profiler_lock = NULL;
+  }
+}
+
+size_t taskProfilerAvailable() {
+  return _profiler_count;
+}
+
+uint32_t taskProfilerDropped() {
+  return _profiler_dropped;
+}
+
+bool taskProfilerRead(task_profile_sample_t *sample, task_profile_entry_t *entries, size_t max_entries) {
+  if (_profiler_lock == NULL || sample == NULL || xSemaphoreTake(_profiler_lock, portMAX_DELAY) != pdTRUE) {
+    return false;
+  }
+  if (_profiler_count == 0) {
+    xSemaphoreGive(_profiler_lock);
+    return false;
+  }
+  uint16_t tail = (_profiler_head + _profiler_depth - _profiler_count) % _profiler_depth;
+  task_profile_sample_t *slot = profilerSlot(tail);
+  *sample = *slot;
+  if (entries != NULL) {
+    if (sample->task_count > max_entries) {
+      sample->task_count = max_entries;
+    }
+    memcpy(entries, profilerEntries(slot), sample->task_count * sizeof(task_profile_entry_t));
+  }
+  _profiler_count--;
+  xSemaphoreGive(_profiler_lock);
+  return true;
+}
+
+template<typename T> static void exportValue(Print &out, T value) {
+  out.write((const uint8_t *)&value, sizeof(value));
+}
+
+size_t taskProfilerExport(Print &out, task_profile_format_t format) {
+  if (_profiler_lock == NULL || _profiler_export == NULL) {
+    return 0;
+  }
+  task_profile_sample_t &sample = *_profiler_export;
+  task_profile_entry_t *entries = profilerEntries(_profiler_export);
+  size_t exported = 0;
+  if (format == TASK_PROFILE_CSV) {
+    out.print("ms,task,name,load,stack,prio,core\r\n");
+  }
+  while (taskProfilerRead(&sample, entries, _profiler_max_tasks)) {
+    if (format == TASK_PROFILE_CSV) {
+      for (uint16_t i = 0; i < sample.task_count; i++) {
+        task_profile_entry_t *e = &entries[i];
+        out.printf("%lu,%u,%s,%u,%lu,%u,%d\r\n", sample.timestamp_ms, e->number, e->name, e->load_permille, e->stack_free, e->priority, e->core);
+      }
+      if (_isr_accounting) {
+        for (int c = 0; c < portNUM_PROCESSORS; c++) {
+          uint32_t load = sample.period_us ? (uint64_t)sample.isr_us[c] * 1000 / sample.period_us : 0;
+          out.printf("%lu,0,ISR%d,%lu,0,0,%d\r\n", sample.timestamp_ms, c, load, c);
+        }
+      }
+    } else {
+      // 'T' 'P' version cores, then little endian without padding:
+      // timestamp, period, task count, idle per mille and ISR time per core,
+      // then per task: number, load, stack, priority, core, name length, name
+      const uint8_t magic[4] = {'T', 'P', 1, portNUM_PROCESSORS};
+      out.write(magic, sizeof(magic));
+      exportValue(out, sample.timestamp_ms);
+      exportValue(out, sample.period_us);
+      exportValue(out, sample.task_count);
+      for (int c = 0; c < portNUM_PROCESSORS; c++) {
+        exportValue(out, sample.idle_permille[c]);
+      }
+      for (int c = 0; c < portNUM_PROCESSORS; c++) {
+        exportValue(out, sample.isr_us[c]);
+      }
+      for (uint16_t i = 0; i < sample.task_count; i++) {
+        task_profile_entry_t *e = &entries[i];
+        uint8_t name_len = strlen(e->name);
+        exportValue(out, e->number);
+        exportValue(out, e->load_permille);
+        exportValue(out, e->stack_free);
+        out.write(e->priority);
+        out.write((uint8_t)e->core);
+        out.write(name_len);
+        out.write((const uint8_t *)e->name, name_len);
+      }
+    }
+    exported++;
+  }
+  return exported;
+}
+
+#else /* CONFIG_FREERTOS_USE_TRACE_FACILITY */
+
+bool taskProfilerBegin(uint32_t period_ms, uint16_t max_tasks, uint16_t depth, bool isr_accounting) {
+  log_e("FreeRTOS trace facility is not enabled.");
+  return false;
+}
+
+void taskProfilerEnd() {}
+
+size_t taskProfilerAvailable() {
+  return 0;
+}
+
+uint32_t taskProfilerDropped() {
+  return 0;
+}
+
+bool taskProfilerRead(task_profile_sample_t *sample, task_profile_entry_t *entries, size_t max_entries) {
+  return false;
+}
+
+size_t taskProfilerExport(Print &out, task_profile_format_t format) {
+  return 0;
+}
+
+#endif /* CONFIG_FREERTOS_USE_TRACE_FACILITY */
@@ -14,7 +14,24 @@
 
 #pragma once
 
+#include <stdint.h>
+#include <stddef.h>
+#include "freertos/FreeRTOS.h"
+
 #ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Optional ISR time accounting for the task profiler.
+ * Call at the very start and the very end of an interrupt handler (both are IRAM safe).
+ * The time is reported per core in each profiler sample.
+ */
+void taskProfilerIsrEnter(void);
+void taskProfilerIsrExit(void);
+
+#ifdef __cplusplus
+}
 
 #include "Print.h"
 
@@ -25,4 +42,61 @@
  */
 void printRunningTasks(Print &printer);
 
+/*
+ * Continuous task profiler
+ *
+ * Samples the state of all tasks at a fixed period into a preallocated ring.
+ * CPU load needs CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS and is reported in per mille
+ * of one core, so the loads of all tasks add up to 1000 per core.
+ * When the ring is full the oldest sample is overwritten.
+ */
+typedef enum {
+  TASK_PROFILE_CSV,
+  TASK_PROFILE_BINARY
+} task_profile_format_t;
+
+typedef struct {
+  uint32_t timestamp_ms;                       // millis() when the sample was taken
+  uint32_t period_us;                          // time covered by the sample
+  uint16_t task_count;                         // number of valid entries
+  uint16_t idle_permille[portNUM_PROCESSORS];  // load of the idle task of each core
+  uint32_t isr_us[portNUM_PROCESSORS];         // time spent between taskProfilerIsrEnter() and taskProfilerIsrExit()
+} task_profile_sample_t;
+
+typedef struct {
+  char name[configMAX_TASK_NAME_LEN];
+  uint16_t number;
+  uint16_t load_permille;
+  uint32_t stack_free;  // minimum free stack space (high water mark) in bytes
+  uint8_t priority;
+  int8_t core;  // -1 if the task is not pinned
+} task_profile_entry_t;
+
+/*
+ * Start sampling every period_ms.
+ * max_tasks limits the number of tasks recorded per sample, depth is the number of samples kept.
+ * All memory is allocated here.
+ */
+bool taskProfilerBegin(uint32_t period_ms, uint16_t max_tasks = 24, uint16_t depth = 8, bool isr_accounting = false);
+void taskProfilerEnd();
+
+// number of samples waiting to be read
+size_t taskProfilerAvailable();
+// samples overwritten before they were read
+uint32_t taskProfilerDropped();
+
+/*
+ * Pop the oldest sample. Up to max_entries task entries are copied to entries.
+ * Returns false if there is no sample.
+ */
+bool taskProfilerRead(task_profile_sample_t *sample, task_profile_entry_t *entries, size_t max_entries);
+
+/*
+ * Pop all pending samples and write them to out.
+ * CSV has a header line and one line per task and sample, ISR time is reported as the pseudo tasks ISR0, ISR1.
+ * Samples are staged in a slot reserved by taskProfilerBegin(), so only one task may export at a time.
+ * Returns the number of samples written.
+ */
+size_t taskProfilerExport(Print &out, task_profile_format_t format = TASK_PROFILE_CSV);
+
 #endif
@@ -0,0 +1,266 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "loop_monitor.h"
+#include <string.h>
+#include "sdkconfig.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "esp32-hal.h"
+
+#ifdef CONFIG_ESP_TASK_WDT_TIMEOUT_S
+#define LOOP_STALL_DEFAULT_MS (CONFIG_ESP_TASK_WDT_TIMEOUT_S * 1000 / 2)
+#else
+#define LOOP_STALL_DEFAULT_MS 2500
+#endif
+
+typedef struct {
+  micro_task_cb_t cb;
+  void *arg;
+  int64_t next_us;
+  micro_task_stats_t stats;
+} micro_task_t;
+
+static portMUX_TYPE loop_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static bool stats_enabled = false;
+static int64_t last_iteration_us = 0;
+static uint32_t iteration_micro_us = 0;
+static loop_stats_t loop_stats = {0, 0, 0, 0, 0, 0, LOOP_STALL_DEFAULT_MS, {0}};
+
+static micro_task_t micro_tasks[MICRO_TASK_MAX];
+static volatile uint8_t micro_task_count = 0;
+static uint8_t micro_task_next = 0;  // first task checked in the next run, so a full budget does not starve the others
+static uint32_t micro_task_budget_us = 1000;
+static bool micro_task_running = false;
+
+void enableLoopStats() {
+  last_iteration_us = 0;
+  stats_enabled = true;
+}
+
+void disableLoopStats() {
+  stats_enabled = false;
+}
+
+void resetLoopStats() {
+  portENTER_CRITICAL(&loop_mux);
+  uint32_t threshold_ms = loop_stats.threshold_ms;
+  memset(&loop_stats, 0, sizeof(loop_stats));
+  loop_stats.threshold_ms = threshold_ms;
+  last_iteration_us = 0;
+  portEXIT_CRITICAL(&loop_mux);
+}
+
+void setLoopStallThreshold(uint32_t ms) {
+  portENTER_CRITICAL(&loop_mux);
+  loop_stats.threshold_ms = ms;
+  portEXIT_CRITICAL(&loop_mux);
+}
+
+bool getLoopStats(loop_stats_t *stats) {
+  if (stats == NULL) {
+    return false;
+  }
+  portENTER_CRITICAL(&loop_mux);
+  *stats = loop_stats;
+  portEXIT_CRITICAL(&loop_mux);
+  return true;
+}
+
+static void recordIteration(uint32_t duration_us) {
+  uint32_t bucket = 0;
+  if (duration_us >= 16) {
+    bucket = (31 - __builtin_clz(duration_us)) - 3;
+    if (bucket >= LOOP_STATS_BUCKETS) {
+      bucket = LOOP_STATS_BUCKETS - 1;
+    }
+  }
+  bool near_miss = false;
+  portENTER_CRITICAL(&loop_mux);
+  loop_stats.iterations++;
+  loop_stats.total_us += duration_us;
+  loop_stats.histogram[bucket]++;
+  if (duration_us > loop_stats.max_us) {
+    loop_stats.max_us = duration_us;
+    loop_stats.max_at_ms = millis();
+    loop_stats.max_micro_us = iteration_micro_us;
+  }
+  if (loop_stats.threshold_ms && duration_us >= loop_stats.threshold_ms * 1000) {
+    loop_stats.near_misses++;
+    near_miss = true;
+  }
+  portEXIT_CRITICAL(&loop_mux);
+  if (near_miss) {
+    log_w("loop() stalled for %lu ms (micro tasks %lu us)", duration_us / 1000, iteration_micro_us);
+  }
+}
+
+void loopMonitorIteration() {
+  if (micro_task_count) {
+    microTaskRun();
+  }
+  if (!stats_enabled) {
+    return;
+  }
+  int64_t now = esp_timer_get_time();
+  if (last_iteration_us) {
+    recordIteration((uint32_t)(now - last_iteration_us));
+  }
+  last_iteration_us = now;
+  iteration_micro_us = 0;
+}
+
+void printLoopStats(Print &printer) {
+  loop_stats_t stats;
+  getLoopStats(&stats);
+  printer.printf(
+    "Loop: %lu iterations, avg %lu us, max %lu us at %lu ms (micro tasks %lu us), near misses %lu (>= %lu ms)\n", stats.iterations,
+    stats.iterations ? (uint32_t)(stats.total_us / stats.iterations) : 0, stats.max_us, stats.max_at_ms, stats.max_micro_us, stats.near_misses,
+    stats.threshold_ms
+  );
+  for (int i = 0; i < LOOP_STATS_BUCKETS; i++) {
+    if (!stats.histogram[i]) {
+      continue;
+    }
+    if (i == LOOP_STATS_BUCKETS - 1) {
+      printer.printf("  >= %8lu us: %lu\n", (uint32_t)(16UL << (i - 1)), stats.histogram[i]);
+    } else {
+      printer.printf("  <  %8lu us: %lu\n", (uint32_t)(16UL << i), stats.histogram[i]);
+    }
+  }
+  for (int i = 0; i < MICRO_TASK_MAX; i++) {
+    micro_task_stats_t task;
+    if (microTaskGetStats(i, &task)) {
+      printer.printf(
+        "  %-16s every %5lu ms, runs %lu, late %lu, max %lu us\n", task.name ? task.name : "?", task.period_ms, task.runs, task.late, task.max_us
+      );
+    }
+  }
+}
+
+int microTaskAdd(const char *name, micro_task_cb_t cb, uint32_t period_ms, void *arg) {
+  if (cb == NULL) {
+    log_e("Invalid callback");
+    return -1;
+  }
+  int id = -1;
+  portENTER_CRITICAL(&loop_mux);
+  for (int i = 0; i < MICRO_TASK_MAX; i++) {
+    micro_task_t &t = micro_tasks[i];
+    if (t.cb == NULL) {
+      memset(&t, 0, sizeof(t));
+      t.arg = arg;
+      t.next_us = esp_timer_get_time() + (int64_t)period_ms * 1000;
+      t.stats.name = name;
+      t.stats.period_ms = period_ms;
+      t.cb = cb;
+      micro_task_count++;
+      id = i;
+      break;
+    }
+  }
+  portEXIT_CRITICAL(&loop_mux);
+  if (id < 0) {
+    log_e("No free micro task slot");
+  }
+  return id;
+}
+
+bool microTaskRemove(int id) {
+  if (id < 0 || id >= MICRO_TASK_MAX) {
+    return false;
+  }
+  bool removed = false;
+  portENTER_CRITICAL(&loop_mux);
+  if (micro_tasks[id].cb != NULL) {
+    micro_tasks[id].cb = NULL;
+    micro_task_count--;
+    removed = true;
+  }
+  portEXIT_CRITICAL(&loop_mux);
+  return removed;
+}
+
+void microTaskSetBudget(uint32_t budget_us) {
+  micro_task_budget_us = budget_us;
+}
+
+bool microTaskGetStats(int id, micro_task_stats_t *stats) {
+  if (id < 0 || id >= MICRO_TASK_MAX || stats == NULL) {
+    return false;
+  }
+  portENTER_CRITICAL(&loop_mux);
+  bool used = micro_tasks[id].cb != NULL;
+  *stats = micro_tasks[id].stats;
+  portEXIT_CRITICAL(&loop_mux);
+  return used;
+}
+
+void microTaskRun() {
+  if (micro_task_running) {
+    return;  // called from a micro task
+  }
+  micro_task_running = true;
+  int64_t start = esp_timer_get_time();
+  int64_t now = start;
+  uint8_t first = micro_task_next;
+  bool ran = false;
+  for (int n = 0; n < MICRO_TASK_MAX; n++) {
+    int i = (first + n) % MICRO_TASK_MAX;
+    micro_task_cb_t cb = NULL;
+    void *arg = NULL;
+
+    portENTER_CRITICAL(&loop_mux);
+    micro_task_t &t = micro_tasks[i];
+    if (t.cb != NULL && t.next_us <= now) {
+      // the first due task always runs, so a single slow task cannot block the others forever
+      if (micro_task_budget_us && ran && (now - start) >= micro_task_budget_us) {
+        micro_task_next = i;  // out of budget, this one goes first next time
+        portEXIT_CRITICAL(&loop_mux);
+        break;
+      }
+      int64_t period_us = (int64_t)t.stats.period_ms * 1000;
+      if (now - t.next_us > period_us) {
+        t.stats.late++;
+      }
+      t.next_us += period_us;
+      if (t.next_us <= now) {
+        t.next_us = now + period_us;  // do not run back to back to catch up
+      }
+      cb = t.cb;
+      arg = t.arg;
+    }
+    portEXIT_CRITICAL(&loop_mux);
+
+    if (cb == NULL) {
+      continue;
+    }
+    cb(arg);
+    ran = true;
+    int64_t end = esp_timer_get_time();
+    uint32_t run_us = (uint32_t)(end - now);
+    portENTER_CRITICAL(&loop_mux);
+    if (micro_tasks[i].cb == cb) {
+      micro_tasks[i].stats.runs++;
+      if (run_us > micro_tasks[i].stats.max_us) {
+        micro_tasks[i].stats.max_us = run_us;
+      }
+    }
+    portEXIT_CRITICAL(&loop_mux);
+    now = end;
+  }
+  iteration_micro_us += (uint32_t)(now - start);
+  micro_task_running = false;
+}
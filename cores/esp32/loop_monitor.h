@@ -0,0 +1,79 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "Print.h"
+
+/*
+ * Loop task statistics
+ *
+ * Measures every pass of loopTask (loop(), serialEventRun() and the micro tasks below).
+ * Disabled by default, the cost when enabled is one timer read per iteration.
+ */
+#define LOOP_STATS_BUCKETS 16  // bucket 0: < 16 us, bucket n: < (16 << n) us, the last one holds everything longer
+
+typedef struct {
+  uint32_t iterations;
+  uint64_t total_us;
+  uint32_t max_us;          // longest iteration
+  uint32_t max_at_ms;       // millis() at the end of the longest iteration
+  uint32_t max_micro_us;    // part of the longest iteration spent in micro tasks
+  uint32_t near_misses;     // iterations longer than threshold_ms
+  uint32_t threshold_ms;    // half of the task WDT timeout unless set with setLoopStallThreshold()
+  uint32_t histogram[LOOP_STATS_BUCKETS];
+} loop_stats_t;
+
+void enableLoopStats();
+void disableLoopStats();
+void resetLoopStats();
+// Iterations longer than ms are counted as WDT near misses and logged as a warning
+void setLoopStallThreshold(uint32_t ms);
+bool getLoopStats(loop_stats_t *stats);
+void printLoopStats(Print &printer);
+
+/*
+ * Cooperative micro tasks
+ *
+ * Short periodic jobs that run in the loop task between two loop() iterations, in place of
+ * millis() polling inside loop(). Every iteration runs the tasks that are due until the
+ * budget is used up, the rest run in the next iteration. A micro task that blocks delays loop().
+ */
+#ifndef MICRO_TASK_MAX
+#define MICRO_TASK_MAX 16
+#endif
+
+typedef void (*micro_task_cb_t)(void *arg);
+
+typedef struct {
+  const char *name;
+  uint32_t period_ms;
+  uint32_t runs;
+  uint32_t late;    // runs that started more than one period after they were due
+  uint32_t max_us;  // longest run
+} micro_task_stats_t;
+
+// Returns the id of the task or -1. name is not copied
+int microTaskAdd(const char *name, micro_task_cb_t cb, uint32_t period_ms, void *arg = NULL);
+bool microTaskRemove(int id);
+// Time given to micro tasks per loop iteration, 0 runs all due tasks (default 1000 us)
+void microTaskSetBudget(uint32_t budget_us);
+bool microTaskGetStats(int id, micro_task_stats_t *stats);
+// Runs the due micro tasks, for sketches that never return from loop()
+void microTaskRun();
+
+// Called by loopTask after every iteration
+void loopMonitorIteration();
@@ -11,6 +11,7 @@
 #endif
 
 #include "chip-debug-report.h"
+#include "boot_profile.h"
 
 #ifndef ARDUINO_LOOP_STACK_SIZE
 #ifndef CONFIG_ARDUINO_LOOP_STACK_SIZE
@@ -45,6 +46,7 @@ __attribute__((weak)) bool shouldPrintChipDebugReport(void) {
 }
 
 void loopTask(void *pvParameters) {
+  bootProfileMark("loopTask");
 #if !defined(NO_GLOBAL_INSTANCES) && !defined(NO_GLOBAL_SERIAL)
   // sets UART0 (default console) RX/TX pins as already configured in boot or as defined in variants/pins_arduino.h
   Serial0.setPins(gpioNumberToDigitalPin(SOC_RX0), gpioNumberToDigitalPin(SOC_TX0));
@@ -56,7 +58,9 @@ void loopTask(void *pvParameters) {
     printBeforeSetupInfo();
   }
 #endif
+  bootProfileMark("setup start");
   setup();
+  bootProfileMark("setup");
 #if ARDUHAL_LOG_LEVEL >= ARDUHAL_LOG_LEVEL_DEBUG
   printAfterSetupInfo();
 #else
@@ -75,10 +79,12 @@ void loopTask(void *pvParameters) {
     if (serialEventRun) {
       serialEventRun();
     }
+    loopMonitorIteration();
   }
 }
 
 extern "C" void app_main() {
+  bootProfileMark("app_main");
 #ifdef F_XTAL_MHZ
 #if !CONFIG_IDF_TARGET_ESP32S2  // ESP32-S2 does not support rtc_clk_xtal_freq_update
   rtc_clk_xtal_freq_update((rtc_xtal_freq_t)F_XTAL_MHZ);
@@ -99,6 +105,9 @@ extern "C" void app_main() {
 #endif
 #if ARDUINO_USB_ON_BOOT && !ARDUINO_USB_MODE
   USB.begin();
+#endif
+#if (ARDUINO_USB_CDC_ON_BOOT | ARDUINO_USB_MSC_ON_BOOT | ARDUINO_USB_DFU_ON_BOOT) && !ARDUINO_USB_MODE
+  bootProfileMark("usb");
 #endif
   loopTaskWDTEnabled = false;
   initArduino();
@@ -0,0 +1,66 @@
+/*
+  Serves a web site from a read-only AssetFS image.
+
+  Files are packed on the host and written to the "assets" partition of partitions.csv:
+
+    python tools/asset_packer.py data assets.bin --size 0x200000
+    esptool.py write_flash 0x1F0000 assets.bin
+
+  Text files are stored gzipped with their ETag computed on the host. The handler sends them
+  straight from flash and answers revalidations with 304 without touching the data.
+*/
+
+#include <WiFi.h>
+#include <WebServer.h>
+#include <AssetFS.h>
+#include <AssetWebHandler.h>
+
+const char *ssid = "........";
+const char *password = "........";
+
+WebServer server(80);
+
+void listAssets(File dir, int depth) {
+  File file;
+  while ((file = dir.openNextFile())) {
+    Serial.printf("%*s%s", depth * 2, "", file.path());
+    if (file.isDirectory()) {
+      Serial.println("/");
+      listAssets(file, depth + 1);
+    } else {
+      Serial.printf(" (%u bytes)\n", file.size());
+    }
+  }
+}
+
+void setup() {
+  Serial.begin(115200);
+
+  if (!AssetFS.begin("assets")) {
+    Serial.println("No asset image, flash one with tools/asset_packer.py");
+    return;
+  }
+  Serial.printf("%u assets, %u bytes\n", AssetFS.count(), AssetFS.totalBytes());
+  listAssets(AssetFS.open("/"), 0);
+
+  WiFi.mode(WIFI_STA);
+  WiFi.begin(ssid, password);
+  while (WiFi.status() != WL_CONNECTED) {
+    delay(500);
+    Serial.print(".");
+  }
+  Serial.println("");
+  Serial.print("IP address: ");
+  Serial.println(WiFi.localIP());
+
+  server.addHandler(new AssetRequestHandler(AssetFS, "/", "max-age=86400"));
+  server.onNotFound([]() {
+    server.send(404, "text/plain", "Not found");
+  });
+  server.begin();
+}
+
+void loop() {
+  server.handleClient();
+  delay(2);
+}
@@ -0,0 +1,461 @@
+// Copyright 2025 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "AssetFS.h"
+#include "FSImpl.h"
+#include "esp32-hal-log.h"
+#include <string.h>
+
+using namespace fs;
+
+class AssetFSImpl : public FSImpl {
+public:
+  AssetFSImpl() : _image(NULL), _header(NULL), _entries(NULL) {}
+  virtual ~AssetFSImpl() {}
+
+  bool mount(const uint8_t *image, size_t size);
+  void unmount() {
+    _image = NULL;
+    _header = NULL;
+    _entries = NULL;
+  }
+  bool mounted() const {
+    return _image != NULL;
+  }
+
+  const asset_entry_t *find(const char *path) const;
+  size_t lowerBound(const char *path) const;
+  size_t count() const {
+    return _header ? _header->count : 0;
+  }
+  const asset_entry_t *entry(size_t index) const {
+    return (index < count()) ? &_entries[index] : NULL;
+  }
+  const char *string(uint32_t offset) const {
+    return (const char *)(_image + offset);
+  }
+  const uint8_t *data(const asset_entry_t *entry) const {
+    return _image + entry->data_offset;
+  }
+  const asset_image_header_t *header() const {
+    return _header;
+  }
+  bool isDirectory(const char *path) const;
+
+  FileImplPtr open(const char *path, const char *mode, const bool create) override;
+  bool exists(const char *path) override;
+  bool rename(const char *pathFrom, const char *pathTo) override {
+    return false;
+  }
+  bool remove(const char *path) override {
+    return false;
+  }
+  bool mkdir(const char *path) override {
+    return false;
+  }
+  bool rmdir(const char *path) override {
+    return false;
+  }
+
+private:
+  const uint8_t *_image;
+  const asset_image_header_t *_header;
+  const asset_entry_t *_entries;
+};
+
+class AssetFileImpl : public FileImpl {
+public:
+  // a file
+  AssetFileImpl(AssetFSImpl *fs, const asset_entry_t *entry) : _fs(fs), _entry(entry), _pos(0), _index(0) {}
+  // a directory, path without the trailing slash ("" for the root)
+  AssetFileImpl(AssetFSImpl *fs, const String &path) : _fs(fs), _entry(NULL), _dir(path), _pos(0), _index(0) {
+    rewindDirectory();
+  }
+  virtual ~AssetFileImpl() {}
+
+  size_t write(const uint8_t *buf, size_t size) override {
+    return 0;
+  }
+  size_t read(uint8_t *buf, size_t size) override;
+  void flush() override {}
+  bool seek(uint32_t pos, SeekMode mode) override;
+  size_t position() const override {
+    return _pos;
+  }
+  size_t size() const override {
+    return _entry ? _entry->size : 0;
+  }
+  bool setBufferSize(size_t size) override {
+    return false;
+  }
+  void close() override {
+    _fs = NULL;
+  }
+  time_t getLastWrite() override {
+    return (_fs && _fs->mounted()) ? _fs->header()->build_time : 0;
+  }
+  const char *path() const override {
+    if (_entry) {
+      return _fs->string(_entry->path_offset);
+    }
+    return _dir.length() ? _dir.c_str() : "/";
+  }
+  const char *name() const override {
+    return pathToFileName(path());
+  }
+  boolean isDirectory(void) override {
+    return _entry == NULL;
+  }
+  FileImplPtr openNextFile(const char *mode) override;
+  boolean seekDir(long position) override;
+  String getNextFileName(void) override {
+    return getNextFileName(NULL);
+  }
+  String getNextFileName(bool *isDir) override;
+  void rewindDirectory(void) override;
+  operator bool() override {
+    return _fs != NULL && _fs->mounted();
+  }
+
+private:
+  bool nextChild(String &path, bool &isDir);
+
+  AssetFSImpl *_fs;
+  const asset_entry_t *_entry;
+  String _dir;
+  size_t _pos;
+  size_t _index;  // next entry to look at while listing a directory
+};
+
+// NUL terminated string of len characters at offset
+static bool stringInImage(const uint8_t *image, uint32_t size, uint32_t offset, uint32_t len) {
+  return offset < size && len < size - offset && image[offset + len] == 0;
+}
+
+bool AssetFSImpl::mount(const uint8_t *image, size_t size) {
+  const asset_image_header_t *header = (const asset_image_header_t *)image;
+  if (size < sizeof(asset_image_header_t) || header->magic != ASSET_IMAGE_MAGIC) {
+    log_e("No asset image found");
+    return false;
+  }
+  if (header->version != ASSET_IMAGE_VERSION || header->entry_size != sizeof(asset_entry_t)) {
+    log_e("Unsupported asset image version %u", header->version);
+    return false;
+  }
+  if (header->image_size > size || header->entries_offset > header->image_size
+      || header->count > (header->image_size - header->entries_offset) / sizeof(asset_entry_t)) {
+    log_e("Asset image is truncated");
+    return false;
+  }
+  if (header->entries_offset % 4 != 0) {
+    // the entries are read with word loads, which fault when unaligned on Xtensa
+    log_e("Asset image is corrupted");
+    return false;
+  }
+  // checked once here, so lookups and reads can trust the offsets
+  const asset_entry_t *entries = (const asset_entry_t *)(image + header->entries_offset);
+  for (uint32_t i = 0; i < header->count; i++) {
+    const asset_entry_t *e = &entries[i];
+    if (!stringInImage(image, header->image_size, e->path_offset, e->path_len) || image[e->path_offset] != '/'
+        || !stringInImage(image, header->image_size, e->etag_offset, e->etag_len)
+        || !stringInImage(image, header->image_size, e->mime_offset, e->mime_len) || e->data_offset > header->image_size
+        || e->size > header->image_size - e->data_offset) {
+      log_e("Asset entry %lu is corrupted", i);
+      return false;
+    }
+    if (i && strcmp((const char *)image + entries[i - 1].path_offset, (const char *)image + e->path_offset) >= 0) {
+      log_e("Asset entries are not sorted");
+      return false;
+    }
+  }
+  _image = image;
+  _header = header;
+  _entries = entries;
+  return true;
+}
+
+size_t AssetFSImpl::lowerBound(const char *path) const {
+  size_t lo = 0;
+  size_t hi = count();
+  while (lo < hi) {
+    size_t mid = (lo + hi) / 2;
+    if (strcmp(string(_entries[mid].path_offset), path) < 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+const asset_entry_t *AssetFSImpl::find(const char *path) const {
+  if (!mounted() || path == NULL || path[0] != '/') {
+    return NULL;
+  }
+  size_t i = lowerBound(path);
+  if (i < count() && strcmp(string(_entries[i].path_offset), path) == 0) {
+    return &_entries[i];
+  }
+  return NULL;
+}
+
+bool AssetFSImpl::isDirectory(const char *path) const {
+  if (!mounted()) {
+    return false;
+  }
+  // a directory exists when some entry starts with "path/"
+  String prefix = path;
+  if (!prefix.endsWith("/")) {
+    prefix += "/";
+  }
+  if (prefix == "/") {
+    return true;
+  }
+  size_t i = lowerBound(prefix.c_str());
+  return i < count() && strncmp(string(_entries[i].path_offset), prefix.c_str(), prefix.length()) == 0;
+}
+
+FileImplPtr AssetFSImpl::open(const char *path, const char *mode, const bool create) {
+  if (!mounted() || path == NULL || path[0] != '/') {
+    return FileImplPtr();
+  }
+  if (mode && mode[0] != 'r') {
+    log_e("%s: AssetFS is read only", path);
+    return FileImplPtr();
+  }
+  const asset_entry_t *e = find(path);
+  if (e != NULL) {
+    return std::make_shared<AssetFileImpl>(this, e);
+  }
+  String dir = path;
+  while (dir.endsWith("/")) {
+    dir.remove(dir.length() - 1);
+  }
+  if (isDirectory(dir.c_str())) {
+    return std::make_shared<AssetFileImpl>(this, dir);
+  }
+  return FileImplPtr();
+}
+
+bool AssetFSImpl::exists(const char *path) {
+  return find(path) != NULL || (path != NULL && path[0] == '/' && isDirectory(path));
+}
+
+size_t AssetFileImpl::read(uint8_t *buf, size_t size) {
+  if (_entry == NULL || _fs == NULL || !_fs->mounted() || _pos >= _entry->size) {
+    return 0;
+  }
+  if (size > _entry->size - _pos) {
+    size = _entry->size - _pos;
+  }
+  memcpy(buf, _fs->data(_entry) + _pos, size);
+  _pos += size;
+  return size;
+}
+
+bool AssetFileImpl::seek(uint32_t pos, SeekMode mode) {
+  if (_entry == NULL) {
+    return false;
+  }
+  size_t target;
+  switch (mode) {
+    case SeekSet: target = pos; break;
+    case SeekCur: target = _pos + pos; break;
+    case SeekEnd: target = _entry->size + pos; break;
+    default:      return false;
+  }
+  if (target > _entry->size) {
+    return false;
+  }
+  _pos = target;
+  return true;
+}
+
+void AssetFileImpl::rewindDirectory(void) {
+  if (_entry != NULL || _fs == NULL) {
+    return;
+  }
+  String prefix = _dir + "/";
+  _index = _fs->lowerBound(prefix.c_str());
+}
+
+boolean AssetFileImpl::seekDir(long position) {
+  if (_entry != NULL || _fs == NULL || position < 0) {
+    return false;
+  }
+  _index = position;
+  return true;
+}
+
+bool AssetFileImpl::nextChild(String &path, bool &isDir) {
+  if (_entry != NULL || _fs == NULL || !_fs->mounted()) {
+    return false;
+  }
+  size_t prefixLen = _dir.length() + 1;
+  const asset_entry_t *e = _fs->entry(_index);
+  if (e == NULL) {
+    return false;
+  }
+  const char *p = _fs->string(e->path_offset);
+  if (strncmp(p, _dir.c_str(), _dir.length()) != 0 || p[_dir.length()] != '/') {
+    return false;  // past the last entry of this directory
+  }
+  const char *slash = strchr(p + prefixLen, '/');
+  if (slash == NULL) {
+    path = p;
+    isDir = false;
+    _index++;
+    return true;
+  }
+  // a subdirectory: its entries are contiguous, skip all of them
+  path = String(p).substring(0, slash - p);
+  isDir = true;
+  String sub = path + "/";
+  do {
+    e = _fs->entry(++_index);
+  } while (e != NULL && strncmp(_fs->string(e->path_offset), sub.c_str(), sub.length()) == 0);
+  return true;
+}
+
+FileImplPtr AssetFileImpl::openNextFile(const char *mode) {
+  String path;
+  bool isDir;
+  if (!nextChild(path, isDir)) {
+    return FileImplPtr();
+  }
+  return _fs->open(path.c_str(), "r", false);
+}
+
+String AssetFileImpl::getNextFileName(bool *isDir) {
+  String path;
+  bool dir;
+  if (!nextChild(path, dir)) {
+    return "";
+  }
+  if (isDir) {
+    *isDir = dir;
+  }
+  return path;
+}
+
+AssetFSFS::AssetFSFS() : FS(FSImplPtr(new AssetFSImpl())), _mmapHandle(0), _mapped(false) {}
+
+AssetFSFS::~AssetFSFS() {
+  end();
+}
+
+bool AssetFSFS::begin(const char *partitionLabel) {
+  const esp_partition_t *partition = esp_partition_find_first(ESP_PARTITION_TYPE_ANY, ESP_PARTITION_SUBTYPE_ANY, partitionLabel);
+  if (partition == NULL) {
+    log_e("Partition '%s' not found", partitionLabel ? partitionLabel : "");
+    return false;
+  }
+  return begin(partition);
+}
+
+bool AssetFSFS::begin(const esp_partition_t *partition) {
+  AssetFSImpl *impl = static_cast<AssetFSImpl *>(_impl.get());
+  if (impl->mounted()) {
+    log_w("AssetFS Already Mounted!");
+    return true;
+  }
+  if (partition == NULL) {
+    return false;
+  }
+  // only map what the image uses, the rest of the partition does not cost MMU pages
+  asset_image_header_t header;
+  esp_err_t err = esp_partition_read(partition, 0, &header, sizeof(header));
+  if (err != ESP_OK) {
+    log_e("Failed to read partition '%s': %d", partition->label, err);
+    return false;
+  }
+  if (header.magic != ASSET_IMAGE_MAGIC) {
+    log_e("No asset image in partition '%s'", partition->label);
+    return false;
+  }
+  if (header.image_size < sizeof(header) || header.image_size > partition->size) {
+    log_e("Asset image does not fit partition '%s'", partition->label);
+    return false;
+  }
+  const void *ptr = NULL;
+  err = esp_partition_mmap(partition, 0, header.image_size, ESP_PARTITION_MMAP_DATA, &ptr, &_mmapHandle);
+  if (err != ESP_OK) {
+    log_e("Failed to map partition '%s': %d", partition->label, err);
+    return false;
+  }
+  _mapped = true;
+  if (!impl->mount((const uint8_t *)ptr, header.image_size)) {
+    end();
+    return false;
+  }
+  log_v("Mapped %lu assets, %lu bytes", header.count, header.image_size);
+  return true;
+}
+
+bool AssetFSFS::begin(const uint8_t *image, size_t size) {
+  AssetFSImpl *impl = static_cast<AssetFSImpl *>(_impl.get());
+  if (impl->mounted()) {
+    log_w("AssetFS Already Mounted!");
+    return true;
+  }
+  return image != NULL && impl->mount(image, size);
+}
+
+void AssetFSFS::end() {
+  static_cast<AssetFSImpl *>(_impl.get())->unmount();
+  if (_mapped) {
+    esp_partition_munmap(_mmapHandle);
+    _mapped = false;
+  }
+}
+
+const asset_entry_t *AssetFSFS::find(const char *path) const {
+  return static_cast<AssetFSImpl *>(_impl.get())->find(path);
+}
+
+size_t AssetFSFS::count() const {
+  return static_cast<AssetFSImpl *>(_impl.get())->count();
+}
+
+const asset_entry_t *AssetFSFS::entry(size_t index) const {
+  return static_cast<AssetFSImpl *>(_impl.get())->entry(index);
+}
+
+const uint8_t *AssetFSFS::data(const asset_entry_t *entry) const {
+  return static_cast<AssetFSImpl *>(_impl.get())->data(entry);
+}
+
+const char *AssetFSFS::path(const asset_entry_t *entry) const {
+  return static_cast<AssetFSImpl *>(_impl.get())->string(entry->path_offset);
+}
+
+const char *AssetFSFS::etag(const asset_entry_t *entry) const {
+  return static_cast<AssetFSImpl *>(_impl.get())->string(entry->etag_offset);
+}
+
+const char *AssetFSFS::contentType(const asset_entry_t *entry) const {
+  return static_cast<AssetFSImpl *>(_impl.get())->string(entry->mime_offset);
+}
+
+uint32_t AssetFSFS::buildTime() const {
+  const asset_image_header_t *header = static_cast<AssetFSImpl *>(_impl.get())->header();
+  return header ? header->build_time : 0;
+}
+
+size_t AssetFSFS::totalBytes() const {
+  const asset_image_header_t *header = static_cast<AssetFSImpl *>(_impl.get())->header();
+  return header ? header->image_size : 0;
+}
+
+AssetFSFS AssetFS;
@@ -0,0 +1,93 @@
+// Copyright 2025 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _ASSETFS_H_
+#define _ASSETFS_H_
+
+#include "FS.h"
+#include "esp_partition.h"
+
+/*
+ * Asset image, written by tools/asset_packer.py. All values are little endian.
+ *
+ *   header | entries sorted by path | NUL terminated strings | file data (4 byte aligned)
+ *
+ * Paths are absolute ("/index.html"). Files stored gzip compressed have the ".gz" suffix
+ * in their path and ASSET_FLAG_GZIP set, the content type is the one of the original file.
+ */
+#define ASSET_IMAGE_MAGIC   0x31545341  // "AST1"
+#define ASSET_IMAGE_VERSION 1
+#define ASSET_FLAG_GZIP     0x01
+
+typedef struct {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t entry_size;  // sizeof(asset_entry_t)
+  uint32_t count;
+  uint32_t entries_offset;
+  uint32_t image_size;
+  uint32_t build_time;  // seconds since epoch, reported as the last write time of every file
+  uint32_t reserved[2];
+} asset_image_header_t;
+
+typedef struct {
+  uint32_t path_offset;  // offsets are from the start of the image
+  uint32_t data_offset;
+  uint32_t size;
+  uint32_t original_size;  // size before compression
+  uint32_t etag_offset;    // quoted ETag, base64 of the MD5 of the stored data
+  uint32_t mime_offset;
+  uint16_t path_len;
+  uint8_t etag_len;
+  uint8_t mime_len;
+  uint32_t flags;
+} asset_entry_t;
+
+namespace fs {
+
+class AssetFSFS : public FS {
+public:
+  AssetFSFS();
+  ~AssetFSFS();
+
+  // Maps the image in the data partition called partitionLabel
+  bool begin(const char *partitionLabel = "assets");
+  bool begin(const esp_partition_t *partition);
+  // Uses an image that is already addressable, for example one embedded in the application
+  bool begin(const uint8_t *image, size_t size);
+  void end();
+
+  // Direct access to the mapped image, the pointers stay valid until end()
+  const asset_entry_t *find(const char *path) const;
+  size_t count() const;
+  const asset_entry_t *entry(size_t index) const;
+  const uint8_t *data(const asset_entry_t *entry) const;
+  const char *path(const asset_entry_t *entry) const;
+  const char *etag(const asset_entry_t *entry) const;
+  const char *contentType(const asset_entry_t *entry) const;
+  uint32_t buildTime() const;
+  size_t totalBytes() const;
+
+private:
+  bool mount(const uint8_t *image, size_t size);
+
+  esp_partition_mmap_handle_t _mmapHandle;
+  bool _mapped;
+};
+
+}  // namespace fs
+
+extern fs::AssetFSFS AssetFS;
+
+#endif /* _ASSETFS_H_ */
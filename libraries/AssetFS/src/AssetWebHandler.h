@@ -0,0 +1,115 @@
+// Copyright 2025 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _ASSET_WEB_HANDLER_H_
+#define _ASSET_WEB_HANDLER_H_
+
+#include "AssetFS.h"
+#include "WebServer.h"
+
+/*
+ * Serves the files of an AssetFS image below uri.
+ *
+ * Responses are sent straight from the mapped flash: no file is opened, nothing is copied
+ * to RAM and the ETag and content type come precomputed from the image. A request for
+ * "/app.js" is answered with "/app.js.gz" and "Content-Encoding: gzip" when only the
+ * compressed copy is stored, and with 304 when If-None-Match carries the current ETag.
+ *
+ *   server.addHandler(new AssetRequestHandler(AssetFS, "/", "max-age=86400"));
+ */
+class AssetRequestHandler : public RequestHandler {
+public:
+  AssetRequestHandler(fs::AssetFSFS &fs, const char *uri = "/", const char *cacheHeader = NULL)
+    : _fs(fs), _uri(uri), _cacheHeader(cacheHeader ? cacheHeader : "") {
+    if (_uri.endsWith("/")) {
+      _uri.remove(_uri.length() - 1);
+    }
+  }
+
+  bool canHandle(HTTPMethod requestMethod, const String &requestUri) override {
+    return requestMethod == HTTP_GET && inScope(requestUri);
+  }
+
+  bool canHandle(WebServer &server, HTTPMethod requestMethod, const String &requestUri) override {
+    if (requestMethod != HTTP_GET || !inScope(requestUri)) {
+      return false;
+    }
+    return _filter != NULL ? _filter(server) : true;
+  }
+
+  bool handle(WebServer &server, HTTPMethod requestMethod, const String &requestUri) override {
+    if (!canHandle(server, requestMethod, requestUri)) {
+      return false;
+    }
+    String path = requestUri.substring(_uri.length());
+    if (!path.startsWith("/")) {
+      path = "/" + path;
+    }
+    const asset_entry_t *entry;
+    if (path.endsWith("/")) {
+      entry = lookup(path + "index.html");
+      if (entry == NULL) {
+        entry = lookup(path + "index.htm");
+      }
+    } else {
+      entry = lookup(path);
+    }
+    if (entry == NULL) {
+      return false;  // let the next handler or onNotFound() answer
+    }
+
+    const char *etag = _fs.etag(entry);
+    if (entry->etag_len && server.hasHeader("If-None-Match") && server.header("If-None-Match") == etag) {
+      server.send(304);
+      return true;
+    }
+    if (_cacheHeader.length()) {
+      server.sendHeader("Cache-Control", _cacheHeader);
+    }
+    if (entry->etag_len) {
+      server.sendHeader("ETag", etag);
+    }
+    if (entry->flags & ASSET_FLAG_GZIP) {
+      server.sendHeader("Content-Encoding", "gzip");
+    }
+    server.send_P(200, _fs.contentType(entry), (PGM_P)_fs.data(entry), entry->size);
+    return true;
+  }
+
+  RequestHandler &setFilter(std::function<bool(WebServer &)> filter) override {
+    _filter = filter;
+    return *this;
+  }
+
+protected:
+  bool inScope(const String &requestUri) const {
+    return requestUri.startsWith(_uri) && (requestUri.length() == _uri.length() || requestUri[_uri.length()] == '/' || _uri.length() == 0);
+  }
+
+  const asset_entry_t *lookup(const String &path) const {
+    const asset_entry_t *entry = _fs.find(path.c_str());
+    if (entry == NULL) {
+      String gz = path + ".gz";
+      entry = _fs.find(gz.c_str());
+    }
+    return entry;
+  }
+
+  fs::AssetFSFS &_fs;
+  String _uri;
+  String _cacheHeader;
+  std::function<bool(WebServer &)> _filter;
+};
+
+#endif /* _ASSET_WEB_HANDLER_H_ */
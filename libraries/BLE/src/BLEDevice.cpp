@@ -314,6 +314,7 @@ gatts_event_handler BLEDevice::m_customGattsHandler = nullptr;
 
     esp_err_t errRc = ESP_OK;
 #ifdef ARDUINO_ARCH_ESP32
+    initNvs();  // in case it was deferred at boot, bonding keys are stored there
     if (!btStart()) {
       errRc = ESP_FAIL;
       return;
@@ -10,12 +10,61 @@
 #define DEBUG_OUTPUT Serial
 #endif
 
-#define DNS_MIN_REQ_LEN 17  // minimal size for DNS request asking ROOT = DNS_HEADER_SIZE + 1 null byte for Name + 4 bytes type/class
+#define DNS_MIN_REQ_LEN    17   // minimal size for DNS request asking ROOT = DNS_HEADER_SIZE + 1 null byte for Name + 4 bytes type/class
+#define DNS_MAX_NAME_LEN   255  // RFC1035 2.3.4, names in wire format are limited to 255 bytes
+#define DNS_MAX_LABEL_LEN  63
+#define DNS_TYPE_ANY       255
 
-DNSServer::DNSServer() : _port(DNS_DEFAULT_PORT), _ttl(htonl(DNS_DEFAULT_TTL)), _errorReplyCode(DNSReplyCode::NonExistentDomain) {}
+static inline uint8_t dnsToLower(uint8_t c) {
+  return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+}
+
+// FNV-1a over the lower case name, names are case insensitive (RFC4343)
+static uint32_t dnsNameHash(const uint8_t *name, size_t len) {
+  uint32_t h = 2166136261UL;
+  for (size_t i = 0; i < len; i++) {
+    h = (h ^ dnsToLower(name[i])) * 16777619UL;
+  }
+  return h;
+}
+
+// compare a name from a request with a lower case name from the zone
+static bool dnsNameEquals(const uint8_t *qname, const uint8_t *name, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    if (dnsToLower(qname[i]) != name[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void dnsBuildAnswer(uint8_t *answer, uint16_t type, uint32_t ttl, const IPAddress &ip, uint16_t rdLength) {
+  // Use DNS name compression : instead of repeating the name in this RNAME occurrence,
+  // set the two MSB of the byte corresponding normally to the length to 1. The following
+  // 14 bits must be used to specify the offset of the domain name in the message
+  // (<255 here so the first byte has the 6 LSB at 0)
+  uint16_t answerType = htons(type), answerClass = htons(DNS_CLASS_IN), answerLength = htons(rdLength);
+  answer[0] = 0xC0;
+  answer[1] = DNS_OFFSET_DOMAIN_NAME;
+  memcpy(answer + 2, &answerType, 2);
+  memcpy(answer + 4, &answerClass, 2);
+  memcpy(answer + 6, &ttl, 4);  // DNS Time To Live, already in network order
+  memcpy(answer + 10, &answerLength, 2);
+  for (uint16_t i = 0; i < rdLength; i++) {
+    answer[12 + i] = ip[i];
+  }
+}
+
+DNSServer::DNSServer()
+  : _port(DNS_DEFAULT_PORT), _ttl(htonl(DNS_DEFAULT_TTL)), _errorReplyCode(DNSReplyCode::NonExistentDomain), _hasDefault(false), _zoneCount(0) {
+  memset(_zoneIndex, -1, sizeof(_zoneIndex));
+}
 
 DNSServer::DNSServer(const String &domainName)
-  : _port(DNS_DEFAULT_PORT), _ttl(htonl(DNS_DEFAULT_TTL)), _errorReplyCode(DNSReplyCode::NonExistentDomain), _domainName(domainName){};
+  : _port(DNS_DEFAULT_PORT), _ttl(htonl(DNS_DEFAULT_TTL)), _errorReplyCode(DNSReplyCode::NonExistentDomain), _domainName(domainName), _hasDefault(false),
+    _zoneCount(0) {
+  memset(_zoneIndex, -1, sizeof(_zoneIndex));
+}
 
 bool DNSServer::start() {
   if (_resolvedIP.operator uint32_t() == 0) {  // no address is set, try to obtain AP interface's IP
@@ -32,6 +81,14 @@ bool DNSServer::start() {
   }
 
   _udp.close();
+  DNSZoneRecord record;
+  bool hasDefault = compileRecord(record, _domainName.isEmpty() ? String("*") : _domainName);
+  if (hasDefault) {
+    record.ipv4 = _resolvedIP;
+    record.hasA = true;
+    buildAnswers(record);
+  }
+  setDefault(record, hasDefault);
   _udp.onPacket([this](AsyncUDPPacket &pkt) {
     this->_handleUDP(pkt);
   });
@@ -49,6 +106,22 @@ bool DNSServer::start(uint16_t port, const String &domainName, const IPAddress &
 
   _resolvedIP = resolvedIP;
   _udp.close();
+  DNSZoneRecord record;
+  // an empty name answers every query, like "*"
+  bool hasDefault = compileRecord(record, domainName.isEmpty() ? String("*") : domainName);
+  if (hasDefault) {
+    if (_resolvedIP.type() == IPv6) {
+      record.ipv6 = _resolvedIP;
+      record.hasAAAA = true;
+    } else {
+      record.ipv4 = _resolvedIP;
+      record.hasA = true;
+    }
+    buildAnswers(record);
+  } else {
+    log_e("Invalid domain name: %s", domainName.c_str());
+  }
+  setDefault(record, hasDefault);
   _udp.onPacket([this](AsyncUDPPacket &pkt) {
     this->_handleUDP(pkt);
   });
@@ -60,7 +133,184 @@ void DNSServer::setErrorReplyCode(const DNSReplyCode &replyCode) {
 }
 
 void DNSServer::setTTL(const uint32_t &ttl) {
+  portENTER_CRITICAL(&_zoneLock);
   _ttl = htonl(ttl);
+  if (_hasDefault) {
+    buildAnswers(_default);
+  }
+  for (uint8_t i = 0; i < _zoneCount; i++) {
+    buildAnswers(_zone[i]);
+  }
+  portEXIT_CRITICAL(&_zoneLock);
+}
+
+void DNSServer::setDefault(const DNSZoneRecord &record, bool hasDefault) {
+  portENTER_CRITICAL(&_zoneLock);
+  _default = record;
+  _hasDefault = hasDefault;
+  portEXIT_CRITICAL(&_zoneLock);
+}
+
+bool DNSServer::compileRecord(DNSZoneRecord &record, const String &domainName) {
+  record.hasA = false;
+  record.hasAAAA = false;
+  record.nameLength = 0;
+  record.hash = 0;
+  if (domainName == "*") {
+    return true;  // catch-all record
+  }
+
+  const char *name = domainName.c_str();
+  size_t len = domainName.length();
+  if (len > 4 && strncasecmp(name, "www.", 4) == 0) {
+    name += 4;
+    len -= 4;
+  }
+  if (len && name[len - 1] == '.') {
+    len--;  // fully qualified name
+  }
+  if (len == 0 || len + 2 > DNS_ZONE_MAX_NAME_LENGTH) {
+    return false;
+  }
+
+  // convert "example.com" to the labels "\7example\3com\0"
+  uint8_t *label = record.name;
+  uint8_t *out = record.name + 1;
+  for (size_t i = 0; i <= len; i++) {
+    if (i == len || name[i] == '.') {
+      size_t labelLength = out - label - 1;
+      if (labelLength == 0 || labelLength > DNS_MAX_LABEL_LEN) {
+        return false;
+      }
+      *label = labelLength;
+      label = out++;
+    } else {
+      *out++ = dnsToLower(name[i]);
+    }
+  }
+  *label = 0;
+  record.nameLength = out - record.name;
+  record.hash = dnsNameHash(record.name, record.nameLength);
+  return true;
+}
+
+void DNSServer::buildAnswers(DNSZoneRecord &record) {
+  if (record.hasA) {
+    dnsBuildAnswer(record.answerA, DNS_TYPE_A, _ttl, record.ipv4, DNS_RDLENGTH_IPV4);
+  }
+  if (record.hasAAAA) {
+    dnsBuildAnswer(record.answerAAAA, DNS_TYPE_AAAA, _ttl, record.ipv6, 16);
+  }
+}
+
+void DNSServer::rebuildZoneIndex() {
+  memset(_zoneIndex, -1, sizeof(_zoneIndex));
+  for (uint8_t i = 0; i < _zoneCount; i++) {
+    uint8_t bucket = _zone[i].hash % DNS_ZONE_BUCKETS;
+    while (_zoneIndex[bucket] >= 0) {
+      bucket = (bucket + 1) % DNS_ZONE_BUCKETS;
+    }
+    _zoneIndex[bucket] = i;
+  }
+}
+
+int DNSServer::findZoneRecord(const uint8_t *name, uint8_t nameLength, uint32_t hash) const {
+  uint8_t bucket = hash % DNS_ZONE_BUCKETS;
+  for (uint8_t n = 0; n < DNS_ZONE_BUCKETS; n++) {
+    int8_t i = _zoneIndex[bucket];
+    if (i < 0) {
+      break;
+    }
+    const DNSZoneRecord &record = _zone[i];
+    if (record.hash == hash && record.nameLength == nameLength && dnsNameEquals(name, record.name, nameLength)) {
+      return i;
+    }
+    bucket = (bucket + 1) % DNS_ZONE_BUCKETS;
+  }
+  return -1;
+}
+
+const DNSZoneRecord *DNSServer::lookup(const uint8_t *qname, uint16_t qnameLength) const {
+  // a leading "www" label is ignored, the same as for the configured names
+  if (qnameLength > 5 && qname[0] == 3 && dnsToLower(qname[1]) == 'w' && dnsToLower(qname[2]) == 'w' && dnsToLower(qname[3]) == 'w') {
+    qname += 4;
+    qnameLength -= 4;
+  }
+  if (qnameLength <= DNS_ZONE_MAX_NAME_LENGTH) {
+    uint32_t hash = dnsNameHash(qname, qnameLength);
+    int i = findZoneRecord(qname, qnameLength, hash);
+    if (i >= 0) {
+      return &_zone[i];
+    }
+    if (_hasDefault && _default.nameLength == qnameLength && _default.hash == hash && dnsNameEquals(qname, _default.name, qnameLength)) {
+      return &_default;
+    }
+  }
+  // catch-all records
+  int i = findZoneRecord(nullptr, 0, 0);
+  if (i >= 0) {
+    return &_zone[i];
+  }
+  if (_hasDefault && _default.nameLength == 0) {
+    return &_default;
+  }
+  return nullptr;
+}
+
+bool DNSServer::addRecord(const String &domainName, const IPAddress &ip) {
+  DNSZoneRecord record;
+  if (!compileRecord(record, domainName)) {
+    log_e("Invalid domain name: %s", domainName.c_str());
+    return false;
+  }
+  portENTER_CRITICAL(&_zoneLock);
+  int i = findZoneRecord(record.name, record.nameLength, record.hash);
+  if (i < 0) {
+    if (_zoneCount >= DNS_ZONE_MAX_RECORDS) {
+      portEXIT_CRITICAL(&_zoneLock);
+      log_e("DNS zone is full");
+      return false;
+    }
+    i = _zoneCount;
+    _zone[i] = record;
+    _zoneCount++;
+    rebuildZoneIndex();
+  }
+  if (ip.type() == IPv6) {
+    _zone[i].ipv6 = ip;
+    _zone[i].hasAAAA = true;
+  } else {
+    _zone[i].ipv4 = ip;
+    _zone[i].hasA = true;
+  }
+  buildAnswers(_zone[i]);
+  portEXIT_CRITICAL(&_zoneLock);
+  return true;
+}
+
+bool DNSServer::removeRecord(const String &domainName) {
+  DNSZoneRecord record;
+  if (!compileRecord(record, domainName)) {
+    return false;
+  }
+  portENTER_CRITICAL(&_zoneLock);
+  int i = findZoneRecord(record.name, record.nameLength, record.hash);
+  if (i >= 0) {
+    _zoneCount--;
+    if (i != _zoneCount) {
+      _zone[i] = _zone[_zoneCount];
+    }
+    rebuildZoneIndex();
+  }
+  portEXIT_CRITICAL(&_zoneLock);
+  return i >= 0;
+}
+
+void DNSServer::clearRecords() {
+  portENTER_CRITICAL(&_zoneLock);
+  _zoneCount = 0;
+  memset(_zoneIndex, -1, sizeof(_zoneIndex));
+  portEXIT_CRITICAL(&_zoneLock);
 }
 
 void DNSServer::stop() {
@@ -85,43 +335,67 @@ void DNSServer::_handleUDP(AsyncUDPPacket &pkt) {
     return;  // ignore non-query messages
   }
 
-  if (requestIncludesOnlyOneQuestion(dnsHeader)) {
-    /*
-      // The QName has a variable length, maximum 255 bytes and is comprised of multiple labels.
-      // Each label contains a byte to describe its length and the label itself. The list of
-      // labels terminates with a zero-valued byte. In "github.com", we have two labels "github" & "com"
-*/
-    const char *enoflbls = strchr(reinterpret_cast<const char *>(pkt.data()) + DNS_HEADER_SIZE, 0);  // find end_of_label marker
-    ++enoflbls;                                                                                      // advance after null terminator
-    dnsQuestion.QName = pkt.data() + DNS_HEADER_SIZE;                                                // we can reference labels from the request
-    dnsQuestion.QNameLength = enoflbls - (char *)pkt.data() - DNS_HEADER_SIZE;
-    /*
-        check if we aint going out of pkt bounds
-        proper dns req should have label terminator at least 4 bytes before end of packet
-      */
-    if (dnsQuestion.QNameLength > pkt.length() - DNS_HEADER_SIZE - sizeof(dnsQuestion.QType) - sizeof(dnsQuestion.QClass)) {
-      return;  // malformed packet
-    }
-
-    // Copy the QType and QClass
-    memcpy(&dnsQuestion.QType, enoflbls, sizeof(dnsQuestion.QType));
-    memcpy(&dnsQuestion.QClass, enoflbls + sizeof(dnsQuestion.QType), sizeof(dnsQuestion.QClass));
+  if (!requestIncludesOnlyOneQuestion(dnsHeader) || dnsHeader.OPCode != DNS_OPCODE_QUERY) {
+    replyWithCustomCode(pkt, dnsHeader);
+    return;
   }
 
-  // will reply with IP only to "*" or if domain matches without www. subdomain
-  if (dnsHeader.OPCode == DNS_OPCODE_QUERY && requestIncludesOnlyOneQuestion(dnsHeader)
-      && (_domainName.isEmpty() || getDomainNameWithoutWwwPrefix(static_cast<const unsigned char *>(dnsQuestion.QName), dnsQuestion.QNameLength) == _domainName)) {
+  /*
+    // The QName has a variable length, maximum 255 bytes and is comprised of multiple labels.
+    // Each label contains a byte to describe its length and the label itself. The list of
+    // labels terminates with a zero-valued byte. In "github.com", we have two labels "github" & "com"
+  */
+  const uint8_t *data = pkt.data();
+  size_t length = pkt.length();
+  size_t pos = DNS_HEADER_SIZE;
+  while (pos < length && data[pos] != 0) {
+    if (data[pos] & 0xC0) {
+      return;  // compression pointers are not expected in the question
+    }
+    pos += data[pos] + 1;
+  }
+  dnsQuestion.QName = data + DNS_HEADER_SIZE;  // we can reference labels from the request
+  dnsQuestion.QNameLength = pos + 1 - DNS_HEADER_SIZE;
+  /*
+      check if we aint going out of pkt bounds
+      proper dns req should have label terminator at least 4 bytes before end of packet
+    */
+  if (dnsQuestion.QNameLength > DNS_MAX_NAME_LEN || pos + 1 + sizeof(dnsQuestion.QType) + sizeof(dnsQuestion.QClass) > length) {
+    return;  // malformed packet
+  }
 
-    // Qtype = A (1) or ANY (255): send an A record otherwise an empty response
-    if (ntohs(dnsQuestion.QType) == 1 || ntohs(dnsQuestion.QType) == 255) {
-      replyWithIP(pkt, dnsHeader, dnsQuestion);
-    } else {
-      replyWithNoAnsw(pkt, dnsHeader, dnsQuestion);
+  // Copy the QType and QClass
+  memcpy(&dnsQuestion.QType, data + pos + 1, sizeof(dnsQuestion.QType));
+  memcpy(&dnsQuestion.QClass, data + pos + 1 + sizeof(dnsQuestion.QType), sizeof(dnsQuestion.QClass));
+
+  // will reply only to names of the zone, the configured domain or to any name in captive-portal mode
+  // Qtype = A (1) or ANY (255): send an A record, AAAA (28): send an AAAA record, otherwise an empty response
+  // the answer is copied under the lock so the zone can change while the reply is sent
+  uint16_t qtype = ntohs(dnsQuestion.QType);
+  uint8_t answer[DNS_ANSWER_AAAA_LENGTH];
+  size_t answerLength = 0;
+  portENTER_CRITICAL(&_zoneLock);
+  const DNSZoneRecord *record = lookup(dnsQuestion.QName, dnsQuestion.QNameLength);
+  bool found = record != nullptr;
+  if (found) {
+    if ((qtype == DNS_TYPE_A || qtype == DNS_TYPE_ANY) && record->hasA) {
+      answerLength = DNS_ANSWER_A_LENGTH;
+      memcpy(answer, record->answerA, answerLength);
+    } else if (qtype == DNS_TYPE_AAAA && record->hasAAAA) {
+      answerLength = DNS_ANSWER_AAAA_LENGTH;
+      memcpy(answer, record->answerAAAA, answerLength);
     }
-    return;
   }
-  // otherwise reply with custom code
-  replyWithCustomCode(pkt, dnsHeader);
+  portEXIT_CRITICAL(&_zoneLock);
+
+  if (!found) {
+    // otherwise reply with custom code
+    replyWithCustomCode(pkt, dnsHeader);
+  } else if (answerLength) {
+    replyWithAnswer(pkt, dnsHeader, dnsQuestion, answer, answerLength);
+  } else {
+    replyWithNoAnsw(pkt, dnsHeader, dnsQuestion);
+  }
 }
 
 bool DNSServer::requestIncludesOnlyOneQuestion(DNSHeader &dnsHeader) {
@@ -143,41 +417,27 @@ String DNSServer::getDomainNameWithoutWwwPrefix(const unsigned char *start, size
   return parsedDomainName;
 }
 
-void DNSServer::replyWithIP(AsyncUDPPacket &req, DNSHeader &dnsHeader, DNSQuestion &dnsQuestion) {
-  AsyncUDPMessage rpl;
+void DNSServer::replyWithAnswer(AsyncUDPPacket &req, DNSHeader &dnsHeader, DNSQuestion &dnsQuestion, const uint8_t *answer, size_t answerLength) {
+  uint8_t rpl[DNS_HEADER_SIZE + DNS_MAX_NAME_LEN + 4 + DNS_ANSWER_AAAA_LENGTH];
   // Change the type of message to a response and set the number of answers equal to
   // the number of questions in the header
   dnsHeader.QR = DNS_QR_RESPONSE;
   dnsHeader.ANCount = dnsHeader.QDCount;
-  rpl.write((unsigned char *)&dnsHeader, DNS_HEADER_SIZE);
+  memcpy(rpl, &dnsHeader, DNS_HEADER_SIZE);
 
-  // Write the question
-  rpl.write(dnsQuestion.QName, dnsQuestion.QNameLength);
-  rpl.write((uint8_t *)&dnsQuestion.QType, 2);
-  rpl.write((uint8_t *)&dnsQuestion.QClass, 2);
-
-  // Write the answer
-  // Use DNS name compression : instead of repeating the name in this RNAME occurrence,
-  // set the two MSB of the byte corresponding normally to the length to 1. The following
-  // 14 bits must be used to specify the offset of the domain name in the message
-  // (<255 here so the first byte has the 6 LSB at 0)
-  rpl.write((uint8_t)0xC0);
-  rpl.write((uint8_t)DNS_OFFSET_DOMAIN_NAME);
+  // Copy the question, QName, QType and QClass follow each other in the request
+  size_t len = DNS_HEADER_SIZE + dnsQuestion.QNameLength + sizeof(dnsQuestion.QType) + sizeof(dnsQuestion.QClass);
+  memcpy(rpl + DNS_HEADER_SIZE, dnsQuestion.QName, len - DNS_HEADER_SIZE);
 
-  // DNS type A : host address, DNS class IN for INternet, returning an IPv4 address
-  uint16_t answerType = htons(DNS_TYPE_A), answerClass = htons(DNS_CLASS_IN), answerIPv4 = htons(DNS_RDLENGTH_IPV4);
-  rpl.write((unsigned char *)&answerType, 2);
-  rpl.write((unsigned char *)&answerClass, 2);
-  rpl.write((unsigned char *)&_ttl, 4);  // DNS Time To Live
-  rpl.write((unsigned char *)&answerIPv4, 2);
-  uint32_t ip = _resolvedIP;
-  rpl.write(reinterpret_cast<uint8_t *>(&ip), sizeof(uint32_t));  // The IPv4 address to return
+  // Append the prebuilt answer
+  memcpy(rpl + len, answer, answerLength);
+  len += answerLength;
 
-  _udp.sendTo(rpl, req.remoteIP(), req.remotePort());
+  _udp.writeTo(rpl, len, req.remoteIP(), req.remotePort());
 
 #ifdef DEBUG_ESP_DNS
   DEBUG_OUTPUT.printf(
-    "DNS responds: %s for %s\n", _resolvedIP.toString().c_str(),
+    "DNS responds: %u bytes for %s\n", len,
     getDomainNameWithoutWwwPrefix(static_cast<const unsigned char *>(dnsQuestion.QName), dnsQuestion.QNameLength).c_str()
   );
 #endif
@@ -29,6 +29,14 @@
 #define DNS_SOA_RETRY   10000       // Arbitrary (seconds)
 #define DNS_SOA_EXPIRE  1000000     // Arbitrary (seconds)
 #define DNS_MINIMAL_TTL 5           // Time to live for negative answers RFC2308
+// Compiled zone: names with prebuilt answer records, looked up through a small hash table
+#ifndef DNS_ZONE_MAX_RECORDS
+#define DNS_ZONE_MAX_RECORDS 8
+#endif
+#define DNS_ZONE_BUCKETS         (2 * DNS_ZONE_MAX_RECORDS)  // open addressing, keep the load factor at or below 0.5
+#define DNS_ZONE_MAX_NAME_LENGTH 255                         // domain name in wire format (labels), including the terminating null label (RFC1035 2.3.4)
+#define DNS_ANSWER_A_LENGTH      16                          // name pointer + type + class + TTL + rdlength + IPv4 address
+#define DNS_ANSWER_AAAA_LENGTH   28                          // name pointer + type + class + TTL + rdlength + IPv6 address
 enum class DNSReplyCode : uint16_t {
   NoError = 0,
   FormError = 1,
@@ -86,6 +94,18 @@ struct DNSQuestion {
   uint16_t QClass;
 };
 
+struct DNSZoneRecord {
+  uint32_t hash;                            // hash of the lower case name in wire format
+  uint8_t nameLength;                       // length of name, 0 for the catch-all record
+  uint8_t name[DNS_ZONE_MAX_NAME_LENGTH];   // lower case name in wire format without a leading "www" label
+  uint8_t answerA[DNS_ANSWER_A_LENGTH];     // prebuilt answer appended to the question for A queries
+  uint8_t answerAAAA[DNS_ANSWER_AAAA_LENGTH];  // prebuilt answer appended to the question for AAAA queries
+  IPAddress ipv4;
+  IPAddress ipv6;
+  bool hasA;
+  bool hasAAAA;
+};
+
 class DNSServer {
 public:
   /**
@@ -150,6 +170,33 @@ public:
      */
   bool start(uint16_t port, const String &domainName, const IPAddress &resolvedIP);
 
+  /**
+     * @brief add or update a record of the compiled zone
+     * an IPv4 address sets the A record and an IPv6 address the AAAA record of the name,
+     * so calling it twice with both address types serves both record types.
+     * Records are matched before the domain configured with start().
+     *
+     * @param domainName name to resolve, a leading "www." is ignored, "*" matches any name
+     * @param ip address to reply with
+     * @return true on success
+     * @return false if the name is invalid or the zone is full
+     */
+  bool addRecord(const String &domainName, const IPAddress &ip);
+
+  /**
+     * @brief remove a record (both A and AAAA) from the compiled zone
+     *
+     * @param domainName name of the record
+     * @return true if the record was found and removed
+     */
+  bool removeRecord(const String &domainName);
+
+  /**
+     * @brief remove all records from the compiled zone
+     *
+     */
+  void clearRecords();
+
   /**
      * @brief stops the server and close UDP socket
      *
@@ -185,6 +232,16 @@ private:
   String _domainName;
   IPAddress _resolvedIP;
 
+  // record built from _domainName and _resolvedIP by start()
+  DNSZoneRecord _default;
+  bool _hasDefault;
+  // records added with addRecord() and their hash table of indexes into _zone, -1 marks an empty bucket
+  DNSZoneRecord _zone[DNS_ZONE_MAX_RECORDS];
+  uint8_t _zoneCount;
+  int8_t _zoneIndex[DNS_ZONE_BUCKETS];
+  // the zone is read by the AsyncUDP task and changed by the application
+  portMUX_TYPE _zoneLock = portMUX_INITIALIZER_UNLOCKED;
+
   void downcaseAndRemoveWwwPrefix(String &domainName);
 
   /**
@@ -197,7 +254,14 @@ private:
      */
   String getDomainNameWithoutWwwPrefix(const unsigned char *start, size_t len);
   inline bool requestIncludesOnlyOneQuestion(DNSHeader &dnsHeader);
-  void replyWithIP(AsyncUDPPacket &req, DNSHeader &dnsHeader, DNSQuestion &dnsQuestion);
+
+  bool compileRecord(DNSZoneRecord &record, const String &domainName);
+  void buildAnswers(DNSZoneRecord &record);
+  void setDefault(const DNSZoneRecord &record, bool hasDefault);
+  void rebuildZoneIndex();
+  int findZoneRecord(const uint8_t *name, uint8_t nameLength, uint32_t hash) const;
+  const DNSZoneRecord *lookup(const uint8_t *qname, uint16_t qnameLength) const;
+  void replyWithAnswer(AsyncUDPPacket &req, DNSHeader &dnsHeader, DNSQuestion &dnsQuestion, const uint8_t *answer, size_t answerLength);
   inline void replyWithCustomCode(AsyncUDPPacket &req, DNSHeader &dnsHeader);
   inline void replyWithNoAnsw(AsyncUDPPacket &req, DNSHeader &dnsHeader, DNSQuestion &dnsQuestion);
 
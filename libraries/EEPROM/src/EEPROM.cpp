@@ -45,6 +45,7 @@ bool EEPROMClass::begin(size_t size) {
     return false;
   }
 
+  initNvs();  // in case it was deferred at boot
   esp_err_t res = nvs_open(_name, NVS_READWRITE, &_handle);
   if (res != ESP_OK) {
     log_e("Unable to open NVS namespace: %d", res);
@@ -237,6 +238,7 @@ uint16_t EEPROMClass::convert(bool clear, const char *EEPROMname, const char *nv
   }
 
   nvs_handle handle;
+  initNvs();
   if (nvs_open(nvsname, NVS_READWRITE, &handle) != ESP_OK) {
     log_e("Unable to open NVS");
     goto exit;
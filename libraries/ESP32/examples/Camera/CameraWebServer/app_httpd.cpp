@@ -12,6 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 #include "esp_http_server.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include "esp_timer.h"
 #include "esp_camera.h"
 #include "img_converters.h"
@@ -20,6 +23,7 @@
 #include "sdkconfig.h"
 #include "camera_index.h"
 #include "board_config.h"
+#include "mjpeg_streamer.h"
 
 #if defined(ARDUINO_ARCH_ESP32) && defined(CONFIG_ARDUHAL_ESP_LOG)
 #include "esp32-hal-log.h"
@@ -205,96 +209,186 @@ static esp_err_t capture_handler(httpd_req_t *req) {
   return res;
 }
 
-static esp_err_t stream_handler(httpd_req_t *req) {
-  camera_fb_t *fb = NULL;
-  struct timeval _timestamp;
-  esp_err_t res = ESP_OK;
-  size_t _jpg_buf_len = 0;
-  uint8_t *_jpg_buf = NULL;
-  char *part_buf[128];
+// One producer task captures and encodes, every viewer gets its own sender task fed by the streamer
+static MjpegStreamer *streamer = NULL;
+static TaskHandle_t stream_producer = NULL;
+
+typedef struct {
+  httpd_req_t *req;
+  int id;
+} stream_client_t;
 
-  static int64_t last_frame = 0;
-  if (!last_frame) {
-    last_frame = esp_timer_get_time();
+static void free_jpg(mjpeg_frame_t *frame) {
+  free((void *)frame->buf);
+}
+
+static bool camera_source(mjpeg_frame_t *frame, void *arg) {
+  camera_fb_t *fb = esp_camera_fb_get();
+  if (!fb) {
+    log_e("Camera capture failed");
+    return false;
+  }
+  frame->timestamp_us = (int64_t)fb->timestamp.tv_sec * 1000000 + fb->timestamp.tv_usec;
+  frame->free_cb = free_jpg;
+  uint8_t *jpg = NULL;
+  size_t jpg_len = 0;
+  if (fb->format != PIXFORMAT_JPEG) {
+    if (!frame2jpg(fb, 80, &jpg, &jpg_len)) {
+      log_e("JPEG compression failed");
+    }
+  } else {
+    // copied, so the driver gets its buffer back at once and a slow viewer can not stall the capture
+    jpg = (uint8_t *)heap_caps_malloc(fb->len, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!jpg) {
+      jpg = (uint8_t *)malloc(fb->len);
+    }
+    if (jpg) {
+      memcpy(jpg, fb->buf, fb->len);
+      jpg_len = fb->len;
+    } else {
+      log_e("No memory for the frame");
+    }
   }
+  esp_camera_fb_return(fb);
+  frame->buf = jpg;
+  frame->len = jpg_len;
+  return jpg != NULL;
+}
 
-  res = httpd_resp_set_type(req, _STREAM_CONTENT_TYPE);
-  if (res != ESP_OK) {
-    return res;
+static void stream_producer_task(void *arg) {
+#if ARDUHAL_LOG_LEVEL >= ARDUHAL_LOG_LEVEL_INFO
+  int64_t last_frame = 0;
+#endif
+  while (true) {
+    // blocks while no one watches
+    if (!streamer->produce(1000)) {
+#if ARDUHAL_LOG_LEVEL >= ARDUHAL_LOG_LEVEL_INFO
+      last_frame = 0;
+#endif
+      continue;
+    }
+#if ARDUHAL_LOG_LEVEL >= ARDUHAL_LOG_LEVEL_INFO
+    int64_t fr_end = esp_timer_get_time();
+    if (last_frame) {
+      uint32_t frame_time = (uint32_t)((fr_end - last_frame) / 1000);
+      uint32_t avg_frame_time = ra_filter_run(&ra_filter, frame_time);
+      mjpeg_producer_stats_t stats;
+      streamer->getStats(&stats);
+      log_i(
+        "MJPG: %lums (%.1ffps), AVG: %lums (%.1ffps), encode %luus, %lu viewers", frame_time, 1000.0 / frame_time, avg_frame_time, 1000.0 / avg_frame_time,
+        stats.capture_us, stats.clients
+      );
+    }
+    last_frame = fr_end;
+#endif
   }
+}
+
+static void stream_client_task(void *arg) {
+  stream_client_t *client = (stream_client_t *)arg;
+  httpd_req_t *req = client->req;
+  esp_err_t res = ESP_OK;
+  char part_buf[128];
 
+  httpd_resp_set_type(req, _STREAM_CONTENT_TYPE);
   httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
   httpd_resp_set_hdr(req, "X-Framerate", "60");
 
-#if defined(LED_GPIO_NUM)
-  isStreaming = true;
-  enable_led(true);
-#endif
-
-  while (true) {
-    fb = esp_camera_fb_get();
-    if (!fb) {
-      log_e("Camera capture failed");
-      res = ESP_FAIL;
-    } else {
-      _timestamp.tv_sec = fb->timestamp.tv_sec;
-      _timestamp.tv_usec = fb->timestamp.tv_usec;
-      if (fb->format != PIXFORMAT_JPEG) {
-        bool jpeg_converted = frame2jpg(fb, 80, &_jpg_buf, &_jpg_buf_len);
-        esp_camera_fb_return(fb);
-        fb = NULL;
-        if (!jpeg_converted) {
-          log_e("JPEG compression failed");
-          res = ESP_FAIL;
-        }
-      } else {
-        _jpg_buf_len = fb->len;
-        _jpg_buf = fb->buf;
-      }
-    }
-    if (res == ESP_OK) {
-      res = httpd_resp_send_chunk(req, _STREAM_BOUNDARY, strlen(_STREAM_BOUNDARY));
+  while (res == ESP_OK) {
+    mjpeg_frame_t *frame = streamer->nextFrame(client->id, 5000);
+    if (frame == NULL) {
+      log_e("No frame from the camera");
+      break;
     }
+    res = httpd_resp_send_chunk(req, _STREAM_BOUNDARY, strlen(_STREAM_BOUNDARY));
     if (res == ESP_OK) {
-      size_t hlen = snprintf((char *)part_buf, 128, _STREAM_PART, _jpg_buf_len, _timestamp.tv_sec, _timestamp.tv_usec);
-      res = httpd_resp_send_chunk(req, (const char *)part_buf, hlen);
+      size_t hlen = snprintf(
+        part_buf, sizeof(part_buf), _STREAM_PART, frame->len, (int)(frame->timestamp_us / 1000000), (int)(frame->timestamp_us % 1000000)
+      );
+      res = httpd_resp_send_chunk(req, part_buf, hlen);
     }
     if (res == ESP_OK) {
-      res = httpd_resp_send_chunk(req, (const char *)_jpg_buf, _jpg_buf_len);
-    }
-    if (fb) {
-      esp_camera_fb_return(fb);
-      fb = NULL;
-      _jpg_buf = NULL;
-    } else if (_jpg_buf) {
-      free(_jpg_buf);
-      _jpg_buf = NULL;
-    }
-    if (res != ESP_OK) {
-      log_e("Send frame failed");
-      break;
+      res = httpd_resp_send_chunk(req, (const char *)frame->buf, frame->len);
     }
-    int64_t fr_end = esp_timer_get_time();
-
-    int64_t frame_time = fr_end - last_frame;
-    last_frame = fr_end;
+    streamer->frameDone(client->id, frame, res == ESP_OK);
+  }
 
-    frame_time /= 1000;
 #if ARDUHAL_LOG_LEVEL >= ARDUHAL_LOG_LEVEL_INFO
-    uint32_t avg_frame_time = ra_filter_run(&ra_filter, frame_time);
-#endif
+  mjpeg_client_stats_t stats;
+  if (streamer->getClientStats(client->id, &stats)) {
     log_i(
-      "MJPG: %uB %ums (%.1ffps), AVG: %ums (%.1ffps)", (uint32_t)(_jpg_buf_len), (uint32_t)frame_time, 1000.0 / (uint32_t)frame_time, avg_frame_time,
-      1000.0 / avg_frame_time
+      "Viewer %d left after %lums: %lu frames sent, %lu dropped, %.1ffps", client->id, stats.connected_ms, stats.frames_sent, stats.frames_dropped, stats.fps
     );
   }
+#endif
+  streamer->removeClient(client->id);
+#if defined(LED_GPIO_NUM)
+  if (streamer->clientCount() == 0) {
+    isStreaming = false;
+    enable_led(false);
+  }
+#endif
+  httpd_req_async_handler_complete(req);
+  free(client);
+  vTaskDelete(NULL);
+}
+
+static esp_err_t stream_handler(httpd_req_t *req) {
+  int id = streamer->addClient();
+  if (id < 0) {
+    httpd_resp_set_status(req, "503 Service Unavailable");
+    return httpd_resp_sendstr(req, "Too many viewers");
+  }
+
+  // the sender task keeps the connection, so the server can accept the next viewer
+  stream_client_t *client = (stream_client_t *)malloc(sizeof(stream_client_t));
+  if (client == NULL || httpd_req_async_handler_begin(req, &client->req) != ESP_OK) {
+    free(client);
+    streamer->removeClient(id);
+    return httpd_resp_send_500(req);
+  }
+  client->id = id;
 
 #if defined(LED_GPIO_NUM)
-  isStreaming = false;
-  enable_led(false);
+  isStreaming = true;
+  enable_led(true);
 #endif
 
-  return res;
+  if (xTaskCreate(stream_client_task, "stream_client", 4096, client, 5, NULL) != pdPASS) {
+    log_e("Failed to start the stream task");
+    streamer->removeClient(id);
+    httpd_req_async_handler_complete(client->req);
+    free(client);
+    return ESP_FAIL;
+  }
+  return ESP_OK;
+}
+
+static esp_err_t stream_stats_handler(httpd_req_t *req) {
+  char json_response[128 + MJPEG_MAX_CLIENTS * 128];
+  mjpeg_producer_stats_t stats;
+  streamer->getStats(&stats);
+  char *p = json_response;
+  char *end = json_response + sizeof(json_response);
+  p += snprintf(
+    p, end - p, "{\"frames\":%lu,\"failures\":%lu,\"fps\":%.1f,\"encode_us\":%lu,\"viewers\":[", stats.frames, stats.failures, stats.fps, stats.capture_us
+  );
+  bool first = true;
+  for (int i = 0; i < MJPEG_MAX_CLIENTS; i++) {
+    mjpeg_client_stats_t client;
+    if (!streamer->getClientStats(i, &client)) {
+      continue;
+    }
+    p += snprintf(
+      p, end - p, "%s{\"id\":%d,\"fps\":%.1f,\"sent\":%lu,\"dropped\":%lu,\"connected_ms\":%lu}", first ? "" : ",", i, client.fps, client.frames_sent,
+      client.frames_dropped, client.connected_ms
+    );
+    first = false;
+  }
+  snprintf(p, end - p, "]}");
+  httpd_resp_set_type(req, "application/json");
+  httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+  return httpd_resp_sendstr(req, json_response);
 }
 
 static esp_err_t parse_get(httpd_req_t *req, char **obuf) {
@@ -736,6 +830,19 @@ void startCameraServer() {
 #endif
   };
 
+  httpd_uri_t stream_stats_uri = {
+    .uri = "/stream_stats",
+    .method = HTTP_GET,
+    .handler = stream_stats_handler,
+    .user_ctx = NULL
+#ifdef CONFIG_HTTPD_WS_SUPPORT
+    ,
+    .is_websocket = true,
+    .handle_ws_control_frames = false,
+    .supported_subprotocol = NULL
+#endif
+  };
+
   httpd_uri_t bmp_uri = {
     .uri = "/bmp",
     .method = HTTP_GET,
@@ -816,6 +923,9 @@ void startCameraServer() {
 
   ra_filter_init(&ra_filter, 20);
 
+  streamer = new MjpegStreamer(camera_source);
+  xTaskCreate(stream_producer_task, "stream_producer", config.stack_size, NULL, 5, &stream_producer);
+
   log_i("Starting web server on port: '%d'", config.server_port);
   if (httpd_start(&camera_httpd, &config) == ESP_OK) {
     httpd_register_uri_handler(camera_httpd, &index_uri);
@@ -823,6 +933,7 @@ void startCameraServer() {
     httpd_register_uri_handler(camera_httpd, &status_uri);
     httpd_register_uri_handler(camera_httpd, &capture_uri);
     httpd_register_uri_handler(camera_httpd, &bmp_uri);
+    httpd_register_uri_handler(camera_httpd, &stream_stats_uri);
 
     httpd_register_uri_handler(camera_httpd, &xclk_uri);
     httpd_register_uri_handler(camera_httpd, &reg_uri);
@@ -0,0 +1,227 @@
+// Copyright 2025 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "mjpeg_streamer.h"
+#include <string.h>
+#include <chrono>
+
+// weight of the newest interval in the moving averages
+#define FPS_ALPHA 0.2f
+
+static int64_t now_us() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static float update_fps(float fps, int64_t interval_us) {
+  if (interval_us <= 0) {
+    return fps;
+  }
+  float current = 1000000.0f / interval_us;
+  return (fps == 0) ? current : fps + FPS_ALPHA * (current - fps);
+}
+
+MjpegStreamer::MjpegStreamer(mjpeg_source_cb_t source, void *arg)
+  : _source(source), _arg(arg), _latest(NULL), _seq(0), _stopped(false), _clients(0), _lastFrameUs(0) {
+  memset(&_stats, 0, sizeof(_stats));
+  memset(_client, 0, sizeof(_client));
+}
+
+MjpegStreamer::~MjpegStreamer() {
+  stop();
+  if (_latest != NULL) {
+    release(_latest);
+    _latest = NULL;
+  }
+}
+
+void MjpegStreamer::release(mjpeg_frame_t *frame) {
+  if (frame->refs.fetch_sub(1) == 1) {
+    if (frame->free_cb != NULL) {
+      frame->free_cb(frame);
+    }
+    delete frame;
+  }
+}
+
+bool MjpegStreamer::produce(uint32_t timeoutMs) {
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    // nobody is watching: do not capture and encode for nothing
+    if (!_cond.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this] {
+          return _stopped || _clients > 0;
+        })) {
+      return false;
+    }
+    if (_stopped) {
+      return false;
+    }
+  }
+
+  mjpeg_frame_t *frame = new mjpeg_frame_t();
+  frame->refs = 1;  // the reference of _latest
+  int64_t start = now_us();
+  bool ok = _source(frame, _arg) && frame->buf != NULL;
+  int64_t end = now_us();
+
+  mjpeg_frame_t *old = NULL;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stats.capture_us = (uint32_t)(end - start);
+    if (ok && _clients == 0) {
+      ok = false;  // the last client left during the capture, do not keep the frame around
+    } else if (ok) {
+      frame->seq = ++_seq;
+      old = _latest;
+      _latest = frame;
+      _stats.frames++;
+      if (_lastFrameUs) {
+        _stats.fps = update_fps(_stats.fps, end - _lastFrameUs);
+      }
+      _lastFrameUs = end;
+    } else if (_clients) {
+      _stats.failures++;
+    }
+  }
+  if (!ok) {
+    release(frame);
+    return false;
+  }
+  _cond.notify_all();
+  if (old != NULL) {
+    release(old);  // freed here unless a client is still sending it
+  }
+  return true;
+}
+
+int MjpegStreamer::addClient() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (_stopped) {
+    return -1;
+  }
+  for (int i = 0; i < MJPEG_MAX_CLIENTS; i++) {
+    Client &c = _client[i];
+    if (!c.active) {
+      memset(&c, 0, sizeof(c));
+      c.active = true;
+      // the latest frame may be old if no one watched, wait for a fresh one
+      c.lastSeq = _seq;
+      c.connectedUs = now_us();
+      _clients++;
+      _stats.clients = _clients;
+      _cond.notify_all();
+      return i;
+    }
+  }
+  return -1;
+}
+
+void MjpegStreamer::removeClient(int id) {
+  if (id < 0 || id >= MJPEG_MAX_CLIENTS) {
+    return;
+  }
+  mjpeg_frame_t *idle = NULL;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_client[id].active) {
+      return;
+    }
+    _client[id].active = false;
+    _clients--;
+    _stats.clients = _clients;
+    if (_clients == 0) {
+      // free the frame buffer while no one watches
+      idle = _latest;
+      _latest = NULL;
+    }
+  }
+  _cond.notify_all();
+  if (idle != NULL) {
+    release(idle);
+  }
+}
+
+mjpeg_frame_t *MjpegStreamer::nextFrame(int id, uint32_t timeoutMs) {
+  if (id < 0 || id >= MJPEG_MAX_CLIENTS) {
+    return NULL;
+  }
+  std::unique_lock<std::mutex> lock(_mutex);
+  Client &c = _client[id];
+  if (!_cond.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this, &c] {
+        return _stopped || !c.active || (_latest != NULL && _latest->seq != c.lastSeq);
+      })) {
+    return NULL;
+  }
+  if (_stopped || !c.active) {
+    return NULL;
+  }
+  // drop to latest: the frames published while this client was busy are skipped
+  c.stats.frames_dropped += _latest->seq - c.lastSeq - 1;
+  c.lastSeq = _latest->seq;
+  _latest->refs++;
+  return _latest;
+}
+
+void MjpegStreamer::frameDone(int id, mjpeg_frame_t *frame, bool sent) {
+  if (id >= 0 && id < MJPEG_MAX_CLIENTS && sent) {
+    int64_t now = now_us();
+    std::lock_guard<std::mutex> lock(_mutex);
+    Client &c = _client[id];
+    c.stats.frames_sent++;
+    c.stats.bytes_sent += frame->len;
+    if (c.lastSentUs) {
+      c.stats.fps = update_fps(c.stats.fps, now - c.lastSentUs);
+    }
+    c.lastSentUs = now;
+  }
+  release(frame);
+}
+
+void MjpegStreamer::stop() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stopped = true;
+  }
+  _cond.notify_all();
+}
+
+bool MjpegStreamer::stopped() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _stopped;
+}
+
+size_t MjpegStreamer::clientCount() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _clients;
+}
+
+bool MjpegStreamer::getClientStats(int id, mjpeg_client_stats_t *stats) {
+  if (id < 0 || id >= MJPEG_MAX_CLIENTS || stats == NULL) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(_mutex);
+  Client &c = _client[id];
+  if (!c.active) {
+    return false;
+  }
+  *stats = c.stats;
+  stats->connected_ms = (uint32_t)((now_us() - c.connectedUs) / 1000);
+  return true;
+}
+
+void MjpegStreamer::getStats(mjpeg_producer_stats_t *stats) {
+  if (stats == NULL) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(_mutex);
+  *stats = _stats;
+}
@@ -0,0 +1,114 @@
+// Copyright 2025 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+/*
+ * Shared frame MJPEG streaming
+ *
+ * One producer captures and encodes every frame once, all clients send that same buffer.
+ * Frames are reference counted: the streamer holds the latest one, every client holds the
+ * one it is sending. A client that is slower than the camera skips to the latest frame when
+ * it is done instead of queueing, so it never slows down the producer or the other clients.
+ *
+ * Only standard C++ is used here, the camera and HTTP parts live in app_httpd.cpp, so the
+ * fan out can be tested on the host with a synthetic source (see extras/).
+ */
+
+#ifndef MJPEG_MAX_CLIENTS
+#define MJPEG_MAX_CLIENTS 4
+#endif
+
+struct mjpeg_frame_t {
+  const uint8_t *buf;
+  size_t len;
+  int64_t timestamp_us;                    // capture time, set by the source
+  uint32_t seq;                            // set by the streamer, starts at 1
+  void (*free_cb)(mjpeg_frame_t *frame);  // set by the source, frees buf once no one uses the frame
+  void *ctx;                               // for the source
+  std::atomic<int> refs;
+};
+
+// Fills buf, len, timestamp_us and free_cb of frame. Returns false if there is no frame
+typedef bool (*mjpeg_source_cb_t)(mjpeg_frame_t *frame, void *arg);
+
+typedef struct {
+  uint32_t frames_sent;
+  uint32_t frames_dropped;  // frames that were replaced by a newer one before the client got to them
+  uint64_t bytes_sent;
+  float fps;                // moving average of the send rate
+  uint32_t connected_ms;
+} mjpeg_client_stats_t;
+
+typedef struct {
+  uint32_t frames;    // captured and encoded
+  uint32_t failures;  // source calls that returned no frame
+  uint32_t clients;
+  float fps;
+  uint32_t capture_us;  // duration of the last source call
+} mjpeg_producer_stats_t;
+
+class MjpegStreamer {
+public:
+  MjpegStreamer(mjpeg_source_cb_t source, void *arg = NULL);
+  ~MjpegStreamer();
+
+  // Producer side, to be called in a loop from one task. Waits up to timeoutMs for a client,
+  // then captures one frame and hands it to all clients. Returns false if nothing was produced
+  bool produce(uint32_t timeoutMs);
+
+  // Client side. addClient() returns the client id or -1 when all slots are taken
+  int addClient();
+  void removeClient(int id);
+  // Waits for a frame newer than the last one the client got. The frame stays valid until
+  // frameDone(). Returns NULL on timeout or after stop()
+  mjpeg_frame_t *nextFrame(int id, uint32_t timeoutMs);
+  void frameDone(int id, mjpeg_frame_t *frame, bool sent);
+
+  // Wakes up all waiting clients and the producer, nextFrame() and produce() return at once
+  void stop();
+  bool stopped();
+
+  size_t clientCount();
+  bool getClientStats(int id, mjpeg_client_stats_t *stats);
+  void getStats(mjpeg_producer_stats_t *stats);
+
+private:
+  struct Client {
+    bool active;
+    uint32_t lastSeq;
+    int64_t connectedUs;
+    int64_t lastSentUs;
+    mjpeg_client_stats_t stats;
+  };
+
+  static void release(mjpeg_frame_t *frame);
+
+  mjpeg_source_cb_t _source;
+  void *_arg;
+  std::mutex _mutex;
+  std::condition_variable _cond;
+  mjpeg_frame_t *_latest;
+  uint32_t _seq;
+  bool _stopped;
+  size_t _clients;
+  int64_t _lastFrameUs;
+  mjpeg_producer_stats_t _stats;
+  Client _client[MJPEG_MAX_CLIENTS];
+};
@@ -8,11 +8,99 @@
 #include "esp_system.h"
 #include "esp32-hal.h"
 #include "esp_wifi.h"
+#include "esp_timer.h"
+
+// Open addressed MAC -> _esp_now_peers[] slot index. Must be a power of two larger than the peer table.
+#define ESP_NOW_PEER_INDEX_SIZE 32
+static_assert(ESP_NOW_PEER_INDEX_SIZE > ESP_NOW_MAX_TOTAL_PEER_NUM, "ESP_NOW_PEER_INDEX_SIZE is too small");
+static_assert((ESP_NOW_PEER_INDEX_SIZE & (ESP_NOW_PEER_INDEX_SIZE - 1)) == 0, "ESP_NOW_PEER_INDEX_SIZE must be a power of two");
 
 static void (*new_cb)(const esp_now_recv_info_t *info, const uint8_t *data, int len, void *arg) = nullptr;
 static void *new_arg = nullptr;  // * tx_arg = nullptr, * rx_arg = nullptr,
 static bool _esp_now_has_begun = false;
 static ESP_NOW_Peer *_esp_now_peers[ESP_NOW_MAX_TOTAL_PEER_NUM];
+static int8_t _esp_now_peer_index[ESP_NOW_PEER_INDEX_SIZE];
+static portMUX_TYPE _esp_now_peer_mux = portMUX_INITIALIZER_UNLOCKED;
+
+// Deferred receive: frames are copied into a preallocated pool and dispatched by a worker task
+typedef struct {
+  int64_t timestamp;
+  wifi_pkt_rx_ctrl_t rx_ctrl;
+  uint8_t src_addr[ESP_NOW_ETH_ALEN];
+  uint8_t des_addr[ESP_NOW_ETH_ALEN];
+  uint16_t len;
+} esp_now_rx_frame_t;
+
+#define ESP_NOW_RX_TASK_STOP 0xFF
+
+static uint8_t *_esp_now_rx_pool = nullptr;
+static size_t _esp_now_rx_slot_size = 0;
+static size_t _esp_now_rx_data_size = 0;
+static QueueHandle_t _esp_now_rx_free_queue = nullptr;
+static QueueHandle_t _esp_now_rx_ready_queue = nullptr;
+static TaskHandle_t _esp_now_rx_task = nullptr;
+static TaskHandle_t _esp_now_rx_task_waiter = nullptr;
+static volatile bool _esp_now_rx_deferred = false;
+static volatile uint8_t _esp_now_rx_cb_active = 0;  // receive callbacks currently using the pool
+static portMUX_TYPE _esp_now_rx_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static esp_now_stats_t _esp_now_stats;
+static uint64_t _esp_now_rx_latency_sum = 0;
+static uint32_t _esp_now_rx_latency_count = 0;
+
+static inline uint8_t _esp_now_mac_hash(const uint8_t *mac_addr) {
+  // The first three bytes are usually the same vendor OUI, so only the NIC specific part is hashed
+  uint32_t h = 2166136261UL;
+  for (uint8_t i = 3; i < ESP_NOW_ETH_ALEN; i++) {
+    h = (h ^ mac_addr[i]) * 16777619UL;
+  }
+  return (h ^ (h >> 16)) & (ESP_NOW_PEER_INDEX_SIZE - 1);
+}
+
+// must be called with _esp_now_peer_mux held
+static void _esp_now_index_insert(uint8_t slot) {
+  uint8_t h = _esp_now_mac_hash(_esp_now_peers[slot]->addr());
+  while (_esp_now_peer_index[h] >= 0) {
+    h = (h + 1) & (ESP_NOW_PEER_INDEX_SIZE - 1);
+  }
+  _esp_now_peer_index[h] = slot;
+}
+
+// must be called with _esp_now_peer_mux held
+static void _esp_now_index_rebuild() {
+  memset(_esp_now_peer_index, -1, sizeof(_esp_now_peer_index));
+  for (uint8_t i = 0; i < ESP_NOW_MAX_TOTAL_PEER_NUM; i++) {
+    if (_esp_now_peers[i] != nullptr) {
+      _esp_now_index_insert(i);
+    }
+  }
+}
+
+static void _esp_now_clear_peers() {
+  portENTER_CRITICAL(&_esp_now_peer_mux);
+  memset(_esp_now_peers, 0, sizeof(ESP_NOW_Peer *) * ESP_NOW_MAX_TOTAL_PEER_NUM);
+  memset(_esp_now_peer_index, -1, sizeof(_esp_now_peer_index));
+  portEXIT_CRITICAL(&_esp_now_peer_mux);
+}
+
+static ESP_NOW_Peer *_esp_now_find_peer(const uint8_t *mac_addr) {
+  ESP_NOW_Peer *peer = nullptr;
+  uint8_t h = _esp_now_mac_hash(mac_addr);
+  portENTER_CRITICAL(&_esp_now_peer_mux);
+  for (uint8_t n = 0; n < ESP_NOW_PEER_INDEX_SIZE; n++) {
+    int8_t slot = _esp_now_peer_index[h];
+    if (slot < 0) {
+      break;
+    }
+    if (memcmp(mac_addr, _esp_now_peers[slot]->addr(), ESP_NOW_ETH_ALEN) == 0) {
+      peer = _esp_now_peers[slot];
+      break;
+    }
+    h = (h + 1) & (ESP_NOW_PEER_INDEX_SIZE - 1);
+  }
+  portEXIT_CRITICAL(&_esp_now_peer_mux);
+  return peer;
+}
 
 static esp_err_t _esp_now_add_peer(const uint8_t *mac_addr, uint8_t channel, wifi_interface_t iface, const uint8_t *lmk, ESP_NOW_Peer *_peer = nullptr) {
   log_v(MACSTR, MAC2STR(mac_addr));
@@ -34,13 +122,18 @@ static esp_err_t _esp_now_add_peer(const uint8_t *mac_addr, uint8_t channel, wif
   esp_err_t result = esp_now_add_peer(&peer);
   if (result == ESP_OK) {
     if (_peer != nullptr) {
+      esp_err_t err = ESP_FAIL;
+      portENTER_CRITICAL(&_esp_now_peer_mux);
       for (uint8_t i = 0; i < ESP_NOW_MAX_TOTAL_PEER_NUM; i++) {
         if (_esp_now_peers[i] == nullptr) {
           _esp_now_peers[i] = _peer;
-          return ESP_OK;
+          _esp_now_index_insert(i);
+          err = ESP_OK;
+          break;
         }
       }
-      return ESP_FAIL;
+      portEXIT_CRITICAL(&_esp_now_peer_mux);
+      return err;
     }
   } else if (result == ESP_ERR_ESPNOW_NOT_INIT) {
     log_e("ESPNOW Not Init");
@@ -66,12 +159,15 @@ static esp_err_t _esp_now_del_peer(const uint8_t *mac_addr) {
     log_e("Peer Not Found");
   }
 
+  portENTER_CRITICAL(&_esp_now_peer_mux);
   for (uint8_t i = 0; i < ESP_NOW_MAX_TOTAL_PEER_NUM; i++) {
     if (_esp_now_peers[i] != nullptr && memcmp(mac_addr, _esp_now_peers[i]->addr(), ESP_NOW_ETH_ALEN) == 0) {
       _esp_now_peers[i] = nullptr;
+      _esp_now_index_rebuild();
       break;
     }
   }
+  portEXIT_CRITICAL(&_esp_now_peer_mux);
   return result;
 }
 
@@ -107,36 +203,107 @@ static esp_err_t _esp_now_modify_peer(const uint8_t *mac_addr, uint8_t channel,
   return result;
 }
 
-static void _esp_now_rx_cb(const esp_now_recv_info_t *info, const uint8_t *data, int len) {
+static void _esp_now_dispatch(const esp_now_recv_info_t *info, const uint8_t *data, int len) {
   bool broadcast = memcmp(info->des_addr, ESP_NOW.BROADCAST_ADDR, ESP_NOW_ETH_ALEN) == 0;
   log_v("%s from " MACSTR ", data length : %u", broadcast ? "Broadcast" : "Unicast", MAC2STR(info->src_addr), len);
   log_buf_v(data, len);
-  if (!esp_now_is_peer_exist(info->src_addr) && new_cb != nullptr) {
+  //find the peer and call it's callback
+  ESP_NOW_Peer *peer = _esp_now_find_peer(info->src_addr);
+  if (peer != nullptr) {
+    log_v("Calling onReceive");
+    _esp_now_stats.rx_frames++;
+    peer->onReceive(data, len, broadcast);
+    return;
+  }
+  if (new_cb != nullptr && !esp_now_is_peer_exist(info->src_addr)) {
     log_v("Calling new_cb, peer not found.");
+    _esp_now_stats.rx_frames++;
     new_cb(info, data, len, new_arg);
     return;
   }
-  //find the peer and call it's callback
-  for (uint8_t i = 0; i < ESP_NOW_MAX_TOTAL_PEER_NUM; i++) {
-    if (_esp_now_peers[i] != nullptr) {
-      log_v("Checking peer " MACSTR, MAC2STR(_esp_now_peers[i]->addr()));
+  _esp_now_stats.rx_unknown++;
+}
+
+static inline esp_now_rx_frame_t *_esp_now_rx_slot(uint8_t slot) {
+  return (esp_now_rx_frame_t *)(_esp_now_rx_pool + slot * _esp_now_rx_slot_size);
+}
+
+static void _esp_now_rx_task_fn(void *arg) {
+  uint8_t slot;
+  for (;;) {
+    if (xQueueReceive(_esp_now_rx_ready_queue, &slot, portMAX_DELAY) != pdTRUE) {
+      continue;
     }
-    if (_esp_now_peers[i] != nullptr && memcmp(info->src_addr, _esp_now_peers[i]->addr(), ESP_NOW_ETH_ALEN) == 0) {
-      log_v("Calling onReceive");
-      _esp_now_peers[i]->onReceive(data, len, broadcast);
-      return;
+    if (slot == ESP_NOW_RX_TASK_STOP) {
+      break;
     }
+    esp_now_rx_frame_t *frame = _esp_now_rx_slot(slot);
+    uint32_t latency = (uint32_t)(esp_timer_get_time() - frame->timestamp);
+    if (latency > _esp_now_stats.rx_latency_max_us) {
+      _esp_now_stats.rx_latency_max_us = latency;
+    }
+    _esp_now_rx_latency_sum += latency;
+    _esp_now_rx_latency_count++;
+
+    esp_now_recv_info_t info;
+    info.src_addr = frame->src_addr;
+    info.des_addr = frame->des_addr;
+    info.rx_ctrl = &frame->rx_ctrl;
+    _esp_now_dispatch(&info, (const uint8_t *)(frame + 1), frame->len);
+    xQueueSend(_esp_now_rx_free_queue, &slot, 0);
+  }
+  xTaskNotifyGive(_esp_now_rx_task_waiter);
+  vTaskDelete(NULL);
+}
+
+static void _esp_now_rx_cb(const esp_now_recv_info_t *info, const uint8_t *data, int len) {
+  // disableDeferredReceive() waits for callbacks that saw the pool before freeing it
+  portENTER_CRITICAL(&_esp_now_rx_mux);
+  bool deferred = _esp_now_rx_deferred;
+  if (deferred) {
+    _esp_now_rx_cb_active++;
+  }
+  portEXIT_CRITICAL(&_esp_now_rx_mux);
+  if (!deferred) {
+    _esp_now_dispatch(info, data, len);
+    return;
   }
+  uint8_t slot;
+  if (len < 0 || (size_t)len > _esp_now_rx_data_size || xQueueReceive(_esp_now_rx_free_queue, &slot, 0) != pdTRUE) {
+    _esp_now_stats.rx_dropped++;
+    portENTER_CRITICAL(&_esp_now_rx_mux);
+    _esp_now_rx_cb_active--;
+    portEXIT_CRITICAL(&_esp_now_rx_mux);
+    return;
+  }
+  esp_now_rx_frame_t *frame = _esp_now_rx_slot(slot);
+  frame->timestamp = esp_timer_get_time();
+  frame->rx_ctrl = *info->rx_ctrl;
+  memcpy(frame->src_addr, info->src_addr, ESP_NOW_ETH_ALEN);
+  memcpy(frame->des_addr, info->des_addr, ESP_NOW_ETH_ALEN);
+  frame->len = len;
+  memcpy(frame + 1, data, len);
+  xQueueSend(_esp_now_rx_ready_queue, &slot, 0);
+  UBaseType_t waiting = uxQueueMessagesWaiting(_esp_now_rx_ready_queue);
+  if (waiting > _esp_now_stats.rx_queue_max) {
+    _esp_now_stats.rx_queue_max = waiting;
+  }
+  portENTER_CRITICAL(&_esp_now_rx_mux);
+  _esp_now_rx_cb_active--;
+  portEXIT_CRITICAL(&_esp_now_rx_mux);
 }
 
 static void _esp_now_tx_cb(const uint8_t *mac_addr, esp_now_send_status_t status) {
   log_v(MACSTR " : %s", MAC2STR(mac_addr), (status == ESP_NOW_SEND_SUCCESS) ? "SUCCESS" : "FAILED");
+  if (status == ESP_NOW_SEND_SUCCESS) {
+    _esp_now_stats.tx_ok++;
+  } else {
+    _esp_now_stats.tx_fail++;
+  }
   //find the peer and call it's callback
-  for (uint8_t i = 0; i < ESP_NOW_MAX_TOTAL_PEER_NUM; i++) {
-    if (_esp_now_peers[i] != nullptr && memcmp(mac_addr, _esp_now_peers[i]->addr(), ESP_NOW_ETH_ALEN) == 0) {
-      _esp_now_peers[i]->onSent(status == ESP_NOW_SEND_SUCCESS);
-      return;
-    }
+  ESP_NOW_Peer *peer = _esp_now_find_peer(mac_addr);
+  if (peer != nullptr) {
+    peer->onSent(status == ESP_NOW_SEND_SUCCESS);
   }
 }
 
@@ -177,7 +344,7 @@ bool ESP_NOW_Class::begin(const uint8_t *pmk) {
 
   _esp_now_has_begun = true;
 
-  memset(_esp_now_peers, 0, sizeof(ESP_NOW_Peer *) * ESP_NOW_MAX_TOTAL_PEER_NUM);
+  _esp_now_clear_peers();
 
   err = esp_now_init();
   if (err != ESP_OK) {
@@ -215,6 +382,7 @@ bool ESP_NOW_Class::end() {
   if (!_esp_now_has_begun) {
     return true;
   }
+  disableDeferredReceive();
   //remove all peers
   for (uint8_t i = 0; i < ESP_NOW_MAX_TOTAL_PEER_NUM; i++) {
     if (_esp_now_peers[i] != nullptr) {
@@ -228,7 +396,7 @@ bool ESP_NOW_Class::end() {
   }
   _esp_now_has_begun = false;
   //clear the peer list
-  memset(_esp_now_peers, 0, sizeof(ESP_NOW_Peer *) * ESP_NOW_MAX_TOTAL_PEER_NUM);
+  _esp_now_clear_peers();
   return true;
 }
 
@@ -319,6 +487,119 @@ bool ESP_NOW_Class::removePeer(ESP_NOW_Peer &peer) {
   return peer.remove();
 }
 
+bool ESP_NOW_Class::enableDeferredReceive(size_t queue_len, uint32_t stack_size, UBaseType_t priority, BaseType_t core) {
+  if (!_esp_now_has_begun) {
+    log_e("ESP-NOW not initialized. Please call begin() first.");
+    return false;
+  }
+  if (_esp_now_rx_deferred) {
+    return true;
+  }
+  if (queue_len == 0 || queue_len >= ESP_NOW_RX_TASK_STOP) {
+    log_e("Invalid queue length %u", queue_len);
+    return false;
+  }
+
+  _esp_now_rx_data_size = max_data_len;
+  _esp_now_rx_slot_size = (sizeof(esp_now_rx_frame_t) + _esp_now_rx_data_size + 3) & ~3;
+  _esp_now_rx_pool = (uint8_t *)malloc(_esp_now_rx_slot_size * queue_len);
+  _esp_now_rx_free_queue = xQueueCreate(queue_len, sizeof(uint8_t));
+  _esp_now_rx_ready_queue = xQueueCreate(queue_len + 1, sizeof(uint8_t));
+  if (_esp_now_rx_pool == nullptr || _esp_now_rx_free_queue == nullptr || _esp_now_rx_ready_queue == nullptr) {
+    log_e("Failed to allocate the deferred receive pool");
+    disableDeferredReceive();
+    return false;
+  }
+  for (uint8_t i = 0; i < queue_len; i++) {
+    xQueueSend(_esp_now_rx_free_queue, &i, 0);
+  }
+
+  xTaskCreateUniversal(_esp_now_rx_task_fn, "esp_now_rx", stack_size, NULL, priority, &_esp_now_rx_task, core);
+  if (_esp_now_rx_task == nullptr) {
+    log_e("Failed to create the deferred receive task");
+    disableDeferredReceive();
+    return false;
+  }
+  _esp_now_rx_deferred = true;
+  return true;
+}
+
+bool ESP_NOW_Class::disableDeferredReceive() {
+  // stop new frames from reaching the queues, then wait for callbacks already copying one
+  portENTER_CRITICAL(&_esp_now_rx_mux);
+  _esp_now_rx_deferred = false;
+  portEXIT_CRITICAL(&_esp_now_rx_mux);
+  while (_esp_now_rx_cb_active) {
+    vTaskDelay(1);
+  }
+  if (_esp_now_rx_task != nullptr) {
+    // frames already queued are delivered before the task stops
+    uint8_t stop = ESP_NOW_RX_TASK_STOP;
+    _esp_now_rx_task_waiter = xTaskGetCurrentTaskHandle();
+    xQueueSend(_esp_now_rx_ready_queue, &stop, portMAX_DELAY);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    _esp_now_rx_task = nullptr;
+  }
+  // the worker has exited, nothing references the queues or the pool anymore
+  if (_esp_now_rx_ready_queue != nullptr) {
+    vQueueDelete(_esp_now_rx_ready_queue);
+    _esp_now_rx_ready_queue = nullptr;
+  }
+  if (_esp_now_rx_free_queue != nullptr) {
+    vQueueDelete(_esp_now_rx_free_queue);
+    _esp_now_rx_free_queue = nullptr;
+  }
+  free(_esp_now_rx_pool);
+  _esp_now_rx_pool = nullptr;
+  return true;
+}
+
+bool ESP_NOW_Class::isDeferredReceive() const {
+  return _esp_now_rx_deferred;
+}
+
+size_t ESP_NOW_Class::sendMulti(ESP_NOW_Peer *const peers[], size_t count, const uint8_t *data, size_t len) {
+  if (!_esp_now_has_begun || peers == nullptr) {
+    return 0;
+  }
+  if (len > max_data_len) {
+    len = max_data_len;
+  }
+  size_t sent = 0;
+  for (size_t i = 0; i < count; i++) {
+    ESP_NOW_Peer *peer = peers[i];
+    if (peer == nullptr || !peer->added) {
+      continue;
+    }
+    esp_err_t result = esp_now_send(peer->mac, data, len);
+    if (result == ESP_ERR_ESPNOW_NO_MEM) {
+      // the Wi-Fi TX queue is full, let it drain before retrying
+      vTaskDelay(1);
+      result = esp_now_send(peer->mac, data, len);
+    }
+    if (result == ESP_OK) {
+      sent++;
+    } else {
+      log_e("Send to " MACSTR " failed: 0x%x", MAC2STR(peer->mac), result);
+    }
+  }
+  return sent;
+}
+
+void ESP_NOW_Class::getStats(esp_now_stats_t *stats) const {
+  if (stats == nullptr) {
+    return;
+  }
+  *stats = _esp_now_stats;
+  stats->rx_latency_avg_us = _esp_now_rx_latency_count ? (uint32_t)(_esp_now_rx_latency_sum / _esp_now_rx_latency_count) : 0;
+}
+
+void ESP_NOW_Class::resetStats() {
+  memset(&_esp_now_stats, 0, sizeof(_esp_now_stats));
+  _esp_now_rx_latency_sum = 0;
+  _esp_now_rx_latency_count = 0;
+}
+
 ESP_NOW_Class ESP_NOW;
 
 /*
@@ -6,6 +6,9 @@
 #else
 
 #include "esp_wifi_types.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
 #include "Print.h"
 #include "esp_now.h"
 #include "esp32-hal-log.h"
@@ -13,6 +16,17 @@
 
 class ESP_NOW_Peer;  //forward declaration for friend function
 
+typedef struct {
+  uint32_t rx_frames;          // frames delivered to a peer or to the new peer callback
+  uint32_t rx_dropped;         // frames dropped because the deferred pool was exhausted
+  uint32_t rx_unknown;         // frames from unregistered peers with no new peer callback
+  uint32_t tx_ok;              // send callbacks reporting success
+  uint32_t tx_fail;            // send callbacks reporting failure
+  uint32_t rx_queue_max;       // highest number of frames waiting in the deferred pool
+  uint32_t rx_latency_max_us;  // longest time a frame waited before its callback ran
+  uint32_t rx_latency_avg_us;  // average time a frame waited before its callback ran
+} esp_now_stats_t;
+
 class ESP_NOW_Class : public Print {
 public:
   const uint8_t BROADCAST_ADDR[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
@@ -37,6 +51,18 @@ public:
   void onNewPeer(void (*cb)(const esp_now_recv_info_t *info, const uint8_t *data, int len, void *arg), void *arg);
   bool removePeer(ESP_NOW_Peer &peer);
 
+  // Deliver received frames from a worker task instead of the Wi-Fi task.
+  // Frames are copied into a pool of queue_len preallocated slots; when the pool is full new frames are dropped.
+  bool enableDeferredReceive(size_t queue_len = 16, uint32_t stack_size = 4096, UBaseType_t priority = 2, BaseType_t core = tskNO_AFFINITY);
+  bool disableDeferredReceive();
+  bool isDeferredReceive() const;
+
+  // Send the same payload to several peers. Returns the number of peers the frame was queued for.
+  size_t sendMulti(ESP_NOW_Peer *const peers[], size_t count, const uint8_t *data, size_t len);
+
+  void getStats(esp_now_stats_t *stats) const;
+  void resetStats();
+
 protected:
   size_t max_data_len;
   uint32_t version;
@@ -85,6 +111,7 @@ public:
   }
 
   friend bool ESP_NOW_Class::removePeer(ESP_NOW_Peer &);
+  friend size_t ESP_NOW_Class::sendMulti(ESP_NOW_Peer *const[], size_t, const uint8_t *, size_t);
 };
 
 extern ESP_NOW_Class ESP_NOW;
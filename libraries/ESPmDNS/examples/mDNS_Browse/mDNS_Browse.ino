@@ -0,0 +1,67 @@
+/*
+  mDNS non-blocking service browser
+
+  Keeps a live list of the HTTP servers on the network without ever blocking loop().
+  Servers are reported when they appear and when they go away (goodbye or no answer).
+
+  Instructions:
+  - Update WiFi SSID and password as necessary.
+  - Flash the sketch and open the Serial Monitor.
+  - Start or stop an HTTP server that announces itself with mDNS (e.g. mDNS_Web_Server).
+ */
+
+#include <WiFi.h>
+#include <ESPmDNS.h>
+
+const char *ssid = "...";
+const char *password = "...";
+
+MDNSBrowser browser;
+uint32_t lastList = 0;
+
+void setup() {
+  Serial.begin(115200);
+  WiFi.begin(ssid, password);
+  while (WiFi.status() != WL_CONNECTED) {
+    delay(250);
+    Serial.print(".");
+  }
+  Serial.println("");
+  Serial.print("Connected to ");
+  Serial.println(ssid);
+
+  if (!MDNS.begin("ESP32_Browser")) {
+    Serial.println("Error setting up MDNS responder!");
+    while (1) {
+      delay(1000);
+    }
+  }
+
+  browser.onAdd([](const MDNSService &s) {
+    Serial.printf("+ %s (%s.local) at %s:%u\n", s.instanceName(), s.hostname(), s.address().toString().c_str(), s.port());
+    const char *path = s.txt("path");
+    if (path) {
+      Serial.printf("  path: %s\n", path);
+    }
+  });
+  browser.onRemove([](const MDNSService &s) {
+    Serial.printf("- %s\n", s.instanceName());
+  });
+  // query every 10 seconds, each query collects answers for 3 seconds
+  browser.begin("http", "tcp", 10000, 3000);
+}
+
+void loop() {
+  browser.update();
+
+  if (millis() - lastList >= 30000) {
+    lastList = millis();
+    Serial.printf("%u HTTP servers:\n", browser.count());
+    for (size_t i = 0; i < browser.count(); i++) {
+      const MDNSService &s = browser[i];
+      Serial.printf("  %s %s:%u, %u TXT records\n", s.instanceName(), s.address().toString().c_str(), s.port(), s.numTxt());
+    }
+  }
+  // other work keeps running while the queries are in flight
+  delay(10);
+}
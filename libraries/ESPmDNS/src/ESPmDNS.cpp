@@ -229,6 +229,7 @@ int MDNSResponder::queryService(char *service, char *proto) {
   }
 
   if (results) {
+    _resultIndex.clear();
     mdns_query_results_free(results);
     results = NULL;
   }
@@ -257,25 +258,18 @@ int MDNSResponder::queryService(char *service, char *proto) {
   }
 
   mdns_result_t *r = results;
-  int i = 0;
   while (r) {
-    i++;
+    _resultIndex.push_back(r);
     r = r->next;
   }
-  return i;
+  return _resultIndex.size();
 }
 
 mdns_result_t *MDNSResponder::_getResult(int idx) {
-  mdns_result_t *result = results;
-  int i = 0;
-  while (result) {
-    if (i == idx) {
-      break;
-    }
-    i++;
-    result = result->next;
+  if (idx < 0 || (size_t)idx >= _resultIndex.size()) {
+    return NULL;
   }
-  return result;
+  return _resultIndex[idx];
 }
 
 mdns_txt_item_t *MDNSResponder::_getResultTxt(int idx, int txtIdx) {
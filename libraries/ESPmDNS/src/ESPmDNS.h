@@ -47,6 +47,8 @@ License (MIT license):
 #include "Arduino.h"
 #include "mdns.h"
 #include "esp_interface.h"
+#include "MDNSBrowser.h"
+#include <vector>
 
 //this should be defined at build time
 #ifndef ARDUINO_VARIANT
@@ -101,6 +103,7 @@ public:
     return queryHost(host.c_str(), timeout);
   }
 
+  // Blocks for up to 3 seconds, see MDNSBrowser for a non-blocking alternative
   int queryService(char *service, char *proto);
   int queryService(const char *service, const char *proto) {
     return queryService((char *)service, (char *)proto);
@@ -123,6 +126,7 @@ public:
 private:
   String _hostname;
   mdns_result_t *results;
+  std::vector<mdns_result_t *> _resultIndex;  // results by index, the list is walked once per query
   mdns_result_t *_getResult(int idx);
   mdns_txt_item_t *_getResultTxt(int idx, int txtIdx);
 };
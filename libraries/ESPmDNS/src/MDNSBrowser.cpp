@@ -0,0 +1,233 @@
+// Copyright 2025 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "MDNSBrowser.h"
+#ifdef CONFIG_MDNS_MAX_INTERFACES
+#include <new>  //std::nothrow
+
+// An instance that misses this many queries in a row is dropped, even if its TTL is longer.
+// Devices that are switched off do not say goodbye and PTR records live for 75 minutes
+#define MDNS_BROWSER_MISSED_QUERIES 3
+
+static uint32_t hashName(const char *name) {
+  // FNV-1a
+  uint32_t hash = 2166136261UL;
+  while (*name) {
+    hash = (hash ^ (uint8_t)*name++) * 16777619UL;
+  }
+  return hash;
+}
+
+MDNSService::~MDNSService() {
+  free((void *)_txt);
+}
+
+bool MDNSService::set(const mdns_result_t *result, uint32_t hash) {
+  // one block: TXT pointer table, instance, hostname, then the TXT keys and values
+  size_t txt_count = result->txt_count;
+  size_t len = txt_count * 2 * sizeof(char *);
+  len += strlen(result->instance_name) + 1;
+  len += (result->hostname ? strlen(result->hostname) : 0) + 1;
+  for (size_t i = 0; i < txt_count; i++) {
+    len += strlen(result->txt[i].key) + 1;
+    len += (result->txt_value_len ? result->txt_value_len[i] : (result->txt[i].value ? strlen(result->txt[i].value) : 0)) + 1;
+  }
+  char *block = (char *)malloc(len);
+  if (block == NULL) {
+    log_e("No memory for %s", result->instance_name);
+    return false;
+  }
+  const char **table = (const char **)block;
+  char *p = block + txt_count * 2 * sizeof(char *);
+
+  const char *instance = p;
+  p = stpcpy(p, result->instance_name) + 1;
+  const char *hostname = p;
+  p = stpcpy(p, result->hostname ? result->hostname : "") + 1;
+  for (size_t i = 0; i < txt_count; i++) {
+    table[i * 2] = p;
+    p = stpcpy(p, result->txt[i].key) + 1;
+    // values may be binary, they are copied by length and terminated
+    size_t value_len = result->txt_value_len ? result->txt_value_len[i] : (result->txt[i].value ? strlen(result->txt[i].value) : 0);
+    table[i * 2 + 1] = p;
+    if (value_len) {
+      memcpy(p, result->txt[i].value, value_len);
+    }
+    p[value_len] = 0;
+    p += value_len + 1;
+  }
+
+  free((void *)_txt);
+  _txt = table;
+  _txt_count = txt_count;
+  _instance = instance;
+  _hostname = hostname;
+  _hash = hash;
+  _port = result->port;
+  // a result of another interface may come without addresses, keep the known ones then
+  for (mdns_ip_addr_t *addr = result->addr; addr; addr = addr->next) {
+    if (addr->addr.type == MDNS_IP_PROTOCOL_V4) {
+      _address = IPAddress(addr->addr.u_addr.ip4.addr);
+    } else if (addr->addr.type == MDNS_IP_PROTOCOL_V6) {
+      _addressV6 = IPAddress(IPv6, (const uint8_t *)addr->addr.u_addr.ip6.addr, addr->addr.u_addr.ip6.zone);
+    }
+  }
+  return true;
+}
+
+const char *MDNSService::txt(const char *key) const {
+  for (size_t i = 0; i < _txt_count; i++) {
+    if (strcmp(_txt[i * 2], key) == 0) {
+      return _txt[i * 2 + 1];
+    }
+  }
+  return NULL;
+}
+
+MDNSBrowser::MDNSBrowser() : _interval(0), _query_ms(0), _last_query(0), _started(false), _search(NULL) {
+  _service[0] = 0;
+  _proto[0] = 0;
+}
+
+MDNSBrowser::~MDNSBrowser() {
+  end();
+}
+
+bool MDNSBrowser::begin(const char *service, const char *proto, uint32_t interval_ms, uint32_t query_ms) {
+  if (!service || !service[0] || !proto || !proto[0] || query_ms == 0 || interval_ms < query_ms) {
+    log_e("Bad Parameters");
+    return false;
+  }
+  if (strlen(service) + 2 > sizeof(_service) || strlen(proto) + 2 > sizeof(_proto)) {
+    log_e("Service or protocol too long");
+    return false;
+  }
+  end();
+  snprintf(_service, sizeof(_service), "%s%s", (service[0] == '_') ? "" : "_", service);
+  snprintf(_proto, sizeof(_proto), "%s%s", (proto[0] == '_') ? "" : "_", proto);
+  _interval = interval_ms;
+  _query_ms = query_ms;
+  _started = true;
+  _last_query = millis() - interval_ms;  // query at the first update()
+  return true;
+}
+
+void MDNSBrowser::end() {
+  if (_search) {
+    mdns_query_async_delete(_search);
+    _search = NULL;
+  }
+  for (MDNSService *service : _services) {
+    delete service;
+  }
+  _services.clear();
+  _started = false;
+}
+
+void MDNSBrowser::update() {
+  if (!_started) {
+    return;
+  }
+  uint32_t now = millis();
+  if (_search) {
+    mdns_result_t *results = NULL;
+    uint8_t num_results = 0;
+    // timeout 0: only checks whether the query is done
+    if (mdns_query_async_get_results(_search, 0, &results, &num_results)) {
+      mdns_query_async_delete(_search);
+      _search = NULL;
+      merge(results);
+      mdns_query_results_free(results);
+    }
+  } else if (now - _last_query >= _interval) {
+    _search = mdns_query_async_new(NULL, _service, _proto, MDNS_TYPE_PTR, _query_ms, 0, NULL);
+    if (_search == NULL) {
+      log_e("Failed to start the query for %s.%s", _service, _proto);
+    }
+    _last_query = now;
+  }
+  expire(now);
+}
+
+void MDNSBrowser::merge(const mdns_result_t *results) {
+  uint32_t now = millis();
+  uint32_t max_age = MDNS_BROWSER_MISSED_QUERIES * _interval + _query_ms;
+  for (const mdns_result_t *r = results; r; r = r->next) {
+    if (r->instance_name == NULL) {
+      continue;
+    }
+    uint32_t hash = hashName(r->instance_name);
+    int idx = indexOf(r->instance_name, hash);
+    if (r->ttl == 0) {
+      // goodbye
+      if (idx >= 0) {
+        MDNSService *service = _services[idx];
+        _services.erase(_services.begin() + idx);
+        if (_on_remove) {
+          _on_remove(*service);
+        }
+        delete service;
+      }
+      continue;
+    }
+    MDNSService *service = (idx >= 0) ? _services[idx] : new (std::nothrow) MDNSService();
+    if (service == NULL) {
+      continue;
+    }
+    if (!service->set(r, hash)) {
+      if (idx < 0) {
+        delete service;
+      }
+      continue;  // a known instance keeps its previous data
+    }
+    service->_expires = now + ((r->ttl < max_age / 1000) ? r->ttl * 1000 : max_age);
+    if (idx < 0) {
+      _services.push_back(service);
+      if (_on_add) {
+        _on_add(*service);
+      }
+    }
+  }
+}
+
+void MDNSBrowser::expire(uint32_t now) {
+  for (size_t i = 0; i < _services.size();) {
+    MDNSService *service = _services[i];
+    if ((int32_t)(now - service->_expires) >= 0) {
+      _services.erase(_services.begin() + i);
+      if (_on_remove) {
+        _on_remove(*service);
+      }
+      delete service;
+    } else {
+      i++;
+    }
+  }
+}
+
+int MDNSBrowser::indexOf(const char *instanceName, uint32_t hash) const {
+  for (size_t i = 0; i < _services.size(); i++) {
+    if (_services[i]->_hash == hash && strcmp(_services[i]->_instance, instanceName) == 0) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+const MDNSService *MDNSBrowser::find(const char *instanceName) const {
+  int idx = indexOf(instanceName, hashName(instanceName));
+  return (idx >= 0) ? _services[idx] : NULL;
+}
+
+#endif /* CONFIG_MDNS_MAX_INTERFACES */
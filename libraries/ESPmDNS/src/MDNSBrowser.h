@@ -0,0 +1,158 @@
+// Copyright 2025 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MDNS_BROWSER_H
+#define MDNS_BROWSER_H
+
+#include "sdkconfig.h"
+#ifdef CONFIG_MDNS_MAX_INTERFACES
+
+#include "Arduino.h"
+#include "mdns.h"
+#include <functional>
+#include <vector>
+
+/*
+ * Non-blocking service browser
+ *
+ * Keeps a cache of the instances of one service type. A query runs in the background every
+ * interval, update() (to be called from loop()) merges its answers, drops the instances whose
+ * TTL ran out or that said goodbye, and calls the add/remove callbacks. It never blocks.
+ *
+ *   MDNSBrowser browser;
+ *   browser.onAdd([](const MDNSService &s) { Serial.printf("%s at %s\n", s.instanceName(), s.address().toString().c_str()); });
+ *   browser.begin("http", "tcp");
+ *   ...
+ *   void loop() {
+ *     browser.update();
+ *     for (size_t i = 0; i < browser.count(); i++) {
+ *       const MDNSService &s = browser[i];
+ *     }
+ *   }
+ *
+ * Results are kept in an array, access by index is constant time and MDNSService only hands
+ * out pointers to the cached strings. Indexes, references and pointers are valid until the
+ * next update() or end().
+ */
+
+class MDNSService {
+public:
+  MDNSService() : _instance(NULL), _hostname(NULL), _port(0), _txt_count(0), _txt(NULL), _hash(0), _expires(0) {}
+  ~MDNSService();
+  MDNSService(const MDNSService &) = delete;
+  MDNSService &operator=(const MDNSService &) = delete;
+
+  const char *instanceName() const {
+    return _instance;
+  }
+  const char *hostname() const {
+    return _hostname;
+  }
+  IPAddress address() const {
+    return _address;
+  }
+  IPAddress addressV6() const {
+    return _addressV6;
+  }
+  uint16_t port() const {
+    return _port;
+  }
+  size_t numTxt() const {
+    return _txt_count;
+  }
+  const char *txtKey(size_t txtIdx) const {
+    return (txtIdx < _txt_count) ? _txt[txtIdx * 2] : NULL;
+  }
+  const char *txt(size_t txtIdx) const {
+    return (txtIdx < _txt_count) ? _txt[txtIdx * 2 + 1] : NULL;
+  }
+  // NULL if there is no such key
+  const char *txt(const char *key) const;
+  bool hasTxt(const char *key) const {
+    return txt(key) != NULL;
+  }
+  // millis() at which the instance is dropped unless it answers again
+  uint32_t expires() const {
+    return _expires;
+  }
+
+private:
+  friend class MDNSBrowser;
+  bool set(const mdns_result_t *result, uint32_t hash);
+
+  // instance, hostname and the TXT table point into one allocation
+  const char *_instance;
+  const char *_hostname;
+  IPAddress _address;
+  IPAddress _addressV6;
+  uint16_t _port;
+  size_t _txt_count;
+  const char **_txt;  // key, value, key, value...
+  uint32_t _hash;     // of the instance name, to find it without comparing strings
+  uint32_t _expires;
+};
+
+typedef std::function<void(const MDNSService &service)> MDNSServiceCb;
+
+class MDNSBrowser {
+public:
+  MDNSBrowser();
+  ~MDNSBrowser();
+
+  // Starts browsing service (e.g. "http" or "_http") over proto ("tcp" or "udp"). A query of
+  // query_ms is sent every interval_ms, answers also refresh the TTL of the cached instances
+  bool begin(const char *service, const char *proto, uint32_t interval_ms = 10000, uint32_t query_ms = 3000);
+  void end();  // clears the cache without calling onRemove
+  void update();
+
+  void onAdd(MDNSServiceCb cb) {
+    _on_add = cb;
+  }
+  void onRemove(MDNSServiceCb cb) {
+    _on_remove = cb;
+  }
+
+  size_t count() const {
+    return _services.size();
+  }
+  const MDNSService &operator[](size_t idx) const {
+    return *_services[idx];
+  }
+  const MDNSService *service(size_t idx) const {
+    return (idx < _services.size()) ? _services[idx] : NULL;
+  }
+  const MDNSService *find(const char *instanceName) const;
+  bool querying() const {
+    return _search != NULL;
+  }
+
+private:
+  void merge(const mdns_result_t *results);
+  void expire(uint32_t now);
+  int indexOf(const char *instanceName, uint32_t hash) const;
+
+  char _service[32];
+  char _proto[8];
+  uint32_t _interval;
+  uint32_t _query_ms;
+  uint32_t _last_query;
+  bool _started;
+  mdns_search_once_t *_search;
+  std::vector<MDNSService *> _services;
+  MDNSServiceCb _on_add;
+  MDNSServiceCb _on_remove;
+};
+
+#endif /* CONFIG_MDNS_MAX_INTERFACES */
+#endif /* MDNS_BROWSER_H */
@@ -31,10 +31,20 @@
 #include <StreamString.h>
 #include <base64.h>
 #include "HTTPClient.h"
+#include <lwip/sockets.h>
 
 /// Cookie jar support
 #include <time.h>
 
+/// longest single wait for data, the pipeline reader checks for a stop in between
+#define HTTP_WAIT_SLICE_MS 100
+
+/// buffer passed between the pipeline reader task and writeToStream()
+typedef struct {
+  uint8_t *data;  // nullptr ends the body, len is then 0 or an error
+  int len;
+} http_pipe_block_t;
+
 #ifdef HTTPCLIENT_1_1_COMPATIBLE
 class TransportTraits {
 public:
@@ -99,6 +109,7 @@ HTTPClient::~HTTPClient() {
   if (_transportTraits) {
     _transportTraits.reset(nullptr);
   }
+  freeRxBuffers();
 }
 
 void HTTPClient::clear() {
@@ -492,6 +503,24 @@ void HTTPClient::useHTTP10(bool useHTTP10) {
   _reuse = !useHTTP10;
 }
 
+/**
+ * double buffered writeToStream(): a reader task fills one buffer from the network
+ * while the stream writes the other, so storage and network I/O overlap
+ * the buffers are kept until the HTTPClient is destroyed
+ * @param pipelined bool
+ * @param bufferSize size_t size of each of the two buffers
+ */
+void HTTPClient::setPipelined(bool pipelined, size_t bufferSize) {
+  if (!bufferSize) {
+    bufferSize = HTTP_TCP_RX_BUFFER_SIZE;
+  }
+  if (bufferSize != _rxBufferSize) {
+    freeRxBuffers();
+    _rxBufferSize = bufferSize;
+  }
+  _pipelined = pipelined;
+}
+
 /**
  * send a GET request
  * @return http code
@@ -1299,116 +1328,318 @@ int HTTPClient::handleHeaderResponse() {
  * @return < 0 = error >= 0 = size written
  */
 int HTTPClient::writeToStreamDataBlock(Stream *stream, int size) {
-  int buff_size = HTTP_TCP_RX_BUFFER_SIZE;
   int len = size;
   int bytesWritten = 0;
 
-  // if possible create smaller buffer then HTTP_TCP_RX_BUFFER_SIZE
-  if ((len > 0) && (len < buff_size)) {
-    buff_size = len;
+  // small blocks (chunks) are not worth a reader task
+  if (_pipelined && (len < 0 || len > (int)_rxBufferSize)) {
+    return writeToStreamPipelined(stream, len);
   }
 
-  // create buffer for read
-  uint8_t *buff = (uint8_t *)malloc(buff_size);
+  if (!allocRxBuffers(1)) {
+    log_w("too less ram! need %u", _rxBufferSize);
+    return HTTPC_ERROR_TOO_LESS_RAM;
+  }
+  uint8_t *buff = _rxBuffers[0];
+  int buff_size = _rxBufferSize;
 
-  if (buff) {
-    // read all data from server
-    while (connected() && (len > 0 || len == -1)) {
+  // read all data from server
+  unsigned long lastData = millis();
+  while (len > 0 || len == -1) {
 
-      // get available data size
-      size_t sizeAvailable = buff_size;
-      if (len < 0) {
-        sizeAvailable = _client->available();
+    // wait for data in select(), -1 when the connection is closed
+    int sizeAvailable = waitAvailable(HTTP_WAIT_SLICE_MS);
+    if (sizeAvailable < 0) {
+      break;
+    }
+    if (!sizeAvailable) {
+      if (millis() - lastData >= _tcpTimeout) {
+        log_w("no data for %u ms", _tcpTimeout);
+        return HTTPC_ERROR_READ_TIMEOUT;
       }
+      continue;
+    }
 
-      if (sizeAvailable) {
+    int readBytes = sizeAvailable;
 
-        int readBytes = sizeAvailable;
+    // read only the asked bytes
+    if (len > 0 && readBytes > len) {
+      readBytes = len;
+    }
 
-        // read only the asked bytes
-        if (len > 0 && readBytes > len) {
-          readBytes = len;
-        }
+    // not read more the buffer can handle
+    if (readBytes > buff_size) {
+      readBytes = buff_size;
+    }
 
-        // not read more the buffer can handle
-        if (readBytes > buff_size) {
-          readBytes = buff_size;
-        }
+    // read data
+    int bytesRead = _client->read(buff, readBytes);
+    if (bytesRead <= 0) {
+      continue;
+    }
+    lastData = millis();
 
-        // stop if no more reading
-        if (readBytes == 0) {
-          break;
-        }
+    // write it to Stream
+    int bytesWrite = writeStreamBlock(stream, buff, bytesRead);
+    if (bytesWrite < 0) {
+      return bytesWrite;
+    }
+    bytesWritten += bytesWrite;
 
-        // read data
-        int bytesRead = _client->readBytes(buff, readBytes);
+    // count bytes to read left
+    if (len > 0) {
+      len -= bytesRead;
+    }
 
-        // write it to Stream
-        int bytesWrite = stream->write(buff, bytesRead);
-        bytesWritten += bytesWrite;
+    delay(0);
+  }
 
-        // are all Bytes a written to stream ?
-        if (bytesWrite != bytesRead) {
-          log_d("short write asked for %d but got %d retry...", bytesRead, bytesWrite);
+  log_v("connection closed or file end (written: %d).", bytesWritten);
 
-          // check for write error
-          if (stream->getWriteError()) {
-            log_d("stream write error %d", stream->getWriteError());
+  if ((size > 0) && (size != bytesWritten)) {
+    log_d("bytesWritten %d and size %d mismatch!.", bytesWritten, size);
+    return HTTPC_ERROR_STREAM_WRITE;
+  }
 
-            //reset write error for retry
-            stream->clearWriteError();
-          }
+  return bytesWritten;
+}
 
-          // some time for the stream
-          delay(1);
+/**
+ * writeToStreamDataBlock() with a reader task: the network fills one buffer while
+ * the stream writes the other one
+ * @param stream Stream *
+ * @param size int bytes to read, -1 until the connection closes
+ * @return bytes written or error
+ */
+int HTTPClient::writeToStreamPipelined(Stream *stream, int size) {
+  if (!allocRxBuffers(2)) {
+    log_w("too less ram! need 2 x %u", _rxBufferSize);
+    return HTTPC_ERROR_TOO_LESS_RAM;
+  }
+  if (!_pipeFree) {
+    _pipeFree = xQueueCreate(2, sizeof(http_pipe_block_t));
+  }
+  if (!_pipeFull) {
+    // both buffers and the end of the body, the reader never blocks on it
+    _pipeFull = xQueueCreate(3, sizeof(http_pipe_block_t));
+  }
+  if (!_pipeFree || !_pipeFull) {
+    log_w("queue creation failed");
+    return HTTPC_ERROR_TOO_LESS_RAM;
+  }
+  xQueueReset(_pipeFree);
+  xQueueReset(_pipeFull);
+  for (int i = 0; i < 2; i++) {
+    http_pipe_block_t block = {_rxBuffers[i], 0};
+    xQueueSend(_pipeFree, &block, 0);
+  }
+  _pipeLen = size;
+  _pipeStop = false;
 
-          int leftBytes = (bytesRead - bytesWrite);
+  // same priority as the caller, on whichever core is free
+  if (xTaskCreate(pipelineReaderTask, "http_reader", HTTP_PIPELINE_TASK_STACK, this, uxTaskPriorityGet(NULL), NULL) != pdPASS) {
+    log_w("reader task creation failed");
+    return HTTPC_ERROR_TOO_LESS_RAM;
+  }
 
-          // retry to send the missed bytes
-          bytesWrite = stream->write((buff + bytesWrite), leftBytes);
-          bytesWritten += bytesWrite;
+  int bytesWritten = 0;
+  int ret = 0;
+  http_pipe_block_t block;
+  // the reader always ends with a block without data
+  while (xQueueReceive(_pipeFull, &block, portMAX_DELAY) == pdTRUE && block.data) {
+    if (!ret) {
+      int bytesWrite = writeStreamBlock(stream, block.data, block.len);
+      if (bytesWrite < 0) {
+        ret = bytesWrite;
+        _pipeStop = true;
+      } else {
+        bytesWritten += bytesWrite;
+      }
+    }
+    xQueueSend(_pipeFree, &block, 0);
+  }
+  if (ret < 0) {
+    return ret;
+  }
+  if (block.len < 0) {
+    return block.len;
+  }
 
-          if (bytesWrite != leftBytes) {
-            // failed again
-            log_w("short write asked for %d but got %d failed.", leftBytes, bytesWrite);
-            free(buff);
-            return HTTPC_ERROR_STREAM_WRITE;
-          }
-        }
+  log_v("connection closed or file end (written: %d).", bytesWritten);
 
-        // check for write error
-        if (stream->getWriteError()) {
-          log_w("stream write error %d", stream->getWriteError());
-          free(buff);
-          return HTTPC_ERROR_STREAM_WRITE;
-        }
+  if ((size > 0) && (size != bytesWritten)) {
+    log_d("bytesWritten %d and size %d mismatch!.", bytesWritten, size);
+    return HTTPC_ERROR_STREAM_WRITE;
+  }
+  return bytesWritten;
+}
 
-        // count bytes to read left
-        if (len > 0) {
-          len -= bytesRead;
-        }
+void HTTPClient::pipelineReaderTask(void *arg) {
+  HTTPClient *http = (HTTPClient *)arg;
+  int left = http->_pipeLen;
+  int result = 0;
+  http_pipe_block_t block;
+  unsigned long lastData = millis();
 
-        delay(0);
-      } else {
-        delay(1);
+  while (!result && left && !http->_pipeStop) {
+    if (xQueueReceive(http->_pipeFree, &block, pdMS_TO_TICKS(HTTP_WAIT_SLICE_MS)) != pdTRUE) {
+      continue;  // the stream still writes both buffers
+    }
+    block.len = 0;
+    lastData = millis();  // the time waiting for the stream does not count
+    while (block.len < (int)http->_rxBufferSize && left && !http->_pipeStop) {
+      int avail = http->waitAvailable(block.len ? 0 : HTTP_WAIT_SLICE_MS);
+      if (avail < 0) {
+        // closed: the end of a body without length, lost otherwise
+        result = (left > 0) ? HTTPC_ERROR_CONNECTION_LOST : 1;
+        break;
       }
+      if (!avail) {
+        if (block.len) {
+          break;  // nothing more for now, the stream can write this part
+        }
+        if (millis() - lastData >= http->_tcpTimeout) {
+          log_w("no data for %u ms", http->_tcpTimeout);
+          result = HTTPC_ERROR_READ_TIMEOUT;
+          break;
+        }
+        continue;
+      }
+      int readBytes = http->_rxBufferSize - block.len;
+      if (readBytes > avail) {
+        readBytes = avail;
+      }
+      if (left > 0 && readBytes > left) {
+        readBytes = left;
+      }
+      int bytesRead = http->_client->read(block.data + block.len, readBytes);
+      if (bytesRead <= 0) {
+        continue;
+      }
+      block.len += bytesRead;
+      if (left > 0) {
+        left -= bytesRead;
+      }
+      lastData = millis();
+    }
+    if (block.len) {
+      xQueueSend(http->_pipeFull, &block, portMAX_DELAY);
+    } else {
+      xQueueSend(http->_pipeFree, &block, 0);
     }
+  }
 
-    free(buff);
+  // last message, writeToStreamPipelined() returns once it has it
+  block.data = nullptr;
+  block.len = (result < 0) ? result : 0;
+  xQueueSend(http->_pipeFull, &block, portMAX_DELAY);
+  vTaskDelete(NULL);
+}
 
-    log_v("connection closed or file end (written: %d).", bytesWritten);
+/**
+ * write a buffer to the stream, retried once if the stream takes less
+ * @return bytes written or HTTPC_ERROR_STREAM_WRITE
+ */
+int HTTPClient::writeStreamBlock(Stream *stream, uint8_t *buff, int bytesRead) {
+  int bytesWrite = stream->write(buff, bytesRead);
+  int bytesWritten = bytesWrite;
+
+  // are all Bytes a written to stream ?
+  if (bytesWrite != bytesRead) {
+    log_d("short write asked for %d but got %d retry...", bytesRead, bytesWrite);
 
-    if ((size > 0) && (size != bytesWritten)) {
-      log_d("bytesWritten %d and size %d mismatch!.", bytesWritten, size);
+    // check for write error
+    if (stream->getWriteError()) {
+      log_d("stream write error %d", stream->getWriteError());
+
+      //reset write error for retry
+      stream->clearWriteError();
+    }
+
+    // some time for the stream
+    delay(1);
+
+    int leftBytes = (bytesRead - bytesWrite);
+
+    // retry to send the missed bytes
+    bytesWrite = stream->write((buff + bytesWrite), leftBytes);
+    bytesWritten += bytesWrite;
+
+    if (bytesWrite != leftBytes) {
+      // failed again
+      log_w("short write asked for %d but got %d failed.", leftBytes, bytesWrite);
       return HTTPC_ERROR_STREAM_WRITE;
     }
+  }
+
+  // check for write error
+  if (stream->getWriteError()) {
+    log_w("stream write error %d", stream->getWriteError());
+    return HTTPC_ERROR_STREAM_WRITE;
+  }
+  return bytesWritten;
+}
 
+/**
+ * wait until data can be read, blocked in select() instead of polling
+ * @param timeout_ms uint32_t
+ * @return bytes available, 0 on timeout, -1 if the connection is closed
+ */
+int HTTPClient::waitAvailable(uint32_t timeout_ms) {
+  int avail = _client->available();
+  if (avail > 0) {
+    return avail;
+  }
+  if (!_client->connected()) {
+    return -1;
+  }
+  if (!timeout_ms) {
+    return 0;
+  }
+  int fd = _client->fd();
+  if (fd < 0) {
+    delay(1);
   } else {
-    log_w("too less ram! need %d", buff_size);
-    return HTTPC_ERROR_TOO_LESS_RAM;
+    fd_set readSet;
+    FD_ZERO(&readSet);
+    FD_SET(fd, &readSet);
+    struct timeval tv;
+    tv.tv_sec = timeout_ms / 1000;
+    tv.tv_usec = (timeout_ms % 1000) * 1000;
+    select(fd + 1, &readSet, NULL, NULL, &tv);
+  }
+  avail = _client->available();
+  if (avail > 0) {
+    return avail;
+  }
+  return _client->connected() ? 0 : -1;
+}
+
+bool HTTPClient::allocRxBuffers(int count) {
+  for (int i = 0; i < count; i++) {
+    if (!_rxBuffers[i]) {
+      _rxBuffers[i] = (uint8_t *)malloc(_rxBufferSize);
+      if (!_rxBuffers[i]) {
+        return false;
+      }
+    }
   }
+  return true;
+}
 
-  return bytesWritten;
+void HTTPClient::freeRxBuffers() {
+  for (int i = 0; i < 2; i++) {
+    free(_rxBuffers[i]);
+    _rxBuffers[i] = nullptr;
+  }
+  if (_pipeFree) {
+    vQueueDelete(_pipeFree);
+    _pipeFree = nullptr;
+  }
+  if (_pipeFull) {
+    vQueueDelete(_pipeFull);
+    _pipeFull = nullptr;
+  }
 }
 
 /**
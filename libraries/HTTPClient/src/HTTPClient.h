@@ -60,6 +60,11 @@
 #define HTTP_TCP_RX_BUFFER_SIZE (4096)
 #define HTTP_TCP_TX_BUFFER_SIZE (1460)
 
+/// reader task of the pipelined writeToStream(), TLS records are decrypted there
+#ifndef HTTP_PIPELINE_TASK_STACK
+#define HTTP_PIPELINE_TASK_STACK (6144)
+#endif
+
 /// HTTP codes see RFC7231
 typedef enum {
   HTTP_CODE_CONTINUE = 100,
@@ -222,6 +227,7 @@ public:
 
   bool setURL(const String &url);
   void useHTTP10(bool usehttp10 = true);
+  void setPipelined(bool pipelined, size_t bufferSize = HTTP_TCP_RX_BUFFER_SIZE);  /// writeToStream() reads the network while the stream writes
 
   /// request handling
   int GET();
@@ -274,6 +280,12 @@ protected:
   bool sendHeader(const char *type);
   int handleHeaderResponse();
   int writeToStreamDataBlock(Stream *stream, int len);
+  int writeToStreamPipelined(Stream *stream, int len);
+  int writeStreamBlock(Stream *stream, uint8_t *buff, int len);
+  int waitAvailable(uint32_t timeout_ms);
+  bool allocRxBuffers(int count);
+  void freeRxBuffers();
+  static void pipelineReaderTask(void *arg);
 
   /// Cookie jar support
   void setCookie(String date, String headerValue);
@@ -317,6 +329,15 @@ protected:
 
   /// Cookie jar support
   CookieJar *_cookieJar = nullptr;
+
+  /// writeToStream() buffers, kept across requests
+  uint8_t *_rxBuffers[2] = {nullptr, nullptr};
+  size_t _rxBufferSize = HTTP_TCP_RX_BUFFER_SIZE;
+  bool _pipelined = false;
+  QueueHandle_t _pipeFree = nullptr;  // buffers the reader task may fill
+  QueueHandle_t _pipeFull = nullptr;  // filled buffers for the stream
+  int _pipeLen = 0;
+  volatile bool _pipeStop = false;
 };
 
 #endif /* HTTPClient_H_ */
@@ -31,6 +31,10 @@
 
 #include <esp_partition.h>
 #include <esp_ota_ops.h>  // get running partition
+#include <Preferences.h>  // progress of Range downloads
+
+#define HTTP_UPDATE_RESUME_NVS    "httpUpdate"
+#define HTTP_UPDATE_RESUME_BUFFER 1460
 
 // To do extern "C" uint32_t _SPIFFS_start;
 // To do extern "C" uint32_t _SPIFFS_end;
@@ -121,6 +125,7 @@ String HTTPUpdate::getLastErrorString(void) {
     case HTTP_UE_BIN_VERIFY_HEADER_FAILED: return "Verify Bin Header Failed";
     case HTTP_UE_BIN_FOR_WRONG_FLASH:      return "New Binary Does Not Fit Flash Size";
     case HTTP_UE_NO_PARTITION:             return "Partition Could Not be Found";
+    case HTTP_UE_RESUME_FAILED:            return "Download Could Not be Resumed";
   }
 
   return String();
@@ -208,7 +213,15 @@ HTTPUpdateResult HTTPUpdate::handleUpdate(HTTPClient &http, const String &curren
     http.setAuthorization(_auth.c_str());
   }
 
-  const char *headerkeys[] = {"x-MD5"};
+  _received = 0;
+  _requests = 0;
+  if (_resumeChunk) {
+    // continue an interrupted download, the server may answer with the whole image (200)
+    uint32_t from = _loadResume(spiffs ? U_SPIFFS : U_FLASH) ? _resumeState.offset : 0;
+    http.addHeader("Range", String("bytes=") + from + "-" + (from + _resumeChunk - 1));
+  }
+
+  const char *headerkeys[] = {"x-MD5", "Content-Range", "ETag", "Last-Modified"};
   size_t headerkeyssize = sizeof(headerkeys) / sizeof(char *);
 
   // track these headers
@@ -216,6 +229,29 @@ HTTPUpdateResult HTTPUpdate::handleUpdate(HTTPClient &http, const String &curren
 
   int code = http.GET();
   int len = http.getSize();
+  _requests++;
+
+  // first and last + 1 byte of a partial response, len is the image size
+  uint32_t first = 0;
+  uint32_t end = 0;
+  if (code == HTTP_CODE_PARTIAL_CONTENT) {
+    uint32_t last = 0;
+    uint32_t total = 0;
+    len = (sscanf(http.header("Content-Range").c_str(), "bytes %lu-%lu/%lu", &first, &last, &total) == 3 && first <= last && last < total) ? total : 0;
+    end = last + 1;
+    String validator = http.header("ETag");
+    if (!validator.length()) {
+      validator = http.header("Last-Modified");
+    }
+    if (_resumeState.offset && (first != _resumeState.offset || (uint32_t)len != _resumeState.size || validator != _resumeValidator)) {
+      log_w("the image changed, download starts over");
+      clearResume();
+    }
+    _resumeValidator = validator;
+  } else if (code == HTTP_CODE_OK && _resumeState.offset) {
+    // only a whole new image replaces the saved progress, errors keep it for the next attempt
+    clearResume();
+  }
 
   if (code <= 0) {
     log_e("HTTP error: %s\n", http.errorToString(code).c_str());
@@ -248,7 +284,8 @@ HTTPUpdateResult HTTPUpdate::handleUpdate(HTTPClient &http, const String &curren
   }
 
   switch (code) {
-    case HTTP_CODE_OK:  ///< OK (Start Update)
+    case HTTP_CODE_PARTIAL_CONTENT:  ///< First chunk of a Range download
+    case HTTP_CODE_OK:               ///< OK (Start Update)
       if (len > 0) {
         bool startUpdate = true;
         if (spiffs) {
@@ -314,7 +351,10 @@ HTTPUpdateResult HTTPUpdate::handleUpdate(HTTPClient &http, const String &curren
 
             // check for valid first magic byte
             //                    if(buf[0] != 0xE9) {
-            if (tcp->peek() != 0xE9) {
+            // or "ESPZ" for a compressed image (tools/ota_compress.py)
+            // a resumed download checks the first bytes kept from before, Update checks a restarted one
+            int magic = first ? _resumeState.head[0] : tcp->peek();
+            if ((!first || _resumeState.offset) && magic != 0xE9 && magic != (UPDATE_COMPRESSED_MAGIC & 0xFF)) {
               log_e("Magic header does not start with 0xE9\n");
               _lastError = HTTP_UE_BIN_VERIFY_HEADER_FAILED;
               http.end();
@@ -332,7 +372,8 @@ HTTPUpdateResult HTTPUpdate::handleUpdate(HTTPClient &http, const String &curren
                     }
 */
           }
-          if (runUpdate(*tcp, len, md5, command)) {
+          bool ok = (code == HTTP_CODE_PARTIAL_CONTENT) ? runResumeUpdate(http, len, first, end, md5, command) : runUpdate(*tcp, len, md5, command);
+          if (ok) {
             ret = HTTP_UPDATE_OK;
             log_d("Update ok\n");
             http.end();
@@ -417,7 +458,8 @@ bool HTTPUpdate::runUpdate(Stream &in, uint32_t size, String md5, int command) {
 
   // To do: the SHA256 could be checked if the server sends it
 
-  if (Update.writeStream(in) != size) {
+  _received = Update.writeStream(in);
+  if (_received != size) {
     _lastError = Update.getError();
     Update.printError(error);
     error.trim();  // remove line ending
@@ -440,6 +482,243 @@ bool HTTPUpdate::runUpdate(Stream &in, uint32_t size, String md5, int command) {
   return true;
 }
 
+/**
+ * write Update to flash from Range requests, resumed when the connection drops
+ * @param http HTTPClient& with the response of the first chunk
+ * @param size uint32_t image size
+ * @param first uint32_t offset of the first chunk in the image
+ * @param end uint32_t offset after the first chunk
+ * @param md5 String
+ * @return true if Update ok
+ */
+bool HTTPUpdate::runResumeUpdate(HTTPClient &http, uint32_t size, uint32_t first, uint32_t end, String md5, int command) {
+
+  StreamString error;
+
+  if (_cbProgress) {
+    Update.onProgress(_cbProgress);
+  }
+
+  uint32_t pos = _resumeState.offset;
+  bool started = pos ? Update.resume(size, pos, _resumeState.head, command, _ledPin, _ledOn) : Update.begin(size, command, _ledPin, _ledOn);
+  if (!started && pos) {
+    log_w("cannot resume at %lu, download starts over", pos);
+    clearResume();
+    pos = 0;
+    started = Update.begin(size, command, _ledPin, _ledOn);
+  }
+  if (!started) {
+    _lastError = Update.getError();
+    Update.printError(error);
+    error.trim();  // remove line ending
+    log_e("Update.begin failed! (%s)\n", error.c_str());
+    return false;
+  }
+
+  if (_cbProgress) {
+    _cbProgress(pos, size);
+  }
+
+  if (md5.length()) {
+    if (!Update.setMD5(md5.c_str())) {
+      _lastError = HTTP_UE_SERVER_FAULTY_MD5;
+      log_e("Update.setMD5 failed! (%s)\n", md5.c_str());
+      Update.abort();
+      return false;
+    }
+  }
+
+  uint8_t *buf = new (std::nothrow) uint8_t[HTTP_UPDATE_RESUME_BUFFER];
+  if (!buf) {
+    log_e("buffer allocation failed");
+    _lastError = HTTP_UE_RESUME_FAILED;
+    Update.abort();
+    return false;
+  }
+
+  // the first response is used only if it starts where the image continues
+  NetworkClient *tcp = http.getStreamPtr();
+  if (first != pos) {
+    // the unread body would be taken for the next response, drop the connection
+    if (tcp) {
+      tcp->stop();
+    }
+    end = pos;
+  }
+  uint8_t failures = 0;
+  int lastError = HTTP_UE_RESUME_FAILED;
+  unsigned long lastData = millis();
+  while (pos < size) {
+    if (pos == end) {
+      // chunk done, keep the progress in case the device reboots
+      _saveResume(command);
+      // a connection lost after some progress is opened again at once, then back off
+      if (failures > 1) {
+        delay(HTTP_UPDATE_RESUME_DELAY_MS * (failures - 1));
+      }
+      int code = _requestRange(http, pos, size, end);
+      if (code != HTTP_CODE_PARTIAL_CONTENT) {
+        lastError = (code < 0) ? code : HTTP_UE_SERVER_WRONG_HTTP_CODE;
+        log_w("Range request at %lu failed (%d), attempt %u of %u", pos, code, failures + 1, _resumeRetries + 1);
+        // a whole image means it changed since the download started
+        if (code == HTTP_CODE_OK) {
+          clearResume();
+          break;
+        }
+        if (++failures > _resumeRetries) {
+          break;
+        }
+        end = pos;
+        continue;
+      }
+      tcp = http.getStreamPtr();
+      lastData = millis();
+    }
+
+    size_t avail = tcp ? tcp->available() : 0;
+    if (!avail) {
+      if (tcp && tcp->connected() && millis() - lastData < (unsigned long)_httpClientTimeout) {
+        delay(1);
+        continue;
+      }
+      log_w("connection lost at %lu of %lu bytes", pos, size);
+      if (tcp) {
+        tcp->stop();
+      }
+      lastError = HTTPC_ERROR_CONNECTION_LOST;
+      end = pos;  // request the rest of the chunk
+      if (++failures > _resumeRetries) {
+        break;
+      }
+      continue;
+    }
+
+    size_t n = end - pos;
+    if (n > avail) {
+      n = avail;
+    }
+    if (n > HTTP_UPDATE_RESUME_BUFFER) {
+      n = HTTP_UPDATE_RESUME_BUFFER;
+    }
+    int r = tcp->read(buf, n);
+    if (r <= 0) {
+      continue;
+    }
+    if (pos < ENCRYPTED_BLOCK_SIZE) {
+      size_t h = min((size_t)r, (size_t)(ENCRYPTED_BLOCK_SIZE - pos));
+      memcpy(_resumeState.head + pos, buf, h);
+    }
+    if (Update.write(buf, r) != (size_t)r) {
+      delete[] buf;
+      _lastError = Update.getError();
+      Update.printError(error);
+      error.trim();  // remove line ending
+      log_e("Update.write failed! (%s)\n", error.c_str());
+      clearResume();
+      return false;
+    }
+    pos += r;
+    _received += r;
+    failures = 0;
+    lastData = millis();
+  }
+  delete[] buf;
+
+  if (pos < size) {
+    _saveResume(command);
+    Update.abort();
+    _lastError = lastError;
+    log_e("download stopped at %lu of %lu bytes\n", pos, size);
+    return false;
+  }
+  clearResume();
+
+  if (_cbProgress) {
+    _cbProgress(size, size);
+  }
+
+  if (!Update.end()) {
+    _lastError = Update.getError();
+    Update.printError(error);
+    error.trim();  // remove line ending
+    log_e("Update.end failed! (%s)\n", error.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+int HTTPUpdate::_requestRange(HTTPClient &http, uint32_t from, uint32_t size, uint32_t &end) {
+  uint32_t last = from + _resumeChunk - 1;
+  if (last >= size) {
+    last = size - 1;
+  }
+  http.addHeader("Range", String("bytes=") + from + "-" + last);
+  if (_resumeValidator.length()) {
+    http.addHeader("If-Range", _resumeValidator);  // the whole new image comes back if it changed
+  }
+  int code = http.GET();
+  _requests++;
+  if (code != HTTP_CODE_PARTIAL_CONTENT) {
+    return code;
+  }
+  uint32_t start = 0;
+  uint32_t total = 0;
+  if (sscanf(http.header("Content-Range").c_str(), "bytes %lu-%lu/%lu", &start, &last, &total) != 3 || start != from || last < start || total != size) {
+    log_e("unexpected Content-Range: %s", http.header("Content-Range").c_str());
+    return HTTP_UE_RESUME_FAILED;
+  }
+  end = last + 1;
+  return code;
+}
+
+bool HTTPUpdate::_loadResume(int command) {
+  Preferences prefs;
+  memset(&_resumeState, 0, sizeof(_resumeState));
+  _resumeValidator = String();
+  if (!prefs.begin(HTTP_UPDATE_RESUME_NVS)) {
+    return false;
+  }
+  resume_state_t state;
+  bool ok = prefs.isKey("state") && prefs.getBytes("state", &state, sizeof(state)) == sizeof(state) && state.command == command;
+  if (ok) {
+    _resumeState = state;
+    _resumeValidator = prefs.getString("validator");
+    log_d("download stopped at %lu of %lu bytes", state.offset, state.size);
+  }
+  prefs.end();
+  return ok;
+}
+
+void HTTPUpdate::_saveResume(int command) {
+  // only plain images can resume after a reboot, a decoder state is not kept
+  size_t offset = Update.progress();
+  if (!_resumeValidator.length() || !offset || offset == _resumeState.offset || Update.isCompressed() || Update.isDelta()) {
+    return;
+  }
+  _resumeState.size = Update.size();
+  _resumeState.offset = offset;
+  _resumeState.command = command;
+  Preferences prefs;
+  if (prefs.begin(HTTP_UPDATE_RESUME_NVS)) {
+    prefs.putBytes("state", &_resumeState, sizeof(_resumeState));
+    prefs.putString("validator", _resumeValidator);
+    prefs.end();
+  }
+}
+
+void HTTPUpdate::clearResume(void) {
+  memset(&_resumeState, 0, sizeof(_resumeState));
+  _resumeValidator = String();
+  Preferences prefs;
+  if (prefs.begin(HTTP_UPDATE_RESUME_NVS)) {
+    if (prefs.isKey("state")) {
+      prefs.clear();
+    }
+    prefs.end();
+  }
+}
+
 #if !defined(NO_GLOBAL_INSTANCES) && !defined(NO_GLOBAL_HTTPUPDATE)
 HTTPUpdate httpUpdate;
 #endif
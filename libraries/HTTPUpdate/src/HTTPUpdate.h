@@ -41,6 +41,17 @@
 #define HTTP_UE_BIN_VERIFY_HEADER_FAILED (-106)
 #define HTTP_UE_BIN_FOR_WRONG_FLASH      (-107)
 #define HTTP_UE_NO_PARTITION             (-108)
+#define HTTP_UE_RESUME_FAILED            (-109)
+
+#ifndef HTTP_UPDATE_RESUME_CHUNK
+#define HTTP_UPDATE_RESUME_CHUNK (64 * 1024)
+#endif
+#ifndef HTTP_UPDATE_RESUME_RETRIES
+#define HTTP_UPDATE_RESUME_RETRIES 10
+#endif
+#ifndef HTTP_UPDATE_RESUME_DELAY_MS
+#define HTTP_UPDATE_RESUME_DELAY_MS 1000
+#endif
 
 enum HTTPUpdateResult {
   HTTP_UPDATE_FAILED,
@@ -92,6 +103,42 @@ public:
     _auth = auth;
   }
 
+  /**
+      * download the image with Range requests of chunkSize bytes
+      * a dropped connection is resumed where it stopped, up to retries times in a row
+      * the progress is kept in NVS: an update that failed or was cut by a reboot continues
+      * on the next call if the server still has the same file (ETag or Last-Modified)
+      * servers without Range support send the whole image as before
+      * @param resume bool
+      * @param chunkSize size_t
+      * @param retries uint8_t
+      */
+  void setResume(bool resume, size_t chunkSize = HTTP_UPDATE_RESUME_CHUNK, uint8_t retries = HTTP_UPDATE_RESUME_RETRIES) {
+    _resumeChunk = resume ? chunkSize : 0;
+    _resumeRetries = retries;
+  }
+
+  /**
+      * forget the progress of an interrupted download, the next update starts from zero
+      */
+  void clearResume(void);
+
+  /**
+      * body bytes received by the last update, the ones received again after a reboot included
+      * @return size_t
+      */
+  size_t getReceivedBytes(void) {
+    return _received;
+  }
+
+  /**
+      * HTTP requests made by the last update
+      * @return uint32_t
+      */
+  uint32_t getRequests(void) {
+    return _requests;
+  }
+
   t_httpUpdate_return update(NetworkClient &client, const String &url, const String &currentVersion = "", HTTPUpdateRequestCB requestCB = NULL);
 
   t_httpUpdate_return update(
@@ -124,6 +171,7 @@ public:
 protected:
   t_httpUpdate_return handleUpdate(HTTPClient &http, const String &currentVersion, bool spiffs = false, HTTPUpdateRequestCB requestCB = NULL);
   bool runUpdate(Stream &in, uint32_t size, String md5, int command = U_FLASH);
+  bool runResumeUpdate(HTTPClient &http, uint32_t size, uint32_t first, uint32_t end, String md5, int command);
 
   // Set the error and potentially use a CB to notify the application
   void _setLastError(int err) {
@@ -151,6 +199,25 @@ private:
 
   int _ledPin;
   uint8_t _ledOn;
+
+  // Range downloads, the state is kept in NVS
+  typedef struct {
+    uint32_t size;    // image size
+    uint32_t offset;  // bytes flashed, Update.resume() continues there
+    uint8_t command;
+    uint8_t head[ENCRYPTED_BLOCK_SIZE];  // first bytes of the image, only written at the end
+  } resume_state_t;
+
+  bool _loadResume(int command);
+  void _saveResume(int command);
+  int _requestRange(HTTPClient &http, uint32_t from, uint32_t size, uint32_t &end);
+
+  size_t _resumeChunk = 0;
+  uint8_t _resumeRetries = HTTP_UPDATE_RESUME_RETRIES;
+  resume_state_t _resumeState = {};
+  String _resumeValidator;  // ETag or Last-Modified of the image
+  size_t _received = 0;
+  uint32_t _requests = 0;
 };
 
 #if !defined(NO_GLOBAL_INSTANCES) && !defined(NO_GLOBAL_HTTPUPDATE)
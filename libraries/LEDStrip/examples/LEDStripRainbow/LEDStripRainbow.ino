@@ -0,0 +1,59 @@
+/*
+  LEDStrip rainbow
+
+  Scrolls a rainbow over a WS2812B strip and slowly pulses its brightness.
+  The next frame is computed while the previous one is being sent, show() only waits
+  when the strip is slower than the animation.
+
+  Connect the data input of the strip to LED_PIN.
+*/
+
+#include <LEDStrip.h>
+
+#define LED_PIN   4
+#define LED_COUNT 300
+
+LEDStrip strip;
+uint8_t hue = 0;
+
+// 0..255 hue to a fully saturated color
+uint32_t wheel(uint8_t pos) {
+  if (pos < 85) {
+    return ((uint32_t)(255 - pos * 3) << 16) | ((uint32_t)(pos * 3) << 8);
+  }
+  if (pos < 170) {
+    pos -= 85;
+    return ((uint32_t)(255 - pos * 3) << 8) | (pos * 3);
+  }
+  pos -= 170;
+  return ((uint32_t)(pos * 3) << 16) | (255 - pos * 3);
+}
+
+void setup() {
+  Serial.begin(115200);
+  if (!strip.begin(LED_PIN, LED_COUNT, LED_COLOR_ORDER_GRB)) {
+    Serial.println("LEDStrip failed to start");
+    while (1) {
+      delay(1000);
+    }
+  }
+  strip.setGamma(2.2);
+}
+
+void loop() {
+  for (size_t i = 0; i < strip.count(); i++) {
+    strip.setPixel(i, wheel(hue + i * 256 / strip.count()));
+  }
+  hue++;
+  // brightness only changes the lookup table, the pixels stay as drawn
+  strip.setBrightness(128 + 127 * sin(millis() / 1000.0));
+  strip.show();
+
+  static uint32_t last = 0;
+  if (millis() - last > 5000) {
+    last = millis();
+    led_strip_stats_t stats;
+    strip.getStats(&stats);
+    Serial.printf("Frames: %lu Waits: %lu Encode: %lu us Frame: %lu us\n", stats.frames, stats.waits, stats.encode_us, stats.frame_us);
+  }
+}
@@ -0,0 +1,244 @@
+// Copyright 2025 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "LEDStrip.h"
+#if SOC_RMT_SUPPORTED
+#include <math.h>
+
+// 10 MHz RMT clock, 100 ns per tick, same timing as rgbLedWrite()
+#define LED_STRIP_RMT_FREQ 10000000
+#define LED_STRIP_T0H      4  // 0.4 us
+#define LED_STRIP_T0L      8  // 0.8 us
+#define LED_STRIP_T1H      8  // 0.8 us
+#define LED_STRIP_T1L      4  // 0.4 us
+
+LEDStrip::LEDStrip() : _pin(-1), _count(0), _bpp(3), _pixels(NULL), _tx(NULL), _brightness(255), _gamma(1.0f) {
+  memset(_offset, 0, sizeof(_offset));
+  memset(&_stats, 0, sizeof(_stats));
+  for (int i = 0; i < 256; i++) {
+    _gammaTable[i] = i;
+  }
+  buildTable();
+}
+
+LEDStrip::~LEDStrip() {
+  end();
+}
+
+bool LEDStrip::begin(uint8_t pin, size_t numLeds, rgb_led_color_order_t order, bool rgbw) {
+  if (numLeds == 0) {
+    log_e("Bad Parameters");
+    return false;
+  }
+  end();
+
+#if SOC_RMT_SUPPORT_DMA
+  // the DMA capable channel may be taken already
+  bool ok = rmtInitDMA(pin, LED_STRIP_RMT_FREQ);
+  if (!ok) {
+    log_w("No RMT DMA channel for GPIO %u, using the channel memory", pin);
+    ok = rmtInit(pin, RMT_TX_MODE, RMT_MEM_NUM_BLOCKS_2, LED_STRIP_RMT_FREQ);
+  }
+#else
+  // two blocks halve the refill interrupts, fall back to one when the SoC has no room
+  bool ok = rmtInit(pin, RMT_TX_MODE, RMT_MEM_NUM_BLOCKS_2, LED_STRIP_RMT_FREQ);
+#endif
+  if (!ok) {
+    ok = rmtInit(pin, RMT_TX_MODE, RMT_MEM_NUM_BLOCKS_1, LED_STRIP_RMT_FREQ);
+  }
+  if (!ok) {
+    log_e("RMT initialization failed for GPIO %u", pin);
+    return false;
+  }
+
+  rmt_data_t bit0, bit1, reset;
+  bit0.level0 = 1;
+  bit0.duration0 = LED_STRIP_T0H;
+  bit0.level1 = 0;
+  bit0.duration1 = LED_STRIP_T0L;
+  bit1.level0 = 1;
+  bit1.duration0 = LED_STRIP_T1H;
+  bit1.level1 = 0;
+  bit1.duration1 = LED_STRIP_T1L;
+  reset.level0 = 0;
+  reset.duration0 = LED_STRIP_RESET_US * (LED_STRIP_RMT_FREQ / 1000000) / 2;
+  reset.level1 = 0;
+  reset.duration1 = reset.duration0;
+  if (!rmtSetBytesEncoder(pin, bit0, bit1, &reset)) {
+    rmtDeinit(pin);
+    return false;
+  }
+
+  _bpp = rgbw ? 4 : 3;
+  _pixels = (uint8_t *)calloc(numLeds, _bpp);
+  _tx = (uint8_t *)calloc(numLeds, _bpp);
+  if (_pixels == NULL || _tx == NULL) {
+    log_e("No memory for %u LEDs", numLeds);
+    free(_pixels);
+    free(_tx);
+    _pixels = NULL;
+    _tx = NULL;
+    rmtDeinit(pin);
+    return false;
+  }
+
+  // R, G, B positions in the order they are sent
+  static const uint8_t offsets[][3] = {
+    {0, 1, 2},  // LED_COLOR_ORDER_RGB
+    {2, 1, 0},  // LED_COLOR_ORDER_BGR
+    {1, 2, 0},  // LED_COLOR_ORDER_BRG
+    {0, 2, 1},  // LED_COLOR_ORDER_RBG
+    {2, 0, 1},  // LED_COLOR_ORDER_GBR
+    {1, 0, 2},  // LED_COLOR_ORDER_GRB
+  };
+  const uint8_t *offset = offsets[(order <= LED_COLOR_ORDER_GRB) ? order : LED_COLOR_ORDER_GRB];
+  memcpy(_offset, offset, 3);
+  _offset[3] = 3;
+
+  _pin = pin;
+  _count = numLeds;
+  memset(&_stats, 0, sizeof(_stats));
+  // 1.25 us per bit
+  _stats.frame_us = (uint32_t)(_count * _bpp * 8 * 5 / 4) + LED_STRIP_RESET_US;
+  return true;
+}
+
+void LEDStrip::end() {
+  if (_pin < 0) {
+    return;
+  }
+  wait(_stats.frame_us / 1000 + 10);
+  rmtDeinit(_pin);
+  free(_pixels);
+  free(_tx);
+  _pixels = NULL;
+  _tx = NULL;
+  _count = 0;
+  _pin = -1;
+}
+
+uint32_t LEDStrip::getPixel(size_t idx) const {
+  if (idx >= _count) {
+    return 0;
+  }
+  const uint8_t *p = _pixels + idx * _bpp;
+  uint32_t color = ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2];
+  if (_bpp == 4) {
+    color |= (uint32_t)p[3] << 24;
+  }
+  return color;
+}
+
+void LEDStrip::fill(uint8_t red, uint8_t green, uint8_t blue, uint8_t white) {
+  for (size_t i = 0; i < _count; i++) {
+    setPixel(i, red, green, blue, white);
+  }
+}
+
+void LEDStrip::clear() {
+  if (_pixels != NULL) {
+    memset(_pixels, 0, _count * _bpp);
+  }
+}
+
+void LEDStrip::setBrightness(uint8_t brightness) {
+  _brightness = brightness;
+  buildTable();
+}
+
+void LEDStrip::setGamma(float gamma) {
+  if (gamma <= 0) {
+    log_e("Bad Parameters");
+    return;
+  }
+  _gamma = gamma;
+  for (int i = 0; i < 256; i++) {
+    _gammaTable[i] = (uint8_t)(powf(i / 255.0f, gamma) * 255.0f + 0.5f);
+  }
+  buildTable();
+}
+
+void LEDStrip::buildTable() {
+  // integer scaling, changing the brightness every frame (fades) stays cheap
+  for (int i = 0; i < 256; i++) {
+    _table[i] = (_gammaTable[i] * (_brightness + 1)) >> 8;
+  }
+}
+
+bool LEDStrip::busy() {
+  return _pin >= 0 && !rmtTransmitCompleted(_pin);
+}
+
+bool LEDStrip::wait(uint32_t timeout_ms) {
+  if (_pin < 0) {
+    return false;
+  }
+  return rmtWaitTransmitCompleted(_pin, timeout_ms);
+}
+
+bool LEDStrip::show(uint32_t timeout_ms) {
+  if (_pin < 0) {
+    log_e("LEDStrip not started");
+    return false;
+  }
+  // _tx is read by the RMT encoder until the previous frame is out
+  if (!rmtTransmitCompleted(_pin)) {
+    _stats.waits++;
+    if (!rmtWaitTransmitCompleted(_pin, timeout_ms)) {
+      _stats.errors++;
+      return false;
+    }
+  }
+
+  uint32_t start = micros();
+  const uint8_t *src = _pixels;
+  uint8_t *dst = _tx;
+  const uint8_t o0 = _offset[0], o1 = _offset[1], o2 = _offset[2];
+  if (_bpp == 3) {
+    for (size_t i = 0; i < _count; i++, src += 3, dst += 3) {
+      dst[o0] = _table[src[0]];
+      dst[o1] = _table[src[1]];
+      dst[o2] = _table[src[2]];
+    }
+  } else {
+    for (size_t i = 0; i < _count; i++, src += 4, dst += 4) {
+      dst[o0] = _table[src[0]];
+      dst[o1] = _table[src[1]];
+      dst[o2] = _table[src[2]];
+      dst[3] = _table[src[3]];
+    }
+  }
+  _stats.encode_us = micros() - start;
+
+  if (!rmtWriteBytesAsync(_pin, _tx, _count * _bpp)) {
+    _stats.errors++;
+    return false;
+  }
+  _stats.frames++;
+  return true;
+}
+
+void LEDStrip::getStats(led_strip_stats_t *stats) const {
+  if (stats != NULL) {
+    *stats = _stats;
+  }
+}
+
+void LEDStrip::resetStats() {
+  uint32_t frame_us = _stats.frame_us;
+  memset(&_stats, 0, sizeof(_stats));
+  _stats.frame_us = frame_us;
+}
+
+#endif /* SOC_RMT_SUPPORTED */
@@ -0,0 +1,123 @@
+// Copyright 2025 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "soc/soc_caps.h"
+#if SOC_RMT_SUPPORTED
+
+#include "Arduino.h"
+#include "esp32-hal-rgb-led.h"
+#include "esp32-hal-rmt.h"
+
+/*
+ * Addressable LED strip (WS2812B, SK6812...)
+ *
+ * Pixels are kept as 3 bytes (4 for RGBW) and sent by an RMT bytes encoder, instead of 32 bytes
+ * of RMT symbols per pixel as rgbLedWrite() does. show() converts the frame with the gamma and
+ * brightness table into the transmit buffer, starts the transmission and returns: the next frame
+ * can be drawn while the previous one is on the wire. The channel uses DMA on the SoCs that have
+ * a DMA capable RMT channel.
+ *
+ *   LEDStrip strip;
+ *   strip.begin(4, 300);
+ *   strip.setGamma(2.2);
+ *   strip.setPixel(0, 255, 0, 0);
+ *   strip.show();
+ */
+
+// Low time after a frame that latches the data, 280 us for the current WS2812B
+#ifndef LED_STRIP_RESET_US
+#define LED_STRIP_RESET_US 300
+#endif
+
+typedef struct {
+  uint32_t frames;     // frames started by show()
+  uint32_t waits;      // show() calls that waited for the previous frame
+  uint32_t errors;     // frames that could not be sent
+  uint32_t encode_us;  // last gamma/brightness conversion
+  uint32_t frame_us;   // time on the wire of one frame, reset included
+} led_strip_stats_t;
+
+class LEDStrip {
+public:
+  LEDStrip();
+  ~LEDStrip();
+
+  // rgbw: 4 bytes per pixel (SK6812 RGBW), white is sent after the three colors
+  bool begin(uint8_t pin, size_t numLeds, rgb_led_color_order_t order = LED_COLOR_ORDER_GRB, bool rgbw = false);
+  void end();
+
+  size_t count() const {
+    return _count;
+  }
+  size_t bytesPerPixel() const {
+    return _bpp;
+  }
+
+  void setPixel(size_t idx, uint8_t red, uint8_t green, uint8_t blue, uint8_t white = 0) {
+    if (idx < _count) {
+      uint8_t *p = _pixels + idx * _bpp;
+      p[0] = red;
+      p[1] = green;
+      p[2] = blue;
+      if (_bpp == 4) {
+        p[3] = white;
+      }
+    }
+  }
+  // 0xWWRRGGBB
+  void setPixel(size_t idx, uint32_t color) {
+    setPixel(idx, color >> 16, color >> 8, color, color >> 24);
+  }
+  uint32_t getPixel(size_t idx) const;
+  void fill(uint8_t red, uint8_t green, uint8_t blue, uint8_t white = 0);
+  void clear();
+  // The frame being drawn, bytesPerPixel() bytes per LED in R, G, B(, W) order, before gamma and brightness
+  uint8_t *pixels() {
+    return _pixels;
+  }
+
+  // Both apply from the next show(), the pixels are not changed
+  void setBrightness(uint8_t brightness);
+  uint8_t getBrightness() const {
+    return _brightness;
+  }
+  void setGamma(float gamma);  // 1.0 (default) is linear, 2.2 to 2.8 looks even to the eye
+
+  // Sends the frame. Waits up to timeout_ms if the previous frame is still being sent
+  bool show(uint32_t timeout_ms = 100);
+  bool busy();
+  bool wait(uint32_t timeout_ms = RMT_WAIT_FOR_EVER);
+
+  void getStats(led_strip_stats_t *stats) const;
+  void resetStats();
+
+private:
+  void buildTable();
+
+  int8_t _pin;
+  size_t _count;
+  uint8_t _bpp;
+  uint8_t _offset[4];  // position of R, G, B and W in a transmitted pixel
+  uint8_t *_pixels;    // frame being drawn
+  uint8_t *_tx;        // frame being sent
+  uint8_t _brightness;
+  float _gamma;
+  uint8_t _gammaTable[256];
+  uint8_t _table[256];  // gamma and brightness
+  led_strip_stats_t _stats;
+};
+
+#endif /* SOC_RMT_SUPPORTED */
@@ -134,6 +134,8 @@ void ArduinoMatter::_init() {
     return;
   }
 
+  initNvs();  // fabrics and commissioning data are kept in NVS
+
   // Create a Matter node and add the mandatory Root Node device type on endpoint 0
   // node handle can be used to add/modify other endpoints.
   deviceNode = node::create(&node_config, app_attribute_update_cb, app_identification_cb);
@@ -152,6 +154,7 @@ void ArduinoMatter::begin() {
   }
 
   /* Matter start */
+  initNvs();
   esp_err_t err = esp_matter::start(app_event_cb);
   if (err != ESP_OK) {
     log_e("Failed to start Matter, err:%d", err);
@@ -7,11 +7,23 @@
 #include "NetworkManager.h"
 #include "esp_task.h"
 #include "esp32-hal.h"
+#include "esp_timer.h"
+#include <algorithm>
 
 #ifndef ARDUINO_NETWORK_EVENT_TASK_STACK_SIZE
 #define ARDUINO_NETWORK_EVENT_TASK_STACK_SIZE 4096
 #endif
 
+// number of events that can wait for dispatch, the queue storage holds the events themselves
+#ifndef ARDUINO_NETWORK_EVENT_QUEUE_SIZE
+#define ARDUINO_NETWORK_EVENT_QUEUE_SIZE 32
+#endif
+
+// how long postEvent() may block when the queue is full before the event is dropped
+#ifndef ARDUINO_NETWORK_EVENT_POST_TIMEOUT
+#define ARDUINO_NETWORK_EVENT_POST_TIMEOUT portMAX_DELAY
+#endif
+
 NetworkEvents::NetworkEvents() : _arduino_event_group(NULL), _arduino_event_queue(NULL), _arduino_event_task_handle(NULL) {}
 
 NetworkEvents::~NetworkEvents() {
@@ -24,14 +36,11 @@ NetworkEvents::~NetworkEvents() {
     _arduino_event_group = NULL;
   }
   if (_arduino_event_queue != NULL) {
-    arduino_event_t *event = NULL;
-    // consume queue
-    while (xQueueReceive(_arduino_event_queue, &event, 0) == pdTRUE) {
-      delete event;
-    }
     vQueueDelete(_arduino_event_queue);
     _arduino_event_queue = NULL;
   }
+  free(_event_stats);
+  _event_stats = nullptr;
 }
 
 static uint32_t _initial_bits = 0;
@@ -47,7 +56,7 @@ bool NetworkEvents::initNetworkEvents() {
   }
 
   if (!_arduino_event_queue) {
-    _arduino_event_queue = xQueueCreate(32, sizeof(arduino_event_t *));
+    _arduino_event_queue = xQueueCreate(ARDUINO_NETWORK_EVENT_QUEUE_SIZE, sizeof(NetworkEventItem_t));
     if (!_arduino_event_queue) {
       log_e("Network Event Queue Create Failed!");
       return false;
@@ -82,21 +91,43 @@ bool NetworkEvents::postEvent(const arduino_event_t *data) {
   if (data == NULL || _arduino_event_queue == NULL) {
     return false;
   }
-  arduino_event_t *event = new arduino_event_t();
-  if (event == NULL) {
-    log_e("Arduino Event Malloc Failed!");
-    return false;
-  }
+  NetworkEventItem_t item;
+  memcpy(&item.event, data, sizeof(arduino_event_t));
+  item.posted_us = esp_timer_get_time();
 
-  memcpy(event, data, sizeof(arduino_event_t));
-  if (xQueueSend(_arduino_event_queue, &event, portMAX_DELAY) != pdPASS) {
+  if (xQueueSend(_arduino_event_queue, &item, ARDUINO_NETWORK_EVENT_POST_TIMEOUT) != pdPASS) {
     log_e("Arduino Event Send Failed!");
-    delete event;  // release mem on error
+    _dropped_events++;
+    portENTER_CRITICAL(&_event_stats_mux);
+    if (_event_stats != nullptr && data->event_id < ARDUINO_EVENT_MAX) {
+      _event_stats[data->event_id].dropped++;
+    }
+    portEXIT_CRITICAL(&_event_stats_mux);
     return false;
   }
+  uint32_t waiting = uxQueueMessagesWaiting(_arduino_event_queue);
+  if (waiting > _queue_high_water) {
+    _queue_high_water = waiting;
+  }
   return true;
 }
 
+void NetworkEvents::_invokeCallback(NetworkEventCbList_t &cb, arduino_event_t *event) {
+  if (cb.cb) {
+    cb.cb((arduino_event_id_t)event->event_id);
+    return;
+  }
+
+  if (cb.fcb) {
+    cb.fcb((arduino_event_id_t)event->event_id, (arduino_event_info_t)event->event_info);
+    return;
+  }
+
+  if (cb.scb) {
+    cb.scb(event);
+  }
+}
+
 void NetworkEvents::_checkForEvent() {
   // this task can't run without the queue
   if (_arduino_event_queue == NULL) {
@@ -105,51 +136,134 @@ void NetworkEvents::_checkForEvent() {
     return;
   }
 
+  NetworkEventItem_t item;
   for (;;) {
-    arduino_event_t *event = NULL;
     // wait for an event on a queue
-    if (xQueueReceive(_arduino_event_queue, &event, portMAX_DELAY) != pdTRUE) {
-      continue;
-    }
-    if (event == NULL) {
+    if (xQueueReceive(_arduino_event_queue, &item, portMAX_DELAY) != pdTRUE) {
       continue;
     }
+    arduino_event_t *event = &item.event;
     log_v("Network Event: %d - %s", event->event_id, eventName(event->event_id));
+    int64_t dispatch_us = esp_timer_get_time();
 
 #if defined NETWORK_EVENTS_MUTEX && SOC_CPU_CORES_NUM > 1
     std::unique_lock<std::mutex> lock(_mtx);
 #endif  // defined NETWORK_EVENTS_MUTEX &&  SOC_CPU_CORES_NUM > 1
 
-    // iterate over registered callbacks
-    for (auto &i : _cbEventList) {
-      if (i.cb || i.fcb || i.scb) {
-        if (i.event == (arduino_event_id_t)event->event_id || i.event == ARDUINO_EVENT_MAX) {
-          if (i.cb) {
-            i.cb((arduino_event_id_t)event->event_id);
-            continue;
-          }
-
-          if (i.fcb) {
-            i.fcb((arduino_event_id_t)event->event_id, (arduino_event_info_t)event->event_info);
-            continue;
-          }
-
-          i.scb(event);
-        }
+    // merge the callbacks bound to this event with the catch-all ones, keeping the registration order
+    auto first = std::lower_bound(_cbEventIndex.begin(), _cbEventIndex.end(), event->event_id, [this](uint16_t pos, arduino_event_id_t id) {
+      return _cbEventList[pos].event < id;
+    });
+    auto last = std::upper_bound(first, _cbEventIndex.end(), event->event_id, [this](arduino_event_id_t id, uint16_t pos) {
+      return id < _cbEventList[pos].event;
+    });
+    auto any = _cbAnyIndex.begin();
+    while (first != last || any != _cbAnyIndex.end()) {
+      uint16_t pos;
+      if (any == _cbAnyIndex.end() || (first != last && *first < *any)) {
+        pos = *first++;
+      } else {
+        pos = *any++;
       }
+      _invokeCallback(_cbEventList[pos], event);
     }
 
 #if defined NETWORK_EVENTS_MUTEX && SOC_CPU_CORES_NUM > 1
     lock.unlock();
 #endif  // defined NETWORK_EVENTS_MUTEX &&  SOC_CPU_CORES_NUM > 1
 
-    // release the event object's memory
-    delete event;
+    uint32_t latency = (uint32_t)(dispatch_us - item.posted_us);
+    uint32_t handler = (uint32_t)(esp_timer_get_time() - dispatch_us);
+    portENTER_CRITICAL(&_event_stats_mux);
+    if (_event_stats != nullptr && event->event_id < ARDUINO_EVENT_MAX) {
+      NetworkEventStatsEntry_t &e = _event_stats[event->event_id];
+      e.handled++;
+      e.latency_sum_us += latency;
+      if (latency > e.latency_max_us) {
+        e.latency_max_us = latency;
+      }
+      if (handler > e.handler_max_us) {
+        e.handler_max_us = handler;
+      }
+    }
+    portEXIT_CRITICAL(&_event_stats_mux);
   }
 
   vTaskDelete(NULL);
 }
 
+void NetworkEvents::_rebuildEventIndex() {
+  _cbEventIndex.clear();
+  _cbAnyIndex.clear();
+  for (size_t pos = 0; pos < _cbEventList.size(); pos++) {
+    if (_cbEventList[pos].event == ARDUINO_EVENT_MAX) {
+      _cbAnyIndex.push_back(pos);
+    } else {
+      _cbEventIndex.push_back(pos);
+    }
+  }
+  std::stable_sort(_cbEventIndex.begin(), _cbEventIndex.end(), [this](uint16_t a, uint16_t b) {
+    return _cbEventList[a].event < _cbEventList[b].event;
+  });
+}
+
+bool NetworkEvents::enableEventStats(bool enable) {
+  NetworkEventStatsEntry_t *stats = nullptr;
+  if (enable) {
+    if (_event_stats != nullptr) {
+      return true;
+    }
+    stats = (NetworkEventStatsEntry_t *)calloc(ARDUINO_EVENT_MAX, sizeof(NetworkEventStatsEntry_t));
+    if (stats == nullptr) {
+      log_e("Network Event Stats Malloc Failed!");
+      return false;
+    }
+  }
+  // swap the table under the lock so the event task never sees a freed one
+  portENTER_CRITICAL(&_event_stats_mux);
+  NetworkEventStatsEntry_t *old = _event_stats;
+  if (enable && old != nullptr) {
+    old = stats;  // enabled concurrently, keep the table already in use
+  } else {
+    _event_stats = stats;
+  }
+  portEXIT_CRITICAL(&_event_stats_mux);
+  free(old);
+  return true;
+}
+
+bool NetworkEvents::getEventStats(arduino_event_id_t event, network_event_stats_t *stats) const {
+  if (stats == nullptr || event >= ARDUINO_EVENT_MAX) {
+    return false;
+  }
+  NetworkEventStatsEntry_t e;
+  portENTER_CRITICAL(&_event_stats_mux);
+  bool enabled = _event_stats != nullptr;
+  if (enabled) {
+    e = _event_stats[event];
+  }
+  portEXIT_CRITICAL(&_event_stats_mux);
+  if (!enabled) {
+    return false;
+  }
+  stats->handled = e.handled;
+  stats->dropped = e.dropped;
+  stats->latency_max_us = e.latency_max_us;
+  stats->latency_avg_us = e.handled ? (uint32_t)(e.latency_sum_us / e.handled) : 0;
+  stats->handler_max_us = e.handler_max_us;
+  return true;
+}
+
+void NetworkEvents::resetEventStats() {
+  portENTER_CRITICAL(&_event_stats_mux);
+  if (_event_stats != nullptr) {
+    memset(_event_stats, 0, ARDUINO_EVENT_MAX * sizeof(NetworkEventStatsEntry_t));
+  }
+  portEXIT_CRITICAL(&_event_stats_mux);
+  _dropped_events = 0;
+  _queue_high_water = 0;
+}
+
 template<typename T, typename... U> static size_t getStdFunctionAddress(std::function<T(U...)> f) {
   typedef T(fnType)(U...);
   fnType **fnPointer = f.template target<fnType *>();
@@ -169,6 +283,7 @@ network_event_handle_t NetworkEvents::onEvent(NetworkEventCb cbEvent, arduino_ev
 #endif  // defined NETWORK_EVENTS_MUTEX &&  SOC_CPU_CORES_NUM > 1
 
   _cbEventList.emplace_back(++_current_id, cbEvent, nullptr, nullptr, event);
+  _rebuildEventIndex();
   return _cbEventList.back().id;
 }
 
@@ -182,6 +297,7 @@ network_event_handle_t NetworkEvents::onEvent(NetworkEventFuncCb cbEvent, arduin
 #endif  // defined NETWORK_EVENTS_MUTEX &&  SOC_CPU_CORES_NUM > 1
 
   _cbEventList.emplace_back(++_current_id, nullptr, cbEvent, nullptr, event);
+  _rebuildEventIndex();
   return _cbEventList.back().id;
 }
 
@@ -195,6 +311,7 @@ network_event_handle_t NetworkEvents::onEvent(NetworkEventSysCb cbEvent, arduino
 #endif  // defined NETWORK_EVENTS_MUTEX &&  SOC_CPU_CORES_NUM > 1
 
   _cbEventList.emplace_back(++_current_id, nullptr, nullptr, cbEvent, event);
+  _rebuildEventIndex();
   return _cbEventList.back().id;
 }
 
@@ -208,6 +325,7 @@ network_event_handle_t NetworkEvents::onSysEvent(NetworkEventCb cbEvent, arduino
 #endif  // defined NETWORK_EVENTS_MUTEX &&  SOC_CPU_CORES_NUM > 1
 
   _cbEventList.emplace(_cbEventList.begin(), ++_current_id, cbEvent, nullptr, nullptr, event);
+  _rebuildEventIndex();
   return _cbEventList.front().id;
 }
 
@@ -221,6 +339,7 @@ network_event_handle_t NetworkEvents::onSysEvent(NetworkEventFuncCb cbEvent, ard
 #endif  // defined NETWORK_EVENTS_MUTEX &&  SOC_CPU_CORES_NUM > 1
 
   _cbEventList.emplace(_cbEventList.begin(), ++_current_id, nullptr, cbEvent, nullptr, event);
+  _rebuildEventIndex();
   return _cbEventList.front().id;
 }
 
@@ -234,6 +353,7 @@ network_event_handle_t NetworkEvents::onSysEvent(NetworkEventSysCb cbEvent, ardu
 #endif  // defined NETWORK_EVENTS_MUTEX &&  SOC_CPU_CORES_NUM > 1
 
   _cbEventList.emplace(_cbEventList.begin(), ++_current_id, nullptr, nullptr, cbEvent, event);
+  _rebuildEventIndex();
   return _cbEventList.front().id;
 }
 
@@ -255,6 +375,7 @@ void NetworkEvents::removeEvent(NetworkEventCb cbEvent, arduino_event_id_t event
     ),
     _cbEventList.end()
   );
+  _rebuildEventIndex();
 }
 
 void NetworkEvents::removeEvent(NetworkEventFuncCb cbEvent, arduino_event_id_t event) {
@@ -275,6 +396,7 @@ void NetworkEvents::removeEvent(NetworkEventFuncCb cbEvent, arduino_event_id_t e
     ),
     _cbEventList.end()
   );
+  _rebuildEventIndex();
 }
 
 void NetworkEvents::removeEvent(NetworkEventSysCb cbEvent, arduino_event_id_t event) {
@@ -295,6 +417,7 @@ void NetworkEvents::removeEvent(NetworkEventSysCb cbEvent, arduino_event_id_t ev
     ),
     _cbEventList.end()
   );
+  _rebuildEventIndex();
 }
 
 void NetworkEvents::removeEvent(network_event_handle_t id) {
@@ -311,6 +434,7 @@ void NetworkEvents::removeEvent(network_event_handle_t id) {
     ),
     _cbEventList.end()
   );
+  _rebuildEventIndex();
 }
 
 int NetworkEvents::setStatusBits(int bits) {
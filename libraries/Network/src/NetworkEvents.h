@@ -133,6 +133,18 @@ struct arduino_event_t {
   arduino_event_info_t event_info;
 };
 
+/**
+ * @brief per event type dispatch statistics
+ *
+ */
+typedef struct {
+  uint32_t handled;         // events of this type delivered to the callbacks
+  uint32_t dropped;         // events of this type lost because the queue was full
+  uint32_t latency_max_us;  // longest time between postEvent() and the start of dispatch
+  uint32_t latency_avg_us;  // average time between postEvent() and the start of dispatch
+  uint32_t handler_max_us;  // longest time spent running the callbacks for one event
+} network_event_stats_t;
+
 // type aliases
 using NetworkEventCb = void (*)(arduino_event_id_t event);
 using NetworkEventFuncCb = std::function<void(arduino_event_id_t event, arduino_event_info_t info)>;
@@ -240,6 +252,47 @@ public:
    */
   bool postEvent(const arduino_event_t *event);
 
+  /**
+   * @brief enable collection of per event type statistics
+   * @note the statistics table is allocated once when enabled
+   *
+   * @param enable true to start collecting, false to stop and release the table
+   * @return true on success
+   */
+  bool enableEventStats(bool enable = true);
+
+  /**
+   * @brief get the statistics collected for an event type
+   *
+   * @param event event id
+   * @param stats structure to fill
+   * @return false if statistics are not enabled or the event id is invalid
+   */
+  bool getEventStats(arduino_event_id_t event, network_event_stats_t *stats) const;
+
+  /**
+   * @brief clear all collected statistics
+   *
+   */
+  void resetEventStats();
+
+  /**
+   * @brief total number of events lost because the queue was full
+   * @note counted even when per event statistics are disabled
+   *
+   */
+  uint32_t getDroppedEvents() const {
+    return _dropped_events;
+  }
+
+  /**
+   * @brief highest number of events that were waiting in the queue at once
+   *
+   */
+  uint32_t getEventQueueHighWater() const {
+    return _queue_high_water;
+  }
+
   int getStatusBits() const;
   int waitStatusBits(int bits, uint32_t timeout_ms);
   int setStatusBits(int bits);
@@ -285,9 +338,41 @@ private:
       : id(id), cb(cb), fcb(fcb), scb(scb), event(event) {}
   };
 
+  /**
+   * @brief queue item, events are copied by value into the preallocated queue storage
+   *
+   */
+  struct NetworkEventItem_t {
+    arduino_event_t event;
+    int64_t posted_us;
+  };
+
+  /**
+   * @brief internal statistics entry, one per event id
+   *
+   */
+  struct NetworkEventStatsEntry_t {
+    uint32_t handled;
+    uint32_t dropped;
+    uint32_t latency_max_us;
+    uint32_t handler_max_us;
+    uint64_t latency_sum_us;
+  };
+
   // define initial id's value
   network_event_handle_t _current_id{0};
 
+  // positions in _cbEventList of the callbacks bound to a specific event, sorted by event id and registration order
+  std::vector<uint16_t> _cbEventIndex;
+  // positions in _cbEventList of the callbacks bound to any event
+  std::vector<uint16_t> _cbAnyIndex;
+
+  // allocated only while statistics are enabled, accessed under _event_stats_mux
+  NetworkEventStatsEntry_t *_event_stats{nullptr};
+  mutable portMUX_TYPE _event_stats_mux = portMUX_INITIALIZER_UNLOCKED;
+  uint32_t _dropped_events{0};
+  uint32_t _queue_high_water{0};
+
   EventGroupHandle_t _arduino_event_group;
   QueueHandle_t _arduino_event_queue;
   TaskHandle_t _arduino_event_task_handle;
@@ -305,4 +390,16 @@ private:
    *
    */
   void _checkForEvent();
+
+  /**
+   * @brief rebuild the event id index, must be called with the container locked after it was modified
+   *
+   */
+  void _rebuildEventIndex();
+
+  /**
+   * @brief run a single registered callback for an event
+   *
+   */
+  static void _invokeCallback(NetworkEventCbList_t &cb, arduino_event_t *event);
 };
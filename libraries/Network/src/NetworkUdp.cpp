@@ -26,10 +26,46 @@
 #undef write
 #undef read
 
-NetworkUDP::NetworkUDP() : udp_server(-1), server_port(0), remote_port(0), tx_buffer(0), tx_buffer_len(0), rx_buffer(0) {}
+NetworkUDP::NetworkUDP()
+  : udp_server(-1), server_port(0), remote_port(0), tx_buffer(0), tx_buffer_len(0), rx_buffer(0), rx_ring(0), rx_slot(0), rx_slots(0), rx_slot_size(0),
+    rx_head(0), rx_count(0), rx_pos(0), rx_current(false) {
+  memset(&rx_stats, 0, sizeof(rx_stats));
+}
 
 NetworkUDP::~NetworkUDP() {
   stop();
+  setRxRing(0);
+}
+
+static void sockaddr_to_remote(const struct sockaddr_storage &si_other_storage, IPAddress &ip, uint16_t &port) {
+  if (si_other_storage.ss_family == AF_INET) {
+    struct sockaddr_in &si_other = (sockaddr_in &)si_other_storage;
+    ip = IPAddress(si_other.sin_addr.s_addr);
+    port = ntohs(si_other.sin_port);
+  }
+#if LWIP_IPV6
+  else if (si_other_storage.ss_family == AF_INET6) {
+    struct sockaddr_in6 &si_other = (sockaddr_in6 &)si_other_storage;
+    ip = IPAddress(IPv6, (uint8_t *)&si_other.sin6_addr, si_other.sin6_scope_id);  // force IPv6
+    ip_addr_t addr;
+    ip.to_ip_addr_t(&addr);
+    /* Dual-stack: Unmap IPv4 mapped IPv6 addresses */
+    if (ip.type() == IPv6 && ip6_addr_isipv4mappedipv6(ip_2_ip6(&addr))) {
+      unmap_ipv4_mapped_ipv6(ip_2_ip4(&addr), ip_2_ip6(&addr));
+      IP_SET_TYPE_VAL(addr, IPADDR_TYPE_V4);
+      ip.from_ip_addr_t(&addr);
+    }
+    port = ntohs(si_other.sin6_port);
+  } else {
+    ip = ip_addr_any.u_addr.ip4.addr;
+    port = 0;
+  }
+#else
+  else {
+    ip = ip_addr_any.addr;
+    port = 0;
+  }
+#endif  // LWIP_IPV6=1
 }
 
 uint8_t NetworkUDP::begin(IPAddress address, uint16_t port) {
@@ -153,6 +189,9 @@ void NetworkUDP::stop() {
     rx_buffer = NULL;
     delete b;
   }
+  rx_head = 0;
+  rx_count = 0;
+  rx_current = false;
   if (udp_server == -1) {
     return;
   }
@@ -295,6 +334,27 @@ void NetworkUDP::flush() {
 }
 
 int NetworkUDP::parsePacket() {
+  if (rx_ring) {
+    releaseSlot();  // the rest of the current packet is discarded
+    if (rx_count == 0) {
+      if (udp_server == -1) {
+        return 0;
+      }
+      int len;
+      do {
+        len = receiveSlot(rx_head);
+      } while (len == 0);  // skip empty datagrams
+      if (len < 0) {
+        return 0;
+      }
+      rx_count = 1;
+    }
+    rx_current = true;
+    rx_pos = 0;
+    remote_ip = rx_slot[rx_head].ip;
+    remote_port = rx_slot[rx_head].port;
+    return rx_slot[rx_head].len;
+  }
   if (rx_buffer) {
     return 0;
   }
@@ -312,6 +372,7 @@ int NetworkUDP::parsePacket() {
   if (!buf) {
     return 0;
   }
+  rx_stats.allocs++;
   if ((len = recvfrom(udp_server, buf, 1460, MSG_DONTWAIT, (struct sockaddr *)&si_other_storage, (socklen_t *)&slen)) == -1) {
     free(buf);
     if (errno == EWOULDBLOCK) {
@@ -320,43 +381,130 @@ int NetworkUDP::parsePacket() {
     log_e("could not receive data: %d", errno);
     return 0;
   }
-  if (si_other_storage.ss_family == AF_INET) {
-    struct sockaddr_in &si_other = (sockaddr_in &)si_other_storage;
-    remote_ip = IPAddress(si_other.sin_addr.s_addr);
-    remote_port = ntohs(si_other.sin_port);
-  }
-#if LWIP_IPV6
-  else if (si_other_storage.ss_family == AF_INET6) {
-    struct sockaddr_in6 &si_other = (sockaddr_in6 &)si_other_storage;
-    remote_ip = IPAddress(IPv6, (uint8_t *)&si_other.sin6_addr, si_other.sin6_scope_id);  // force IPv6
-    ip_addr_t addr;
-    remote_ip.to_ip_addr_t(&addr);
-    /* Dual-stack: Unmap IPv4 mapped IPv6 addresses */
-    if (remote_ip.type() == IPv6 && ip6_addr_isipv4mappedipv6(ip_2_ip6(&addr))) {
-      unmap_ipv4_mapped_ipv6(ip_2_ip4(&addr), ip_2_ip6(&addr));
-      IP_SET_TYPE_VAL(addr, IPADDR_TYPE_V4);
-      remote_ip.from_ip_addr_t(&addr);
-    }
-    remote_port = ntohs(si_other.sin6_port);
-  } else {
-    remote_ip = ip_addr_any.u_addr.ip4.addr;
-    remote_port = 0;
-  }
-#else
-  else {
-    remote_ip = ip_addr_any.addr;
-    remote_port = 0;
-  }
-#endif  // LWIP_IPV6=1
+  sockaddr_to_remote(si_other_storage, remote_ip, remote_port);
   if (len > 0) {
     rx_buffer = new (std::nothrow) cbuf(len);
+    if (!rx_buffer) {
+      free(buf);
+      return 0;
+    }
     rx_buffer->write(buf, len);
+    rx_stats.allocs += 2;  // the cbuf object and its buffer
+    rx_stats.packets++;
+    rx_stats.bytes += len;
   }
   free(buf);
   return len;
 }
 
+int NetworkUDP::receiveSlot(uint16_t index) {
+  struct sockaddr_storage si_other_storage;
+  socklen_t slen = sizeof(sockaddr_storage);
+  int len = recvfrom(
+    udp_server, rx_ring + (size_t)index * rx_slot_size, rx_slot_size, MSG_DONTWAIT, (struct sockaddr *)&si_other_storage, (socklen_t *)&slen
+  );
+  if (len == -1) {
+    if (errno != EWOULDBLOCK) {
+      log_e("could not receive data: %d", errno);
+    }
+    return -1;
+  }
+  rx_slot_t &slot = rx_slot[index];
+  sockaddr_to_remote(si_other_storage, slot.ip, slot.port);
+  slot.len = len;
+  if (len > 0) {
+    rx_stats.packets++;
+    rx_stats.bytes += len;
+  }
+  return len;
+}
+
+void NetworkUDP::releaseSlot() {
+  if (!rx_current) {
+    return;
+  }
+  rx_current = false;
+  rx_head = (rx_head + 1) % rx_slots;
+  rx_count--;
+}
+
+bool NetworkUDP::setRxRing(size_t slots, size_t slot_size) {
+  if (slots > 0xFFFF || slot_size == 0 || slot_size > 0xFFFF) {
+    log_e("invalid ring of %u slots of %u bytes", slots, slot_size);
+    return false;
+  }
+  // queued packets are dropped
+  rx_head = 0;
+  rx_count = 0;
+  rx_current = false;
+  if (rx_ring) {
+    free(rx_ring);
+    rx_ring = NULL;
+  }
+  if (rx_slot) {
+    delete[] rx_slot;
+    rx_slot = NULL;
+  }
+  rx_slots = 0;
+  rx_slot_size = 0;
+  if (slots == 0) {
+    return true;
+  }
+  clear();
+  rx_ring = (uint8_t *)malloc(slots * slot_size);
+  rx_slot = new (std::nothrow) rx_slot_t[slots];
+  if (!rx_ring || !rx_slot) {
+    log_e("could not allocate the receive ring: %u bytes", slots * slot_size);
+    setRxRing(0);
+    return false;
+  }
+  rx_stats.allocs += 2;
+  rx_slots = slots;
+  rx_slot_size = slot_size;
+  return true;
+}
+
+int NetworkUDP::parsePackets(size_t max) {
+  if (!rx_ring) {
+    log_e("no receive ring, call setRxRing() first");
+    return 0;
+  }
+  if (udp_server == -1) {
+    return 0;
+  }
+  int received = 0;
+  while (max == 0 || (size_t)received < max) {
+    if (rx_count == rx_slots) {
+      rx_stats.ring_full++;
+      break;
+    }
+    uint16_t index = (rx_head + rx_count) % rx_slots;
+    int len = receiveSlot(index);
+    if (len < 0) {
+      break;
+    }
+    if (len > 0) {
+      rx_count++;
+      received++;
+    }
+  }
+  return received;
+}
+
+void NetworkUDP::getRxStats(udp_rx_stats_t *stats) {
+  if (stats) {
+    *stats = rx_stats;
+  }
+}
+
+void NetworkUDP::resetRxStats() {
+  memset(&rx_stats, 0, sizeof(rx_stats));
+}
+
 int NetworkUDP::available() {
+  if (rx_ring) {
+    return rx_current ? rx_slot[rx_head].len - rx_pos : 0;
+  }
   if (!rx_buffer) {
     return 0;
   }
@@ -364,6 +512,16 @@ int NetworkUDP::available() {
 }
 
 int NetworkUDP::read() {
+  if (rx_ring) {
+    if (!rx_current) {
+      return -1;
+    }
+    int out = rx_ring[(size_t)rx_head * rx_slot_size + rx_pos++];
+    if (rx_pos == rx_slot[rx_head].len) {
+      releaseSlot();
+    }
+    return out;
+  }
   if (!rx_buffer) {
     return -1;
   }
@@ -381,6 +539,21 @@ int NetworkUDP::read(unsigned char *buffer, size_t len) {
 }
 
 int NetworkUDP::read(char *buffer, size_t len) {
+  if (rx_ring) {
+    if (!rx_current) {
+      return 0;
+    }
+    size_t out = rx_slot[rx_head].len - rx_pos;
+    if (out > len) {
+      out = len;
+    }
+    memcpy(buffer, rx_ring + (size_t)rx_head * rx_slot_size + rx_pos, out);
+    rx_pos += out;
+    if (rx_pos == rx_slot[rx_head].len) {
+      releaseSlot();
+    }
+    return out;
+  }
   if (!rx_buffer) {
     return 0;
   }
@@ -394,6 +567,9 @@ int NetworkUDP::read(char *buffer, size_t len) {
 }
 
 int NetworkUDP::peek() {
+  if (rx_ring) {
+    return rx_current ? rx_ring[(size_t)rx_head * rx_slot_size + rx_pos] : -1;
+  }
   if (!rx_buffer) {
     return -1;
   }
@@ -401,6 +577,7 @@ int NetworkUDP::peek() {
 }
 
 void NetworkUDP::clear() {
+  releaseSlot();
   if (!rx_buffer) {
     return;
   }
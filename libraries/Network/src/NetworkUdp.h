@@ -39,8 +39,21 @@
 #include <Udp.h>
 #include <cbuf.h>
 
+typedef struct {
+  uint32_t packets;    // datagrams received
+  uint32_t bytes;      // payload bytes received
+  uint32_t allocs;     // heap allocations made by the receive path (buffers and cbuf objects)
+  uint32_t ring_full;  // parsePackets() calls that stopped because all slots were taken
+} udp_rx_stats_t;
+
 class NetworkUDP : public UDP {
 private:
+  typedef struct {
+    IPAddress ip;
+    uint16_t port;
+    uint16_t len;
+  } rx_slot_t;
+
   int udp_server;
   IPAddress multicast_ip;
   IPAddress remote_ip;
@@ -49,6 +62,19 @@ private:
   char *tx_buffer;
   size_t tx_buffer_len;
   cbuf *rx_buffer;
+  // packet ring, see setRxRing()
+  uint8_t *rx_ring;
+  rx_slot_t *rx_slot;
+  uint16_t rx_slots;
+  uint16_t rx_slot_size;
+  uint16_t rx_head;   // oldest queued packet, the one being read if rx_current
+  uint16_t rx_count;  // queued packets, including the one being read
+  uint16_t rx_pos;    // read position in the packet being read
+  bool rx_current;
+  udp_rx_stats_t rx_stats;
+
+  int receiveSlot(uint16_t index);
+  void releaseSlot();
 
 public:
   NetworkUDP();
@@ -75,6 +101,20 @@ public:
   void clear();  // clear rx
   IPAddress remoteIP();
   uint16_t remotePort();
+
+  /*
+   * Receive into a ring of preallocated packet slots instead of a new cbuf per datagram.
+   * Datagrams are received straight into a slot and read from there, so there is no heap
+   * allocation and no locking per packet. slot_size is the largest datagram that is kept
+   * whole, longer ones are truncated. In this mode parsePacket() discards whatever is left
+   * of the current packet. setRxRing(0) frees the ring and goes back to the default mode.
+   */
+  bool setRxRing(size_t slots, size_t slot_size = 1460);
+  // Ring mode only: receives up to max (0 = as many as there are free slots) waiting datagrams
+  // in one call and returns how many were received. They are then read with parsePacket()
+  int parsePackets(size_t max = 0);
+  void getRxStats(udp_rx_stats_t *stats);
+  void resetRxStats();
 };
 
 #endif /* _NETWORKUDP_H_ */
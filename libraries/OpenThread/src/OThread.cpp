@@ -229,6 +229,7 @@ void OpenThread::begin(bool OThreadAutoStart) {
   ot_native_config.port_config.storage_partition_name = "nvs";
   ot_native_config.port_config.netif_queue_size = 10;
   ot_native_config.port_config.task_queue_size = 10;
+  initNvs();  // the stack stores its settings in the "nvs" partition
 
   // Initialize OpenThread stack
   xTaskCreate(ot_task_worker, "ot_main_loop", 10240, NULL, 20, &s_ot_task);
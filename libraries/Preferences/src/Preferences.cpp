@@ -41,6 +41,7 @@ bool Preferences::begin(const char *name, bool readOnly, const char *partition_l
     }
     err = nvs_open_from_partition(partition_label, name, readOnly ? NVS_READONLY : NVS_READWRITE, &_handle);
   } else {
+    initNvs();  // in case it was deferred at boot
     err = nvs_open(name, readOnly ? NVS_READONLY : NVS_READWRITE, &_handle);
   }
   if (err) {
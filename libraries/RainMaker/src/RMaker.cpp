@@ -52,6 +52,7 @@ void RMakerClass::setTimeSync(bool val) {
 }
 
 Node RMakerClass::initNode(const char *name, const char *type) {
+  initNvs();  // node configuration and claiming data live in NVS
   wifiLowLevelInit(true);
   Node node;
   esp_rmaker_node_t *rnode = NULL;
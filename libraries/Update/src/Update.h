@@ -11,6 +11,7 @@
 #include <MD5Builder.h>
 #include <functional>
 #include "esp_partition.h"
+#include "UpdateDelta.h"
 
 #define UPDATE_ERROR_OK           (0)
 #define UPDATE_ERROR_WRITE        (1)
@@ -26,6 +27,8 @@
 #define UPDATE_ERROR_BAD_ARGUMENT (11)
 #define UPDATE_ERROR_ABORT        (12)
 #define UPDATE_ERROR_DECRYPT      (13)
+#define UPDATE_ERROR_DECOMPRESS   (14)
+#define UPDATE_ERROR_DELTA        (15)
 
 #define UPDATE_SIZE_UNKNOWN 0xFFFFFFFF
 
@@ -43,9 +46,35 @@
 #define U_AES_DECRYPT_MODE_MASK    3
 #define U_AES_IMAGE_DECRYPTING_BIT 4
 
+/*
+    Compressed images (tools/ota_compress.py) start with this header, little endian.
+    The zlib stream that follows is inflated while it is written, through a window of
+    1 << window_bits bytes, so the RAM needed does not depend on the image size.
+  */
+#define UPDATE_COMPRESSED_MAGIC       0x5A505345  // "ESPZ"
+#define UPDATE_COMPRESSED_HEADER_SIZE 16
+#define UPDATE_COMPRESSED_ZLIB        1
+#define UPDATE_COMPRESSED_IMAGE       0  // content: an image for the partition
+#define UPDATE_COMPRESSED_DELTA       1  // content: a delta patch (tools/ota_delta.py)
+#ifndef UPDATE_COMPRESSED_MAX_WINDOW_BITS
+#define UPDATE_COMPRESSED_MAX_WINDOW_BITS 15
+#endif
+
+typedef struct {
+  uint32_t magic;
+  uint8_t version;
+  uint8_t format;
+  uint8_t window_bits;
+  uint8_t content;
+  uint32_t image_size;   // size of the inflated content
+  uint32_t stream_size;  // compressed bytes after the header
+} update_compressed_header_t;
+
 #define SPI_SECTORS_PER_BLOCK 16  // usually large erase block is 32k/64k
 #define SPI_FLASH_BLOCK_SIZE  (SPI_SECTORS_PER_BLOCK * SPI_FLASH_SEC_SIZE)
 
+struct UpdateInflate;
+
 class UpdateClass {
 public:
   typedef std::function<void(size_t, size_t)> THandlerFunction_Progress;
@@ -63,6 +92,14 @@ public:
     */
   bool begin(size_t size = UPDATE_SIZE_UNKNOWN, int command = U_FLASH, int ledPin = -1, uint8_t ledOn = LOW, const char *label = NULL);
 
+  /*
+      Continues an update interrupted after offset bytes were flashed (connection lost, reboot)
+      offset is progress() at the interruption, a multiple of the sector size
+      head holds the first ENCRYPTED_BLOCK_SIZE bytes of the image, they are only written by end()
+      Plain images only: the MD5 of the flashed part is computed again from the partition
+    */
+  bool resume(size_t size, size_t offset, const uint8_t *head, int command = U_FLASH, int ledPin = -1, uint8_t ledOn = LOW, const char *label = NULL);
+
 #ifndef UPDATE_NOCRYPT
   /*
      Setup decryption configuration
@@ -77,6 +114,9 @@ public:
   /*
       Writes a buffer to the flash and increments the address
       Returns the amount written
+      A compressed image or a delta patch is detected by its header and decoded on the fly,
+      size(), progress() and remaining() then count the bytes received
+      A delta patch rebuilds the new firmware from the running one, see tools/ota_delta.py
     */
   size_t write(uint8_t *data, size_t len);
 
@@ -179,16 +219,26 @@ public:
     return _size > 0;
   }
   bool isFinished() {
-    return _progress == _size;
+    return progress() == size();
   }
   size_t size() {
-    return _size;
+    return _outBuffer ? _inSize : _size;
   }
   size_t progress() {
-    return _progress;
+    return _outBuffer ? _inProgress : _progress;
   }
   size_t remaining() {
-    return _size - _progress;
+    return size() - progress();
+  }
+  bool isCompressed() {
+    return _inflate != nullptr;
+  }
+  bool isDelta() {
+    return _delta != nullptr;
+  }
+  // Size of the image written to the partition, the same as size() unless compressed or delta
+  size_t imageSize() {
+    return _size;
   }
 
   /*
@@ -251,6 +301,18 @@ private:
   bool _decryptBuffer();
 #endif /* UPDATE_NOCRYPT */
   bool _writeBuffer();
+  bool _flashBuffer();
+  bool _startDecoding(size_t inSize);
+  void _freeDecoders();
+  bool _startInflate();
+  bool _inflateBuffer();
+  bool _startDelta();
+  bool _checkDeltaSource(const esp_partition_t *source, const update_delta_header_t &header);
+  bool _writeDelta(const uint8_t *data, size_t len);
+  bool _deltaBuffer();
+  bool _writeImage(const uint8_t *data, size_t len);
+  bool _flashOutBuffer();
+  bool _finishImage();
   bool _verifyHeader(uint8_t data);
   bool _verifyEnd();
   bool _enablePartition(const esp_partition_t *partition);
@@ -271,6 +333,14 @@ private:
   uint32_t _command;
   const esp_partition_t *_partition;
 
+  UpdateInflate *_inflate;  // set while a compressed image is written
+  UpdateDelta *_delta;      // set while a delta patch is applied
+  uint8_t *_outBuffer;      // decoded sector, allocated when the input is decoded
+  size_t _outLen;
+  size_t _inSize;
+  size_t _inProgress;
+  bool _decoding;
+
   String _target_md5;
 #ifndef UPDATE_NOCRYPT
   bool _target_md5_decrypted = true;
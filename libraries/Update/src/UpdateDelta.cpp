@@ -0,0 +1,141 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "UpdateDelta.h"
+#include <string.h>
+
+static uint32_t _le32(const uint8_t *p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+UpdateDelta::UpdateDelta(THandlerFunction_Read readOld, THandlerFunction_Write writeNew, THandlerFunction_Header onHeader)
+  : _readOld(readOld), _writeNew(writeNew), _onHeader(onHeader), _state(STATE_HEADER), _error(nullptr), _fill(0), _oldPos(0), _newPos(0), _diffLeft(0),
+    _extraLeft(0), _seek(0) {
+  memset(&_header, 0, sizeof(_header));
+}
+
+bool UpdateDelta::_fail(const char *error) {
+  _state = STATE_ERROR;
+  _error = error;
+  return false;
+}
+
+bool UpdateDelta::_parseHeader() {
+  _header.magic = _le32(_buf);
+  _header.version = _buf[4];
+  memcpy(_header.reserved, _buf + 5, sizeof(_header.reserved));
+  _header.old_size = _le32(_buf + 8);
+  _header.new_size = _le32(_buf + 12);
+  memcpy(_header.old_md5, _buf + 16, sizeof(_header.old_md5));
+  if (_header.magic != UPDATE_DELTA_MAGIC || _header.version != 1) {
+    return _fail("not a delta patch");
+  }
+  if (!_header.new_size) {
+    return _fail("empty image");
+  }
+  if (_onHeader && !_onHeader(_header)) {
+    return _fail("patch refused");
+  }
+  _state = STATE_CONTROL;
+  return true;
+}
+
+bool UpdateDelta::_parseControl() {
+  _diffLeft = _le32(_buf);
+  _extraLeft = _le32(_buf + 4);
+  _seek = (int32_t)_le32(_buf + 8);
+  if ((uint64_t)_oldPos + _diffLeft > _header.old_size) {
+    return _fail("diff past the end of the old image");
+  }
+  if ((uint64_t)_newPos + _diffLeft + _extraLeft > _header.new_size) {
+    return _fail("record past the end of the new image");
+  }
+  return _nextState();
+}
+
+// moves on when the current part of the record is complete, empty parts are skipped
+bool UpdateDelta::_nextState() {
+  if (_diffLeft) {
+    _state = STATE_DIFF;
+    return true;
+  }
+  if (_extraLeft) {
+    _state = STATE_EXTRA;
+    return true;
+  }
+  int64_t pos = (int64_t)_oldPos + _seek;
+  if (pos < 0 || pos > (int64_t)_header.old_size) {
+    return _fail("seek out of the old image");
+  }
+  _oldPos = (uint32_t)pos;
+  _seek = 0;
+  _state = (_newPos == _header.new_size) ? STATE_DONE : STATE_CONTROL;
+  return true;
+}
+
+bool UpdateDelta::write(const uint8_t *data, size_t len) {
+  while (len) {
+    size_t n = 0;
+    switch (_state) {
+      case STATE_HEADER:
+      case STATE_CONTROL:
+      {
+        size_t need = ((_state == STATE_HEADER) ? UPDATE_DELTA_HEADER_SIZE : UPDATE_DELTA_CONTROL_SIZE) - _fill;
+        n = (len < need) ? len : need;
+        memcpy(_buf + _fill, data, n);
+        _fill += n;
+        if (n == need) {
+          _fill = 0;
+          if (!((_state == STATE_HEADER) ? _parseHeader() : _parseControl())) {
+            return false;
+          }
+        }
+        break;
+      }
+      case STATE_DIFF:
+      {
+        n = (len < _diffLeft) ? len : _diffLeft;
+        if (n > UPDATE_DELTA_READ_SIZE) {
+          n = UPDATE_DELTA_READ_SIZE;
+        }
+        if (!_readOld(_oldPos, _old, n)) {
+          return _fail("old image read failed");
+        }
+        for (size_t i = 0; i < n; i++) {
+          _old[i] += data[i];
+        }
+        if (!_writeNew(_old, n)) {
+          return _fail("write failed");
+        }
+        _oldPos += n;
+        _newPos += n;
+        _diffLeft -= n;
+        if (!_diffLeft && !_nextState()) {
+          return false;
+        }
+        break;
+      }
+      case STATE_EXTRA:
+      {
+        n = (len < _extraLeft) ? len : _extraLeft;
+        if (!_writeNew(data, n)) {
+          return _fail("write failed");
+        }
+        _newPos += n;
+        _extraLeft -= n;
+        if (!_extraLeft && !_nextState()) {
+          return false;
+        }
+        break;
+      }
+      case STATE_DONE: return true;  // what follows is not part of the patch
+      default:         return false;
+    }
+    data += n;
+    len -= n;
+  }
+  return _state != STATE_ERROR;
+}
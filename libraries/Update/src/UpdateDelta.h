@@ -0,0 +1,108 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ESP32UPDATEDELTA_H
+#define ESP32UPDATEDELTA_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <functional>
+
+#define UPDATE_DELTA_MAGIC        0x44505345  // "ESPD"
+#define UPDATE_DELTA_HEADER_SIZE  32
+#define UPDATE_DELTA_CONTROL_SIZE 12
+#ifndef UPDATE_DELTA_READ_SIZE
+#define UPDATE_DELTA_READ_SIZE 256
+#endif
+
+typedef struct {
+  uint32_t magic;
+  uint8_t version;
+  uint8_t reserved[3];
+  uint32_t old_size;  // bytes of the running image the patch applies to
+  uint32_t new_size;  // size of the rebuilt image
+  uint8_t old_md5[16];
+} update_delta_header_t;
+
+/*
+    Streaming decoder of the patches made by tools/ota_delta.py
+
+    After the header, little endian, the patch is a list of records:
+      uint32_t diff_len, uint32_t extra_len, int32_t seek
+      diff_len bytes, each added to the old image byte at the old position
+      extra_len bytes copied as they are
+    then the old position moves by seek. The patch ends when new_size bytes are rebuilt.
+
+    The patch can be fed in pieces of any size. Only UPDATE_DELTA_READ_SIZE bytes of the
+    old image are held at a time, they are read again where the patch needs them.
+  */
+class UpdateDelta {
+public:
+  typedef std::function<bool(uint32_t offset, uint8_t *data, size_t len)> THandlerFunction_Read;
+  typedef std::function<bool(const uint8_t *data, size_t len)> THandlerFunction_Write;
+  // Called once the header is in, return false to refuse the patch (wrong old image...)
+  typedef std::function<bool(const update_delta_header_t &header)> THandlerFunction_Header;
+
+  UpdateDelta(THandlerFunction_Read readOld, THandlerFunction_Write writeNew, THandlerFunction_Header onHeader = nullptr);
+
+  /*
+      Decodes the next bytes of the patch
+      Returns false if the patch is corrupt or a callback failed, see error()
+    */
+  bool write(const uint8_t *data, size_t len);
+
+  bool hasHeader() const {
+    return _state > STATE_HEADER;
+  }
+  const update_delta_header_t &header() const {
+    return _header;
+  }
+  bool isFinished() const {
+    return _state == STATE_DONE;
+  }
+  bool hasError() const {
+    return _state == STATE_ERROR;
+  }
+  const char *error() const {
+    return _error;
+  }
+  uint32_t written() const {
+    return _newPos;
+  }
+
+private:
+  enum {
+    STATE_HEADER,
+    STATE_CONTROL,
+    STATE_DIFF,
+    STATE_EXTRA,
+    STATE_DONE,
+    STATE_ERROR
+  };
+
+  bool _fail(const char *error);
+  bool _parseHeader();
+  bool _parseControl();
+  bool _nextState();
+
+  THandlerFunction_Read _readOld;
+  THandlerFunction_Write _writeNew;
+  THandlerFunction_Header _onHeader;
+
+  update_delta_header_t _header;
+  int _state;
+  const char *_error;
+  uint8_t _buf[UPDATE_DELTA_HEADER_SIZE];  // header or control being received
+  size_t _fill;
+  uint8_t _old[UPDATE_DELTA_READ_SIZE];
+  uint32_t _oldPos;
+  uint32_t _newPos;
+  uint32_t _diffLeft;
+  uint32_t _extraLeft;
+  int32_t _seek;
+};
+
+#endif
@@ -9,10 +9,28 @@
 #include "spi_flash_mmap.h"
 #include "esp_ota_ops.h"
 #include "esp_image_format.h"
+#include "UpdateDelta.h"
+#include "miniz.h"
 #ifndef UPDATE_NOCRYPT
 #include "mbedtls/aes.h"
 #endif /* UPDATE_NOCRYPT */
 
+// Inflate state of a compressed image, tinfl from the ROM
+struct UpdateInflate {
+  tinfl_decompressor decomp;
+  uint8_t *window;      // last inflated bytes, back references point in there
+  size_t windowSize;    // power of two
+  size_t windowOffset;  // where the next inflated bytes go
+  size_t outSize;       // size given by the header
+  size_t outTotal;
+  bool done;
+
+  UpdateInflate() : window(nullptr), windowSize(0), windowOffset(0), outSize(0), outTotal(0), done(false) {}
+  ~UpdateInflate() {
+    delete[] window;
+  }
+};
+
 static const char *_err2str(uint8_t _error) {
   if (_error == UPDATE_ERROR_OK) {
     return ("No Error");
@@ -44,6 +62,10 @@ static const char *_err2str(uint8_t _error) {
   } else if (_error == UPDATE_ERROR_DECRYPT) {
     return ("Decryption error");
 #endif /* UPDATE_NOCRYPT */
+  } else if (_error == UPDATE_ERROR_DECOMPRESS) {
+    return ("Decompression Error");
+  } else if (_error == UPDATE_ERROR_DELTA) {
+    return ("Delta Patch Error");
   }
   return ("UNKNOWN");
 }
@@ -75,7 +97,8 @@ UpdateClass::UpdateClass()
 #ifndef UPDATE_NOCRYPT
     _cryptKey(0), _cryptBuffer(0),
 #endif /* UPDATE_NOCRYPT */
-    _buffer(0), _skipBuffer(0), _bufferLen(0), _size(0), _progress_callback(NULL), _progress(0), _paroffset(0), _command(U_FLASH), _partition(NULL)
+    _buffer(0), _skipBuffer(0), _bufferLen(0), _size(0), _progress_callback(NULL), _progress(0), _paroffset(0), _command(U_FLASH), _partition(NULL),
+    _inflate(NULL), _delta(NULL), _outBuffer(NULL), _outLen(0), _inSize(0), _inProgress(0), _decoding(false)
 #ifndef UPDATE_NOCRYPT
     ,
     _cryptMode(U_AES_DECRYPT_AUTO), _cryptAddress(0), _cryptCfg(0xf)
@@ -95,12 +118,15 @@ void UpdateClass::_reset() {
   if (_skipBuffer) {
     delete[] _skipBuffer;
   }
+  _freeDecoders();
 
 #ifndef UPDATE_NOCRYPT
   _cryptBuffer = nullptr;
 #endif /* UPDATE_NOCRYPT */
   _buffer = nullptr;
   _skipBuffer = nullptr;
+  _inSize = 0;
+  _inProgress = 0;
   _bufferLen = 0;
   _progress = 0;
   _size = 0;
@@ -190,6 +216,62 @@ bool UpdateClass::begin(size_t size, int command, int ledPin, uint8_t ledOn, con
   return true;
 }
 
+bool UpdateClass::resume(size_t size, size_t offset, const uint8_t *head, int command, int ledPin, uint8_t ledOn, const char *label) {
+  if (!offset) {
+    return begin(size, command, ledPin, ledOn, label);
+  }
+  if (offset % SPI_FLASH_SEC_SIZE || offset >= size || (command == U_FLASH && (!head || head[0] != ESP_IMAGE_HEADER_MAGIC))) {
+    log_e("cannot resume at %u of %u bytes", offset, size);
+    _error = UPDATE_ERROR_BAD_ARGUMENT;
+    return false;
+  }
+#ifndef UPDATE_NOCRYPT
+  //the flash holds the decrypted bytes, the MD5 could not be computed again
+  //with a key set the image may be decrypted in any mode, auto included
+  if (_cryptKey) {
+    log_e("encrypted images cannot resume");
+    _error = UPDATE_ERROR_BAD_ARGUMENT;
+    return false;
+  }
+#endif /* UPDATE_NOCRYPT */
+  if (!begin(size, command, ledPin, ledOn, label)) {
+    return false;
+  }
+
+  //sectors after offset may have been written before the interruption, _flashBuffer() only
+  //erases at the next block boundary
+  size_t end = (_partition->address + offset + SPI_FLASH_BLOCK_SIZE - 1) / SPI_FLASH_BLOCK_SIZE * SPI_FLASH_BLOCK_SIZE - _partition->address;
+  if (end > _partition->size) {
+    end = _partition->size;
+  }
+  if (end > offset && !ESP.partitionEraseRange(_partition, offset, end - offset)) {
+    _abort(UPDATE_ERROR_ERASE);
+    return false;
+  }
+
+  for (size_t pos = 0; pos < offset; pos += SPI_FLASH_SEC_SIZE) {
+    if (!ESP.partitionRead(_partition, pos, (uint32_t *)_buffer, SPI_FLASH_SEC_SIZE)) {
+      _abort(UPDATE_ERROR_READ);
+      return false;
+    }
+    if (!pos && command == U_FLASH) {
+      //held back by _flashBuffer(), written by end()
+      _skipBuffer = new (std::nothrow) uint8_t[ENCRYPTED_BLOCK_SIZE];
+      if (!_skipBuffer) {
+        log_e("_skipBuffer allocation failed");
+        _abort(UPDATE_ERROR_ABORT);
+        return false;
+      }
+      memcpy(_skipBuffer, head, ENCRYPTED_BLOCK_SIZE);
+      memcpy(_buffer, head, ENCRYPTED_BLOCK_SIZE);
+    }
+    _md5.add(_buffer, SPI_FLASH_SEC_SIZE);
+  }
+  _progress = offset;
+  log_d("Resuming at %u of %u bytes", offset, size);
+  return true;
+}
+
 #ifndef UPDATE_NOCRYPT
 bool UpdateClass::setupCrypt(const uint8_t *cryptKey, size_t cryptAddress, uint8_t cryptConfig, int cryptMode) {
   if (setCryptKey(cryptKey)) {
@@ -359,6 +441,305 @@ bool UpdateClass::_decryptBuffer() {
 #endif /* UPDATE_NOCRYPT */
 
 bool UpdateClass::_writeBuffer() {
+  //first bytes of the image, check for the header of a compressed image or of a delta patch
+  if (!_inflate && !_delta && !_progress && _bufferLen >= sizeof(uint32_t)) {
+    uint32_t magic;
+    memcpy(&magic, _buffer, sizeof(magic));
+    if (magic == UPDATE_COMPRESSED_MAGIC && _bufferLen >= UPDATE_COMPRESSED_HEADER_SIZE && !_startInflate()) {
+      return false;
+    }
+    if (magic == UPDATE_DELTA_MAGIC && !_startDelta()) {
+      return false;
+    }
+  }
+  if (!_inflate && !_delta) {
+    return _flashBuffer();
+  }
+
+  //the decoders stay allocated until they return, even if the update is aborted meanwhile
+  _decoding = true;
+  bool ok = _inflate ? _inflateBuffer() : _deltaBuffer();
+  _decoding = false;
+  if (hasError()) {
+    _freeDecoders();
+  }
+  return ok;
+}
+
+void UpdateClass::_freeDecoders() {
+  if (_decoding) {
+    return;
+  }
+  delete _inflate;
+  delete _delta;
+  delete[] _outBuffer;
+  _inflate = nullptr;
+  _delta = nullptr;
+  _outBuffer = nullptr;
+  _outLen = 0;
+}
+
+bool UpdateClass::_startDecoding(size_t inSize) {
+  if (!_outBuffer) {
+    _outBuffer = new (std::nothrow) uint8_t[SPI_FLASH_SEC_SIZE];
+    if (!_outBuffer) {
+      log_e("_outBuffer allocation failed");
+      return false;
+    }
+    _outLen = 0;
+    //from now on size() and progress() count the bytes received
+    _inSize = inSize;
+    _inProgress = 0;
+  }
+  return true;
+}
+
+bool UpdateClass::_startInflate() {
+  update_compressed_header_t header;
+  memcpy(&header, _buffer, sizeof(header));
+  if (header.version != 1 || header.format != UPDATE_COMPRESSED_ZLIB || header.window_bits < 8 || header.window_bits > UPDATE_COMPRESSED_MAX_WINDOW_BITS
+      || header.content > UPDATE_COMPRESSED_DELTA) {
+    log_e("unsupported compressed image: version %u, format %u, window %u bits", header.version, header.format, header.window_bits);
+    _abort(UPDATE_ERROR_DECOMPRESS);
+    return false;
+  }
+  size_t total = UPDATE_COMPRESSED_HEADER_SIZE + header.stream_size;
+  if (!header.image_size || (header.content == UPDATE_COMPRESSED_IMAGE && header.image_size > _partition->size) || total > _size) {
+    log_e("bad compressed image size %lu (%u compressed)", header.image_size, total);
+    _abort(UPDATE_ERROR_SIZE);
+    return false;
+  }
+
+  _inflate = new (std::nothrow) UpdateInflate();
+  if (_inflate) {
+    _inflate->windowSize = 1 << header.window_bits;
+    _inflate->window = new (std::nothrow) uint8_t[_inflate->windowSize];
+    _inflate->outSize = header.image_size;
+  }
+  if (!_inflate || !_inflate->window || !_startDecoding(total)) {
+    log_e("inflate allocation failed");
+    _abort(UPDATE_ERROR_DECOMPRESS);
+    return false;
+  }
+  tinfl_init(&_inflate->decomp);
+  log_d("Compressed %s: %lu bytes, %u compressed, %u bytes window", header.content ? "patch" : "image", header.image_size, total, _inflate->windowSize);
+
+  if (header.content == UPDATE_COMPRESSED_DELTA) {
+    return _startDelta();
+  }
+  _size = header.image_size;
+  return true;
+}
+
+bool UpdateClass::_startDelta() {
+  if (_command != U_FLASH) {
+    log_e("delta patches only apply to the application");
+    _abort(UPDATE_ERROR_BAD_ARGUMENT);
+    return false;
+  }
+  const esp_partition_t *source = esp_ota_get_running_partition();
+  if (!source) {
+    _abort(UPDATE_ERROR_NO_PARTITION);
+    return false;
+  }
+  _delta = new (std::nothrow) UpdateDelta(
+    [source](uint32_t offset, uint8_t *data, size_t len) {
+      return esp_partition_read(source, offset, data, len) == ESP_OK;
+    },
+    [this](const uint8_t *data, size_t len) {
+      return _writeImage(data, len);
+    },
+    [this, source](const update_delta_header_t &header) {
+      return _checkDeltaSource(source, header);
+    }
+  );
+  //a patch that is not compressed is counted like one, up to the size given to begin()
+  if (!_delta || !_startDecoding(_size)) {
+    log_e("delta allocation failed");
+    _abort(UPDATE_ERROR_DELTA);
+    return false;
+  }
+  return true;
+}
+
+bool UpdateClass::_checkDeltaSource(const esp_partition_t *source, const update_delta_header_t &header) {
+  if (header.old_size > source->size || header.new_size > _partition->size) {
+    log_e("patch from %lu to %lu bytes does not fit the partitions", header.old_size, header.new_size);
+    return false;
+  }
+  //the patch only rebuilds the image it was made from, _outBuffer is still empty
+  MD5Builder md5;
+  md5.begin();
+  for (uint32_t offset = 0; offset < header.old_size; offset += SPI_FLASH_SEC_SIZE) {
+    size_t len = header.old_size - offset;
+    if (len > SPI_FLASH_SEC_SIZE) {
+      len = SPI_FLASH_SEC_SIZE;
+    }
+    if (esp_partition_read(source, offset, _outBuffer, len) != ESP_OK) {
+      log_e("running partition read failed");
+      return false;
+    }
+    md5.add(_outBuffer, len);
+  }
+  md5.calculate();
+  uint8_t digest[16];
+  md5.getBytes(digest);
+  if (memcmp(digest, header.old_md5, sizeof(digest))) {
+    log_e("the patch was made for another firmware than %s", md5.toString().c_str());
+    return false;
+  }
+  _size = header.new_size;
+  log_d("Delta patch: %lu bytes from the running %lu bytes image %s", header.new_size, header.old_size, source->label);
+  return true;
+}
+
+bool UpdateClass::_writeDelta(const uint8_t *data, size_t len) {
+  bool finished = _delta->isFinished();
+  if (!_delta->write(data, len)) {
+    if (!hasError()) {  //not aborted by the flash write already
+      log_e("delta patch: %s", _delta->error());
+      _abort(UPDATE_ERROR_DELTA);
+    }
+    return false;
+  }
+  if (!finished && _delta->isFinished()) {
+    return _finishImage();
+  }
+  return true;
+}
+
+bool UpdateClass::_deltaBuffer() {
+  //the MD5 is the one of the file that is sent
+  _md5.add(_buffer, _bufferLen);
+  const uint8_t *in = _buffer;
+  size_t len = _bufferLen;
+  _inProgress += _bufferLen;
+  _bufferLen = 0;
+  if (!_writeDelta(in, len)) {
+    return false;
+  }
+  if (_delta->isFinished()) {
+    _inSize = _inProgress;  //the rest is not part of the patch
+  } else if (_inProgress >= _inSize) {
+    log_e("delta patch is truncated");
+    _abort(UPDATE_ERROR_DELTA);
+    return false;
+  }
+  return true;
+}
+
+bool UpdateClass::_inflateBuffer() {
+  UpdateInflate *z = _inflate;
+  //the MD5 of a compressed image is the one of the file that is sent
+  _md5.add(_buffer, _bufferLen);
+
+  const uint8_t *in = _buffer;
+  size_t inLen = _bufferLen;
+  if (!_inProgress) {
+    in += UPDATE_COMPRESSED_HEADER_SIZE;
+    inLen -= UPDATE_COMPRESSED_HEADER_SIZE;
+  }
+  _inProgress += _bufferLen;
+  _bufferLen = 0;
+  bool last = _inProgress >= _inSize;
+  int flags = TINFL_FLAG_PARSE_ZLIB_HEADER | TINFL_FLAG_COMPUTE_ADLER32 | (last ? 0 : TINFL_FLAG_HAS_MORE_INPUT);
+
+  while (!z->done) {
+    size_t inBytes = inLen;
+    size_t outBytes = z->windowSize - z->windowOffset;
+    tinfl_status status = tinfl_decompress(&z->decomp, in, &inBytes, z->window, z->window + z->windowOffset, &outBytes, flags);
+    if (status < TINFL_STATUS_DONE) {
+      log_e("inflate failed: %d", status);
+      _abort(UPDATE_ERROR_DECOMPRESS);
+      return false;
+    }
+    in += inBytes;
+    inLen -= inBytes;
+
+    const uint8_t *out = z->window + z->windowOffset;
+    z->windowOffset = (z->windowOffset + outBytes) & (z->windowSize - 1);
+    if (z->outTotal + outBytes > z->outSize) {
+      log_e("inflated data is larger than %u bytes", z->outSize);
+      _abort(UPDATE_ERROR_SIZE);
+      return false;
+    }
+    z->outTotal += outBytes;
+    if (outBytes && !(_delta ? _writeDelta(out, outBytes) : _writeImage(out, outBytes))) {
+      return false;
+    }
+
+    if (status == TINFL_STATUS_DONE) {
+      z->done = true;
+    } else if (status == TINFL_STATUS_NEEDS_MORE_INPUT) {
+      if (last) {
+        log_e("compressed image is truncated");
+        _abort(UPDATE_ERROR_DECOMPRESS);
+        return false;
+      }
+      return true;
+    }
+    //TINFL_STATUS_HAS_MORE_OUTPUT: the window was full, keep going
+  }
+
+  if (z->outTotal != z->outSize || (_delta && !_delta->isFinished())) {
+    log_e("inflated %u bytes, expected %u", z->outTotal, z->outSize);
+    _abort(UPDATE_ERROR_SIZE);
+    return false;
+  }
+  if (inLen) {
+    log_w("%u bytes after the compressed stream ignored", inLen);
+  }
+  _inSize = _inProgress;
+  return _delta ? true : _finishImage();
+}
+
+bool UpdateClass::_writeImage(const uint8_t *data, size_t len) {
+  while (len) {
+    size_t n = SPI_FLASH_SEC_SIZE - _outLen;
+    if (n > len) {
+      n = len;
+    }
+    if (_progress + _outLen + n > _size) {
+      log_e("image is larger than %u bytes", _size);
+      _abort(UPDATE_ERROR_SIZE);
+      return false;
+    }
+    memcpy(_outBuffer + _outLen, data, n);
+    _outLen += n;
+    data += n;
+    len -= n;
+    if (_outLen == SPI_FLASH_SEC_SIZE && !_flashOutBuffer()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool UpdateClass::_flashOutBuffer() {
+  //_flashBuffer() writes _buffer, hand it the decoded sector
+  std::swap(_buffer, _outBuffer);
+  _bufferLen = _outLen;
+  _outLen = 0;
+  bool ok = _flashBuffer();
+  if (!hasError()) {  //_reset() freed both buffers otherwise
+    std::swap(_buffer, _outBuffer);
+  }
+  return ok;
+}
+
+bool UpdateClass::_finishImage() {
+  if (_outLen && !_flashOutBuffer()) {
+    return false;
+  }
+  if (_progress != _size) {
+    log_e("decoded %u bytes, expected %u", _progress, _size);
+    _abort(UPDATE_ERROR_SIZE);
+    return false;
+  }
+  return true;
+}
+
+bool UpdateClass::_flashBuffer() {
 #ifndef UPDATE_NOCRYPT
   //first bytes of loading image, check to see if loading image needs decrypting
   if (!_progress) {
@@ -369,7 +750,7 @@ bool UpdateClass::_writeBuffer() {
     }
   }
 
-  if (!_target_md5_decrypted) {
+  if (!_target_md5_decrypted && !_outBuffer) {
     _md5.add(_buffer, _bufferLen);
   }
 
@@ -431,12 +812,12 @@ bool UpdateClass::_writeBuffer() {
     _buffer[0] = ESP_IMAGE_HEADER_MAGIC;
   }
 #ifndef UPDATE_NOCRYPT
-  if (_target_md5_decrypted) {
+  if (_target_md5_decrypted && !_outBuffer) {
+#else
+  if (!_outBuffer) {
 #endif /* UPDATE_NOCRYPT */
     _md5.add(_buffer, _bufferLen);
-#ifndef UPDATE_NOCRYPT
   }
-#endif /* UPDATE_NOCRYPT */
   _progress += _bufferLen;
   _bufferLen = 0;
   if (_progress_callback) {
@@ -447,7 +828,7 @@ bool UpdateClass::_writeBuffer() {
 
 bool UpdateClass::_verifyHeader(uint8_t data) {
   if (_command == U_FLASH) {
-    if (data != ESP_IMAGE_HEADER_MAGIC) {
+    if (data != ESP_IMAGE_HEADER_MAGIC && data != (UPDATE_COMPRESSED_MAGIC & 0xFF)) {
       _abort(UPDATE_ERROR_MAGIC_BYTE);
       return false;
     }
@@ -511,7 +892,18 @@ bool UpdateClass::end(bool evenIfRemaining) {
     if (_bufferLen > 0) {
       _writeBuffer();
     }
-    _size = progress();
+    if (hasError()) {
+      return false;
+    }
+    if (!_outBuffer) {
+      _size = progress();
+    }
+  }
+
+  if ((_inflate && !_inflate->done) || (_delta && !_delta->isFinished())) {
+    log_e("image is incomplete: %u/%u bytes", _progress, _size);
+    _abort(_delta ? UPDATE_ERROR_DELTA : UPDATE_ERROR_DECOMPRESS);
+    return false;
   }
 
   _md5.calculate();
@@ -111,9 +111,7 @@ bool WebServer::authenticateBasicSHA1(const char *_username, const char *_sha1Ba
 
     uint8_t sha1[20];
     char sha1calc[48];  // large enough for base64 and Hex representation
-    String ret;
     SHA1Builder sha_builder;
-    base64 b64;
 
     log_v("Trying to authenticate user %s using SHA1.", username.c_str());
     sha_builder.begin();
@@ -128,8 +126,7 @@ bool WebServer::authenticateBasicSHA1(const char *_username, const char *_sha1Ba
       sha_builder.bytes2hex(sha1calc, sizeof(sha1calc), sha1, sizeof(sha1));
       log_v("Calculated SHA1 in hex: %s", sha1calc);
     } else {
-      ret = b64.encode(sha1, sizeof(sha1));
-      ret.toCharArray(sha1calc, sizeof(sha1calc));
+      base64::encode(sha1, sizeof(sha1), sha1calc, sizeof(sha1calc));
       log_v("Calculated SHA1 in base64: %s", sha1calc);
     }
 
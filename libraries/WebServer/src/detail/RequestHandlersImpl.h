@@ -273,7 +273,12 @@ public:
     calcMD5.getBytes(md5_buf);
     f.close();
     // create a minimal-length eTag using base64 byte[]->text encoding.
-    result = "\"" + base64::encode(md5_buf, 16) + "\"";
+    char etag[1 + 24 + 2];
+    etag[0] = '"';
+    base64::encode(md5_buf, sizeof(md5_buf), etag + 1, sizeof(etag) - 1);
+    etag[sizeof(etag) - 2] = '"';
+    etag[sizeof(etag) - 1] = 0;
+    result = etag;
     return (result);
   }  // calcETag
 
@@ -0,0 +1,42 @@
+/*
+ *  This sketch wakes up from deep sleep every 30 seconds and connects with WiFiMulti fast connect.
+ *
+ *  The first boot does a full scan. The AP it connects to is kept in RTC memory and the
+ *  following wake ups connect to it directly, with its BSSID, channel and PMK, which skips
+ *  the scan and the key derivation. Each wake up prints how it connected and the time to IP.
+ */
+
+#include <WiFi.h>
+#include <WiFiMulti.h>
+
+#define SLEEP_SECONDS 30
+
+WiFiMulti wifiMulti;
+
+RTC_DATA_ATTR int bootCount = 0;
+
+void setup() {
+  Serial.begin(115200);
+  delay(10);
+  Serial.printf("Boot %d\n", ++bootCount);
+
+  wifiMulti.addAP("ssid_from_AP_1", "your_password_for_AP_1");
+  wifiMulti.addAP("ssid_from_AP_2", "your_password_for_AP_2");
+  wifiMulti.setFastConnect(true);
+
+  WiFi.mode(WIFI_STA);
+  if (wifiMulti.run() == WL_CONNECTED) {
+    Serial.printf("Connected to %s, IP %s\n", WiFi.SSID().c_str(), WiFi.localIP().toString().c_str());
+    Serial.printf("Time to IP: %lu ms (%s)\n", wifiMulti.lastConnectTime(), WiFiMulti::pathName(wifiMulti.lastConnectPath()));
+  } else {
+    Serial.println("WiFi not connected!");
+  }
+
+  // the work of the wake up goes here
+
+  Serial.flush();
+  esp_sleep_enable_timer_wakeup(SLEEP_SECONDS * 1000000ULL);
+  esp_deep_sleep_start();
+}
+
+void loop() {}
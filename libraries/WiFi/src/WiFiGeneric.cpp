@@ -354,6 +354,7 @@ bool wifiLowLevelInit(bool persistent) {
       cfg.dynamic_rx_buf_num = 32;
     }
 
+    initNvs();  // in case it was deferred at boot
     esp_err_t err = esp_wifi_init(&cfg);
     if (err) {
       log_e("esp_wifi_init 0x%x: %s", err, esp_err_to_name(err));
@@ -26,8 +26,107 @@
 #include "WiFiMulti.h"
 #if SOC_WIFI_SUPPORTED || CONFIG_ESP_WIFI_REMOTE_ENABLED
 #include <limits.h>
+#include <stddef.h>
 #include <string.h>
 #include <esp32-hal.h>
+#include "esp_attr.h"
+#include "esp_rom_crc.h"
+#include "mbedtls/pkcs5.h"
+
+// Scans with the WiFi library
+class WiFiScanSource : public WiFiMultiScanSource {
+public:
+  int16_t scan(bool show_hidden, uint8_t channel, const char *ssid) override {
+    return WiFi.scanNetworks(false, show_hidden, false, 300, channel, ssid);
+  }
+
+  bool result(int16_t index, wifi_multi_scan_result_t *result) override {
+    String ssid;
+    uint8_t sec;
+    int32_t rssi;
+    uint8_t *bssid;
+    int32_t channel;
+    if (!WiFi.getNetworkInfo(index, ssid, sec, rssi, bssid, channel)) {
+      return false;
+    }
+    memset(result, 0, sizeof(*result));
+    strncpy(result->ssid, ssid.c_str(), sizeof(result->ssid) - 1);
+    memcpy(result->bssid, bssid, sizeof(result->bssid));
+    result->channel = channel;
+    result->rssi = rssi;
+    result->authmode = sec;
+    return true;
+  }
+
+  void clear() override {
+    WiFi.scanDelete();
+  }
+};
+
+static WiFiScanSource wifiScanSource;
+
+// Fast connect cache, kept over deep sleep and resets and checked with a CRC after power on
+#define WIFI_MULTI_CACHE_MAGIC 0x43464D57  // "WMFC"
+
+typedef struct {
+  uint32_t magic;
+  char ssid[33];
+  uint8_t bssid[6];
+  uint8_t channel;
+  uint8_t authmode;
+  uint8_t has_pmk;
+  uint8_t pmk[32];
+  uint32_t pass_crc;  // of the passphrase the PMK was derived from
+  uint32_t crc;
+} wifi_multi_cache_t;
+
+RTC_NOINIT_ATTR static wifi_multi_cache_t s_cache;
+
+static uint32_t cacheCRC(const wifi_multi_cache_t *cache) {
+  return esp_rom_crc32_le(0, (const uint8_t *)cache, offsetof(wifi_multi_cache_t, crc));
+}
+
+static uint32_t passCRC(const char *passphrase) {
+  return esp_rom_crc32_le(0, (const uint8_t *)passphrase, strlen(passphrase));
+}
+
+static bool cacheLoad(wifi_multi_cache_t *cache) {
+  if (s_cache.magic != WIFI_MULTI_CACHE_MAGIC || s_cache.crc != cacheCRC(&s_cache)) {
+    return false;
+  }
+  *cache = s_cache;
+  cache->ssid[sizeof(cache->ssid) - 1] = 0;
+  return true;
+}
+
+static void cacheSave(const WifiAPlist_t &ap, uint8_t authmode) {
+  wifi_multi_cache_t cache;
+  bool cached = cacheLoad(&cache);
+  memset(&s_cache, 0, sizeof(s_cache));
+  s_cache.magic = WIFI_MULTI_CACHE_MAGIC;
+  strncpy(s_cache.ssid, ap.ssid, sizeof(s_cache.ssid) - 1);
+  memcpy(s_cache.bssid, WiFi.BSSID(), sizeof(s_cache.bssid));
+  s_cache.channel = WiFi.channel();
+  s_cache.authmode = authmode;
+  // only the PSK modes accept a PMK in place of the passphrase, SAE (WPA3) does not
+  if (ap.passphrase && (authmode == WIFI_AUTH_WPA_PSK || authmode == WIFI_AUTH_WPA2_PSK || authmode == WIFI_AUTH_WPA_WPA2_PSK)) {
+    s_cache.pass_crc = passCRC(ap.passphrase);
+    if (cached && cache.has_pmk && cache.pass_crc == s_cache.pass_crc && strcmp(cache.ssid, s_cache.ssid) == 0) {
+      memcpy(s_cache.pmk, cache.pmk, sizeof(s_cache.pmk));
+      s_cache.has_pmk = 1;
+    } else {
+#if defined(MBEDTLS_PKCS5_C)
+      // PMK = PBKDF2-HMAC-SHA1(passphrase, ssid, 4096 iterations), done once per network
+      int ret = mbedtls_pkcs5_pbkdf2_hmac_ext(
+        MBEDTLS_MD_SHA1, (const unsigned char *)ap.passphrase, strlen(ap.passphrase), (const unsigned char *)ap.ssid, strlen(ap.ssid), 4096,
+        sizeof(s_cache.pmk), s_cache.pmk
+      );
+      s_cache.has_pmk = (ret == 0);
+#endif
+    }
+  }
+  s_cache.crc = cacheCRC(&s_cache);
+}
 
 WiFiMulti::WiFiMulti() {
   ipv6_support = false;
@@ -88,8 +187,7 @@ bool WiFiMulti::addAP(const char *ssid, const char *passphrase) {
 }
 
 uint8_t WiFiMulti::run(uint32_t connectTimeout, bool scanHidden) {
-  int8_t scanResult;
-  unsigned long startTime;
+  int16_t scanResult;
   uint8_t status = WiFi.status();
   if (status == WL_CONNECTED) {
     if (!_bWFMInit && _connectionTestCBFunc != NULL) {
@@ -113,197 +211,78 @@ uint8_t WiFiMulti::run(uint32_t connectTimeout, bool scanHidden) {
     status = WiFi.status();
   }
 
-  scanResult = WiFi.scanNetworks(false, scanHidden);
+  _runStart = millis();
+  if (_bFastConnect && WiFi.scanComplete() != WIFI_SCAN_RUNNING) {
+    status = fastConnect(connectTimeout, scanHidden);
+    if (status == WL_CONNECTED) {
+      return status;
+    }
+  }
+
+  WiFiMultiScanSource *source = _scanSource ? _scanSource : &wifiScanSource;
+  scanResult = source->scan(scanHidden, 0, NULL);
   if (scanResult == WIFI_SCAN_RUNNING) {
     // scan is running
     return WL_NO_SSID_AVAIL;
   } else if (scanResult >= 0) {
     // scan done analyze
-    int32_t bestIndex = -1;
-    WifiAPlist_t bestNetwork{NULL, NULL, false};
-    int bestNetworkDb = INT_MIN;
-    int bestNetworkSec = WIFI_AUTH_MAX;
-    uint8_t bestBSSID[6];
-    int32_t bestChannel = 0;
-
     log_i("[WIFI] scan done");
 
     if (scanResult == 0) {
       log_e("[WIFI] no networks found");
     } else {
       log_i("[WIFI] %d networks found", scanResult);
+    }
 
-      int8_t failCount = 0;
-      int8_t foundCount = 0;
-      for (int8_t i = 0; i < scanResult; ++i) {
-
-        String ssid_scan;
-        int32_t rssi_scan;
-        uint8_t sec_scan;
-        uint8_t *BSSID_scan;
-        int32_t chan_scan;
-        bool hidden_scan;
-
-        WiFi.getNetworkInfo(i, ssid_scan, sec_scan, rssi_scan, BSSID_scan, chan_scan);
-        hidden_scan = (ssid_scan.length() == 0) && scanHidden;
-        // add any Open WiFi AP to the list, if allowed with setAllowOpenAP(true)
-        if (_bAllowOpenAP && sec_scan == WIFI_AUTH_OPEN) {
-          bool found = false;
-          for (auto check : APlist) {
-            if (ssid_scan == check.ssid) {
-              found = true;
-              break;
-            }
-          }
-          // If we didn't find it, add this Open WiFi AP to the list
-          if (!found) {
-            log_i("[WIFI][APlistAdd] adding Open WiFi SSID: %s", ssid_scan.c_str());
-            addAP(ssid_scan.c_str());
-          }
-        }
-
-        if (hidden_scan) {
-          log_v("hidden ssid on channel %d found, trying to connect with known credentials...", chan_scan);
+    // add any Open WiFi AP to the list, if allowed with setAllowOpenAP(true)
+    if (_bAllowOpenAP) {
+      wifi_multi_scan_result_t network;
+      for (int16_t i = 0; i < scanResult; ++i) {
+        if (source->result(i, &network) && network.authmode == WIFI_AUTH_OPEN && network.ssid[0] && findAP(network.ssid) < 0) {
+          log_i("[WIFI][APlistAdd] adding Open WiFi SSID: %s", network.ssid);
+          addAP(network.ssid);
         }
+      }
+    }
 
-        bool known = false;
-        for (uint32_t x = 0; x < APlist.size(); x++) {
-          WifiAPlist_t entry = APlist[x];
-
-          if (ssid_scan == entry.ssid || hidden_scan) {  // SSID match or hidden network found
-            if (!hidden_scan) {
-              log_v("known ssid: %s, has failed: %s", entry.ssid, entry.hasFailed ? "yes" : "no");
-              foundCount++;
-            }
-            if (!entry.hasFailed) {
-              if (hidden_scan) {
-                WiFi.begin(entry.ssid, entry.passphrase, chan_scan, BSSID_scan);
-
-                // If the ssid returned from the scan is empty, it is a hidden SSID
-                // it appears that the WiFi.begin() function is asynchronous and takes
-                // additional time to connect to a hidden SSID. Therefore a delay of 1000ms
-                // is added for hidden SSIDs before calling WiFi.status()
-                delay(1000);
-
-                status = WiFi.status();
-                startTime = millis();
-
-                while (status != WL_CONNECTED && (millis() - startTime) <= connectTimeout) {
-                  delay(10);
-                  status = WiFi.status();
-                }
-
-                WiFi.disconnect();
-                delay(10);
-
-                if (status == WL_CONNECTED) {
-                  log_v("hidden ssid %s found", entry.ssid);
-                  ssid_scan = entry.ssid;
-                  foundCount++;
-                } else {
-                  continue;
-                }
-              }
-              known = true;
-              log_v("rssi_scan: %d, bestNetworkDb: %d", rssi_scan, bestNetworkDb);
-              if (rssi_scan > bestNetworkDb) {                                            // best network
-                if (_bAllowOpenAP || (sec_scan == WIFI_AUTH_OPEN || entry.passphrase)) {  // check for passphrase if not open wlan
-                  log_v("best network is now: %s", ssid_scan);
-                  bestIndex = x;
-                  bestNetworkSec = sec_scan;
-                  bestNetworkDb = rssi_scan;
-                  bestChannel = chan_scan;
-                  memcpy((void *)&bestNetwork, (void *)&entry, sizeof(bestNetwork));
-                  memcpy((void *)&bestBSSID, (void *)BSSID_scan, sizeof(bestBSSID));
-                }
-              }
-              break;
-            } else {
-              failCount++;
-            }
-          }
+    wifi_multi_selection_t selection;
+    wifiMultiSelect(
+      *source, scanResult, APlist, _bAllowOpenAP, scanHidden,
+      [connectTimeout](const WifiAPlist_t &entry, const wifi_multi_scan_result_t &network) {
+        WiFi.begin(entry.ssid, entry.passphrase, network.channel, network.bssid);
+
+        // If the ssid returned from the scan is empty, it is a hidden SSID
+        // it appears that the WiFi.begin() function is asynchronous and takes
+        // additional time to connect to a hidden SSID. Therefore a delay of 1000ms
+        // is added for hidden SSIDs before calling WiFi.status()
+        delay(1000);
+
+        uint8_t status = WiFi.status();
+        unsigned long startTime = millis();
+        while (status != WL_CONNECTED && (millis() - startTime) <= connectTimeout) {
+          delay(10);
+          status = WiFi.status();
         }
 
-        if (known) {
-          log_d(
-            " --->   %d: [%d][%02X:%02X:%02X:%02X:%02X:%02X] %s (%d) (%c) (%s)", i, chan_scan, BSSID_scan[0], BSSID_scan[1], BSSID_scan[2], BSSID_scan[3],
-            BSSID_scan[4], BSSID_scan[5], ssid_scan.c_str(), rssi_scan, (sec_scan == WIFI_AUTH_OPEN) ? ' ' : '*', (hidden_scan) ? "hidden" : "visible"
-          );
-        } else {
-          log_d(
-            "        %d: [%d][%02X:%02X:%02X:%02X:%02X:%02X] %s (%d) (%c) (%s)", i, chan_scan, BSSID_scan[0], BSSID_scan[1], BSSID_scan[2], BSSID_scan[3],
-            BSSID_scan[4], BSSID_scan[5], ssid_scan.c_str(), rssi_scan, (sec_scan == WIFI_AUTH_OPEN) ? ' ' : '*', (hidden_scan) ? "hidden" : "visible"
-          );
-        }
-      }
-      log_v("foundCount = %d, failCount = %d", foundCount, failCount);
-      // if all the APs in the list have failed, reset the failure flags
-      if (foundCount == failCount) {
-        resetFails();  // keeps trying the APs in the list
-      }
+        WiFi.disconnect();
+        delay(10);
+        return status == WL_CONNECTED;
+      },
+      &selection
+    );
+    log_v("foundCount = %d, failCount = %d", selection.found, selection.failed);
+    // if all the APs in the list have failed, reset the failure flags
+    if (scanResult > 0 && selection.found == selection.failed) {
+      resetFails();  // keeps trying the APs in the list
     }
     // clean up ram
-    WiFi.scanDelete();
+    source->clear();
 
-    if (bestIndex >= 0) {
-      log_i(
-        "[WIFI] Connecting BSSID: %02X:%02X:%02X:%02X:%02X:%02X SSID: %s Channel: %d (%d)", bestBSSID[0], bestBSSID[1], bestBSSID[2], bestBSSID[3],
-        bestBSSID[4], bestBSSID[5], bestNetwork.ssid, bestChannel, bestNetworkDb
-      );
-
-#if CONFIG_LWIP_IPV6
-      if (ipv6_support == true) {
-        WiFi.enableIPv6();
-      }
-#endif
-      WiFi.disconnect();
-      delay(10);
-      WiFi.begin(bestNetwork.ssid, (_bAllowOpenAP && bestNetworkSec == WIFI_AUTH_OPEN) ? NULL : bestNetwork.passphrase, bestChannel, bestBSSID);
-      status = WiFi.status();
+    if (selection.ap >= 0) {
+      const char *passphrase = (_bAllowOpenAP && selection.network.authmode == WIFI_AUTH_OPEN) ? NULL : APlist[selection.ap].passphrase;
+      status = connectAP(selection.ap, selection.network, passphrase, connectTimeout);
       _bWFMInit = true;
-
-      startTime = millis();
-      // wait for connection, fail, or timeout
-      while (status != WL_CONNECTED && (millis() - startTime) <= connectTimeout) {  // && status != WL_NO_SSID_AVAIL && status != WL_CONNECT_FAILED
-        delay(10);
-        status = WiFi.status();
-      }
-
-      switch (status) {
-        case WL_CONNECTED:
-          log_i("[WIFI] Connecting done.");
-          log_d("[WIFI] SSID: %s", WiFi.SSID().c_str());
-          log_d("[WIFI] IP: %s", WiFi.localIP().toString().c_str());
-          log_d("[WIFI] MAC: %s", WiFi.BSSIDstr().c_str());
-          log_d("[WIFI] Channel: %d", WiFi.channel());
-
-          if (_connectionTestCBFunc != NULL) {
-            // We connected to an AP but if it's a captive portal we're not going anywhere.  Test it.
-            if (_connectionTestCBFunc()) {
-              resetFails();
-            } else {
-              markAsFailed(bestIndex);
-              WiFi.disconnect();
-              delay(10);
-              status = WiFi.status();
-            }
-          } else {
-            resetFails();
-          }
-          break;
-        case WL_NO_SSID_AVAIL:
-          log_e("[WIFI] Connecting Failed AP not found.");
-          markAsFailed(bestIndex);
-          break;
-        case WL_CONNECT_FAILED:
-          log_e("[WIFI] Connecting Failed.");
-          markAsFailed(bestIndex);
-          break;
-        default:
-          log_e("[WIFI] Connecting Failed (%d).", status);
-          markAsFailed(bestIndex);
-          break;
-      }
+      status = connectResult(selection.ap, status, WIFI_MULTI_PATH_FULL_SCAN, selection.network);
     } else {
       log_e("[WIFI] no matching wifi found!");
     }
@@ -320,6 +299,205 @@ uint8_t WiFiMulti::run(uint32_t connectTimeout, bool scanHidden) {
   return status;
 }
 
+uint8_t WiFiMulti::fastConnect(uint32_t connectTimeout, bool scanHidden) {
+  uint8_t status = WiFi.status();
+  wifi_multi_cache_t cache;
+  bool cached = cacheLoad(&cache);
+  int32_t index = cached ? findAP(cache.ssid) : -1;
+
+  // 1. the cached AP, directly
+  if (index >= 0 && !APlist[index].hasFailed) {
+    WifiAPlist_t &ap = APlist[index];
+    wifi_multi_scan_result_t network;
+    memset(&network, 0, sizeof(network));
+    strncpy(network.ssid, cache.ssid, sizeof(network.ssid) - 1);
+    memcpy(network.bssid, cache.bssid, sizeof(network.bssid));
+    network.channel = cache.channel;
+    network.authmode = cache.authmode;
+    // a cached PMK saves the key derivation, which takes most of a WPA2 connect
+    char pmk[65];
+    const char *passphrase = ap.passphrase;
+    if (cache.has_pmk && ap.passphrase && cache.pass_crc == passCRC(ap.passphrase)) {
+      for (int i = 0; i < 32; i++) {
+        sprintf(pmk + i * 2, "%02x", cache.pmk[i]);
+      }
+      passphrase = pmk;
+    }
+    log_i(
+      "[WIFI] Fast connect to BSSID: %02X:%02X:%02X:%02X:%02X:%02X SSID: %s Channel: %d%s", cache.bssid[0], cache.bssid[1], cache.bssid[2], cache.bssid[3],
+      cache.bssid[4], cache.bssid[5], cache.ssid, cache.channel, (passphrase == pmk) ? " (cached PMK)" : ""
+    );
+    status = connectAP(index, network, passphrase, connectTimeout);
+    if (status == WL_CONNECTED) {
+      _bWFMInit = true;
+      return connectResult(index, status, WIFI_MULTI_PATH_DIRECT, network);
+    }
+    // the AP moved or its settings changed, the scans below will find it again
+    log_w("[WIFI] Fast connect failed (%d)", status);
+    _pathStats[WIFI_MULTI_PATH_DIRECT].attempts++;
+    clearFastConnect();
+  }
+
+  // 2. scan only the channel the AP was last seen on
+  if (cached && cache.channel) {
+    status = scanAndConnect(WIFI_MULTI_PATH_CHANNEL_SCAN, cache.channel, NULL, connectTimeout, scanHidden);
+    if (status == WL_CONNECTED) {
+      return status;
+    }
+  }
+
+  // 3. scan all channels, but only for the SSID of the cached AP
+  if (index >= 0) {
+    status = scanAndConnect(WIFI_MULTI_PATH_SSID_SCAN, 0, APlist[index].ssid, connectTimeout, false);
+  }
+  return status;
+}
+
+uint8_t WiFiMulti::scanAndConnect(wifi_multi_path_t path, uint8_t channel, const char *ssid, uint32_t connectTimeout, bool scanHidden) {
+  WiFiMultiScanSource *source = _scanSource ? _scanSource : &wifiScanSource;
+  int16_t count = source->scan(scanHidden && !ssid, channel, ssid);
+  if (count <= 0) {
+    log_d("[WIFI] %s found nothing", pathName(path));
+    source->clear();
+    return WiFi.status();
+  }
+  wifi_multi_selection_t selection;
+  // hidden networks are left to the full scan, probing them here would cost more than it saves
+  wifiMultiSelect(*source, count, APlist, _bAllowOpenAP, false, NULL, &selection);
+  source->clear();
+  if (selection.ap < 0) {
+    log_d("[WIFI] %s found no known AP", pathName(path));
+    return WiFi.status();
+  }
+  const char *passphrase = (_bAllowOpenAP && selection.network.authmode == WIFI_AUTH_OPEN) ? NULL : APlist[selection.ap].passphrase;
+  uint8_t status = connectAP(selection.ap, selection.network, passphrase, connectTimeout);
+  _bWFMInit = true;
+  return connectResult(selection.ap, status, path, selection.network);
+}
+
+uint8_t WiFiMulti::connectAP(int32_t index, const wifi_multi_scan_result_t &network, const char *passphrase, uint32_t connectTimeout) {
+  log_i(
+    "[WIFI] Connecting BSSID: %02X:%02X:%02X:%02X:%02X:%02X SSID: %s Channel: %d (%d)", network.bssid[0], network.bssid[1], network.bssid[2],
+    network.bssid[3], network.bssid[4], network.bssid[5], APlist[index].ssid, network.channel, network.rssi
+  );
+
+#if CONFIG_LWIP_IPV6
+  if (ipv6_support == true) {
+    WiFi.enableIPv6();
+  }
+#endif
+  WiFi.disconnect();
+  delay(10);
+  WiFi.begin(APlist[index].ssid, passphrase, network.channel, network.bssid);
+  uint8_t status = WiFi.status();
+
+  unsigned long startTime = millis();
+  // wait for connection, fail, or timeout
+  while (status != WL_CONNECTED && (millis() - startTime) <= connectTimeout) {  // && status != WL_NO_SSID_AVAIL && status != WL_CONNECT_FAILED
+    delay(10);
+    status = WiFi.status();
+  }
+  return status;
+}
+
+uint8_t WiFiMulti::connectResult(int32_t index, uint8_t status, wifi_multi_path_t path, const wifi_multi_scan_result_t &network) {
+  wifi_multi_path_stats_t &stats = _pathStats[path];
+  stats.attempts++;
+  switch (status) {
+    case WL_CONNECTED:
+      log_i("[WIFI] Connecting done.");
+      log_d("[WIFI] SSID: %s", WiFi.SSID().c_str());
+      log_d("[WIFI] IP: %s", WiFi.localIP().toString().c_str());
+      log_d("[WIFI] MAC: %s", WiFi.BSSIDstr().c_str());
+      log_d("[WIFI] Channel: %d", WiFi.channel());
+
+      if (_connectionTestCBFunc != NULL) {
+        // We connected to an AP but if it's a captive portal we're not going anywhere.  Test it.
+        if (_connectionTestCBFunc()) {
+          resetFails();
+        } else {
+          markAsFailed(index);
+          WiFi.disconnect();
+          delay(10);
+          status = WiFi.status();
+          break;
+        }
+      } else {
+        resetFails();
+      }
+      _lastPath = path;
+      _lastTime = millis() - _runStart;
+      stats.connects++;
+      stats.last_ms = _lastTime;
+      stats.total_ms += _lastTime;
+      log_i("[WIFI] Connected in %lu ms (%s)", _lastTime, pathName(path));
+      if (_bFastConnect) {
+        cacheSave(APlist[index], network.authmode);
+      }
+      break;
+    case WL_NO_SSID_AVAIL:
+      log_e("[WIFI] Connecting Failed AP not found.");
+      markAsFailed(index);
+      break;
+    case WL_CONNECT_FAILED:
+      log_e("[WIFI] Connecting Failed.");
+      markAsFailed(index);
+      break;
+    default:
+      log_e("[WIFI] Connecting Failed (%d).", status);
+      markAsFailed(index);
+      break;
+  }
+  return status;
+}
+
+int32_t WiFiMulti::findAP(const char *ssid) {
+  for (uint32_t i = 0; i < APlist.size(); i++) {
+    if (strcmp(APlist[i].ssid, ssid) == 0) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+void WiFiMulti::setFastConnect(bool enable) {
+  _bFastConnect = enable;
+}
+
+void WiFiMulti::clearFastConnect() {
+  memset(&s_cache, 0, sizeof(s_cache));
+}
+
+wifi_multi_path_t WiFiMulti::lastConnectPath() {
+  return _lastPath;
+}
+
+uint32_t WiFiMulti::lastConnectTime() {
+  return _lastTime;
+}
+
+bool WiFiMulti::getPathStats(wifi_multi_path_t path, wifi_multi_path_stats_t *stats) {
+  if (path >= WIFI_MULTI_PATH_MAX || stats == NULL) {
+    return false;
+  }
+  *stats = _pathStats[path];
+  return true;
+}
+
+const char *WiFiMulti::pathName(wifi_multi_path_t path) {
+  switch (path) {
+    case WIFI_MULTI_PATH_DIRECT:       return "direct";
+    case WIFI_MULTI_PATH_CHANNEL_SCAN: return "channel scan";
+    case WIFI_MULTI_PATH_SSID_SCAN:    return "SSID scan";
+    case WIFI_MULTI_PATH_FULL_SCAN:    return "full scan";
+    default:                           return "none";
+  }
+}
+
+void WiFiMulti::setScanSource(WiFiMultiScanSource *source) {
+  _scanSource = source;
+}
+
 #if CONFIG_LWIP_IPV6
 void WiFiMulti::enableIPv6(bool state) {
   ipv6_support = state;
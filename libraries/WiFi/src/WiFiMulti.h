@@ -30,13 +30,25 @@
 #if SOC_WIFI_SUPPORTED || CONFIG_ESP_WIFI_REMOTE_ENABLED
 
 #include "WiFi.h"
+#include "WiFiMultiSelect.h"
 #include <vector>
 
+// How run() found the AP it connected to, fastest first
+typedef enum {
+  WIFI_MULTI_PATH_NONE,
+  WIFI_MULTI_PATH_DIRECT,        // cached BSSID and channel, no scan
+  WIFI_MULTI_PATH_CHANNEL_SCAN,  // scan of the cached channel only
+  WIFI_MULTI_PATH_SSID_SCAN,     // scan for the cached SSID on all channels
+  WIFI_MULTI_PATH_FULL_SCAN,
+  WIFI_MULTI_PATH_MAX
+} wifi_multi_path_t;
+
 typedef struct {
-  char *ssid;
-  char *passphrase;
-  bool hasFailed;
-} WifiAPlist_t;
+  uint32_t attempts;
+  uint32_t connects;
+  uint32_t last_ms;   // time from run() to connected with an IP
+  uint32_t total_ms;  // of all connects, for the average
+} wifi_multi_path_stats_t;
 
 typedef std::function<bool(void)> ConnectionTestCB_t;
 
@@ -67,6 +79,22 @@ public:
   // set the callback to NULL to disable the feature and validate any SSID that is in the list.
   void setConnectionTestCallbackFunc(ConnectionTestCB_t cbFunc);
 
+  // Fast connect: the BSSID, channel and, for WPA/WPA2-PSK, the PMK of the last AP are kept in
+  // RTC memory, so they survive deep sleep and resets. run() first connects to that AP directly,
+  // then falls back to a scan of its channel, a scan for its SSID and finally a full scan.
+  // Note that the PMK is a secret equivalent to the passphrase of that network.
+  void setFastConnect(bool enable = true);
+  void clearFastConnect();  // forgets the cached AP
+
+  // Path and time to IP of the last connect done by run()
+  wifi_multi_path_t lastConnectPath();
+  uint32_t lastConnectTime();
+  bool getPathStats(wifi_multi_path_t path, wifi_multi_path_stats_t *stats);
+  static const char *pathName(wifi_multi_path_t path);
+
+  // Replaces WiFi scans, for tests. NULL restores the default
+  void setScanSource(WiFiMultiScanSource *source);
+
 private:
   std::vector<WifiAPlist_t> APlist;
   bool ipv6_support;
@@ -76,8 +104,20 @@ private:
   ConnectionTestCB_t _connectionTestCBFunc = NULL;
   bool _bWFMInit = false;
 
+  bool _bFastConnect = false;
+  WiFiMultiScanSource *_scanSource = NULL;
+  unsigned long _runStart = 0;
+  wifi_multi_path_t _lastPath = WIFI_MULTI_PATH_NONE;
+  uint32_t _lastTime = 0;
+  wifi_multi_path_stats_t _pathStats[WIFI_MULTI_PATH_MAX] = {};
+
   void markAsFailed(int32_t i);
   void resetFails();
+  uint8_t fastConnect(uint32_t connectTimeout, bool scanHidden);
+  uint8_t scanAndConnect(wifi_multi_path_t path, uint8_t channel, const char *ssid, uint32_t connectTimeout, bool scanHidden);
+  uint8_t connectAP(int32_t index, const wifi_multi_scan_result_t &network, const char *passphrase, uint32_t connectTimeout);
+  uint8_t connectResult(int32_t index, uint8_t status, wifi_multi_path_t path, const wifi_multi_scan_result_t &network);
+  int32_t findAP(const char *ssid);
 };
 
 #endif /* SOC_WIFI_SUPPORTED */
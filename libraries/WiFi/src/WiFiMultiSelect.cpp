@@ -0,0 +1,88 @@
+// Copyright 2025 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "WiFiMultiSelect.h"
+#include <limits.h>
+#include <string.h>
+
+#ifdef ARDUINO
+#include "esp32-hal-log.h"
+#else
+// host build, the arguments are still evaluated to keep the compiler happy
+static inline void log_host(const char *format, ...) {}
+#define log_v(format, ...) log_host(format, ##__VA_ARGS__)
+#define log_d(format, ...) log_host(format, ##__VA_ARGS__)
+#endif
+
+void wifiMultiSelect(
+  WiFiMultiScanSource &source, int16_t count, const std::vector<WifiAPlist_t> &aps, bool allowOpenAP, bool scanHidden, WiFiMultiProbeCB_t probeHidden,
+  wifi_multi_selection_t *selection
+) {
+  int32_t bestNetworkDb = INT_MIN;
+  memset(selection, 0, sizeof(*selection));
+  selection->ap = -1;
+
+  for (int16_t i = 0; i < count; ++i) {
+    wifi_multi_scan_result_t network;
+    if (!source.result(i, &network)) {
+      continue;
+    }
+    bool hidden = (network.ssid[0] == 0) && scanHidden;
+    if (hidden) {
+      log_v("hidden ssid on channel %d found, trying to connect with known credentials...", network.channel);
+    }
+
+    bool known = false;
+    for (size_t x = 0; x < aps.size(); x++) {
+      const WifiAPlist_t &entry = aps[x];
+
+      if (!hidden && strcmp(network.ssid, entry.ssid) != 0) {
+        continue;
+      }
+      if (!hidden) {
+        log_v("known ssid: %s, has failed: %s", entry.ssid, entry.hasFailed ? "yes" : "no");
+        selection->found++;
+      }
+      if (entry.hasFailed) {
+        selection->failed++;
+        continue;
+      }
+      if (hidden) {
+        if (!probeHidden || !probeHidden(entry, network)) {
+          continue;
+        }
+        log_v("hidden ssid %s found", entry.ssid);
+        strncpy(network.ssid, entry.ssid, sizeof(network.ssid) - 1);
+        selection->found++;
+      }
+      known = true;
+      log_v("rssi_scan: %d, bestNetworkDb: %d", network.rssi, bestNetworkDb);
+      if (network.rssi > bestNetworkDb) {                                                      // best network
+        if (allowOpenAP || (network.authmode == WIFI_MULTI_AUTH_OPEN || entry.passphrase)) {  // check for passphrase if not open wlan
+          log_v("best network is now: %s", network.ssid);
+          selection->ap = x;
+          selection->network = network;
+          bestNetworkDb = network.rssi;
+        }
+      }
+      break;
+    }
+
+    log_d(
+      " %s %d: [%d][%02X:%02X:%02X:%02X:%02X:%02X] %s (%d) (%c) (%s)", known ? "--->  " : "      ", i, network.channel, network.bssid[0], network.bssid[1],
+      network.bssid[2], network.bssid[3], network.bssid[4], network.bssid[5], network.ssid, network.rssi,
+      (network.authmode == WIFI_MULTI_AUTH_OPEN) ? ' ' : '*', hidden ? "hidden" : "visible"
+    );
+  }
+}
@@ -0,0 +1,73 @@
+// Copyright 2025 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*
+ * Access point selection of WiFiMulti
+ *
+ * Picks the network to connect to from scan results and the list of known APs. It only
+ * depends on the C++ standard library and reads the results through WiFiMultiScanSource,
+ * so it can be tested on the host with a fake scan source (see tests/host/).
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <functional>
+#include <vector>
+
+// Values of wifi_auth_mode_t that the selection needs to know
+#define WIFI_MULTI_AUTH_OPEN 0
+
+typedef struct {
+  char *ssid;
+  char *passphrase;
+  bool hasFailed;
+} WifiAPlist_t;
+
+typedef struct {
+  char ssid[33];  // empty for hidden networks
+  uint8_t bssid[6];
+  int32_t channel;
+  int32_t rssi;
+  uint8_t authmode;  // wifi_auth_mode_t
+} wifi_multi_scan_result_t;
+
+class WiFiMultiScanSource {
+public:
+  virtual ~WiFiMultiScanSource() {}
+  // Blocking scan. channel 0 scans all channels, ssid NULL looks for all networks.
+  // Returns the number of results or a negative value on failure
+  virtual int16_t scan(bool show_hidden, uint8_t channel, const char *ssid) = 0;
+  virtual bool result(int16_t index, wifi_multi_scan_result_t *result) = 0;
+  // Frees the results
+  virtual void clear() = 0;
+};
+
+typedef struct {
+  int32_t ap;  // index in the AP list, -1 if nothing matched
+  wifi_multi_scan_result_t network;
+  int32_t found;   // results that match a known AP
+  int32_t failed;  // of those, results for APs that have failed
+} wifi_multi_selection_t;
+
+// Called for a hidden network with the credentials of every AP that has not failed, until one connects
+typedef std::function<bool(const WifiAPlist_t &ap, const wifi_multi_scan_result_t &network)> WiFiMultiProbeCB_t;
+
+// Selects the strongest network of count results that matches a known AP that has not failed.
+// Open networks qualify without a passphrase only if allowOpenAP is set.
+void wifiMultiSelect(
+  WiFiMultiScanSource &source, int16_t count, const std::vector<WifiAPlist_t> &aps, bool allowOpenAP, bool scanHidden, WiFiMultiProbeCB_t probeHidden,
+  wifi_multi_selection_t *selection
+);
@@ -596,6 +596,50 @@ void TwoWire::flush() {
   //i2cFlush(num); // cleanup
 }
 
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 4, 0)
+bool TwoWire::beginAsync(size_t queueDepth, uint32_t stackSize, uint8_t priority, int core) {
+#if SOC_I2C_SUPPORT_SLAVE
+  if (is_slave) {
+    log_e("Bus is in Slave Mode");
+    return false;
+  }
+#endif /* SOC_I2C_SUPPORT_SLAVE */
+  esp_err_t err = i2cAsyncBegin(num, queueDepth, stackSize, priority, core);
+  if (err != ESP_OK) {
+    log_e("i2cAsyncBegin returned Error %d", err);
+  }
+  return (err == ESP_OK);
+}
+
+void TwoWire::endAsync() {
+  i2cAsyncEnd(num);
+}
+
+bool TwoWire::queueWriteRead(uint8_t address, const uint8_t *wbuff, size_t wsize, uint8_t *rbuff, size_t rsize, i2c_transaction_cb_t cb, void *arg) {
+  esp_err_t err = i2cQueueWriteRead(num, address, wbuff, wsize, rbuff, rsize, _timeOutMillis, cb, arg);
+  if (err != ESP_OK && err != ESP_ERR_TIMEOUT) {
+    log_e("i2cQueueWriteRead returned Error %d", err);
+  }
+  return (err == ESP_OK);
+}
+
+bool TwoWire::waitAsync(uint32_t timeOutMillis) {
+  return i2cAsyncWait(num, timeOutMillis) == ESP_OK;
+}
+
+size_t TwoWire::asyncPending() {
+  return i2cAsyncPending(num);
+}
+
+bool TwoWire::getAsyncStats(i2c_async_stats_t &stats) {
+  return i2cAsyncGetStats(num, &stats) == ESP_OK;
+}
+
+void TwoWire::resetAsyncStats() {
+  i2cAsyncResetStats(num);
+}
+#endif
+
 void TwoWire::onReceive(const std::function<void(int)> &function) {
 #if SOC_I2C_SUPPORT_SLAVE
   user_onReceive = function;
@@ -615,6 +659,26 @@ size_t TwoWire::slaveWrite(const uint8_t *buffer, size_t len) {
   return i2cSlaveWrite(num, buffer, len, _timeOutMillis);
 }
 
+bool TwoWire::setRegisterMap(size_t size) {
+  return i2cSlaveSetRegisterMap(num, size) == ESP_OK;
+}
+
+bool TwoWire::writeRegisterMap(size_t offset, const uint8_t *data, size_t len) {
+  return i2cSlaveWriteRegisterMap(num, offset, data, len, _timeOutMillis) == ESP_OK;
+}
+
+bool TwoWire::commitRegisterMap() {
+  return i2cSlaveCommitRegisterMap(num, _timeOutMillis) == ESP_OK;
+}
+
+bool TwoWire::getSlaveStats(i2c_slave_stats_t &stats) {
+  return i2cSlaveGetStats(num, &stats) == ESP_OK;
+}
+
+void TwoWire::resetSlaveStats() {
+  i2cSlaveResetStats(num);
+}
+
 void TwoWire::onReceiveService(uint8_t num, uint8_t *inBytes, size_t numBytes, bool stop, void *arg) {
   TwoWire *wire = (TwoWire *)arg;
   if (!wire->user_onReceive) {
@@ -624,9 +688,10 @@ void TwoWire::onReceiveService(uint8_t num, uint8_t *inBytes, size_t numBytes, b
     log_e("NULL RX buffer pointer");
     return;
   }
-  for (uint8_t i = 0; i < numBytes; ++i) {
-    wire->rxBuffer[i] = inBytes[i];
+  if (numBytes > wire->bufferSize) {
+    numBytes = wire->bufferSize;
   }
+  memcpy(wire->rxBuffer, inBytes, numBytes);
   wire->rxIndex = 0;
   wire->rxLength = numBytes;
   wire->user_onReceive(numBytes);
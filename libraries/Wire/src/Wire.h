@@ -39,6 +39,10 @@
 #endif
 #include "HardwareI2C.h"
 #include "Stream.h"
+#include "esp32-hal-i2c.h"
+#if SOC_I2C_SUPPORT_SLAVE
+#include "esp32-hal-i2c-slave.h"
+#endif /* SOC_I2C_SUPPORT_SLAVE */
 
 // WIRE_HAS_BUFFER_SIZE means Wire has setBufferSize()
 #define WIRE_HAS_BUFFER_SIZE 1
@@ -139,7 +143,38 @@ public:
 
 #if SOC_I2C_SUPPORT_SLAVE
   size_t slaveWrite(const uint8_t *, size_t);
+
+  // Register addressed slave: the first byte the master writes selects a register and reads are
+  // answered from the map in the ISR, without calling onRequest(). Writes are staged and become
+  // visible to the master all at once on commitRegisterMap(). Call after begin(address).
+  bool setRegisterMap(size_t size);
+  bool writeRegisterMap(size_t offset, const uint8_t *data, size_t len);
+  bool commitRegisterMap();
+  bool getSlaveStats(i2c_slave_stats_t &stats);
+  void resetSlaveStats();
 #endif /* SOC_I2C_SUPPORT_SLAVE */
+
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 4, 0)
+  // Queued transactions run back to back in a worker task, so the caller does not wait for the bus.
+  // Callbacks are called from that task. Buffers must stay valid until the callback, except write
+  // data of up to I2C_ASYNC_INLINE_WRITE bytes, which is copied. Callbacks can not call endAsync(),
+  // waitAsync() or end(), those wait for the worker task.
+  bool beginAsync(size_t queueDepth = 16, uint32_t stackSize = 4096, uint8_t priority = 2, int core = tskNO_AFFINITY);
+  void endAsync();
+  bool queueWriteRead(
+    uint8_t address, const uint8_t *wbuff, size_t wsize, uint8_t *rbuff, size_t rsize, i2c_transaction_cb_t cb = NULL, void *arg = NULL
+  );
+  bool queueWrite(uint8_t address, const uint8_t *buff, size_t size, i2c_transaction_cb_t cb = NULL, void *arg = NULL) {
+    return queueWriteRead(address, buff, size, NULL, 0, cb, arg);
+  }
+  bool queueRead(uint8_t address, uint8_t *buff, size_t size, i2c_transaction_cb_t cb = NULL, void *arg = NULL) {
+    return queueWriteRead(address, NULL, 0, buff, size, cb, arg);
+  }
+  bool waitAsync(uint32_t timeOutMillis = UINT32_MAX);  // wait until all queued transactions completed
+  size_t asyncPending();
+  bool getAsyncStats(i2c_async_stats_t &stats);
+  void resetAsyncStats();
+#endif
 };
 
 extern TwoWire Wire;
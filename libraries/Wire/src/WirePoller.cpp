@@ -0,0 +1,289 @@
+// Copyright 2025 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "WirePoller.h"
+#if SOC_I2C_SUPPORTED && ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 4, 0)
+
+#include "Arduino.h"
+
+static uint32_t gcd(uint32_t a, uint32_t b) {
+  while (b) {
+    uint32_t t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+static void timerTaskBarrier(void *arg) {
+  xSemaphoreGive(static_cast<SemaphoreHandle_t>(arg));
+}
+
+// Returns once the esp_timer task finished the callback it may be running. It runs the callbacks
+// one at a time, so it got past that one when it runs a new one
+static void waitTimerTask() {
+  SemaphoreHandle_t done = xSemaphoreCreateBinary();
+  esp_timer_handle_t barrier = NULL;
+  esp_timer_create_args_t args = {};
+  args.callback = timerTaskBarrier;
+  args.arg = done;
+  args.dispatch_method = ESP_TIMER_TASK;
+  args.name = "wire_poller_sync";
+  if (done == NULL || esp_timer_create(&args, &barrier) != ESP_OK || esp_timer_start_once(barrier, 0) != ESP_OK) {
+    log_e("Failed to sync with the timer task");
+  } else {
+    xSemaphoreTake(done, portMAX_DELAY);
+  }
+  if (barrier != NULL) {
+    esp_timer_delete(barrier);
+  }
+  if (done != NULL) {
+    vSemaphoreDelete(done);
+  }
+}
+
+WirePoller::WirePoller(TwoWire &wire) : _wire(wire), _timer(NULL), _running(false), _cb(NULL), _cbArg(NULL) {
+  portMUX_INITIALIZE(&_mux);
+  memset(_devices, 0, sizeof(_devices));
+  for (int i = 0; i < WIRE_POLLER_MAX_DEVICES; i++) {
+    _devices[i].poller = this;
+  }
+}
+
+WirePoller::~WirePoller() {
+  end();
+  if (_timer != NULL) {
+    // esp_timer_stop() does not wait for a poll that already started, and it may queue reads
+    esp_timer_stop(_timer);
+    waitTimerTask();
+    _wire.waitAsync();
+    esp_timer_delete(_timer);
+  }
+}
+
+int WirePoller::addDevice(uint8_t address, const uint8_t *reg, size_t regLen, size_t len, uint32_t periodMs) {
+  if (regLen > WIRE_POLLER_MAX_WRITE || (regLen && reg == NULL) || len == 0 || len > WIRE_POLLER_MAX_READ || periodMs == 0) {
+    log_e("Invalid device: addr=0x%x reg=%u len=%u period=%lu", address, regLen, len, periodMs);
+    return -1;
+  }
+  int id = -1;
+  portENTER_CRITICAL(&_mux);
+  for (int i = 0; i < WIRE_POLLER_MAX_DEVICES; i++) {
+    Device &d = _devices[i];
+    if (!d.used && !d.busy) {
+      d.address = address;
+      d.regLen = regLen;
+      if (regLen) {
+        memcpy(d.reg, reg, regLen);
+      }
+      d.len = len;
+      d.periodMs = periodMs;
+      d.nextUs = esp_timer_get_time();
+      d.fresh = false;
+      d.front = 0;
+      memset(&d.stats, 0, sizeof(d.stats));
+      d.used = true;
+      id = i;
+      break;
+    }
+  }
+  portEXIT_CRITICAL(&_mux);
+  if (id < 0) {
+    log_e("No free device slot");
+    return -1;
+  }
+  if (_running && !startTimer()) {
+    removeDevice(id);
+    return -1;
+  }
+  return id;
+}
+
+bool WirePoller::removeDevice(int id) {
+  if (id < 0 || id >= WIRE_POLLER_MAX_DEVICES) {
+    return false;
+  }
+  portENTER_CRITICAL(&_mux);
+  bool used = _devices[id].used;
+  // a read still in flight completes into the slot, which is only reused once it did
+  _devices[id].used = false;
+  portEXIT_CRITICAL(&_mux);
+  return used;
+}
+
+bool WirePoller::startTimer() {
+  uint32_t periodMs = 0;
+  portENTER_CRITICAL(&_mux);
+  for (int i = 0; i < WIRE_POLLER_MAX_DEVICES; i++) {
+    if (_devices[i].used) {
+      periodMs = gcd(_devices[i].periodMs, periodMs);
+    }
+  }
+  portEXIT_CRITICAL(&_mux);
+
+  if (_timer == NULL) {
+    esp_timer_create_args_t args = {};
+    args.callback = &WirePoller::tick;
+    args.arg = this;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "wire_poller";
+    if (esp_timer_create(&args, &_timer) != ESP_OK) {
+      log_e("Failed to create poll timer");
+      return false;
+    }
+  }
+  esp_timer_stop(_timer);
+  if (periodMs == 0) {
+    return true;  // nothing to poll yet
+  }
+  if (esp_timer_start_periodic(_timer, periodMs * 1000ULL) != ESP_OK) {
+    log_e("Failed to start poll timer");
+    return false;
+  }
+  log_v("Polling every %lu ms", periodMs);
+  return true;
+}
+
+bool WirePoller::begin() {
+  if (_running) {
+    return true;
+  }
+  if (!_wire.beginAsync()) {
+    return false;
+  }
+  _running = true;
+  if (!startTimer()) {
+    _running = false;
+    return false;
+  }
+  return true;
+}
+
+void WirePoller::end() {
+  if (!_running) {
+    return;
+  }
+  _running = false;
+  if (_timer != NULL) {
+    esp_timer_stop(_timer);
+  }
+  // let queued reads complete before the result slots can go away
+  _wire.waitAsync();
+}
+
+void WirePoller::onSample(wire_poller_cb_t cb, void *arg) {
+  portENTER_CRITICAL(&_mux);
+  _cb = cb;
+  _cbArg = arg;
+  portEXIT_CRITICAL(&_mux);
+}
+
+void WirePoller::tick(void *arg) {
+  static_cast<WirePoller *>(arg)->poll();
+}
+
+void WirePoller::poll() {
+  int64_t now = esp_timer_get_time();
+  for (int i = 0; i < WIRE_POLLER_MAX_DEVICES; i++) {
+    Device &d = _devices[i];
+    if (!d.used || d.nextUs > now) {
+      continue;
+    }
+    int64_t periodUs = (int64_t)d.periodMs * 1000;
+    d.nextUs += periodUs;
+    if (d.nextUs <= now) {
+      // do not burst to catch up after a stall
+      d.nextUs = now + periodUs;
+    }
+    if (d.busy) {
+      d.stats.overruns++;
+      continue;
+    }
+    d.busy = true;
+    d.scheduledUs = now;
+    if (!_wire.queueWriteRead(d.address, d.regLen ? d.reg : NULL, d.regLen, d.data[d.front ^ 1], d.len, &WirePoller::done, &d)) {
+      d.busy = false;
+      d.stats.overruns++;
+    }
+  }
+}
+
+void WirePoller::done(uint8_t i2c_num, uint16_t address, esp_err_t err, uint8_t *rbuff, size_t rsize, void *arg) {
+  Device *d = static_cast<Device *>(arg);
+  WirePoller *poller = d->poller;
+  int64_t now = esp_timer_get_time();
+  bool ok = (err == ESP_OK && rsize == d->len);
+
+  portENTER_CRITICAL(&poller->_mux);
+  if (ok) {
+    d->front ^= 1;
+    d->fresh = true;
+    d->sampleUs = now;
+    d->stats.samples++;
+  } else {
+    d->stats.errors++;
+  }
+  d->stats.latency_us = (uint32_t)(now - d->scheduledUs);
+  wire_poller_cb_t cb = d->used ? poller->_cb : NULL;
+  void *cbArg = poller->_cbArg;
+  portEXIT_CRITICAL(&poller->_mux);
+
+  // the front buffer only changes in the next completion, which runs in this task too
+  if (ok && cb != NULL) {
+    cb(d - poller->_devices, d->data[d->front], d->len, cbArg);
+  }
+  d->busy = false;
+}
+
+bool WirePoller::available(int id) {
+  if (id < 0 || id >= WIRE_POLLER_MAX_DEVICES) {
+    return false;
+  }
+  portENTER_CRITICAL(&_mux);
+  bool fresh = _devices[id].used && _devices[id].fresh;
+  portEXIT_CRITICAL(&_mux);
+  return fresh;
+}
+
+size_t WirePoller::read(int id, uint8_t *data, size_t len, uint32_t *timestampMillis) {
+  if (id < 0 || id >= WIRE_POLLER_MAX_DEVICES || data == NULL) {
+    return 0;
+  }
+  size_t copied = 0;
+  portENTER_CRITICAL(&_mux);
+  Device &d = _devices[id];
+  if (d.used && d.stats.samples) {
+    copied = (len < d.len) ? len : d.len;
+    memcpy(data, d.data[d.front], copied);
+    d.fresh = false;
+    if (timestampMillis != NULL) {
+      *timestampMillis = (uint32_t)(d.sampleUs / 1000);
+    }
+  }
+  portEXIT_CRITICAL(&_mux);
+  return copied;
+}
+
+bool WirePoller::getStats(int id, wire_poller_stats_t &stats) {
+  if (id < 0 || id >= WIRE_POLLER_MAX_DEVICES) {
+    return false;
+  }
+  portENTER_CRITICAL(&_mux);
+  bool used = _devices[id].used;
+  stats = _devices[id].stats;
+  portEXIT_CRITICAL(&_mux);
+  return used;
+}
+
+#endif /* SOC_I2C_SUPPORTED && ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 4, 0) */
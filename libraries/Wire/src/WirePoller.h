@@ -0,0 +1,109 @@
+// Copyright 2025 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "soc/soc_caps.h"
+#if SOC_I2C_SUPPORTED
+#include "esp_idf_version.h"
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 4, 0)
+
+#include "Wire.h"
+#include "esp_timer.h"
+
+#ifndef WIRE_POLLER_MAX_DEVICES
+#define WIRE_POLLER_MAX_DEVICES 16
+#endif
+
+#ifndef WIRE_POLLER_MAX_WRITE
+#define WIRE_POLLER_MAX_WRITE 4  // register address bytes written before each read
+#endif
+
+#ifndef WIRE_POLLER_MAX_READ
+#define WIRE_POLLER_MAX_READ 32
+#endif
+
+typedef struct {
+  uint32_t samples;     // successful reads
+  uint32_t errors;      // failed reads
+  uint32_t overruns;    // polls skipped because the previous one was still queued or the queue was full
+  uint32_t latency_us;  // schedule to completion of the last read
+} wire_poller_stats_t;
+
+// Called from the I2C worker task with the new sample
+typedef void (*wire_poller_cb_t)(int id, const uint8_t *data, size_t len, void *arg);
+
+/*
+ * Polls a set of I2C devices at individual rates through the queued transactions of TwoWire.
+ * Devices that are due at the same time are queued back to back. Every device has two result
+ * buffers: the bus fills one while read() copies the other, which holds the latest sample.
+ */
+class WirePoller {
+public:
+  WirePoller(TwoWire &wire = Wire);
+  ~WirePoller();
+
+  // Reads len bytes every periodMs, after writing reg when regLen is not 0.
+  // Returns the device id or -1
+  int addDevice(uint8_t address, const uint8_t *reg, size_t regLen, size_t len, uint32_t periodMs);
+  int addDevice(uint8_t address, uint8_t reg, size_t len, uint32_t periodMs) {
+    return addDevice(address, &reg, 1, len, periodMs);
+  }
+  bool removeDevice(int id);
+
+  bool begin();
+  void end();
+  void onSample(wire_poller_cb_t cb, void *arg = NULL);
+
+  // True if a sample arrived since the last read()
+  bool available(int id);
+  // Copies the latest sample, returns its length or 0 if there is none
+  size_t read(int id, uint8_t *data, size_t len, uint32_t *timestampMillis = NULL);
+  bool getStats(int id, wire_poller_stats_t &stats);
+
+private:
+  struct Device {
+    WirePoller *poller;
+    bool used;
+    volatile bool busy;
+    bool fresh;
+    uint8_t front;
+    uint8_t address;
+    uint8_t regLen;
+    uint8_t len;
+    uint8_t reg[WIRE_POLLER_MAX_WRITE];
+    uint8_t data[2][WIRE_POLLER_MAX_READ];
+    uint32_t periodMs;
+    int64_t nextUs;
+    int64_t scheduledUs;
+    int64_t sampleUs;
+    wire_poller_stats_t stats;
+  };
+
+  static void tick(void *arg);
+  static void done(uint8_t i2c_num, uint16_t address, esp_err_t err, uint8_t *rbuff, size_t rsize, void *arg);
+  void poll();
+  bool startTimer();
+
+  TwoWire &_wire;
+  esp_timer_handle_t _timer;
+  portMUX_TYPE _mux;
+  bool _running;
+  wire_poller_cb_t _cb;
+  void *_cbArg;
+  Device _devices[WIRE_POLLER_MAX_DEVICES];
+};
+
+#endif /* ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 4, 0) */
+#endif /* SOC_I2C_SUPPORTED */
@@ -6,6 +6,7 @@
 #include "ZigbeeHandlers.cpp"
 #include "Arduino.h"
 #include <set>
+#include "esp_timer.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -32,6 +33,11 @@ ZigbeeCore::ZigbeeCore() {
   _scan_duration = 3;  // default scan duration
   _rx_on_when_idle = true;
   _debug = false;
+  memset(_ep_table, 0, sizeof(_ep_table));
+  memset(&_stats, 0, sizeof(_stats));
+  _stats_mux = portMUX_INITIALIZER_UNLOCKED;
+  _lock_start_us = 0;
+  _lock_depth = 0;
   if (!lock) {
     lock = xSemaphoreCreateBinary();
     if (lock == NULL) {
@@ -113,9 +119,83 @@ bool ZigbeeCore::addEndpoint(ZigbeeEP *ep) {
     log_e("Failed to add endpoint: 0x%x: %s", ret, esp_err_to_name(ret));
     return false;
   }
+  if (ep->_endpoint <= ZB_MAX_ENDPOINT_ID) {
+    _ep_table[ep->_endpoint] = ep;
+  }
+  return true;
+}
+
+ZigbeeEP *ZigbeeCore::getEndpoint(uint8_t endpoint) {
+  if (endpoint <= ZB_MAX_ENDPOINT_ID) {
+    return _ep_table[endpoint];
+  }
+  // ids above 240 are reserved, an endpoint added with one is only found in the list
+  for (std::list<ZigbeeEP *>::iterator it = ep_objects.begin(); it != ep_objects.end(); ++it) {
+    if ((*it)->getEndpoint() == endpoint) {
+      return *it;
+    }
+  }
+  return NULL;
+}
+
+bool ZigbeeCore::lockAcquire(TickType_t timeout) {
+  int64_t start = esp_timer_get_time();
+  if (!esp_zb_lock_acquire(timeout)) {
+    return false;
+  }
+  // the lock is recursive, only the outermost acquisition is timed
+  if (_lock_depth++ == 0) {
+    _lock_start_us = esp_timer_get_time();
+    uint32_t wait_us = (uint32_t)(_lock_start_us - start);
+    portENTER_CRITICAL(&_stats_mux);
+    if (wait_us > _stats.lock_wait_max_us) {
+      _stats.lock_wait_max_us = wait_us;
+    }
+    portEXIT_CRITICAL(&_stats_mux);
+  }
   return true;
 }
 
+void ZigbeeCore::lockRelease() {
+  if (_lock_depth && --_lock_depth == 0) {
+    uint32_t hold_us = (uint32_t)(esp_timer_get_time() - _lock_start_us);
+    portENTER_CRITICAL(&_stats_mux);
+    _stats.lock_count++;
+    _stats.lock_hold_total_us += hold_us;
+    if (hold_us > _stats.lock_hold_max_us) {
+      _stats.lock_hold_max_us = hold_us;
+    }
+    portEXIT_CRITICAL(&_stats_mux);
+  }
+  esp_zb_lock_release();
+}
+
+void ZigbeeCore::getStats(zigbee_stats_t *stats) {
+  if (stats == NULL) {
+    return;
+  }
+  portENTER_CRITICAL(&_stats_mux);
+  *stats = _stats;
+  portEXIT_CRITICAL(&_stats_mux);
+}
+
+void ZigbeeCore::resetStats() {
+  portENTER_CRITICAL(&_stats_mux);
+  memset(&_stats, 0, sizeof(_stats));
+  portEXIT_CRITICAL(&_stats_mux);
+}
+
+void ZigbeeCore::printStats(Print &print) {
+  zigbee_stats_t stats;
+  getStats(&stats);
+  print.printf("Zigbee: %lu messages handled, %lu unhandled\n", stats.messages_handled, stats.messages_unhandled);
+  print.printf(
+    "  stack lock: %lu times, avg hold %lu us, max hold %lu us, max wait %lu us\n", stats.lock_count,
+    stats.lock_count ? (uint32_t)(stats.lock_hold_total_us / stats.lock_count) : 0, stats.lock_hold_max_us, stats.lock_wait_max_us
+  );
+  print.printf("  reports: %lu sent, %lu coalesced\n", stats.reports_sent, stats.reports_coalesced);
+}
+
 static void esp_zb_task(void *pvParameters) {
   esp_zb_bdb_set_scan_duration(Zigbee.getScanDuration());
 
@@ -138,6 +218,7 @@ bool ZigbeeCore::zigbeeInit(esp_zb_cfg_t *zb_cfg, bool erase_nvs) {
     .host_config = _host_config,
   };
 
+  initNvs();  // in case it was deferred at boot
   esp_err_t err = esp_zb_platform_config(&platform_config);
   if (err != ESP_OK) {
     log_e("Failed to configure Zigbee platform");
@@ -31,6 +31,19 @@ typedef enum {
 
 #define ZB_BEGIN_TIMEOUT_DEFAULT 30000  // 30 seconds
 
+#define ZB_MAX_ENDPOINT_ID 240  // application endpoints are 1 - 240
+
+typedef struct {
+  uint32_t messages_handled;    // ZCL messages dispatched to an endpoint
+  uint32_t messages_unhandled;  // messages for endpoints that are not registered and unknown callbacks
+  uint32_t lock_count;          // stack lock acquisitions by the library and the sketch through lockAcquire()
+  uint32_t lock_wait_max_us;    // longest wait for the stack lock
+  uint32_t lock_hold_max_us;    // longest hold of the stack lock
+  uint64_t lock_hold_total_us;
+  uint32_t reports_sent;       // attribute reports sent through ZigbeeReport
+  uint32_t reports_coalesced;  // reports merged into one that was already pending
+} zigbee_stats_t;
+
 #define ZIGBEE_DEFAULT_ED_CONFIG()                                      \
   {                                                                     \
     .esp_zb_role = ESP_ZB_DEVICE_TYPE_ED, .install_code_policy = false, \
@@ -103,6 +116,12 @@ private:
   SemaphoreHandle_t lock;
   bool _debug;
 
+  ZigbeeEP *_ep_table[ZB_MAX_ENDPOINT_ID + 1];  // registered endpoints by id, for the message handlers
+  zigbee_stats_t _stats;
+  portMUX_TYPE _stats_mux;
+  int64_t _lock_start_us;
+  uint8_t _lock_depth;
+
   bool zigbeeInit(esp_zb_cfg_t *zb_cfg, bool erase_nvs);
   static void scanCompleteCallback(esp_zb_zdp_status_t zdo_status, uint8_t count, esp_zb_network_descriptor_t *nwk_descriptor);
   const char *getDeviceTypeString(esp_zb_ha_standard_devices_t deviceId);
@@ -133,6 +152,16 @@ public:
 
   bool addEndpoint(ZigbeeEP *ep);
   //void removeEndpoint(ZigbeeEP *ep);
+  // Registered endpoint with this id or NULL, constant time for the application ids 1 - 240
+  ZigbeeEP *getEndpoint(uint8_t endpoint);
+
+  // Stack lock with hold time accounting, used by the library in place of esp_zb_lock_acquire()
+  bool lockAcquire(TickType_t timeout = portMAX_DELAY);
+  void lockRelease();
+
+  void getStats(zigbee_stats_t *stats);
+  void resetStats();
+  void printStats(Print &print);
 
   void setRadioConfig(esp_zb_radio_config_t config);
   esp_zb_radio_config_t getRadioConfig();
@@ -179,6 +208,9 @@ public:
   // Friend function declaration to allow access to private members
   friend void esp_zb_app_signal_handler(esp_zb_app_signal_t *signal_struct);
   friend bool zb_apsde_data_indication_handler(esp_zb_apsde_data_ind_t ind);
+  friend class ZigbeeReport;
+  friend class ZigbeeEP;
+  friend void zbCountMessage(bool handled);
 
   // Helper functions for formatting addresses
   static inline const char *formatIEEEAddress(const esp_zb_ieee_addr_t addr) {
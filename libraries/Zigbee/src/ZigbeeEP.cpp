@@ -7,8 +7,98 @@
 #include "esp_zigbee_cluster.h"
 #include "zcl/esp_zigbee_zcl_power_config.h"
 
+/* Multi attribute report builder */
+ZigbeeReport::ZigbeeReport(uint8_t endpoint) {
+  _endpoint = endpoint;
+  _count = 0;
+}
+
+bool ZigbeeReport::add(uint16_t cluster_id, uint16_t attribute_id, const void *value, size_t size) {
+  if (value != NULL && (size == 0 || size > ZB_REPORT_MAX_VALUE_SIZE)) {
+    log_e("Invalid value size %u for attribute 0x%04x", size, attribute_id);
+    return false;
+  }
+  zb_report_entry_t *entry = NULL;
+  for (size_t i = 0; i < _count; i++) {
+    if (_entries[i].cluster_id == cluster_id && _entries[i].attribute_id == attribute_id) {
+      entry = &_entries[i];
+      break;
+    }
+  }
+  if (entry == NULL) {
+    if (_count >= ZB_REPORT_MAX_ATTRIBUTES) {
+      log_e("Report is full, max %d attributes", ZB_REPORT_MAX_ATTRIBUTES);
+      return false;
+    }
+    entry = &_entries[_count++];
+    entry->cluster_id = cluster_id;
+    entry->attribute_id = attribute_id;
+    entry->size = 0;
+  }
+  if (value != NULL) {
+    memcpy(entry->value, value, size);
+    entry->size = size;
+  }
+  return true;
+}
+
+bool ZigbeeReport::contains(uint16_t cluster_id, uint16_t attribute_id) const {
+  for (size_t i = 0; i < _count; i++) {
+    if (_entries[i].cluster_id == cluster_id && _entries[i].attribute_id == attribute_id) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ZigbeeReport::send() {
+  if (_count == 0) {
+    return true;
+  }
+  esp_zb_zcl_report_attr_cmd_t report_attr_cmd = {0};
+  report_attr_cmd.address_mode = ESP_ZB_APS_ADDR_MODE_DST_ADDR_ENDP_NOT_PRESENT;
+  report_attr_cmd.direction = ESP_ZB_ZCL_CMD_DIRECTION_TO_CLI;
+  report_attr_cmd.zcl_basic_cmd.src_endpoint = _endpoint;
+  report_attr_cmd.manuf_code = ESP_ZB_ZCL_ATTR_NON_MANUFACTURER_SPECIFIC;
+
+  bool ok = true;
+  uint32_t sent = 0;
+  // The stack sends one report command per attribute, but the lock is only taken once
+  Zigbee.lockAcquire();
+  for (size_t i = 0; i < _count; i++) {
+    zb_report_entry_t *entry = &_entries[i];
+    if (entry->size) {
+      esp_zb_zcl_status_t status = esp_zb_zcl_set_attribute_val(
+        _endpoint, entry->cluster_id, ESP_ZB_ZCL_CLUSTER_SERVER_ROLE, entry->attribute_id, entry->value, false
+      );
+      if (status != ESP_ZB_ZCL_STATUS_SUCCESS) {
+        log_e("Failed to set attribute 0x%04x of cluster 0x%04x: 0x%x", entry->attribute_id, entry->cluster_id, status);
+        ok = false;
+        continue;
+      }
+    }
+    report_attr_cmd.clusterID = entry->cluster_id;
+    report_attr_cmd.attributeID = entry->attribute_id;
+    esp_err_t ret = esp_zb_zcl_report_attr_cmd_req(&report_attr_cmd);
+    if (ret != ESP_OK) {
+      log_e("Failed to report attribute 0x%04x of cluster 0x%04x: 0x%x: %s", entry->attribute_id, entry->cluster_id, ret, esp_err_to_name(ret));
+      ok = false;
+    } else {
+      sent++;
+    }
+  }
+  Zigbee.lockRelease();
+
+  portENTER_CRITICAL(&Zigbee._stats_mux);
+  Zigbee._stats.reports_sent += sent;
+  portEXIT_CRITICAL(&Zigbee._stats_mux);
+  log_v("Report with %u attributes sent", _count);
+  _count = 0;
+  return ok;
+}
+
 /* Zigbee End Device Class */
-ZigbeeEP::ZigbeeEP(uint8_t endpoint) {
+ZigbeeEP::ZigbeeEP(uint8_t endpoint) : _pending_report(endpoint) {
   _endpoint = endpoint;
   log_v("Endpoint: %d", _endpoint);
   _ep_config.endpoint = 0;
@@ -20,6 +110,9 @@ ZigbeeEP::ZigbeeEP(uint8_t endpoint) {
   _is_bound = false;
   _use_manual_binding = false;
   _allow_multiple_binding = false;
+  _report_interval = 0;
+  _last_report = 0;
+  _flush_scheduled = false;
   if (!lock) {
     lock = xSemaphoreCreateBinary();
     if (lock == NULL) {
@@ -114,12 +207,12 @@ bool ZigbeeEP::setBatteryPercentage(uint8_t percentage) {
     percentage = 100;
   }
   percentage = percentage * 2;
-  esp_zb_lock_acquire(portMAX_DELAY);
+  Zigbee.lockAcquire();
   ret = esp_zb_zcl_set_attribute_val(
     _endpoint, ESP_ZB_ZCL_CLUSTER_ID_POWER_CONFIG, ESP_ZB_ZCL_CLUSTER_SERVER_ROLE, ESP_ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_PERCENTAGE_REMAINING_ID, &percentage,
     false
   );
-  esp_zb_lock_release();
+  Zigbee.lockRelease();
   if (ret != ESP_ZB_ZCL_STATUS_SUCCESS) {
     log_e("Failed to set battery percentage: 0x%x: %s", ret, esp_zb_zcl_status_to_name(ret));
     return false;
@@ -130,11 +223,11 @@ bool ZigbeeEP::setBatteryPercentage(uint8_t percentage) {
 
 bool ZigbeeEP::setBatteryVoltage(uint8_t voltage) {
   esp_zb_zcl_status_t ret = ESP_ZB_ZCL_STATUS_SUCCESS;
-  esp_zb_lock_acquire(portMAX_DELAY);
+  Zigbee.lockAcquire();
   ret = esp_zb_zcl_set_attribute_val(
     _endpoint, ESP_ZB_ZCL_CLUSTER_ID_POWER_CONFIG, ESP_ZB_ZCL_CLUSTER_SERVER_ROLE, ESP_ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_VOLTAGE_ID, &voltage, false
   );
-  esp_zb_lock_release();
+  Zigbee.lockRelease();
   if (ret != ESP_ZB_ZCL_STATUS_SUCCESS) {
     log_e("Failed to set battery voltage: 0x%x: %s", ret, esp_zb_zcl_status_to_name(ret));
     return false;
@@ -144,26 +237,88 @@ bool ZigbeeEP::setBatteryVoltage(uint8_t voltage) {
 }
 
 bool ZigbeeEP::reportBatteryPercentage() {
-  /* Send report attributes command */
-  esp_zb_zcl_report_attr_cmd_t report_attr_cmd = {0};
-  report_attr_cmd.address_mode = ESP_ZB_APS_ADDR_MODE_DST_ADDR_ENDP_NOT_PRESENT;
-  report_attr_cmd.attributeID = ESP_ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_PERCENTAGE_REMAINING_ID;
-  report_attr_cmd.direction = ESP_ZB_ZCL_CMD_DIRECTION_TO_CLI;
-  report_attr_cmd.clusterID = ESP_ZB_ZCL_CLUSTER_ID_POWER_CONFIG;
-  report_attr_cmd.zcl_basic_cmd.src_endpoint = _endpoint;
-  report_attr_cmd.manuf_code = ESP_ZB_ZCL_ATTR_NON_MANUFACTURER_SPECIFIC;
-
-  esp_zb_lock_acquire(portMAX_DELAY);
-  esp_err_t ret = esp_zb_zcl_report_attr_cmd_req(&report_attr_cmd);
-  esp_zb_lock_release();
-  if (ret != ESP_OK) {
-    log_e("Failed to report battery percentage: 0x%x: %s", ret, esp_err_to_name(ret));
+  if (!reportAttribute(ESP_ZB_ZCL_CLUSTER_ID_POWER_CONFIG, ESP_ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_PERCENTAGE_REMAINING_ID)) {
+    log_e("Failed to report battery percentage");
     return false;
   }
   log_v("Battery percentage reported");
   return true;
 }
 
+bool ZigbeeEP::reportAttribute(uint16_t cluster_id, uint16_t attribute_id) {
+  ZigbeeReport report(_endpoint);
+  report.add(cluster_id, attribute_id);
+  return reportAttributes(report);
+}
+
+bool ZigbeeEP::reportAttributes(ZigbeeReport &report) {
+  bool ret = true;
+  // the pending report is shared with the flush alarm, which runs in the Zigbee task
+  Zigbee.lockAcquire();
+  uint32_t elapsed = millis() - _last_report;
+  if (_report_interval == 0 || (_pending_report.count() == 0 && elapsed >= _report_interval)) {
+    ret = report.send();
+    _last_report = millis();
+  } else {
+    for (size_t i = 0; i < report._count; i++) {
+      ZigbeeReport::zb_report_entry_t *entry = &report._entries[i];
+      const void *value = entry->size ? entry->value : NULL;
+      if (_pending_report.contains(entry->cluster_id, entry->attribute_id)) {
+        portENTER_CRITICAL(&Zigbee._stats_mux);
+        Zigbee._stats.reports_coalesced++;
+        portEXIT_CRITICAL(&Zigbee._stats_mux);
+        _pending_report.add(entry->cluster_id, entry->attribute_id, value, entry->size);
+      } else if (!_pending_report.add(entry->cluster_id, entry->attribute_id, value, entry->size)) {
+        // no room left, send what is pending and start over with this one
+        ret &= _pending_report.send();
+        _last_report = millis();
+        _pending_report.add(entry->cluster_id, entry->attribute_id, value, entry->size);
+      }
+    }
+    report.clear();
+    if (!_flush_scheduled && _pending_report.count()) {
+      if (Zigbee.getEndpoint(_endpoint) == this) {
+        uint32_t delay = (elapsed < _report_interval) ? _report_interval - elapsed : 1;
+        esp_zb_scheduler_alarm(flushReportsCb, _endpoint, delay);
+        _flush_scheduled = true;
+      } else {
+        // the alarm could not find an endpoint that is not registered, do not hold the reports back
+        ret &= _pending_report.send();
+        _last_report = millis();
+      }
+    }
+  }
+  Zigbee.lockRelease();
+  return ret;
+}
+
+bool ZigbeeEP::sendReport(ZigbeeReport &report) {
+  Zigbee.lockAcquire();
+  bool ret = report.send();
+  _last_report = millis();
+  Zigbee.lockRelease();
+  return ret;
+}
+
+bool ZigbeeEP::flushReports() {
+  Zigbee.lockAcquire();
+  bool ret = true;
+  if (_pending_report.count()) {
+    ret = _pending_report.send();
+    _last_report = millis();
+  }
+  Zigbee.lockRelease();
+  return ret;
+}
+
+void ZigbeeEP::flushReportsCb(uint8_t endpoint) {
+  ZigbeeEP *ep = Zigbee.getEndpoint(endpoint);
+  if (ep != NULL) {
+    ep->_flush_scheduled = false;
+    ep->flushReports();
+  }
+}
+
 char *ZigbeeEP::readManufacturer(uint8_t endpoint, uint16_t short_addr, esp_zb_ieee_addr_t ieee_addr) {
   /* Read peer Manufacture Name & Model Identifier */
   esp_zb_zcl_read_attr_cmd_t read_req = {0};
@@ -191,9 +346,9 @@ char *ZigbeeEP::readManufacturer(uint8_t endpoint, uint16_t short_addr, esp_zb_i
   }
   _read_manufacturer = NULL;
 
-  esp_zb_lock_acquire(portMAX_DELAY);
+  Zigbee.lockAcquire();
   esp_zb_zcl_read_attr_cmd_req(&read_req);
-  esp_zb_lock_release();
+  Zigbee.lockRelease();
 
   //Wait for response or timeout
   if (xSemaphoreTake(lock, ZB_CMD_TIMEOUT) != pdTRUE) {
@@ -229,9 +384,9 @@ char *ZigbeeEP::readModel(uint8_t endpoint, uint16_t short_addr, esp_zb_ieee_add
   }
   _read_model = NULL;
 
-  esp_zb_lock_acquire(portMAX_DELAY);
+  Zigbee.lockAcquire();
   esp_zb_zcl_read_attr_cmd_req(&read_req);
-  esp_zb_lock_release();
+  Zigbee.lockRelease();
 
   //Wait for response or timeout
   if (xSemaphoreTake(lock, ZB_CMD_TIMEOUT) != pdTRUE) {
@@ -349,9 +504,9 @@ bool ZigbeeEP::setTime(tm time) {
   esp_zb_zcl_status_t ret = ESP_ZB_ZCL_STATUS_SUCCESS;
   time_t utc_time = mktime(&time);
   log_d("Setting time to %lld", utc_time);
-  esp_zb_lock_acquire(portMAX_DELAY);
+  Zigbee.lockAcquire();
   ret = esp_zb_zcl_set_attribute_val(_endpoint, ESP_ZB_ZCL_CLUSTER_ID_TIME, ESP_ZB_ZCL_CLUSTER_SERVER_ROLE, ESP_ZB_ZCL_ATTR_TIME_TIME_ID, &utc_time, false);
-  esp_zb_lock_release();
+  Zigbee.lockRelease();
   if (ret != ESP_ZB_ZCL_STATUS_SUCCESS) {
     log_e("Failed to set time: 0x%x: %s", ret, esp_zb_zcl_status_to_name(ret));
     return false;
@@ -362,10 +517,10 @@ bool ZigbeeEP::setTime(tm time) {
 bool ZigbeeEP::setTimezone(int32_t gmt_offset) {
   esp_zb_zcl_status_t ret = ESP_ZB_ZCL_STATUS_SUCCESS;
   log_d("Setting timezone to %d", gmt_offset);
-  esp_zb_lock_acquire(portMAX_DELAY);
+  Zigbee.lockAcquire();
   ret =
     esp_zb_zcl_set_attribute_val(_endpoint, ESP_ZB_ZCL_CLUSTER_ID_TIME, ESP_ZB_ZCL_CLUSTER_SERVER_ROLE, ESP_ZB_ZCL_ATTR_TIME_TIME_ZONE_ID, &gmt_offset, false);
-  esp_zb_lock_release();
+  Zigbee.lockRelease();
   if (ret != ESP_ZB_ZCL_STATUS_SUCCESS) {
     log_e("Failed to set timezone: 0x%x: %s", ret, esp_zb_zcl_status_to_name(ret));
     return false;
@@ -412,11 +567,11 @@ tm ZigbeeEP::getTime(uint8_t endpoint, int32_t short_addr, esp_zb_ieee_addr_t ie
     setTime(*timeinfo);
     // Update time status to synced
     _time_status |= 0x02;
-    esp_zb_lock_acquire(portMAX_DELAY);
+    Zigbee.lockAcquire();
     esp_zb_zcl_set_attribute_val(
       _endpoint, ESP_ZB_ZCL_CLUSTER_ID_TIME, ESP_ZB_ZCL_CLUSTER_SERVER_ROLE, ESP_ZB_ZCL_ATTR_TIME_TIME_STATUS_ID, &_time_status, false
     );
-    esp_zb_lock_release();
+    Zigbee.lockRelease();
 
     return *timeinfo;
   } else {
@@ -553,11 +708,11 @@ void ZigbeeEP::requestOTAUpdate() {
   req.num_out_clusters = 0;
   req.profile_id = ESP_ZB_AF_HA_PROFILE_ID;
   req.cluster_list = cluster_list;
-  esp_zb_lock_acquire(portMAX_DELAY);
+  Zigbee.lockAcquire();
   if (esp_zb_bdb_dev_joined()) {
     esp_zb_zdo_match_cluster(&req, findOTAServer, &_endpoint);
   }
-  esp_zb_lock_release();
+  Zigbee.lockRelease();
 }
 
 void ZigbeeEP::removeBoundDevice(uint8_t endpoint, esp_zb_ieee_addr_t ieee_addr) {
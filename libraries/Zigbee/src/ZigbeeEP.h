@@ -38,6 +38,54 @@ typedef enum {
   ZB_POWER_SOURCE_BATTERY = 0x03,
 } zb_power_source_t;
 
+#define ZB_REPORT_MAX_ATTRIBUTES 16
+#define ZB_REPORT_MAX_VALUE_SIZE 8
+
+/*
+ * Multi attribute report builder
+ *
+ * Collects attribute reports of one endpoint and sends them with a single stack lock
+ * acquisition, instead of one lock round trip per attribute:
+ *
+ *   ZigbeeReport report(10);
+ *   report.add(ESP_ZB_ZCL_CLUSTER_ID_TEMP_MEASUREMENT, ESP_ZB_ZCL_ATTR_TEMP_MEASUREMENT_VALUE_ID, &temperature, sizeof(temperature));
+ *   report.add(ESP_ZB_ZCL_CLUSTER_ID_REL_HUMIDITY_MEASUREMENT, ESP_ZB_ZCL_ATTR_REL_HUMIDITY_MEASUREMENT_VALUE_ID);
+ *   report.send();
+ *
+ * An attribute added with a value is set before it is reported, without a value its current
+ * value is reported. Values are copied, up to ZB_REPORT_MAX_VALUE_SIZE bytes (numeric types).
+ */
+class ZigbeeReport {
+public:
+  ZigbeeReport(uint8_t endpoint);
+
+  // Adding an attribute that is already in the report only updates its value
+  bool add(uint16_t cluster_id, uint16_t attribute_id, const void *value = NULL, size_t size = 0);
+  bool contains(uint16_t cluster_id, uint16_t attribute_id) const;
+  size_t count() const {
+    return _count;
+  }
+  void clear() {
+    _count = 0;
+  }
+  // Sets the values and sends one report per attribute, all under one lock. The report is cleared
+  bool send();
+
+private:
+  friend class ZigbeeEP;  // merges reports into the pending one
+
+  typedef struct {
+    uint16_t cluster_id;
+    uint16_t attribute_id;
+    uint8_t size;  // 0 to report the current value
+    uint8_t value[ZB_REPORT_MAX_VALUE_SIZE];
+  } zb_report_entry_t;
+
+  uint8_t _endpoint;
+  size_t _count;
+  zb_report_entry_t _entries[ZB_REPORT_MAX_ATTRIBUTES];
+};
+
 /* Zigbee End Device Class */
 class ZigbeeEP {
 public:
@@ -89,6 +137,16 @@ public:
   bool setBatteryVoltage(uint8_t voltage);                                                                 // voltage in 100mV (example value 35 for 3.5V)
   bool reportBatteryPercentage();                                                                          // battery voltage is not reportable attribute
 
+  // Report rate limiting: reports requested less than min_interval_ms after the last one are
+  // coalesced and sent together when the interval has passed. 0 (default) reports at once
+  void setReportInterval(uint32_t min_interval_ms) {
+    _report_interval = min_interval_ms;
+  }
+  bool reportAttribute(uint16_t cluster_id, uint16_t attribute_id);
+  bool reportAttributes(ZigbeeReport &report);  // rate limited like reportAttribute(), the report is cleared
+  bool sendReport(ZigbeeReport &report);        // sends at once, ignoring the report interval
+  bool flushReports();  // sends the coalesced reports now
+
   // Set time
   bool addTimeCluster(tm time = {}, int32_t gmt_offset = 0);  // gmt offset in seconds
   bool setTime(tm time);
@@ -163,6 +221,12 @@ private:
   time_t _read_time;
   int32_t _read_timezone;
 
+  ZigbeeReport _pending_report;
+  uint32_t _report_interval;
+  uint32_t _last_report;
+  bool _flush_scheduled;
+  static void flushReportsCb(uint8_t endpoint);
+
 protected:
   // Convert ZCL status to name
   const char *esp_zb_zcl_status_to_name(esp_zb_zcl_status_t status);
@@ -36,6 +36,17 @@ static esp_err_t zb_window_covering_movement_resp_handler(const esp_zb_zcl_windo
 static esp_err_t zb_ota_upgrade_status_handler(const esp_zb_zcl_ota_upgrade_value_message_t *message);
 static esp_err_t zb_ota_upgrade_query_image_resp_handler(const esp_zb_zcl_ota_upgrade_query_image_resp_message_t *message);
 
+// Counts the incoming messages for Zigbee.getStats(), a message without a matching endpoint object is unhandled
+void zbCountMessage(bool handled) {
+  portENTER_CRITICAL(&Zigbee._stats_mux);
+  if (handled) {
+    Zigbee._stats.messages_handled++;
+  } else {
+    Zigbee._stats.messages_unhandled++;
+  }
+  portEXIT_CRITICAL(&Zigbee._stats_mux);
+}
+
 // Zigbee action handlers
 [[maybe_unused]]
 static esp_err_t zb_action_handler(esp_zb_core_action_callback_id_t callback_id, const void *message) {
@@ -59,7 +70,10 @@ static esp_err_t zb_action_handler(esp_zb_core_action_callback_id_t callback_id,
       ret = zb_ota_upgrade_query_image_resp_handler((esp_zb_zcl_ota_upgrade_query_image_resp_message_t *)message);
       break;
     case ESP_ZB_CORE_CMD_DEFAULT_RESP_CB_ID: ret = zb_cmd_default_resp_handler((esp_zb_zcl_cmd_default_resp_message_t *)message); break;
-    default:                                 log_w("Receive unhandled Zigbee action(0x%x) callback", callback_id); break;
+    default:
+      log_w("Receive unhandled Zigbee action(0x%x) callback", callback_id);
+      zbCountMessage(false);
+      break;
   }
   return ret;
 }
@@ -79,14 +93,14 @@ static esp_err_t zb_attribute_set_handler(const esp_zb_zcl_set_attr_value_messag
     message->attribute.data.size
   );
 
-  // List through all Zigbee EPs and call the callback function, with the message
-  for (std::list<ZigbeeEP *>::iterator it = Zigbee.ep_objects.begin(); it != Zigbee.ep_objects.end(); ++it) {
-    if (message->info.dst_endpoint == (*it)->getEndpoint()) {
-      if (message->info.cluster == ESP_ZB_ZCL_CLUSTER_ID_IDENTIFY) {
-        (*it)->zbIdentify(message);  //method zbIdentify implemented in the common EP class
-      } else {
-        (*it)->zbAttributeSet(message);  //method zbAttributeSet must be implemented in specific EP class
-      }
+  // Dispatch to the endpoint object, indexed by the destination endpoint
+  ZigbeeEP *ep = Zigbee.getEndpoint(message->info.dst_endpoint);
+  zbCountMessage(ep != NULL);
+  if (ep != NULL) {
+    if (message->info.cluster == ESP_ZB_ZCL_CLUSTER_ID_IDENTIFY) {
+      ep->zbIdentify(message);  //method zbIdentify implemented in the common EP class
+    } else {
+      ep->zbAttributeSet(message);  //method zbAttributeSet must be implemented in specific EP class
     }
   }
   return ESP_OK;
@@ -105,13 +119,13 @@ static esp_err_t zb_attribute_reporting_handler(const esp_zb_zcl_report_attr_mes
     "Received report from address(0x%x) src endpoint(%d) to dst endpoint(%d) cluster(0x%x)", message->src_address.u.short_addr, message->src_endpoint,
     message->dst_endpoint, message->cluster
   );
-  // List through all Zigbee EPs and call the callback function, with the message
-  for (std::list<ZigbeeEP *>::iterator it = Zigbee.ep_objects.begin(); it != Zigbee.ep_objects.end(); ++it) {
-    if (message->dst_endpoint == (*it)->getEndpoint()) {
-      (*it)->zbAttributeRead(
-        message->cluster, &message->attribute, message->src_endpoint, message->src_address
-      );  //method zbAttributeRead must be implemented in specific EP class
-    }
+  // Dispatch to the endpoint object, indexed by the destination endpoint
+  ZigbeeEP *ep = Zigbee.getEndpoint(message->dst_endpoint);
+  zbCountMessage(ep != NULL);
+  if (ep != NULL) {
+    ep->zbAttributeRead(
+      message->cluster, &message->attribute, message->src_endpoint, message->src_address
+    );  //method zbAttributeRead must be implemented in specific EP class
   }
   return ESP_OK;
 }
@@ -130,27 +144,28 @@ static esp_err_t zb_cmd_read_attr_resp_handler(const esp_zb_zcl_cmd_read_attr_re
     message->info.src_endpoint, message->info.dst_endpoint, message->info.cluster
   );
 
-  for (std::list<ZigbeeEP *>::iterator it = Zigbee.ep_objects.begin(); it != Zigbee.ep_objects.end(); ++it) {
-    if (message->info.dst_endpoint == (*it)->getEndpoint()) {
-      esp_zb_zcl_read_attr_resp_variable_t *variable = message->variables;
-      while (variable) {
-        log_v(
-          "Read attribute response: status(%d), cluster(0x%x), attribute(0x%x), type(0x%x), value(%d)", variable->status, message->info.cluster,
-          variable->attribute.id, variable->attribute.data.type, variable->attribute.data.value ? *(uint8_t *)variable->attribute.data.value : 0
-        );
-        if (variable->status == ESP_ZB_ZCL_STATUS_SUCCESS) {
-          if (message->info.cluster == ESP_ZB_ZCL_CLUSTER_ID_BASIC) {
-            (*it)->zbReadBasicCluster(&variable->attribute);  //method zbReadBasicCluster implemented in the common EP class
-          } else if (message->info.cluster == ESP_ZB_ZCL_CLUSTER_ID_TIME) {
-            (*it)->zbReadTimeCluster(&variable->attribute);  //method zbReadTimeCluster implemented in the common EP class
-          } else {
-            (*it)->zbAttributeRead(
-              message->info.cluster, &variable->attribute, message->info.src_endpoint, message->info.src_address
-            );  //method zbAttributeRead must be implemented in specific EP class
-          }
+  // Dispatch to the endpoint object, indexed by the destination endpoint
+  ZigbeeEP *ep = Zigbee.getEndpoint(message->info.dst_endpoint);
+  zbCountMessage(ep != NULL);
+  if (ep != NULL) {
+    esp_zb_zcl_read_attr_resp_variable_t *variable = message->variables;
+    while (variable) {
+      log_v(
+        "Read attribute response: status(%d), cluster(0x%x), attribute(0x%x), type(0x%x), value(%d)", variable->status, message->info.cluster,
+        variable->attribute.id, variable->attribute.data.type, variable->attribute.data.value ? *(uint8_t *)variable->attribute.data.value : 0
+      );
+      if (variable->status == ESP_ZB_ZCL_STATUS_SUCCESS) {
+        if (message->info.cluster == ESP_ZB_ZCL_CLUSTER_ID_BASIC) {
+          ep->zbReadBasicCluster(&variable->attribute);  //method zbReadBasicCluster implemented in the common EP class
+        } else if (message->info.cluster == ESP_ZB_ZCL_CLUSTER_ID_TIME) {
+          ep->zbReadTimeCluster(&variable->attribute);  //method zbReadTimeCluster implemented in the common EP class
+        } else {
+          ep->zbAttributeRead(
+            message->info.cluster, &variable->attribute, message->info.src_endpoint, message->info.src_address
+          );  //method zbAttributeRead must be implemented in specific EP class
         }
-        variable = variable->next;
       }
+      variable = variable->next;
     }
   }
   return ESP_OK;
@@ -190,10 +205,11 @@ static esp_err_t zb_cmd_ias_zone_status_change_handler(const esp_zb_zcl_ias_zone
     message->info.src_endpoint, message->info.dst_endpoint, message->info.cluster
   );
 
-  for (std::list<ZigbeeEP *>::iterator it = Zigbee.ep_objects.begin(); it != Zigbee.ep_objects.end(); ++it) {
-    if (message->info.dst_endpoint == (*it)->getEndpoint()) {
-      (*it)->zbIASZoneStatusChangeNotification(message);
-    }
+  // Dispatch to the endpoint object, indexed by the destination endpoint
+  ZigbeeEP *ep = Zigbee.getEndpoint(message->info.dst_endpoint);
+  zbCountMessage(ep != NULL);
+  if (ep != NULL) {
+    ep->zbIASZoneStatusChangeNotification(message);
   }
   return ESP_OK;
 }
@@ -208,10 +224,11 @@ static esp_err_t zb_cmd_ias_zone_enroll_response_handler(const esp_zb_zcl_ias_zo
     return ESP_ERR_INVALID_ARG;
   }
   log_v("IAS Zone Enroll Response received");
-  for (std::list<ZigbeeEP *>::iterator it = Zigbee.ep_objects.begin(); it != Zigbee.ep_objects.end(); ++it) {
-    if (message->info.dst_endpoint == (*it)->getEndpoint()) {
-      (*it)->zbIASZoneEnrollResponse(message);
-    }
+  // Dispatch to the endpoint object, indexed by the destination endpoint
+  ZigbeeEP *ep = Zigbee.getEndpoint(message->info.dst_endpoint);
+  zbCountMessage(ep != NULL);
+  if (ep != NULL) {
+    ep->zbIASZoneEnrollResponse(message);
   }
   return ESP_OK;
 }
@@ -229,11 +246,11 @@ static esp_err_t zb_window_covering_movement_resp_handler(const esp_zb_zcl_windo
     message->payload
   );
 
-  // List through all Zigbee EPs and call the callback function, with the message
-  for (std::list<ZigbeeEP *>::iterator it = Zigbee.ep_objects.begin(); it != Zigbee.ep_objects.end(); ++it) {
-    if (message->info.dst_endpoint == (*it)->getEndpoint()) {
-      (*it)->zbWindowCoveringMovementCmd(message);  //method zbWindowCoveringMovementCmd must be implemented in specific EP class
-    }
+  // Dispatch to the endpoint object, indexed by the destination endpoint
+  ZigbeeEP *ep = Zigbee.getEndpoint(message->info.dst_endpoint);
+  zbCountMessage(ep != NULL);
+  if (ep != NULL) {
+    ep->zbWindowCoveringMovementCmd(message);  //method zbWindowCoveringMovementCmd must be implemented in specific EP class
   }
   return ESP_OK;
 }
@@ -184,11 +184,11 @@ bool ZigbeeAnalog::setAnalogInput(float analog) {
     return false;
   }
   log_d("Setting analog input to %.1f", analog);
-  esp_zb_lock_acquire(portMAX_DELAY);
+  Zigbee.lockAcquire();
   ret = esp_zb_zcl_set_attribute_val(
     _endpoint, ESP_ZB_ZCL_CLUSTER_ID_ANALOG_INPUT, ESP_ZB_ZCL_CLUSTER_SERVER_ROLE, ESP_ZB_ZCL_ATTR_ANALOG_INPUT_PRESENT_VALUE_ID, &analog, false
   );
-  esp_zb_lock_release();
+  Zigbee.lockRelease();
   if (ret != ESP_ZB_ZCL_STATUS_SUCCESS) {
     log_e("Failed to set analog input: 0x%x: %s", ret, esp_zb_zcl_status_to_name(ret));
     return false;
@@ -203,11 +203,11 @@ bool ZigbeeAnalog::setAnalogOutput(float analog) {
 
   log_v("Updating analog output to %.2f", analog);
   /* Update analog output */
-  esp_zb_lock_acquire(portMAX_DELAY);
+  Zigbee.lockAcquire();
   ret = esp_zb_zcl_set_attribute_val(
     _endpoint, ESP_ZB_ZCL_CLUSTER_ID_ANALOG_OUTPUT, ESP_ZB_ZCL_CLUSTER_SERVER_ROLE, ESP_ZB_ZCL_ATTR_ANALOG_OUTPUT_PRESENT_VALUE_ID, &_output_state, false
   );
-  esp_zb_lock_release();
+  Zigbee.lockRelease();
 
   if (ret != ESP_ZB_ZCL_STATUS_SUCCESS) {
     log_e("Failed to set analog output: 0x%x: %s", ret, esp_zb_zcl_status_to_name(ret));
@@ -217,20 +217,8 @@ bool ZigbeeAnalog::setAnalogOutput(float analog) {
 }
 
 bool ZigbeeAnalog::reportAnalogInput() {
-  /* Send report attributes command */
-  esp_zb_zcl_report_attr_cmd_t report_attr_cmd;
-  report_attr_cmd.address_mode = ESP_ZB_APS_ADDR_MODE_DST_ADDR_ENDP_NOT_PRESENT;
-  report_attr_cmd.attributeID = ESP_ZB_ZCL_ATTR_ANALOG_INPUT_PRESENT_VALUE_ID;
-  report_attr_cmd.direction = ESP_ZB_ZCL_CMD_DIRECTION_TO_CLI;
-  report_attr_cmd.clusterID = ESP_ZB_ZCL_CLUSTER_ID_ANALOG_INPUT;
-  report_attr_cmd.zcl_basic_cmd.src_endpoint = _endpoint;
-  report_attr_cmd.manuf_code = ESP_ZB_ZCL_ATTR_NON_MANUFACTURER_SPECIFIC;
-
-  esp_zb_lock_acquire(portMAX_DELAY);
-  esp_err_t ret = esp_zb_zcl_report_attr_cmd_req(&report_attr_cmd);
-  esp_zb_lock_release();
-  if (ret != ESP_OK) {
-    log_e("Failed to send Analog Input report: 0x%x: %s", ret, esp_err_to_name(ret));
+  if (!reportAttribute(ESP_ZB_ZCL_CLUSTER_ID_ANALOG_INPUT, ESP_ZB_ZCL_ATTR_ANALOG_INPUT_PRESENT_VALUE_ID)) {
+    log_e("Failed to send Analog Input report");
     return false;
   }
   log_v("Analog Input report sent");
@@ -238,20 +226,8 @@ bool ZigbeeAnalog::reportAnalogInput() {
 }
 
 bool ZigbeeAnalog::reportAnalogOutput() {
-  /* Send report attributes command */
-  esp_zb_zcl_report_attr_cmd_t report_attr_cmd;
-  report_attr_cmd.address_mode = ESP_ZB_APS_ADDR_MODE_DST_ADDR_ENDP_NOT_PRESENT;
-  report_attr_cmd.attributeID = ESP_ZB_ZCL_ATTR_ANALOG_OUTPUT_PRESENT_VALUE_ID;
-  report_attr_cmd.direction = ESP_ZB_ZCL_CMD_DIRECTION_TO_CLI;
-  report_attr_cmd.clusterID = ESP_ZB_ZCL_CLUSTER_ID_ANALOG_OUTPUT;
-  report_attr_cmd.zcl_basic_cmd.src_endpoint = _endpoint;
-  report_attr_cmd.manuf_code = ESP_ZB_ZCL_ATTR_NON_MANUFACTURER_SPECIFIC;
-
-  esp_zb_lock_acquire(portMAX_DELAY);
-  esp_err_t ret = esp_zb_zcl_report_attr_cmd_req(&report_attr_cmd);
-  esp_zb_lock_release();
-  if (ret != ESP_OK) {
-    log_e("Failed to send Analog Output report: 0x%x: %s", ret, esp_err_to_name(ret));
+  if (!reportAttribute(ESP_ZB_ZCL_CLUSTER_ID_ANALOG_OUTPUT, ESP_ZB_ZCL_ATTR_ANALOG_OUTPUT_PRESENT_VALUE_ID)) {
+    log_e("Failed to send Analog Output report");
     return false;
   }
   log_v("Analog Output report sent");
@@ -274,9 +250,9 @@ bool ZigbeeAnalog::setAnalogInputReporting(uint16_t min_interval, uint16_t max_i
   reporting_info.dst.profile_id = ESP_ZB_AF_HA_PROFILE_ID;
   reporting_info.manuf_code = ESP_ZB_ZCL_ATTR_NON_MANUFACTURER_SPECIFIC;
 
-  esp_zb_lock_acquire(portMAX_DELAY);
+  Zigbee.lockAcquire();
   esp_err_t ret = esp_zb_zcl_update_reporting_info(&reporting_info);
-  esp_zb_lock_release();
+  Zigbee.lockRelease();
   if (ret != ESP_OK) {
     log_e("Failed to set Analog Input reporting: 0x%x: %s", ret, esp_err_to_name(ret));
     return false;
@@ -73,9 +73,9 @@ bool ZigbeeCarbonDioxideSensor::setReporting(uint16_t min_interval, uint16_t max
   float delta_f = delta / 1000000.0f;
   memcpy(&reporting_info.u.send_info.delta.s32, &delta_f, sizeof(float));
 
-  esp_zb_lock_acquire(portMAX_DELAY);
+  Zigbee.lockAcquire();
   esp_err_t ret = esp_zb_zcl_update_reporting_info(&reporting_info);
-  esp_zb_lock_release();
+  Zigbee.lockRelease();
   if (ret != ESP_OK) {
     log_e("Failed to set reporting: 0x%x: %s", ret, esp_err_to_name(ret));
     return false;
@@ -89,12 +89,12 @@ bool ZigbeeCarbonDioxideSensor::setCarbonDioxide(float carbon_dioxide) {
   log_v("Updating carbon dioxide sensor value...");
   /* Update carbon dioxide sensor measured value */
   log_d("Setting carbon dioxide to %0.1f", carbon_dioxide);
-  esp_zb_lock_acquire(portMAX_DELAY);
+  Zigbee.lockAcquire();
   ret = esp_zb_zcl_set_attribute_val(
     _endpoint, ESP_ZB_ZCL_CLUSTER_ID_CARBON_DIOXIDE_MEASUREMENT, ESP_ZB_ZCL_CLUSTER_SERVER_ROLE, ESP_ZB_ZCL_ATTR_CARBON_DIOXIDE_MEASUREMENT_MEASURED_VALUE_ID,
     &zb_carbon_dioxide, false
   );
-  esp_zb_lock_release();
+  Zigbee.lockRelease();
   if (ret != ESP_ZB_ZCL_STATUS_SUCCESS) {
     log_e("Failed to set carbon dioxide: 0x%x: %s", ret, esp_zb_zcl_status_to_name(ret));
     return false;
@@ -103,20 +103,8 @@ bool ZigbeeCarbonDioxideSensor::setCarbonDioxide(float carbon_dioxide) {
 }
 
 bool ZigbeeCarbonDioxideSensor::report() {
-  /* Send report attributes command */
-  esp_zb_zcl_report_attr_cmd_t report_attr_cmd;
-  report_attr_cmd.address_mode = ESP_ZB_APS_ADDR_MODE_DST_ADDR_ENDP_NOT_PRESENT;
-  report_attr_cmd.attributeID = ESP_ZB_ZCL_ATTR_CARBON_DIOXIDE_MEASUREMENT_MEASURED_VALUE_ID;
-  report_attr_cmd.direction = ESP_ZB_ZCL_CMD_DIRECTION_TO_CLI;
-  report_attr_cmd.clusterID = ESP_ZB_ZCL_CLUSTER_ID_CARBON_DIOXIDE_MEASUREMENT;
-  report_attr_cmd.zcl_basic_cmd.src_endpoint = _endpoint;
-  report_attr_cmd.manuf_code = ESP_ZB_ZCL_ATTR_NON_MANUFACTURER_SPECIFIC;
-
-  esp_zb_lock_acquire(portMAX_DELAY);
-  esp_err_t ret = esp_zb_zcl_report_attr_cmd_req(&report_attr_cmd);
-  esp_zb_lock_release();
-  if (ret != ESP_OK) {
-    log_e("Failed to send carbon dioxide report: 0x%x: %s", ret, esp_err_to_name(ret));
+  if (!reportAttribute(ESP_ZB_ZCL_CLUSTER_ID_CARBON_DIOXIDE_MEASUREMENT, ESP_ZB_ZCL_ATTR_CARBON_DIOXIDE_MEASUREMENT_MEASURED_VALUE_ID)) {
+    log_e("Failed to send carbon dioxide report");
     return false;
   }
   log_v("Carbon dioxide report sent");
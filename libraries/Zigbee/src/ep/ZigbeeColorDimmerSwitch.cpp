@@ -102,9 +102,9 @@ void ZigbeeColorDimmerSwitch::lightToggle() {
     cmd_req.address_mode = ESP_ZB_APS_ADDR_MODE_DST_ADDR_ENDP_NOT_PRESENT;
     cmd_req.on_off_cmd_id = ESP_ZB_ZCL_CMD_ON_OFF_TOGGLE_ID;
     log_v("Sending 'light toggle' command");
-    esp_zb_lock_acquire(portMAX_DELAY);
+    Zigbee.lockAcquire();
     esp_zb_zcl_on_off_cmd_req(&cmd_req);
-    esp_zb_lock_release();
+    Zigbee.lockRelease();
   } else {
     log_e("Light not bound");
   }
@@ -118,9 +118,9 @@ void ZigbeeColorDimmerSwitch::lightToggle(uint16_t group_addr) {
     cmd_req.address_mode = ESP_ZB_APS_ADDR_MODE_16_GROUP_ENDP_NOT_PRESENT;
     cmd_req.on_off_cmd_id = ESP_ZB_ZCL_CMD_ON_OFF_TOGGLE_ID;
     log_v("Sending 'light toggle' command to group address 0x%x", group_addr);
-    esp_zb_lock_acquire(portMAX_DELAY);
+    Zigbee.lockAcquire();
     esp_zb_zcl_on_off_cmd_req(&cmd_req);
-    esp_zb_lock_release();
+    Zigbee.lockRelease();
   } else {
     log_e("Light not bound");
   }
@@ -135,9 +135,9 @@ void ZigbeeColorDimmerSwitch::lightToggle(uint8_t endpoint, uint16_t short_addr)
     cmd_req.address_mode = ESP_ZB_APS_ADDR_MODE_16_ENDP_PRESENT;
     cmd_req.on_off_cmd_id = ESP_ZB_ZCL_CMD_ON_OFF_TOGGLE_ID;
     log_v("Sending 'light toggle' command to endpoint %d, address 0x%x", endpoint, short_addr);
-    esp_zb_lock_acquire(portMAX_DELAY);
+    Zigbee.lockAcquire();
     esp_zb_zcl_on_off_cmd_req(&cmd_req);
-    esp_zb_lock_release();
+    Zigbee.lockRelease();
   } else {
     log_e("Light not bound");
   }
@@ -155,9 +155,9 @@ void ZigbeeColorDimmerSwitch::lightToggle(uint8_t endpoint, esp_zb_ieee_addr_t i
       "Sending 'light toggle' command to endpoint %d, ieee address %02x:%02x:%02x:%02x:%02x:%02x:%02x:%02x", endpoint, ieee_addr[7], ieee_addr[6], ieee_addr[5],
       ieee_addr[4], ieee_addr[3], ieee_addr[2], ieee_addr[1], ieee_addr[0]
     );
-    esp_zb_lock_acquire(portMAX_DELAY);
+    Zigbee.lockAcquire();
     esp_zb_zcl_on_off_cmd_req(&cmd_req);
-    esp_zb_lock_release();
+    Zigbee.lockRelease();
   } else {
     log_e("Light not bound");
   }
@@ -170,9 +170,9 @@ void ZigbeeColorDimmerSwitch::lightOn() {
     cmd_req.address_mode = ESP_ZB_APS_ADDR_MODE_DST_ADDR_ENDP_NOT_PRESENT;
     cmd_req.on_off_cmd_id = ESP_ZB_ZCL_CMD_ON_OFF_ON_ID;
     log_v("Sending 'light on' command");
-    esp_zb_lock_acquire(portMAX_DELAY);
+    Zigbee.lockAcquire();
     esp_zb_zcl_on_off_cmd_req(&cmd_req);
-    esp_zb_lock_release();
+    Zigbee.lockRelease();
   } else {
     log_e("Light not bound");
   }
@@ -186,9 +186,9 @@ void ZigbeeColorDimmerSwitch::lightOn(uint16_t group_addr) {
     cmd_req.address_mode = ESP_ZB_APS_ADDR_MODE_16_GROUP_ENDP_NOT_PRESENT;
     cmd_req.on_off_cmd_id = ESP_ZB_ZCL_CMD_ON_OFF_ON_ID;
     log_v("Sending 'light on' command to group address 0x%x", group_addr);
-    esp_zb_lock_acquire(portMAX_DELAY);
+    Zigbee.lockAcquire();
     esp_zb_zcl_on_off_cmd_req(&cmd_req);
-    esp_zb_lock_release();
+    Zigbee.lockRelease();
   } else {
     log_e("Light not bound");
   }
@@ -203,9 +203,9 @@ void ZigbeeColorDimmerSwitch::lightOn(uint8_t endpoint, uint16_t short_addr) {
     cmd_req.address_mode = ESP_ZB_APS_ADDR_MODE_16_ENDP_PRESENT;
     cmd_req.on_off_cmd_id = ESP_ZB_ZCL_CMD_ON_OFF_ON_ID;
     log_v("Sending 'light on' command to endpoint %d, address 0x%x", endpoint, short_addr);
-    esp_zb_lock_acquire(portMAX_DELAY);
+    Zigbee.lockAcquire();
     esp_zb_zcl_on_off_cmd_req(&cmd_req);
-    esp_zb_lock_release();
+    Zigbee.lockRelease();
   } else {
     log_e("Light not bound");
   }
@@ -223,9 +223,9 @@ void ZigbeeColorDimmerSwitch::lightOn(uint8_t endpoint, esp_zb_ieee_addr_t ieee_
       "Sending 'light on' command to endpoint %d, ieee address %02x:%02x:%02x:%02x:%02x:%02x:%02x:%02x", endpoint, ieee_addr[7], ieee_addr[6], ieee_addr[5],
       ieee_addr[4], ieee_addr[3], ieee_addr[2], ieee_addr[1], ieee_addr[0]
     );
-    esp_zb_lock_acquire(portMAX_DELAY);
+    Zigbee.lockAcquire();
     esp_zb_zcl_on_off_cmd_req(&cmd_req);
-    esp_zb_lock_release();
+    Zigbee.lockRelease();
   } else {
     log_e("Light not bound");
   }
@@ -238,9 +238,9 @@ void ZigbeeColorDimmerSwitch::lightOff() {
     cmd_req.address_mode = ESP_ZB_APS_ADDR_MODE_DST_ADDR_ENDP_NOT_PRESENT;
     cmd_req.on_off_cmd_id = ESP_ZB_ZCL_CMD_ON_OFF_OFF_ID;
     log_v("Sending 'light off' command");
-    esp_zb_lock_acquire(portMAX_DELAY);
+    Zigbee.lockAcquire();
     esp_zb_zcl_on_off_cmd_req(&cmd_req);
-    esp_zb_lock_release();
+    Zigbee.lockRelease();
   } else {
     log_e("Light not bound");
   }
@@ -254,9 +254,9 @@ void ZigbeeColorDimmerSwitch::lightOff(uint16_t group_addr) {
     cmd_req.address_mode = ESP_ZB_APS_ADDR_MODE_16_GROUP_ENDP_NOT_PRESENT;
     cmd_req.on_off_cmd_id = ESP_ZB_ZCL_CMD_ON_OFF_OFF_ID;
     log_v("Sending 'light off' command to group address 0x%x", group_addr);
-    esp_zb_lock_acquire(portMAX_DELAY);
+    Zigbee.lockAcquire();
     esp_zb_zcl_on_off_cmd_req(&cmd_req);
-    esp_zb_lock_release();
+    Zigbee.lockRelease();
   } else {
     log_e("Light not bound");
   }
@@ -271,9 +271,9 @@ void ZigbeeColorDimmerSwitch::lightOff(uint8_t endpoint, uint16_t short_addr) {
     cmd_req.address_mode = ESP_ZB_APS_ADDR_MODE_16_ENDP_PRESENT;
     cmd_req.on_off_cmd_id = ESP_ZB_ZCL_CMD_ON_OFF_OFF_ID;
     log_v("Sending 'light off' command to endpoint %d, address 0x%x", endpoint, short_addr);
-    esp_zb_lock_acquire(portMAX_DELAY);
+    Zigbee.lockAcquire();
     esp_zb_zcl_on_off_cmd_req(&cmd_req);
-    esp_zb_lock_release();
+    Zigbee.lockRelease();
   } else {
     log_e("Light not bound");
   }
@@ -291,9 +291,9 @@ void ZigbeeColorDimmerSwitch::lightOff(uint8_t endpoint, esp_zb_ieee_addr_t ieee
       "Sending 'light off' command to endpoint %d, ieee address %02x:%02x:%02x:%02x:%02x:%02x:%02x:%02x", endpoint, ieee_addr[7], ieee_addr[6], ieee_addr[5],
       ieee_addr[4], ieee_addr[3], ieee_addr[2], ieee_addr[1], ieee_addr[0]
     );
-    esp_zb_lock_acquire(portMAX_DELAY);
+    Zigbee.lockAcquire();
     esp_zb_zcl_on_off_cmd_req(&cmd_req);
-    esp_zb_lock_release();
+    Zigbee.lockRelease();
   } else {
     log_e("Light not bound");
   }
@@ -307,9 +307,9 @@ void ZigbeeColorDimmerSwitch::lightOffWithEffect(uint8_t effect_id, uint8_t effe
     cmd_req.effect_id = effect_id;
     cmd_req.effect_variant = effect_variant;
     log_v("Sending 'light off with effect' command");
-    esp_zb_lock_acquire(portMAX_DELAY);
+    Zigbee.lockAcquire();
     esp_zb_zcl_on_off_off_with_effect_cmd_req(&cmd_req);
-    esp_zb_lock_release();
+    Zigbee.lockRelease();
   } else {
     log_e("Light not bound");
   }
@@ -321,9 +321,9 @@ void ZigbeeColorDimmerSwitch::lightOnWithSceneRecall() {
     cmd_req.zcl_basic_cmd.src_endpoint = _endpoint;
     cmd_req.address_mode = ESP_ZB_APS_ADDR_MODE_DST_ADDR_ENDP_NOT_PRESENT;
     log_v("Sending 'light on with scene recall' command");
-    esp_zb_lock_acquire(portMAX_DELAY);
+    Zigbee.lockAcquire();
     esp_zb_zcl_on_off_on_with_recall_global_scene_cmd_req(&cmd_req);
-    esp_zb_lock_release();
+    Zigbee.lockRelease();
   } else {
     log_e("Light not bound");
   }
@@ -338,9 +338,9 @@ void ZigbeeColorDimmerSwitch::lightOnWithTimedOff(uint8_t on_off_control, uint16
     cmd_req.on_time = time_on;
     cmd_req.off_wait_time = time_off;
     log_v("Sending 'light on with time off' command");
-    esp_zb_lock_acquire(portMAX_DELAY);
+    Zigbee.lockAcquire();
     esp_zb_zcl_on_off_on_with_timed_off_cmd_req(&cmd_req);
-    esp_zb_lock_release();
+    Zigbee.lockRelease();
   } else {
     log_e("Light not bound");
   }
@@ -354,9 +354,9 @@ void ZigbeeColorDimmerSwitch::setLightLevel(uint8_t level) {
     cmd_req.level = level;
     cmd_req.transition_time = 0xffff;
     log_v("Sending 'set light level' command");
-    esp_zb_lock_acquire(portMAX_DELAY);
+    Zigbee.lockAcquire();
     esp_zb_zcl_level_move_to_level_cmd_req(&cmd_req);
-    esp_zb_lock_release();
+    Zigbee.lockRelease();
   } else {
     log_e("Light not bound");
   }
@@ -371,9 +371,9 @@ void ZigbeeColorDimmerSwitch::setLightLevel(uint8_t level, uint16_t group_addr)
     cmd_req.level = level;
     cmd_req.transition_time = 0xffff;
     log_v("Sending 'set light level' command to group address 0x%x", group_addr);
-    esp_zb_lock_acquire(portMAX_DELAY);
+    Zigbee.lockAcquire();
     esp_zb_zcl_level_move_to_level_cmd_req(&cmd_req);
-    esp_zb_lock_release();
+    Zigbee.lockRelease();
   } else {
     log_e("Light not bound");
   }
@@ -389,9 +389,9 @@ void ZigbeeColorDimmerSwitch::setLightLevel(uint8_t level, uint8_t endpoint, uin
     cmd_req.level = level;
     cmd_req.transition_time = 0xffff;
     log_v("Sending 'set light level' command to endpoint %d, address 0x%x", endpoint, short_addr);
-    esp_zb_lock_acquire(portMAX_DELAY);
+    Zigbee.lockAcquire();
     esp_zb_zcl_level_move_to_level_cmd_req(&cmd_req);
-    esp_zb_lock_release();
+    Zigbee.lockRelease();
   } else {
     log_e("Light not bound");
   }
@@ -410,9 +410,9 @@ void ZigbeeColorDimmerSwitch::setLightLevel(uint8_t level, uint8_t endpoint, esp
       "Sending 'set light level' command to endpoint %d, ieee address %02x:%02x:%02x:%02x:%02x:%02x:%02x:%02x", endpoint, ieee_addr[7], ieee_addr[6],
       ieee_addr[5], ieee_addr[4], ieee_addr[3], ieee_addr[2], ieee_addr[1], ieee_addr[0]
     );
-    esp_zb_lock_acquire(portMAX_DELAY);
+    Zigbee.lockAcquire();
     esp_zb_zcl_level_move_to_level_cmd_req(&cmd_req);
-    esp_zb_lock_release();
+    Zigbee.lockRelease();
   } else {
     log_e("Light not bound");
   }
@@ -429,9 +429,9 @@ void ZigbeeColorDimmerSwitch::setLightColor(uint8_t red, uint8_t green, uint8_t
     cmd_req.color_y = xy_color.y;
     cmd_req.transition_time = 0;
     log_v("Sending 'set light color' command");
-    esp_zb_lock_acquire(portMAX_DELAY);
+    Zigbee.lockAcquire();
     esp_zb_zcl_color_move_to_color_cmd_req(&cmd_req);
-    esp_zb_lock_release();
+    Zigbee.lockRelease();
   } else {
     log_e("Light not bound");
   }
@@ -449,9 +449,9 @@ void ZigbeeColorDimmerSwitch::setLightColor(uint8_t red, uint8_t green, uint8_t
     cmd_req.color_y = xy_color.y;
     cmd_req.transition_time = 0;
     log_v("Sending 'set light color' command to group address 0x%x", group_addr);
-    esp_zb_lock_acquire(portMAX_DELAY);
+    Zigbee.lockAcquire();
     esp_zb_zcl_color_move_to_color_cmd_req(&cmd_req);
-    esp_zb_lock_release();
+    Zigbee.lockRelease();
   } else {
     log_e("Light not bound");
   }
@@ -470,9 +470,9 @@ void ZigbeeColorDimmerSwitch::setLightColor(uint8_t red, uint8_t green, uint8_t
     cmd_req.color_y = xy_color.y;
     cmd_req.transition_time = 0;
     log_v("Sending 'set light color' command to endpoint %d, address 0x%x", endpoint, short_addr);
-    esp_zb_lock_acquire(portMAX_DELAY);
+    Zigbee.lockAcquire();
     esp_zb_zcl_color_move_to_color_cmd_req(&cmd_req);
-    esp_zb_lock_release();
+    Zigbee.lockRelease();
   } else {
     log_e("Light not bound");
   }
@@ -494,9 +494,9 @@ void ZigbeeColorDimmerSwitch::setLightColor(uint8_t red, uint8_t green, uint8_t
       "Sending 'set light color' command to endpoint %d,  ieee address %02x:%02x:%02x:%02x:%02x:%02x:%02x:%02x", endpoint, ieee_addr[7], ieee_addr[6],
       ieee_addr[5], ieee_addr[4], ieee_addr[3], ieee_addr[2], ieee_addr[1], ieee_addr[0]
     );
-    esp_zb_lock_acquire(portMAX_DELAY);
+    Zigbee.lockAcquire();
     esp_zb_zcl_color_move_to_color_cmd_req(&cmd_req);
-    esp_zb_lock_release();
+    Zigbee.lockRelease();
   } else {
     log_e("Light not bound");
   }
@@ -32,11 +32,11 @@ void ZigbeeContactSwitch::setIASClientEndpoint(uint8_t ep_number) {
 bool ZigbeeContactSwitch::setClosed() {
   log_v("Setting Contact switch to closed");
   uint8_t closed = 0;  // ALARM1 = 0, ALARM2 = 0
-  esp_zb_lock_acquire(portMAX_DELAY);
+  Zigbee.lockAcquire();
   esp_err_t ret = esp_zb_zcl_set_attribute_val(
     _endpoint, ESP_ZB_ZCL_CLUSTER_ID_IAS_ZONE, ESP_ZB_ZCL_CLUSTER_SERVER_ROLE, ESP_ZB_ZCL_ATTR_IAS_ZONE_ZONESTATUS_ID, &closed, false
   );
-  esp_zb_lock_release();
+  Zigbee.lockRelease();
   if (ret != ESP_OK) {
     log_e("Failed to set contact switch to closed: 0x%x: %s", ret, esp_err_to_name(ret));
     return false;
@@ -48,11 +48,11 @@ bool ZigbeeContactSwitch::setClosed() {
 bool ZigbeeContactSwitch::setOpen() {
   log_v("Setting Contact switch to open");
   uint8_t open = ESP_ZB_ZCL_IAS_ZONE_ZONE_STATUS_ALARM1 | ESP_ZB_ZCL_IAS_ZONE_ZONE_STATUS_ALARM2;  // ALARM1 = 1, ALARM2 = 1
-  esp_zb_lock_acquire(portMAX_DELAY);
+  Zigbee.lockAcquire();
   esp_err_t ret = esp_zb_zcl_set_attribute_val(
     _endpoint, ESP_ZB_ZCL_CLUSTER_ID_IAS_ZONE, ESP_ZB_ZCL_CLUSTER_SERVER_ROLE, ESP_ZB_ZCL_ATTR_IAS_ZONE_ZONESTATUS_ID, &open, false
   );
-  esp_zb_lock_release();
+  Zigbee.lockRelease();
   if (ret != ESP_OK) {
     log_e("Failed to set contact switch to open: 0x%x: %s", ret, esp_err_to_name(ret));
     return false;
@@ -75,9 +75,9 @@ bool ZigbeeContactSwitch::report() {
   status_change_notif_cmd.zone_id = _zone_id;
   status_change_notif_cmd.delay = 0;
 
-  esp_zb_lock_acquire(portMAX_DELAY);
+  Zigbee.lockAcquire();
   esp_err_t ret = esp_zb_zcl_ias_zone_status_change_notif_cmd_req(&status_change_notif_cmd);
-  esp_zb_lock_release();
+  Zigbee.lockRelease();
   if (ret != ESP_OK) {
     log_e("Failed to send IAS Zone status changed notification: 0x%x: %s", ret, esp_err_to_name(ret));
     return false;
@@ -91,7 +91,7 @@ void ZigbeeContactSwitch::zbIASZoneEnrollResponse(const esp_zb_zcl_ias_zone_enro
     log_v("IAS Zone Enroll Response: zone id(%d), status(%d)", message->zone_id, message->response_code);
     if (message->response_code == ESP_ZB_ZCL_IAS_ZONE_ENROLL_RESPONSE_CODE_SUCCESS) {
       log_v("IAS Zone Enroll Response: success");
-      esp_zb_lock_acquire(portMAX_DELAY);
+      Zigbee.lockAcquire();
       memcpy(
         _ias_cie_addr,
         (*(esp_zb_ieee_addr_t *)
@@ -99,7 +99,7 @@ void ZigbeeContactSwitch::zbIASZoneEnrollResponse(const esp_zb_zcl_ias_zone_enro
               ->data_p),
         sizeof(esp_zb_ieee_addr_t)
       );
-      esp_zb_lock_release();
+      Zigbee.lockRelease();
       _zone_id = message->zone_id;
     }
 
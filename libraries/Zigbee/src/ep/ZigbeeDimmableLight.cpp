@@ -60,7 +60,7 @@ bool ZigbeeDimmableLight::setLight(bool state, uint8_t level) {
 
   log_v("Updating on/off light state to %d", state);
   /* Update light clusters */
-  esp_zb_lock_acquire(portMAX_DELAY);
+  Zigbee.lockAcquire();
   // set on/off state
   ret = esp_zb_zcl_set_attribute_val(
     _endpoint, ESP_ZB_ZCL_CLUSTER_ID_ON_OFF, ESP_ZB_ZCL_CLUSTER_SERVER_ROLE, ESP_ZB_ZCL_ATTR_ON_OFF_ON_OFF_ID, &_current_state, false
@@ -78,7 +78,7 @@ bool ZigbeeDimmableLight::setLight(bool state, uint8_t level) {
     goto unlock_and_return;
   }
 unlock_and_return:
-  esp_zb_lock_release();
+  Zigbee.lockRelease();
   return ret == ESP_ZB_ZCL_STATUS_SUCCESS;
 }
 
@@ -33,11 +33,11 @@ bool ZigbeeDoorWindowHandle::setClosed() {
   esp_zb_zcl_status_t ret = ESP_ZB_ZCL_STATUS_SUCCESS;
   log_v("Setting Door/Window handle to closed");
   uint8_t closed = 0;  // ALARM1 = 0, ALARM2 = 0
-  esp_zb_lock_acquire(portMAX_DELAY);
+  Zigbee.lockAcquire();
   ret = esp_zb_zcl_set_attribute_val(
     _endpoint, ESP_ZB_ZCL_CLUSTER_ID_IAS_ZONE, ESP_ZB_ZCL_CLUSTER_SERVER_ROLE, ESP_ZB_ZCL_ATTR_IAS_ZONE_ZONESTATUS_ID, &closed, false
   );
-  esp_zb_lock_release();
+  Zigbee.lockRelease();
   if (ret != ESP_ZB_ZCL_STATUS_SUCCESS) {
     log_e("Failed to set door/window handle to closed: 0x%x: %s", ret, esp_zb_zcl_status_to_name(ret));
     return false;
@@ -50,11 +50,11 @@ bool ZigbeeDoorWindowHandle::setOpen() {
   esp_zb_zcl_status_t ret = ESP_ZB_ZCL_STATUS_SUCCESS;
   log_v("Setting Door/Window handle to open");
   uint8_t open = ESP_ZB_ZCL_IAS_ZONE_ZONE_STATUS_ALARM1 | ESP_ZB_ZCL_IAS_ZONE_ZONE_STATUS_ALARM2;  // ALARM1 = 1, ALARM2 = 1
-  esp_zb_lock_acquire(portMAX_DELAY);
+  Zigbee.lockAcquire();
   ret = esp_zb_zcl_set_attribute_val(
     _endpoint, ESP_ZB_ZCL_CLUSTER_ID_IAS_ZONE, ESP_ZB_ZCL_CLUSTER_SERVER_ROLE, ESP_ZB_ZCL_ATTR_IAS_ZONE_ZONESTATUS_ID, &open, false
   );
-  esp_zb_lock_release();
+  Zigbee.lockRelease();
   if (ret != ESP_ZB_ZCL_STATUS_SUCCESS) {
     log_e("Failed to set door/window handle to open: 0x%x: %s", ret, esp_zb_zcl_status_to_name(ret));
     return false;
@@ -67,11 +67,11 @@ bool ZigbeeDoorWindowHandle::setTilted() {
   esp_zb_zcl_status_t ret = ESP_ZB_ZCL_STATUS_SUCCESS;
   log_v("Setting Door/Window handle to tilted");
   uint8_t tilted = ESP_ZB_ZCL_IAS_ZONE_ZONE_STATUS_ALARM1;  // ALARM1 = 1, ALARM2 = 0
-  esp_zb_lock_acquire(portMAX_DELAY);
+  Zigbee.lockAcquire();
   ret = esp_zb_zcl_set_attribute_val(
     _endpoint, ESP_ZB_ZCL_CLUSTER_ID_IAS_ZONE, ESP_ZB_ZCL_CLUSTER_SERVER_ROLE, ESP_ZB_ZCL_ATTR_IAS_ZONE_ZONESTATUS_ID, &tilted, false
   );
-  esp_zb_lock_release();
+  Zigbee.lockRelease();
   if (ret != ESP_ZB_ZCL_STATUS_SUCCESS) {
     log_e("Failed to set door/window handle to tilted: 0x%x: %s", ret, esp_zb_zcl_status_to_name(ret));
     return false;
@@ -95,9 +95,9 @@ bool ZigbeeDoorWindowHandle::report() {
   status_change_notif_cmd.delay = 0;
 
   //NOTE: Check result of esp_zb_zcl_ias_zone_status_change_notif_cmd_req() and return true if success, false if failure
-  esp_zb_lock_acquire(portMAX_DELAY);
+  Zigbee.lockAcquire();
   esp_zb_zcl_ias_zone_status_change_notif_cmd_req(&status_change_notif_cmd);
-  esp_zb_lock_release();
+  Zigbee.lockRelease();
   log_v("IAS Zone status changed notification sent");
   return true;
 }
@@ -107,7 +107,7 @@ void ZigbeeDoorWindowHandle::zbIASZoneEnrollResponse(const esp_zb_zcl_ias_zone_e
     log_v("IAS Zone Enroll Response: zone id(%d), status(%d)", message->zone_id, message->response_code);
     if (message->response_code == ESP_ZB_ZCL_IAS_ZONE_ENROLL_RESPONSE_CODE_SUCCESS) {
       log_v("IAS Zone Enroll Response: success");
-      esp_zb_lock_acquire(portMAX_DELAY);
+      Zigbee.lockAcquire();
       memcpy(
         _ias_cie_addr,
         (*(esp_zb_ieee_addr_t *)
@@ -115,7 +115,7 @@ void ZigbeeDoorWindowHandle::zbIASZoneEnrollResponse(const esp_zb_zcl_ias_zone_e
               ->data_p),
         sizeof(esp_zb_ieee_addr_t)
       );
-      esp_zb_lock_release();
+      Zigbee.lockRelease();
       _zone_id = message->zone_id;
     }
 
@@ -231,9 +231,9 @@ bool ZigbeeElectricalMeasurement::setDCReporting(ZIGBEE_DC_MEASUREMENT_TYPE meas
   reporting_info.u.send_info.delta.s16 = delta;
   reporting_info.dst.profile_id = ESP_ZB_AF_HA_PROFILE_ID;
   reporting_info.manuf_code = ESP_ZB_ZCL_ATTR_NON_MANUFACTURER_SPECIFIC;
-  esp_zb_lock_acquire(portMAX_DELAY);
+  Zigbee.lockAcquire();
   esp_err_t ret = esp_zb_zcl_update_reporting_info(&reporting_info);
-  esp_zb_lock_release();
+  Zigbee.lockRelease();
   if (ret != ESP_OK) {
     log_e("Failed to set reporting: 0x%x: %s", ret, esp_err_to_name(ret));
     return false;
@@ -254,9 +254,9 @@ bool ZigbeeElectricalMeasurement::setDCMeasurement(ZIGBEE_DC_MEASUREMENT_TYPE me
   log_v("Updating DC measurement value...");
   /* Update DC sensor measured value */
   log_d("Setting DC measurement to %d", measurement);
-  esp_zb_lock_acquire(portMAX_DELAY);
+  Zigbee.lockAcquire();
   ret = esp_zb_zcl_set_attribute_val(_endpoint, ESP_ZB_ZCL_CLUSTER_ID_ELECTRICAL_MEASUREMENT, ESP_ZB_ZCL_CLUSTER_SERVER_ROLE, attr_id, &measurement, false);
-  esp_zb_lock_release();
+  Zigbee.lockRelease();
   if (ret != ESP_ZB_ZCL_STATUS_SUCCESS) {
     log_e("Failed to set DC measurement: 0x%x: %s", ret, esp_zb_zcl_status_to_name(ret));
     return false;
@@ -271,20 +271,8 @@ bool ZigbeeElectricalMeasurement::reportDC(ZIGBEE_DC_MEASUREMENT_TYPE measuremen
   } else if (measurement_type == ZIGBEE_DC_MEASUREMENT_TYPE_POWER) {
     attr_id = ESP_ZB_ZCL_ATTR_ELECTRICAL_MEASUREMENT_DC_POWER_ID;
   }
-  /* Send report attributes command */
-  esp_zb_zcl_report_attr_cmd_t report_attr_cmd;
-  report_attr_cmd.address_mode = ESP_ZB_APS_ADDR_MODE_DST_ADDR_ENDP_NOT_PRESENT;
-  report_attr_cmd.attributeID = attr_id;
-  report_attr_cmd.direction = ESP_ZB_ZCL_CMD_DIRECTION_TO_CLI;
-  report_attr_cmd.clusterID = ESP_ZB_ZCL_CLUSTER_ID_ELECTRICAL_MEASUREMENT;
-  report_attr_cmd.zcl_basic_cmd.src_endpoint = _endpoint;
-  report_attr_cmd.manuf_code = ESP_ZB_ZCL_ATTR_NON_MANUFACTURER_SPECIFIC;
-
-  esp_zb_lock_acquire(portMAX_DELAY);
-  esp_err_t ret = esp_zb_zcl_report_attr_cmd_req(&report_attr_cmd);
-  esp_zb_lock_release();
-  if (ret != ESP_OK) {
-    log_e("Failed to send DC report: 0x%x: %s", ret, esp_err_to_name(ret));
+  if (!reportAttribute(ESP_ZB_ZCL_CLUSTER_ID_ELECTRICAL_MEASUREMENT, attr_id)) {
+    log_e("Failed to send DC report");
     return false;
   }
   log_v("DC report sent");
@@ -777,10 +765,10 @@ bool ZigbeeElectricalMeasurement::setACMeasurement(ZIGBEE_AC_MEASUREMENT_TYPE me
       // Use uint16_t for voltage
       log_v("Updating AC voltage measurement value...");
       log_d("Setting AC voltage to %u", uint16_value);
-      esp_zb_lock_acquire(portMAX_DELAY);
+      Zigbee.lockAcquire();
       ret =
         esp_zb_zcl_set_attribute_val(_endpoint, ESP_ZB_ZCL_CLUSTER_ID_ELECTRICAL_MEASUREMENT, ESP_ZB_ZCL_CLUSTER_SERVER_ROLE, attr_id, &uint16_value, false);
-      esp_zb_lock_release();
+      Zigbee.lockRelease();
       break;
 
     case ZIGBEE_AC_MEASUREMENT_TYPE_CURRENT:
@@ -794,10 +782,10 @@ bool ZigbeeElectricalMeasurement::setACMeasurement(ZIGBEE_AC_MEASUREMENT_TYPE me
       // Use uint16_t for current
       log_v("Updating AC current measurement value...");
       log_d("Setting AC current to %u", uint16_value);
-      esp_zb_lock_acquire(portMAX_DELAY);
+      Zigbee.lockAcquire();
       ret =
         esp_zb_zcl_set_attribute_val(_endpoint, ESP_ZB_ZCL_CLUSTER_ID_ELECTRICAL_MEASUREMENT, ESP_ZB_ZCL_CLUSTER_SERVER_ROLE, attr_id, &uint16_value, false);
-      esp_zb_lock_release();
+      Zigbee.lockRelease();
       break;
 
     case ZIGBEE_AC_MEASUREMENT_TYPE_POWER:
@@ -811,9 +799,9 @@ bool ZigbeeElectricalMeasurement::setACMeasurement(ZIGBEE_AC_MEASUREMENT_TYPE me
       // Use int16_t for power
       log_v("Updating AC power measurement value...");
       log_d("Setting AC power to %d", int16_value);
-      esp_zb_lock_acquire(portMAX_DELAY);
+      Zigbee.lockAcquire();
       ret = esp_zb_zcl_set_attribute_val(_endpoint, ESP_ZB_ZCL_CLUSTER_ID_ELECTRICAL_MEASUREMENT, ESP_ZB_ZCL_CLUSTER_SERVER_ROLE, attr_id, &int16_value, false);
-      esp_zb_lock_release();
+      Zigbee.lockRelease();
       break;
 
     case ZIGBEE_AC_MEASUREMENT_TYPE_FREQUENCY:
@@ -821,10 +809,10 @@ bool ZigbeeElectricalMeasurement::setACMeasurement(ZIGBEE_AC_MEASUREMENT_TYPE me
       // Use uint16_t for frequency
       log_v("Updating AC frequency measurement value...");
       log_d("Setting AC frequency to %u", uint16_value);
-      esp_zb_lock_acquire(portMAX_DELAY);
+      Zigbee.lockAcquire();
       ret =
         esp_zb_zcl_set_attribute_val(_endpoint, ESP_ZB_ZCL_CLUSTER_ID_ELECTRICAL_MEASUREMENT, ESP_ZB_ZCL_CLUSTER_SERVER_ROLE, attr_id, &uint16_value, false);
-      esp_zb_lock_release();
+      Zigbee.lockRelease();
       break;
     case ZIGBEE_AC_MEASUREMENT_TYPE_POWER_FACTOR:
       switch (phase_type) {
@@ -837,9 +825,9 @@ bool ZigbeeElectricalMeasurement::setACMeasurement(ZIGBEE_AC_MEASUREMENT_TYPE me
       // Use int8_t for power factor
       log_v("Updating AC power factor measurement value...");
       log_d("Setting AC power factor to %d", int8_value);
-      esp_zb_lock_acquire(portMAX_DELAY);
+      Zigbee.lockAcquire();
       ret = esp_zb_zcl_set_attribute_val(_endpoint, ESP_ZB_ZCL_CLUSTER_ID_ELECTRICAL_MEASUREMENT, ESP_ZB_ZCL_CLUSTER_SERVER_ROLE, attr_id, &int8_value, false);
-      esp_zb_lock_release();
+      Zigbee.lockRelease();
       break;
     default: log_e("Invalid measurement type"); return false;
   }
@@ -911,9 +899,9 @@ bool ZigbeeElectricalMeasurement::setACReporting(
   }
   reporting_info.dst.profile_id = ESP_ZB_AF_HA_PROFILE_ID;
   reporting_info.manuf_code = ESP_ZB_ZCL_ATTR_NON_MANUFACTURER_SPECIFIC;
-  esp_zb_lock_acquire(portMAX_DELAY);
+  Zigbee.lockAcquire();
   esp_err_t ret = esp_zb_zcl_update_reporting_info(&reporting_info);
-  esp_zb_lock_release();
+  Zigbee.lockRelease();
   if (ret != ESP_OK) {
     log_e("Failed to set reporting: 0x%x: %s", ret, esp_err_to_name(ret));
     return false;
@@ -956,20 +944,8 @@ bool ZigbeeElectricalMeasurement::reportAC(ZIGBEE_AC_MEASUREMENT_TYPE measuremen
     case ZIGBEE_AC_MEASUREMENT_TYPE_POWER_FACTOR: log_e("Power factor attribute reporting not supported by zigbee specification"); return false;
     default:                                      log_e("Invalid measurement type"); return false;
   }
-  /* Send report attributes command */
-  esp_zb_zcl_report_attr_cmd_t report_attr_cmd;
-  report_attr_cmd.address_mode = ESP_ZB_APS_ADDR_MODE_DST_ADDR_ENDP_NOT_PRESENT;
-  report_attr_cmd.attributeID = attr_id;
-  report_attr_cmd.direction = ESP_ZB_ZCL_CMD_DIRECTION_TO_CLI;
-  report_attr_cmd.clusterID = ESP_ZB_ZCL_CLUSTER_ID_ELECTRICAL_MEASUREMENT;
-  report_attr_cmd.zcl_basic_cmd.src_endpoint = _endpoint;
-  report_attr_cmd.manuf_code = ESP_ZB_ZCL_ATTR_NON_MANUFACTURER_SPECIFIC;
-
-  esp_zb_lock_acquire(portMAX_DELAY);
-  esp_err_t ret = esp_zb_zcl_report_attr_cmd_req(&report_attr_cmd);
-  esp_zb_lock_release();
-  if (ret != ESP_OK) {
-    log_e("Failed to send AC report: 0x%x: %s", ret, esp_err_to_name(ret));
+  if (!reportAttribute(ESP_ZB_ZCL_CLUSTER_ID_ELECTRICAL_MEASUREMENT, attr_id)) {
+    log_e("Failed to send AC report");
     return false;
   }
   log_v("AC report sent");
@@ -99,9 +99,9 @@ void ZigbeeSwitch::lightToggle() {
     cmd_req.address_mode = ESP_ZB_APS_ADDR_MODE_DST_ADDR_ENDP_NOT_PRESENT;
     cmd_req.on_off_cmd_id = ESP_ZB_ZCL_CMD_ON_OFF_TOGGLE_ID;
     log_v("Sending 'light toggle' command");
-    esp_zb_lock_acquire(portMAX_DELAY);
+    Zigbee.lockAcquire();
     esp_zb_zcl_on_off_cmd_req(&cmd_req);
-    esp_zb_lock_release();
+    Zigbee.lockRelease();
   } else {
     log_e("Light not bound");
   }
@@ -115,9 +115,9 @@ void ZigbeeSwitch::lightToggle(uint16_t group_addr) {
     cmd_req.address_mode = ESP_ZB_APS_ADDR_MODE_16_GROUP_ENDP_NOT_PRESENT;
     cmd_req.on_off_cmd_id = ESP_ZB_ZCL_CMD_ON_OFF_TOGGLE_ID;
     log_v("Sending 'light toggle' command to group address 0x%x", group_addr);
-    esp_zb_lock_acquire(portMAX_DELAY);
+    Zigbee.lockAcquire();
     esp_zb_zcl_on_off_cmd_req(&cmd_req);
-    esp_zb_lock_release();
+    Zigbee.lockRelease();
   } else {
     log_e("Light not bound");
   }
@@ -132,9 +132,9 @@ void ZigbeeSwitch::lightToggle(uint8_t endpoint, uint16_t short_addr) {
     cmd_req.address_mode = ESP_ZB_APS_ADDR_MODE_16_ENDP_PRESENT;
     cmd_req.on_off_cmd_id = ESP_ZB_ZCL_CMD_ON_OFF_TOGGLE_ID;
     log_v("Sending 'light toggle' command to endpoint %d, address 0x%x", endpoint, short_addr);
-    esp_zb_lock_acquire(portMAX_DELAY);
+    Zigbee.lockAcquire();
     esp_zb_zcl_on_off_cmd_req(&cmd_req);
-    esp_zb_lock_release();
+    Zigbee.lockRelease();
   } else {
     log_e("Light not bound");
   }
@@ -152,9 +152,9 @@ void ZigbeeSwitch::lightToggle(uint8_t endpoint, esp_zb_ieee_addr_t ieee_addr) {
       "Sending 'light toggle' command to endpoint %d, ieee address %02x:%02x:%02x:%02x:%02x:%02x:%02x:%02x", endpoint, ieee_addr[7], ieee_addr[6], ieee_addr[5],
       ieee_addr[4], ieee_addr[3], ieee_addr[2], ieee_addr[1], ieee_addr[0]
     );
-    esp_zb_lock_acquire(portMAX_DELAY);
+    Zigbee.lockAcquire();
     esp_zb_zcl_on_off_cmd_req(&cmd_req);
-    esp_zb_lock_release();
+    Zigbee.lockRelease();
   } else {
     log_e("Light not bound");
   }
@@ -167,9 +167,9 @@ void ZigbeeSwitch::lightOn() {
     cmd_req.address_mode = ESP_ZB_APS_ADDR_MODE_DST_ADDR_ENDP_NOT_PRESENT;
     cmd_req.on_off_cmd_id = ESP_ZB_ZCL_CMD_ON_OFF_ON_ID;
     log_v("Sending 'light on' command");
-    esp_zb_lock_acquire(portMAX_DELAY);
+    Zigbee.lockAcquire();
     esp_zb_zcl_on_off_cmd_req(&cmd_req);
-    esp_zb_lock_release();
+    Zigbee.lockRelease();
   } else {
     log_e("Light not bound");
   }
@@ -183,9 +183,9 @@ void ZigbeeSwitch::lightOn(uint16_t group_addr) {
     cmd_req.address_mode = ESP_ZB_APS_ADDR_MODE_16_GROUP_ENDP_NOT_PRESENT;
     cmd_req.on_off_cmd_id = ESP_ZB_ZCL_CMD_ON_OFF_ON_ID;
     log_v("Sending 'light on' command to group address 0x%x", group_addr);
-    esp_zb_lock_acquire(portMAX_DELAY);
+    Zigbee.lockAcquire();
     esp_zb_zcl_on_off_cmd_req(&cmd_req);
-    esp_zb_lock_release();
+    Zigbee.lockRelease();
   } else {
     log_e("Light not bound");
   }
@@ -200,9 +200,9 @@ void ZigbeeSwitch::lightOn(uint8_t endpoint, uint16_t short_addr) {
     cmd_req.address_mode = ESP_ZB_APS_ADDR_MODE_16_ENDP_PRESENT;
     cmd_req.on_off_cmd_id = ESP_ZB_ZCL_CMD_ON_OFF_ON_ID;
     log_v("Sending 'light on' command to endpoint %d, address 0x%x", endpoint, short_addr);
-    esp_zb_lock_acquire(portMAX_DELAY);
+    Zigbee.lockAcquire();
     esp_zb_zcl_on_off_cmd_req(&cmd_req);
-    esp_zb_lock_release();
+    Zigbee.lockRelease();
   } else {
     log_e("Light not bound");
   }
@@ -220,9 +220,9 @@ void ZigbeeSwitch::lightOn(uint8_t endpoint, esp_zb_ieee_addr_t ieee_addr) {
       "Sending 'light on' command to endpoint %d, ieee address %02x:%02x:%02x:%02x:%02x:%02x:%02x:%02x", endpoint, ieee_addr[7], ieee_addr[6], ieee_addr[5],
       ieee_addr[4], ieee_addr[3], ieee_addr[2], ieee_addr[1], ieee_addr[0]
     );
-    esp_zb_lock_acquire(portMAX_DELAY);
+    Zigbee.lockAcquire();
     esp_zb_zcl_on_off_cmd_req(&cmd_req);
-    esp_zb_lock_release();
+    Zigbee.lockRelease();
   } else {
     log_e("Light not bound");
   }
@@ -235,9 +235,9 @@ void ZigbeeSwitch::lightOff() {
     cmd_req.address_mode = ESP_ZB_APS_ADDR_MODE_DST_ADDR_ENDP_NOT_PRESENT;
     cmd_req.on_off_cmd_id = ESP_ZB_ZCL_CMD_ON_OFF_OFF_ID;
     log_v("Sending 'light off' command");
-    esp_zb_lock_acquire(portMAX_DELAY);
+    Zigbee.lockAcquire();
     esp_zb_zcl_on_off_cmd_req(&cmd_req);
-    esp_zb_lock_release();
+    Zigbee.lockRelease();
   } else {
     log_e("Light not bound");
   }
@@ -251,9 +251,9 @@ void ZigbeeSwitch::lightOff(uint16_t group_addr) {
     cmd_req.address_mode = ESP_ZB_APS_ADDR_MODE_16_GROUP_ENDP_NOT_PRESENT;
     cmd_req.on_off_cmd_id = ESP_ZB_ZCL_CMD_ON_OFF_OFF_ID;
     log_v("Sending 'light off' command to group address 0x%x", group_addr);
-    esp_zb_lock_acquire(portMAX_DELAY);
+    Zigbee.lockAcquire();
     esp_zb_zcl_on_off_cmd_req(&cmd_req);
-    esp_zb_lock_release();
+    Zigbee.lockRelease();
   } else {
     log_e("Light not bound");
   }
@@ -268,9 +268,9 @@ void ZigbeeSwitch::lightOff(uint8_t endpoint, uint16_t short_addr) {
     cmd_req.address_mode = ESP_ZB_APS_ADDR_MODE_16_ENDP_PRESENT;
     cmd_req.on_off_cmd_id = ESP_ZB_ZCL_CMD_ON_OFF_OFF_ID;
     log_v("Sending 'light off' command to endpoint %d, address 0x%x", endpoint, short_addr);
-    esp_zb_lock_acquire(portMAX_DELAY);
+    Zigbee.lockAcquire();
     esp_zb_zcl_on_off_cmd_req(&cmd_req);
-    esp_zb_lock_release();
+    Zigbee.lockRelease();
   } else {
     log_e("Light not bound");
   }
@@ -288,9 +288,9 @@ void ZigbeeSwitch::lightOff(uint8_t endpoint, esp_zb_ieee_addr_t ieee_addr) {
       "Sending 'light off' command to endpoint %d, ieee address %02x:%02x:%02x:%02x:%02x:%02x:%02x:%02x", endpoint, ieee_addr[7], ieee_addr[6], ieee_addr[5],
       ieee_addr[4], ieee_addr[3], ieee_addr[2], ieee_addr[1], ieee_addr[0]
     );
-    esp_zb_lock_acquire(portMAX_DELAY);
+    Zigbee.lockAcquire();
     esp_zb_zcl_on_off_cmd_req(&cmd_req);
-    esp_zb_lock_release();
+    Zigbee.lockRelease();
   } else {
     log_e("Light not bound");
   }
@@ -304,9 +304,9 @@ void ZigbeeSwitch::lightOffWithEffect(uint8_t effect_id, uint8_t effect_variant)
     cmd_req.effect_id = effect_id;
     cmd_req.effect_variant = effect_variant;
     log_v("Sending 'light off with effect' command");
-    esp_zb_lock_acquire(portMAX_DELAY);
+    Zigbee.lockAcquire();
     esp_zb_zcl_on_off_off_with_effect_cmd_req(&cmd_req);
-    esp_zb_lock_release();
+    Zigbee.lockRelease();
   } else {
     log_e("Light not bound");
   }
@@ -318,9 +318,9 @@ void ZigbeeSwitch::lightOnWithSceneRecall() {
     cmd_req.zcl_basic_cmd.src_endpoint = _endpoint;
     cmd_req.address_mode = ESP_ZB_APS_ADDR_MODE_DST_ADDR_ENDP_NOT_PRESENT;
     log_v("Sending 'light on with scene recall' command");
-    esp_zb_lock_acquire(portMAX_DELAY);
+    Zigbee.lockAcquire();
     esp_zb_zcl_on_off_on_with_recall_global_scene_cmd_req(&cmd_req);
-    esp_zb_lock_release();
+    Zigbee.lockRelease();
   } else {
     log_e("Light not bound");
   }
@@ -334,9 +334,9 @@ void ZigbeeSwitch::lightOnWithTimedOff(uint8_t on_off_control, uint16_t time_on,
     cmd_req.on_time = time_on;
     cmd_req.off_wait_time = time_off;
     log_v("Sending 'light on with time off' command");
-    esp_zb_lock_acquire(portMAX_DELAY);
+    Zigbee.lockAcquire();
     esp_zb_zcl_on_off_on_with_timed_off_cmd_req(&cmd_req);
-    esp_zb_lock_release();
+    Zigbee.lockRelease();
   } else {
     log_e("Light not bound");
   }
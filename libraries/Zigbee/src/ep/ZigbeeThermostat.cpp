@@ -165,9 +165,9 @@ void ZigbeeThermostat::getTemperature() {
   read_req.attr_field = attributes;
 
   log_i("Sending 'read temperature' command");
-  esp_zb_lock_acquire(portMAX_DELAY);
+  Zigbee.lockAcquire();
   esp_zb_zcl_read_attr_cmd_req(&read_req);
-  esp_zb_lock_release();
+  Zigbee.lockRelease();
 }
 
 void ZigbeeThermostat::getTemperature(uint16_t group_addr) {
@@ -183,9 +183,9 @@ void ZigbeeThermostat::getTemperature(uint16_t group_addr) {
   read_req.attr_field = attributes;
 
   log_i("Sending 'read temperature' command to group address 0x%x", group_addr);
-  esp_zb_lock_acquire(portMAX_DELAY);
+  Zigbee.lockAcquire();
   esp_zb_zcl_read_attr_cmd_req(&read_req);
-  esp_zb_lock_release();
+  Zigbee.lockRelease();
 }
 
 void ZigbeeThermostat::getTemperature(uint8_t endpoint, uint16_t short_addr) {
@@ -202,9 +202,9 @@ void ZigbeeThermostat::getTemperature(uint8_t endpoint, uint16_t short_addr) {
   read_req.attr_field = attributes;
 
   log_i("Sending 'read temperature' command to endpoint %d, address 0x%x", endpoint, short_addr);
-  esp_zb_lock_acquire(portMAX_DELAY);
+  Zigbee.lockAcquire();
   esp_zb_zcl_read_attr_cmd_req(&read_req);
-  esp_zb_lock_release();
+  Zigbee.lockRelease();
 }
 
 void ZigbeeThermostat::getTemperature(uint8_t endpoint, esp_zb_ieee_addr_t ieee_addr) {
@@ -224,9 +224,9 @@ void ZigbeeThermostat::getTemperature(uint8_t endpoint, esp_zb_ieee_addr_t ieee_
     "Sending 'read temperature' command to endpoint %d, ieee address %02x:%02x:%02x:%02x:%02x:%02x:%02x:%02x", endpoint, ieee_addr[7], ieee_addr[6],
     ieee_addr[5], ieee_addr[4], ieee_addr[3], ieee_addr[2], ieee_addr[1], ieee_addr[0]
   );
-  esp_zb_lock_acquire(portMAX_DELAY);
+  Zigbee.lockAcquire();
   esp_zb_zcl_read_attr_cmd_req(&read_req);
-  esp_zb_lock_release();
+  Zigbee.lockRelease();
 }
 
 void ZigbeeThermostat::getSensorSettings() {
@@ -243,9 +243,9 @@ void ZigbeeThermostat::getSensorSettings() {
   read_req.attr_field = attributes;
 
   log_i("Sending 'read sensor settings' command");
-  esp_zb_lock_acquire(portMAX_DELAY);
+  Zigbee.lockAcquire();
   esp_zb_zcl_read_attr_cmd_req(&read_req);
-  esp_zb_lock_release();
+  Zigbee.lockRelease();
 
   //Take semaphore to wait for response of all attributes
   if (xSemaphoreTake(lock, ZB_CMD_TIMEOUT) != pdTRUE) {
@@ -272,9 +272,9 @@ void ZigbeeThermostat::getSensorSettings(uint16_t group_addr) {
   read_req.attr_field = attributes;
 
   log_i("Sending 'read sensor settings' command to group address 0x%x", group_addr);
-  esp_zb_lock_acquire(portMAX_DELAY);
+  Zigbee.lockAcquire();
   esp_zb_zcl_read_attr_cmd_req(&read_req);
-  esp_zb_lock_release();
+  Zigbee.lockRelease();
 
   //Take semaphore to wait for response of all attributes
   if (xSemaphoreTake(lock, ZB_CMD_TIMEOUT) != pdTRUE) {
@@ -302,9 +302,9 @@ void ZigbeeThermostat::getSensorSettings(uint8_t endpoint, uint16_t short_addr)
   read_req.attr_field = attributes;
 
   log_i("Sending 'read sensor settings' command to endpoint %d, address 0x%x", endpoint, short_addr);
-  esp_zb_lock_acquire(portMAX_DELAY);
+  Zigbee.lockAcquire();
   esp_zb_zcl_read_attr_cmd_req(&read_req);
-  esp_zb_lock_release();
+  Zigbee.lockRelease();
 
   //Take semaphore to wait for response of all attributes
   if (xSemaphoreTake(lock, ZB_CMD_TIMEOUT) != pdTRUE) {
@@ -335,9 +335,9 @@ void ZigbeeThermostat::getSensorSettings(uint8_t endpoint, esp_zb_ieee_addr_t ie
     "Sending 'read sensor settings' command to endpoint %d, ieee address %02x:%02x:%02x:%02x:%02x:%02x:%02x:%02x", endpoint, ieee_addr[7], ieee_addr[6],
     ieee_addr[5], ieee_addr[4], ieee_addr[3], ieee_addr[2], ieee_addr[1], ieee_addr[0]
   );
-  esp_zb_lock_acquire(portMAX_DELAY);
+  Zigbee.lockAcquire();
   esp_zb_zcl_read_attr_cmd_req(&read_req);
-  esp_zb_lock_release();
+  Zigbee.lockRelease();
 
   //Take semaphore to wait for response of all attributes
   if (xSemaphoreTake(lock, ZB_CMD_TIMEOUT) != pdTRUE) {
@@ -371,9 +371,9 @@ void ZigbeeThermostat::setTemperatureReporting(uint16_t min_interval, uint16_t m
   report_cmd.record_field = records;
 
   log_i("Sending 'configure reporting' command");
-  esp_zb_lock_acquire(portMAX_DELAY);
+  Zigbee.lockAcquire();
   esp_zb_zcl_config_report_cmd_req(&report_cmd);
-  esp_zb_lock_release();
+  Zigbee.lockRelease();
 }
 
 void ZigbeeThermostat::setTemperatureReporting(uint16_t group_addr, uint16_t min_interval, uint16_t max_interval, float delta) {
@@ -399,9 +399,9 @@ void ZigbeeThermostat::setTemperatureReporting(uint16_t group_addr, uint16_t min
   report_cmd.record_field = records;
 
   log_i("Sending 'configure reporting' command to group address 0x%x", group_addr);
-  esp_zb_lock_acquire(portMAX_DELAY);
+  Zigbee.lockAcquire();
   esp_zb_zcl_config_report_cmd_req(&report_cmd);
-  esp_zb_lock_release();
+  Zigbee.lockRelease();
 }
 
 void ZigbeeThermostat::setTemperatureReporting(uint8_t endpoint, uint16_t short_addr, uint16_t min_interval, uint16_t max_interval, float delta) {
@@ -428,9 +428,9 @@ void ZigbeeThermostat::setTemperatureReporting(uint8_t endpoint, uint16_t short_
   report_cmd.record_field = records;
 
   log_i("Sending 'configure reporting' command to endpoint %d, address 0x%x", endpoint, short_addr);
-  esp_zb_lock_acquire(portMAX_DELAY);
+  Zigbee.lockAcquire();
   esp_zb_zcl_config_report_cmd_req(&report_cmd);
-  esp_zb_lock_release();
+  Zigbee.lockRelease();
 }
 
 void ZigbeeThermostat::setTemperatureReporting(uint8_t endpoint, esp_zb_ieee_addr_t ieee_addr, uint16_t min_interval, uint16_t max_interval, float delta) {
@@ -460,9 +460,9 @@ void ZigbeeThermostat::setTemperatureReporting(uint8_t endpoint, esp_zb_ieee_add
     "Sending 'configure reporting' command to endpoint %d, ieee address %02x:%02x:%02x:%02x:%02x:%02x:%02x:%02x", endpoint, ieee_addr[7], ieee_addr[6],
     ieee_addr[5], ieee_addr[4], ieee_addr[3], ieee_addr[2], ieee_addr[1], ieee_addr[0]
   );
-  esp_zb_lock_acquire(portMAX_DELAY);
+  Zigbee.lockAcquire();
   esp_zb_zcl_config_report_cmd_req(&report_cmd);
-  esp_zb_lock_release();
+  Zigbee.lockRelease();
 }
 
 #endif  // CONFIG_ZB_ENABLED
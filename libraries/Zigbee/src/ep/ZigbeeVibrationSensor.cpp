@@ -33,11 +33,11 @@ bool ZigbeeVibrationSensor::setVibration(bool sensed) {
   esp_zb_zcl_status_t ret = ESP_ZB_ZCL_STATUS_SUCCESS;
   log_v("Setting Vibration sensor to %s", sensed ? "sensed" : "not sensed");
   uint8_t vibration = (uint8_t)sensed;
-  esp_zb_lock_acquire(portMAX_DELAY);
+  Zigbee.lockAcquire();
   ret = esp_zb_zcl_set_attribute_val(
     _endpoint, ESP_ZB_ZCL_CLUSTER_ID_IAS_ZONE, ESP_ZB_ZCL_CLUSTER_SERVER_ROLE, ESP_ZB_ZCL_ATTR_IAS_ZONE_ZONESTATUS_ID, &vibration, false
   );
-  esp_zb_lock_release();
+  Zigbee.lockRelease();
   if (ret != ESP_ZB_ZCL_STATUS_SUCCESS) {
     log_e("Failed to set vibration status: 0x%x: %s", ret, esp_zb_zcl_status_to_name(ret));
     return false;
@@ -60,9 +60,9 @@ void ZigbeeVibrationSensor::report() {
   status_change_notif_cmd.zone_id = _zone_id;
   status_change_notif_cmd.delay = 0;
 
-  esp_zb_lock_acquire(portMAX_DELAY);
+  Zigbee.lockAcquire();
   esp_zb_zcl_ias_zone_status_change_notif_cmd_req(&status_change_notif_cmd);
-  esp_zb_lock_release();
+  Zigbee.lockRelease();
   log_v("IAS Zone status changed notification sent");
 }
 
@@ -71,7 +71,7 @@ void ZigbeeVibrationSensor::zbIASZoneEnrollResponse(const esp_zb_zcl_ias_zone_en
     log_v("IAS Zone Enroll Response: zone id(%d), status(%d)", message->zone_id, message->response_code);
     if (message->response_code == ESP_ZB_ZCL_IAS_ZONE_ENROLL_RESPONSE_CODE_SUCCESS) {
       log_v("IAS Zone Enroll Response: success");
-      esp_zb_lock_acquire(portMAX_DELAY);
+      Zigbee.lockAcquire();
       memcpy(
         _ias_cie_addr,
         (*(esp_zb_ieee_addr_t *)
@@ -79,7 +79,7 @@ void ZigbeeVibrationSensor::zbIASZoneEnrollResponse(const esp_zb_zcl_ias_zone_en
               ->data_p),
         sizeof(esp_zb_ieee_addr_t)
       );
-      esp_zb_lock_release();
+      Zigbee.lockRelease();
       _zone_id = message->zone_id;
     }
 
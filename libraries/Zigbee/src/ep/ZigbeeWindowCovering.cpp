@@ -197,12 +197,12 @@ void ZigbeeWindowCovering::zbAttributeSet(const esp_zb_zcl_set_attr_value_messag
       config_status = motor_reversed ? config_status | ESP_ZB_ZCL_ATTR_WINDOW_COVERING_CONFIG_REVERSE_COMMANDS
                                      : config_status & ~ESP_ZB_ZCL_ATTR_WINDOW_COVERING_CONFIG_REVERSE_COMMANDS;
       log_v("Updating window covering config status to %d", config_status);
-      esp_zb_lock_acquire(portMAX_DELAY);
+      Zigbee.lockAcquire();
       esp_zb_zcl_set_attribute_val(
         _endpoint, ESP_ZB_ZCL_CLUSTER_ID_WINDOW_COVERING, ESP_ZB_ZCL_CLUSTER_SERVER_ROLE, ESP_ZB_ZCL_ATTR_WINDOW_COVERING_CONFIG_STATUS_ID, &config_status,
         false
       );
-      esp_zb_lock_release();
+      Zigbee.lockRelease();
       return;
     }
   } else {
@@ -280,7 +280,7 @@ bool ZigbeeWindowCovering::setLiftPosition(uint16_t lift_position) {
   _current_lift_percentage = ((lift_position - _installed_open_limit_lift) * 100) / (_installed_closed_limit_lift - _installed_open_limit_lift);
   log_v("Updating window covering lift position to %d (%d%)", _current_lift_position, _current_lift_percentage);
 
-  esp_zb_lock_acquire(portMAX_DELAY);
+  Zigbee.lockAcquire();
   ret = esp_zb_zcl_set_attribute_val(
     _endpoint, ESP_ZB_ZCL_CLUSTER_ID_WINDOW_COVERING, ESP_ZB_ZCL_CLUSTER_SERVER_ROLE, ESP_ZB_ZCL_ATTR_WINDOW_COVERING_CURRENT_POSITION_LIFT_ID,
     &_current_lift_position, false
@@ -298,7 +298,7 @@ bool ZigbeeWindowCovering::setLiftPosition(uint16_t lift_position) {
     goto unlock_and_return;
   }
 unlock_and_return:
-  esp_zb_lock_release();
+  Zigbee.lockRelease();
   return ret == ESP_ZB_ZCL_STATUS_SUCCESS;
 }
 
@@ -309,7 +309,7 @@ bool ZigbeeWindowCovering::setLiftPercentage(uint8_t lift_percentage) {
   _current_lift_position = _installed_open_limit_lift + ((_installed_closed_limit_lift - _installed_open_limit_lift) * lift_percentage) / 100;
   log_v("Updating window covering lift percentage to %d%% (%d)", _current_lift_percentage, _current_lift_position);
 
-  esp_zb_lock_acquire(portMAX_DELAY);
+  Zigbee.lockAcquire();
   ret = esp_zb_zcl_set_attribute_val(
     _endpoint, ESP_ZB_ZCL_CLUSTER_ID_WINDOW_COVERING, ESP_ZB_ZCL_CLUSTER_SERVER_ROLE, ESP_ZB_ZCL_ATTR_WINDOW_COVERING_CURRENT_POSITION_LIFT_ID,
     &_current_lift_position, false
@@ -327,7 +327,7 @@ bool ZigbeeWindowCovering::setLiftPercentage(uint8_t lift_percentage) {
     goto unlock_and_return;
   }
 unlock_and_return:
-  esp_zb_lock_release();
+  Zigbee.lockRelease();
   return ret == ESP_ZB_ZCL_STATUS_SUCCESS;
 }
 
@@ -339,7 +339,7 @@ bool ZigbeeWindowCovering::setTiltPosition(uint16_t tilt_position) {
 
   log_v("Updating window covering tilt position to %d (%d%)", _current_tilt_position, _current_tilt_percentage);
 
-  esp_zb_lock_acquire(portMAX_DELAY);
+  Zigbee.lockAcquire();
   ret = esp_zb_zcl_set_attribute_val(
     _endpoint, ESP_ZB_ZCL_CLUSTER_ID_WINDOW_COVERING, ESP_ZB_ZCL_CLUSTER_SERVER_ROLE, ESP_ZB_ZCL_ATTR_WINDOW_COVERING_CURRENT_POSITION_TILT_ID,
     &_current_tilt_position, false
@@ -357,7 +357,7 @@ bool ZigbeeWindowCovering::setTiltPosition(uint16_t tilt_position) {
     goto unlock_and_return;
   }
 unlock_and_return:
-  esp_zb_lock_release();
+  Zigbee.lockRelease();
   return ret == ESP_ZB_ZCL_STATUS_SUCCESS;
 }
 
@@ -369,7 +369,7 @@ bool ZigbeeWindowCovering::setTiltPercentage(uint8_t tilt_percentage) {
 
   log_v("Updating window covering tilt percentage to %d%% (%d)", _current_tilt_percentage, _current_tilt_position);
 
-  esp_zb_lock_acquire(portMAX_DELAY);
+  Zigbee.lockAcquire();
   ret = esp_zb_zcl_set_attribute_val(
     _endpoint, ESP_ZB_ZCL_CLUSTER_ID_WINDOW_COVERING, ESP_ZB_ZCL_CLUSTER_SERVER_ROLE, ESP_ZB_ZCL_ATTR_WINDOW_COVERING_CURRENT_POSITION_TILT_ID,
     &_current_tilt_position, false
@@ -387,7 +387,7 @@ bool ZigbeeWindowCovering::setTiltPercentage(uint8_t tilt_percentage) {
     goto unlock_and_return;
   }
 unlock_and_return:
-  esp_zb_lock_release();
+  Zigbee.lockRelease();
   return ret == ESP_ZB_ZCL_STATUS_SUCCESS;
 }
 
@@ -0,0 +1,30 @@
+/*
+  Shared by the host tests. CHECK() records a failure and carries on with the next check,
+  main() ends with return hostTestResult();
+*/
+
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <stdio.h>
+
+static int host_test_failed = 0;
+
+#define CHECK(cond)                                          \
+  do {                                                       \
+    if (!(cond)) {                                           \
+      printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+      host_test_failed++;                                    \
+    }                                                        \
+  } while (0)
+
+static inline int hostTestResult() {
+  if (host_test_failed) {
+    printf("%d checks failed\n", host_test_failed);
+    return 1;
+  }
+  printf("All checks passed\n");
+  return 0;
+}
+
+#endif /* HOST_TEST_H */
@@ -0,0 +1,116 @@
+/*
+  Host test of the MJPEG fan out of the CameraWebServer example with a synthetic frame
+  source, no camera or network needed. Run with make -C tests/host
+
+  A 50 fps source feeds one fast client, one client that needs 60 ms per frame and one that
+  leaves early. Checks that every frame is encoded once whatever the number of clients, that
+  the slow client drops to the latest frame without slowing down the others, that the frame
+  data is intact and that every frame buffer is freed. Only relative rates are checked, so a
+  loaded CI runner does not fail the test.
+*/
+
+#include "host_test.h"
+#include "mjpeg_streamer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+#include <chrono>
+
+#define SOURCE_PERIOD_MS 20
+#define RUN_MS           2000
+
+static std::atomic<int> live_frames(0);
+static std::atomic<uint32_t> encoded(0);
+static void free_frame(mjpeg_frame_t *frame) {
+  free((void *)frame->buf);
+  live_frames--;
+}
+
+// every frame is filled with its own number, so clients can tell torn or freed buffers
+static bool synthetic_source(mjpeg_frame_t *frame, void *arg) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(SOURCE_PERIOD_MS));
+  uint32_t n = ++encoded;
+  size_t len = 1000 + (n % 7) * 100;
+  uint8_t *buf = (uint8_t *)malloc(len);
+  memset(buf, n & 0xff, len);
+  frame->buf = buf;
+  frame->len = len;
+  frame->timestamp_us = n;
+  frame->free_cb = free_frame;
+  live_frames++;
+  return true;
+}
+
+static void client(MjpegStreamer *streamer, int send_ms, int stay_ms, mjpeg_client_stats_t *result) {
+  int id = streamer->addClient();
+  CHECK(id >= 0);
+  auto start = std::chrono::steady_clock::now();
+  uint32_t last = 0;
+  while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(stay_ms)) {
+    mjpeg_frame_t *frame = streamer->nextFrame(id, 500);
+    if (frame == NULL) {
+      break;
+    }
+    CHECK(frame->seq > last);
+    last = frame->seq;
+    for (size_t i = 0; i < frame->len; i++) {
+      if (frame->buf[i] != (uint8_t)(frame->timestamp_us & 0xff)) {
+        CHECK(!"frame data corrupted");
+        break;
+      }
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(send_ms));
+    streamer->frameDone(id, frame, true);
+  }
+  streamer->getClientStats(id, result);
+  streamer->removeClient(id);
+}
+
+int main() {
+  MjpegStreamer streamer(synthetic_source);
+  mjpeg_producer_stats_t stats;
+
+  // no client: nothing is captured
+  CHECK(!streamer.produce(50));
+  CHECK(encoded == 0);
+
+  std::thread producer([&streamer] {
+    while (!streamer.stopped()) {
+      streamer.produce(100);
+    }
+  });
+
+  mjpeg_client_stats_t fast, slow, early;
+  std::thread c1(client, &streamer, 0, RUN_MS, &fast);
+  std::thread c2(client, &streamer, 60, RUN_MS, &slow);
+  std::thread c3(client, &streamer, 0, RUN_MS / 4, &early);
+  c1.join();
+  c2.join();
+  c3.join();
+
+  streamer.stop();
+  producer.join();
+  streamer.getStats(&stats);
+
+  printf("producer: %u frames, %.1f fps\n", stats.frames, stats.fps);
+  printf("fast:  %u sent, %u dropped, %.1f fps\n", fast.frames_sent, fast.frames_dropped, fast.fps);
+  printf("slow:  %u sent, %u dropped, %.1f fps\n", slow.frames_sent, slow.frames_dropped, slow.fps);
+  printf("early: %u sent, %u dropped, %.1f fps\n", early.frames_sent, early.frames_dropped, early.fps);
+
+  // one encode per frame, shared by all clients (the last one may be dropped when they left)
+  CHECK(stats.frames == encoded || stats.frames + 1 == encoded);
+  // the fast client keeps up with the source, the slow one does not hold it back
+  CHECK(fast.frames_sent + fast.frames_dropped + 2 >= stats.frames);
+  CHECK(fast.frames_dropped <= 2);
+  CHECK(slow.frames_dropped > 0);
+  CHECK(slow.frames_sent < fast.frames_sent);
+  CHECK(early.frames_sent > 0 && early.frames_sent < fast.frames_sent);
+  CHECK(streamer.clientCount() == 0);
+  // with the last client gone the streamer lets go of the latest frame too
+  CHECK(live_frames == 0);
+  CHECK(streamer.addClient() < 0);  // stopped
+
+  return hostTestResult();
+}
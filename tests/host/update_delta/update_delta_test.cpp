@@ -0,0 +1,207 @@
+/*
+  Host test of the delta patch decoder: old + patch -> new, no device needed.
+  Run with make -C tests/host
+
+  The patches are made by tools/ota_delta.py (python3 in the PATH) from generated images,
+  then fed to UpdateDelta in pieces of random sizes like a network stream.
+*/
+
+#include "host_test.h"
+#include "UpdateDelta.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+typedef std::vector<uint8_t> Bytes;
+
+static bool writeFile(const char *path, const Bytes &data) {
+  FILE *f = fopen(path, "wb");
+  if (!f) {
+    return false;
+  }
+  bool ok = fwrite(data.data(), 1, data.size(), f) == data.size();
+  fclose(f);
+  return ok;
+}
+
+static Bytes readFile(const char *path) {
+  Bytes data;
+  FILE *f = fopen(path, "rb");
+  if (f) {
+    uint8_t buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+      data.insert(data.end(), buf, buf + n);
+    }
+    fclose(f);
+  }
+  return data;
+}
+
+static Bytes makePatch(const Bytes &oldImage, const Bytes &newImage) {
+  if (!writeFile("delta_old.bin", oldImage) || !writeFile("delta_new.bin", newImage)) {
+    return Bytes();
+  }
+  if (system("python3 " REPO_ROOT "/tools/ota_delta.py --raw delta_old.bin delta_new.bin delta.patch > /dev/null") != 0) {
+    return Bytes();
+  }
+  return readFile("delta.patch");
+}
+
+// Applies the patch in random pieces, returns the rebuilt image
+static Bytes applyPatch(const Bytes &oldImage, const Bytes &patch, bool *finished, size_t maxPiece = 1500) {
+  Bytes out;
+  UpdateDelta delta(
+    [&](uint32_t offset, uint8_t *data, size_t len) {
+      if (offset + len > oldImage.size()) {
+        return false;
+      }
+      memcpy(data, oldImage.data() + offset, len);
+      return true;
+    },
+    [&](const uint8_t *data, size_t len) {
+      out.insert(out.end(), data, data + len);
+      return true;
+    },
+    [&](const update_delta_header_t &header) {
+      return header.old_size == oldImage.size();
+    }
+  );
+  size_t pos = 0;
+  while (pos < patch.size()) {
+    size_t n = 1 + rand() % maxPiece;
+    if (n > patch.size() - pos) {
+      n = patch.size() - pos;
+    }
+    if (!delta.write(patch.data() + pos, n)) {
+      printf("  decoder: %s\n", delta.error());
+      break;
+    }
+    pos += n;
+  }
+  *finished = delta.isFinished();
+  CHECK(!delta.isFinished() || delta.written() == delta.header().new_size);
+  return out;
+}
+
+static Bytes randomBytes(size_t len) {
+  Bytes data(len);
+  for (auto &b : data) {
+    b = rand();
+  }
+  return data;
+}
+
+// Looks like a firmware rebuild: code moves by a few bytes, pointers change by a constant
+static Bytes rebuild(const Bytes &oldImage) {
+  Bytes data = oldImage;
+  Bytes inserted = randomBytes(700);
+  data.insert(data.begin() + 5000, inserted.begin(), inserted.end());
+  for (size_t i = 20000; i + 4 <= 80000 && i + 4 <= data.size(); i += 64) {
+    data[i] += 0x20;
+  }
+  data.erase(data.begin() + 150000, data.begin() + 150400);
+  Bytes tail = randomBytes(3000);
+  data.insert(data.end(), tail.begin(), tail.end());
+  return data;
+}
+
+static void testRoundTrip() {
+  Bytes oldImage = randomBytes(120000);
+  oldImage.insert(oldImage.end(), 40000, 0xFF);
+  Bytes more = randomBytes(60000);
+  oldImage.insert(oldImage.end(), more.begin(), more.end());
+  Bytes newImage = rebuild(oldImage);
+
+  Bytes patch = makePatch(oldImage, newImage);
+  CHECK(patch.size() > UPDATE_DELTA_HEADER_SIZE);
+  // the raw patch is as long as the image, what matters is how much of it is not zero (compresses away)
+  size_t nonZero = 0;
+  for (uint8_t b : patch) {
+    nonZero += (b != 0);
+  }
+  CHECK(nonZero < newImage.size() / 20);
+  printf("patch: %u bytes, %u not zero, for a %u bytes image\n", (unsigned)patch.size(), (unsigned)nonZero, (unsigned)newImage.size());
+
+  for (size_t piece : {1, 7, 256, 4096}) {
+    bool finished = false;
+    Bytes out = applyPatch(oldImage, patch, &finished, piece);
+    CHECK(finished);
+    CHECK(out == newImage);
+  }
+}
+
+static void testSameAndUnrelated() {
+  Bytes oldImage = randomBytes(50000);
+  bool finished = false;
+  Bytes patch = makePatch(oldImage, oldImage);
+  CHECK(applyPatch(oldImage, patch, &finished) == oldImage);
+  CHECK(finished);
+
+  Bytes other = randomBytes(3000);
+  patch = makePatch(oldImage, other);
+  CHECK(applyPatch(oldImage, patch, &finished) == other);
+  CHECK(finished);
+}
+
+// new starts with a block that is not at the start of old, the first record only seeks
+static void testMovedStart() {
+  Bytes oldImage = randomBytes(5000);
+  Bytes newImage(oldImage.begin() + 1000, oldImage.begin() + 3000);
+  newImage.insert(newImage.end(), oldImage.begin(), oldImage.begin() + 1000);
+  Bytes patch = makePatch(oldImage, newImage);
+  CHECK(patch.size() > UPDATE_DELTA_HEADER_SIZE);
+  bool finished = false;
+  CHECK(applyPatch(oldImage, patch, &finished) == newImage);
+  CHECK(finished);
+}
+
+static void testBadPatches() {
+  Bytes oldImage = randomBytes(30000);
+  Bytes newImage = rebuild(oldImage);
+  newImage.resize(40000);
+  Bytes patch = makePatch(oldImage, newImage);
+  bool finished = false;
+
+  // truncated: the decoder waits for more
+  Bytes cut(patch.begin(), patch.begin() + patch.size() / 2);
+  applyPatch(oldImage, cut, &finished);
+  CHECK(!finished);
+
+  // made for another image: refused by the header callback
+  Bytes shorter(oldImage.begin(), oldImage.end() - 1);
+  CHECK(applyPatch(shorter, patch, &finished).empty());
+  CHECK(!finished);
+
+  // not a patch
+  Bytes bad = patch;
+  bad[0] = 'X';
+  CHECK(applyPatch(oldImage, bad, &finished).empty());
+  CHECK(!finished);
+
+  // first record reaching past the old image
+  bad = patch;
+  bad[UPDATE_DELTA_HEADER_SIZE + 3] = 0x7F;
+  CHECK(applyPatch(oldImage, bad, &finished).empty());
+  CHECK(!finished);
+
+  // trailing bytes after the end are left alone
+  bad = patch;
+  bad.insert(bad.end(), 100, 0xAA);
+  CHECK(applyPatch(oldImage, bad, &finished) == newImage);
+  CHECK(finished);
+}
+
+int main() {
+  srand(1234);
+  testRoundTrip();
+  testSameAndUnrelated();
+  testMovedStart();
+  testBadPatches();
+  remove("delta_old.bin");
+  remove("delta_new.bin");
+  remove("delta.patch");
+  return hostTestResult();
+}
@@ -0,0 +1,147 @@
+/*
+  Host test of the WiFiMulti AP selection with a fake scan source, no radio needed.
+  Run with make -C tests/host
+
+  The fake source holds a fixed air around the device and applies the channel and SSID
+  filters like the targeted scans of the fast connect do.
+*/
+
+#include "host_test.h"
+#include "WiFiMultiSelect.h"
+#include <stdio.h>
+#include <string.h>
+
+#define AUTH_WPA2_PSK 3
+
+class FakeScanSource : public WiFiMultiScanSource {
+public:
+  std::vector<wifi_multi_scan_result_t> air;
+  std::vector<wifi_multi_scan_result_t> results;
+  int scans = 0;
+
+  void add(const char *ssid, uint8_t last, int32_t channel, int32_t rssi, uint8_t authmode = AUTH_WPA2_PSK) {
+    wifi_multi_scan_result_t r;
+    memset(&r, 0, sizeof(r));
+    strncpy(r.ssid, ssid, sizeof(r.ssid) - 1);
+    uint8_t bssid[6] = {0x24, 0x0a, 0xc4, 0, 0, last};
+    memcpy(r.bssid, bssid, 6);
+    r.channel = channel;
+    r.rssi = rssi;
+    r.authmode = authmode;
+    air.push_back(r);
+  }
+
+  int16_t scan(bool show_hidden, uint8_t channel, const char *ssid) override {
+    scans++;
+    results.clear();
+    for (auto &r : air) {
+      if (channel && r.channel != channel) {
+        continue;
+      }
+      if (ssid && strcmp(r.ssid, ssid) != 0) {
+        continue;
+      }
+      if (!show_hidden && r.ssid[0] == 0) {
+        continue;
+      }
+      results.push_back(r);
+    }
+    return results.size();
+  }
+
+  bool result(int16_t index, wifi_multi_scan_result_t *result) override {
+    if (index < 0 || (size_t)index >= results.size()) {
+      return false;
+    }
+    *result = results[index];
+    return true;
+  }
+
+  void clear() override {
+    results.clear();
+  }
+};
+
+static std::vector<WifiAPlist_t> makeList() {
+  std::vector<WifiAPlist_t> aps;
+  aps.push_back({(char *)"home", (char *)"password1", false});
+  aps.push_back({(char *)"office", (char *)"password2", false});
+  aps.push_back({(char *)"guest", NULL, false});
+  aps.push_back({(char *)"cafe", NULL, false});
+  return aps;
+}
+
+static wifi_multi_selection_t select(FakeScanSource &source, const std::vector<WifiAPlist_t> &aps, uint8_t channel = 0, const char *ssid = NULL,
+                                     bool allowOpen = false, bool hidden = false, WiFiMultiProbeCB_t probe = NULL) {
+  wifi_multi_selection_t selection;
+  int16_t count = source.scan(hidden, channel, ssid);
+  wifiMultiSelect(source, count, aps, allowOpen, hidden, probe, &selection);
+  source.clear();
+  return selection;
+}
+
+int main() {
+  FakeScanSource source;
+  source.add("neighbour", 1, 1, -40);
+  source.add("home", 2, 6, -70);
+  source.add("home", 3, 11, -55);
+  source.add("office", 4, 6, -60);
+  source.add("guest", 5, 1, -50);  // secured, but the list has no passphrase for it
+  source.add("cafe", 7, 1, -80, 0);
+  source.add("", 6, 3, -30);
+  std::vector<WifiAPlist_t> aps = makeList();
+
+  // full scan: the strongest known AP with credentials wins
+  wifi_multi_selection_t s = select(source, aps);
+  CHECK(s.ap == 0);
+  CHECK(s.network.bssid[5] == 3 && s.network.channel == 11 && s.network.rssi == -55);
+  CHECK(s.found == 5 && s.failed == 0);
+
+  // without a passphrase only open networks qualify, unless allowOpenAP is set
+  s = select(source, aps, 0, NULL, true);
+  CHECK(s.ap == 2 && s.network.bssid[5] == 5);
+
+  // failed APs are skipped and counted
+  aps[0].hasFailed = true;
+  aps[1].hasFailed = true;
+  s = select(source, aps);
+  CHECK(s.ap == 3 && s.network.bssid[5] == 7);  // the open one is left
+  aps[1].hasFailed = false;
+  s = select(source, aps);
+  CHECK(s.ap == 1 && s.network.bssid[5] == 4);
+  CHECK(s.found == 5 && s.failed == 2);
+  aps[0].hasFailed = false;
+
+  // channel scan: only what is on the cached channel
+  s = select(source, aps, 6);
+  CHECK(s.ap == 1 && s.network.channel == 6);  // office is stronger than home on channel 6
+  s = select(source, aps, 13);
+  CHECK(s.ap == -1 && s.found == 0);
+
+  // SSID scan: all channels, only the cached SSID
+  s = select(source, aps, 0, "home");
+  CHECK(s.ap == 0 && s.network.bssid[5] == 3);
+  s = select(source, aps, 0, "missing");
+  CHECK(s.ap == -1);
+
+  // hidden network: probed with the credentials of every AP that has not failed
+  int probes = 0;
+  s = select(source, aps, 3, NULL, false, true, [&probes](const WifiAPlist_t &ap, const wifi_multi_scan_result_t &network) {
+    probes++;
+    return strcmp(ap.ssid, "office") == 0;
+  });
+  CHECK(probes == 2);
+  CHECK(s.ap == 1 && s.network.bssid[5] == 6 && strcmp(s.network.ssid, "office") == 0);
+  // without a probe hidden networks never match
+  s = select(source, aps, 3, NULL, false, true, NULL);
+  CHECK(s.ap == -1);
+
+  // nothing on air
+  FakeScanSource empty;
+  s = select(empty, aps);
+  CHECK(s.ap == -1 && s.found == 0 && s.failed == 0);
+
+  CHECK(source.scans == 10);
+
+  return hostTestResult();
+}
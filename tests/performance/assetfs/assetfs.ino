@@ -0,0 +1,225 @@
+/*
+  AssetFS serving test.
+  Serves the same set of files from LittleFS and from a memory mapped AssetFS image into a sink
+  that copies like a TCP send buffer, and reports MB/s and the time per request. The image is
+  built on the device and written to the inactive OTA partition, so the default partition
+  scheme works without extra flashing.
+*/
+
+#include <Arduino.h>
+#include <FS.h>
+#include <LittleFS.h>
+#include <AssetFS.h>
+#include <esp_ota_ops.h>
+#include <esp_partition.h>
+
+// Number of runs to average
+#define N_RUNS 3
+
+// Files served, their sizes cycle through FILE_SIZES
+#define N_FILES  16
+#define REQUESTS 128
+
+// Read size of WebServer::streamFile() through NetworkClient
+#define STREAM_CHUNK 1360
+#define SINK_CHUNK   1436
+
+static const size_t FILE_SIZES[] = {512, 2048, 8192, 32768};
+
+// Takes the data the way the TCP stack does, one segment worth at a time
+class SinkPrint : public Print {
+public:
+  size_t write(uint8_t c) override {
+    return write(&c, 1);
+  }
+  size_t write(const uint8_t *buffer, size_t size) override {
+    size_t left = size;
+    while (left) {
+      size_t n = left < SINK_CHUNK ? left : SINK_CHUNK;
+      memcpy(segment, buffer, n);
+      buffer += n;
+      left -= n;
+    }
+    bytes += size;
+    return size;
+  }
+  uint8_t segment[SINK_CHUNK];
+  uint64_t bytes = 0;
+};
+
+static char paths[N_FILES][24];
+static size_t sizes[N_FILES];
+
+static size_t fileSize(int i) {
+  return FILE_SIZES[i % (sizeof(FILE_SIZES) / sizeof(FILE_SIZES[0]))];
+}
+
+static void fillRandom(uint8_t *buf, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    buf[i] = esp_random();
+  }
+}
+
+static bool prepareLittleFS(uint8_t *buf) {
+  if (!LittleFS.begin(true)) {
+    Serial.println("LittleFS mount failed");
+    return false;
+  }
+  LittleFS.mkdir("/bench");
+  for (int i = 0; i < N_FILES; i++) {
+    File f = LittleFS.open(paths[i], FILE_WRITE);
+    if (!f) {
+      return false;
+    }
+    fillRandom(buf, sizes[i]);
+    if (f.write(buf, sizes[i]) != sizes[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Same layout as tools/asset_packer.py writes: header, entries, strings, 4 byte aligned data
+static bool prepareAssetFS(uint8_t *buf) {
+  const esp_partition_t *partition = esp_ota_get_next_update_partition(NULL);
+  if (partition == NULL) {
+    Serial.println("No OTA partition for the asset image");
+    return false;
+  }
+  static const char mime[] = "application/octet-stream";
+  static const char etag[] = "\"bench\"";
+  size_t stringsOffset = sizeof(asset_image_header_t) + N_FILES * sizeof(asset_entry_t);
+  size_t dataOffset = stringsOffset;
+  for (int i = 0; i < N_FILES; i++) {
+    dataOffset += strlen(paths[i]) + 1;
+  }
+  size_t etagOffset = dataOffset;
+  size_t mimeOffset = etagOffset + sizeof(etag);
+  dataOffset = (mimeOffset + sizeof(mime) + 3) & ~3;
+
+  size_t imageSize = dataOffset;
+  for (int i = 0; i < N_FILES; i++) {
+    imageSize += sizes[i];
+  }
+  if (imageSize > partition->size) {
+    Serial.println("Asset image does not fit the OTA partition");
+    return false;
+  }
+  if (esp_partition_erase_range(partition, 0, (imageSize + 4095) & ~4095) != ESP_OK) {
+    return false;
+  }
+
+  // the index fits the buffer, the file data goes straight to flash
+  memset(buf, 0, dataOffset);
+  asset_image_header_t *header = (asset_image_header_t *)buf;
+  header->magic = ASSET_IMAGE_MAGIC;
+  header->version = ASSET_IMAGE_VERSION;
+  header->entry_size = sizeof(asset_entry_t);
+  header->count = N_FILES;
+  header->entries_offset = sizeof(asset_image_header_t);
+  header->image_size = imageSize;
+  asset_entry_t *entries = (asset_entry_t *)(buf + header->entries_offset);
+  size_t stringPos = stringsOffset;
+  size_t dataPos = dataOffset;
+  for (int i = 0; i < N_FILES; i++) {
+    size_t len = strlen(paths[i]);
+    memcpy(buf + stringPos, paths[i], len + 1);
+    entries[i].path_offset = stringPos;
+    entries[i].path_len = len;
+    entries[i].etag_offset = etagOffset;
+    entries[i].etag_len = sizeof(etag) - 1;
+    entries[i].mime_offset = mimeOffset;
+    entries[i].mime_len = sizeof(mime) - 1;
+    entries[i].data_offset = dataPos;
+    entries[i].size = sizes[i];
+    entries[i].original_size = sizes[i];
+    stringPos += len + 1;
+    dataPos += sizes[i];
+  }
+  memcpy(buf + etagOffset, etag, sizeof(etag));
+  memcpy(buf + mimeOffset, mime, sizeof(mime));
+  if (esp_partition_write(partition, 0, buf, dataOffset) != ESP_OK) {
+    return false;
+  }
+  for (int i = 0; i < N_FILES; i++) {
+    uint8_t *data = buf + dataOffset;
+    fillRandom(data, sizes[i]);
+    if (esp_partition_write(partition, entries[i].data_offset, data, sizes[i]) != ESP_OK) {
+      return false;
+    }
+  }
+  return AssetFS.begin(partition);
+}
+
+static void report(const char *name, SinkPrint &sink, uint32_t elapsed) {
+  Serial.printf("%s: %.2f MB/s, %.1f us/request\n", name, (float)sink.bytes / elapsed, (float)elapsed / REQUESTS);
+}
+
+// What serveStatic() does: open the file and stream it through a buffer
+static void serveFile(fs::FS &fs, const char *name, uint8_t *buf) {
+  SinkPrint sink;
+  uint32_t start = micros();
+  for (int r = 0; r < REQUESTS; r++) {
+    File f = fs.open(paths[r % N_FILES], "r");
+    size_t n;
+    while ((n = f.read(buf, STREAM_CHUNK)) > 0) {
+      sink.write(buf, n);
+    }
+  }
+  report(name, sink, micros() - start);
+}
+
+// What AssetRequestHandler does: look the entry up and send from the mapped flash
+static void serveDirect() {
+  SinkPrint sink;
+  uint32_t start = micros();
+  for (int r = 0; r < REQUESTS; r++) {
+    const asset_entry_t *entry = AssetFS.find(paths[r % N_FILES]);
+    if (entry != NULL) {
+      sink.write(AssetFS.data(entry), entry->size);
+    }
+  }
+  report("AssetFS direct", sink, micros() - start);
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {
+    delay(10);
+  }
+
+  uint8_t *buf = (uint8_t *)malloc(40 * 1024);
+  if (!buf) {
+    Serial.println("Failed to allocate buffer");
+    return;
+  }
+  for (int i = 0; i < N_FILES; i++) {
+    snprintf(paths[i], sizeof(paths[i]), "/bench/f%02d.bin", i);
+    sizes[i] = fileSize(i);
+  }
+  if (!prepareLittleFS(buf) || !prepareAssetFS(buf)) {
+    Serial.println("Failed to prepare the files");
+    free(buf);
+    return;
+  }
+
+  Serial.printf("Runs: %d\n", N_RUNS);
+  Serial.flush();
+
+  for (int i = 0; i < N_RUNS; i++) {
+    Serial.printf("Run %d\n", i);
+    serveFile(LittleFS, "LittleFS", buf);
+    serveFile(AssetFS, "AssetFS file", buf);
+    serveDirect();
+    Serial.flush();
+  }
+
+  AssetFS.end();
+  LittleFS.end();
+  free(buf);
+  log_d("AssetFS test done");
+}
+
+void loop() {
+  vTaskDelete(NULL);
+}
@@ -0,0 +1,59 @@
+import json
+import logging
+import os
+
+from collections import defaultdict
+
+TESTS = ["LittleFS", "AssetFS file", "AssetFS direct"]
+
+
+def test_assetfs(dut, request):
+    LOGGER = logging.getLogger(__name__)
+
+    # Match "Runs: %d"
+    res = dut.expect(r"Runs: (\d+)", timeout=120)
+    runs = int(res.group(1))
+    LOGGER.info("Number of runs: {}".format(runs))
+    assert runs > 0, "Invalid number of runs"
+
+    rates = defaultdict(list)
+    latencies = defaultdict(list)
+
+    for i in range(runs):
+        # Match "Run %d"
+        res = dut.expect(r"Run (\d+)", timeout=60)
+        run = int(res.group(1))
+        LOGGER.info("Run {}".format(run))
+        assert run == i, "Invalid run number"
+
+        for name in TESTS:
+            # Match "<name>: %.2f MB/s, %.1f us/request"
+            res = dut.expect(r"{}: (\d+\.\d+) MB/s, (\d+\.\d+) us/request".format(name), timeout=120)
+            rate = float(res.group(1))
+            latency = float(res.group(2))
+            LOGGER.info("{}: {} MB/s, {} us/request".format(name, rate, latency))
+            assert rate > 0, "Invalid rate"
+            rates[name].append(rate)
+            latencies[name].append(latency)
+
+    results = {"assetfs": {"runs": runs}}
+    for name in TESTS:
+        key = name.lower().replace(" ", "_")
+        results["assetfs"][key + "_mbps"] = round(sum(rates[name]) / len(rates[name]), 2)
+        results["assetfs"][key + "_us_per_request"] = round(sum(latencies[name]) / len(latencies[name]), 1)
+
+    # Create JSON with results and write it to file
+    # Always create a JSON with this format (so it can be merged later on):
+    # { TEST_NAME_STR: TEST_RESULTS_DICT }
+    current_folder = os.path.dirname(request.path)
+    file_index = 0
+    report_file = os.path.join(current_folder, "result_assetfs" + str(file_index) + ".json")
+    while os.path.exists(report_file):
+        report_file = report_file.replace(str(file_index) + ".json", str(file_index + 1) + ".json")
+        file_index += 1
+
+    with open(report_file, "w") as f:
+        try:
+            f.write(json.dumps(results))
+        except Exception as e:
+            LOGGER.warning("Failed to write results to file: {}".format(e))
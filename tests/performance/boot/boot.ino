@@ -0,0 +1,89 @@
+/* Boot time
+ * Measures the time from app_main() to setup() after a cold boot and after a deep sleep wake up,
+ * once with NVS initialized at boot and once with NVS deferred to first use.
+ * The boots follow each other on their own, the state is kept in RTC memory.
+ * The cold boots after the first one are software resets.
+ */
+
+#include <Arduino.h>
+#include "esp_sleep.h"
+
+#define RUNS       3
+#define BOOT_MAGIC 0xB007B007
+
+enum {
+  BOOT_COLD,
+  BOOT_WAKE,
+  BOOT_COLD_DEFERRED,
+  BOOT_WAKE_DEFERRED,
+  BOOT_KINDS
+};
+
+static const char *boot_names[BOOT_KINDS] = {"Cold", "Wake", "Cold deferred", "Wake deferred"};
+
+RTC_NOINIT_ATTR static uint32_t magic;
+RTC_NOINIT_ATTR static uint32_t step;  // run * BOOT_KINDS + kind of the current boot
+RTC_NOINIT_ATTR static uint32_t boot_us[RUNS][BOOT_KINDS];
+RTC_NOINIT_ATTR static uint32_t nvs_us[RUNS][BOOT_KINDS];
+
+// Called from initArduino(), before setup()
+bool deferNvsInit() {
+  return magic == BOOT_MAGIC && (step % BOOT_KINDS) >= BOOT_COLD_DEFERRED;
+}
+
+void setup() {
+  uint32_t setup_us = bootProfileTime("setup start");
+
+  if (magic != BOOT_MAGIC || step >= RUNS * BOOT_KINDS) {
+    // power on: this boot did not defer NVS, so it is the first cold boot
+    magic = BOOT_MAGIC;
+    step = 0;
+  }
+  uint32_t run = step / BOOT_KINDS;
+  uint32_t kind = step % BOOT_KINDS;
+  boot_us[run][kind] = setup_us;
+
+  // NVS cost: the boot phase when done at boot, the first call when deferred
+  if (kind >= BOOT_COLD_DEFERRED) {
+    uint32_t start = micros();
+    initNvs();
+    nvs_us[run][kind] = micros() - start;
+  } else {
+    boot_phase_t phase;
+    nvs_us[run][kind] = 0;
+    for (size_t i = 0; bootProfileGet(i, &phase); i++) {
+      if (strcmp(phase.name, "nvs") == 0) {
+        nvs_us[run][kind] = phase.duration_us;
+      }
+    }
+  }
+
+  step++;
+  if (step < RUNS * BOOT_KINDS) {
+    uint32_t next = step % BOOT_KINDS;
+    if (next == BOOT_WAKE || next == BOOT_WAKE_DEFERRED) {
+      esp_sleep_enable_timer_wakeup(100000);
+      esp_deep_sleep_start();
+    }
+    esp_restart();
+  }
+
+  Serial.begin(115200);
+  while (!Serial) {
+    delay(10);
+  }
+  printBootProfile(Serial);
+
+  Serial.printf("Runs: %d\n", RUNS);
+  for (int i = 0; i < RUNS; i++) {
+    Serial.printf("Run %d\n", i);
+    for (int k = 0; k < BOOT_KINDS; k++) {
+      Serial.printf("%s boot: %lu us, NVS %lu us\n", boot_names[k], boot_us[i][k], nvs_us[i][k]);
+    }
+  }
+  Serial.flush();
+}
+
+void loop() {
+  vTaskDelete(NULL);
+}
@@ -0,0 +1,59 @@
+import json
+import logging
+import os
+
+from collections import defaultdict
+
+BOOTS = ["Cold", "Wake", "Cold deferred", "Wake deferred"]
+
+
+def test_boot(dut, request):
+    LOGGER = logging.getLogger(__name__)
+
+    # Match "Runs: %d"
+    res = dut.expect(r"Runs: (\d+)", timeout=120)
+    runs = int(res.group(1))
+    LOGGER.info("Number of runs: {}".format(runs))
+    assert runs > 0, "Invalid number of runs"
+
+    boot_times = defaultdict(list)
+    nvs_times = defaultdict(list)
+
+    for i in range(runs):
+        # Match "Run %d"
+        res = dut.expect(r"Run (\d+)", timeout=60)
+        run = int(res.group(1))
+        LOGGER.info("Run {}".format(run))
+        assert run == i, "Invalid run number"
+
+        for name in BOOTS:
+            # Match "<name> boot: %lu us, NVS %lu us"
+            res = dut.expect(r"{} boot: (\d+) us, NVS (\d+) us".format(name), timeout=60)
+            boot_us = int(res.group(1))
+            nvs_us = int(res.group(2))
+            LOGGER.info("{} boot: {} us, NVS {} us".format(name, boot_us, nvs_us))
+            assert boot_us > 0, "Invalid boot time"
+            boot_times[name].append(boot_us)
+            nvs_times[name].append(nvs_us)
+
+    results = {"boot": {"runs": runs}}
+    for name in BOOTS:
+        key = name.lower().replace(" ", "_")
+        results["boot"][key + "_us"] = round(sum(boot_times[name]) / runs)
+        results["boot"][key + "_nvs_us"] = round(sum(nvs_times[name]) / runs)
+
+    # Create JSON with results and write it to file
+    # Always create a JSON with this format (so it can be merged later on):
+    # { TEST_NAME_STR: TEST_RESULTS_DICT }
+    current_folder = os.path.dirname(request.path)
+    file_index = 0
+    report_file = os.path.join(current_folder, "result_boot" + str(file_index) + ".json")
+    while os.path.exists(report_file):
+        report_file = report_file.replace(str(file_index) + ".json", str(file_index + 1) + ".json")
+        file_index += 1
+
+    with open(report_file, "w") as f:
+        try:
+            f.write(json.dumps(results))
+        except Exception as e:
+            LOGGER.warning("Failed to write results to file: {}".format(e))
@@ -0,0 +1,110 @@
+/*
+  DNSServer query rate test.
+  A load generator task sends A queries to the server over the lwIP loopback interface
+  and counts the answers, keeping a fixed number of queries in flight.
+*/
+
+#include <Arduino.h>
+#include <Network.h>
+#include <DNSServer.h>
+#include "lwip/sockets.h"
+
+// Number of runs to average
+#define N_RUNS 3
+
+// Duration of each run in milliseconds
+#define RUN_TIME_MS 5000
+
+// Queries in flight
+#define WINDOW 8
+
+#define DNS_PORT 5353
+
+DNSServer dnsServer;
+
+static size_t buildQuery(uint8_t *buf, uint16_t id, const char *name) {
+  const uint8_t header[] = {(uint8_t)(id >> 8), (uint8_t)id, 0x01, 0x00, 0, 1, 0, 0, 0, 0, 0, 0};
+  memcpy(buf, header, sizeof(header));
+  size_t len = sizeof(header);
+  const char *label = name;
+  while (*label) {
+    const char *dot = strchr(label, '.');
+    size_t l = dot ? dot - label : strlen(label);
+    buf[len++] = l;
+    memcpy(buf + len, label, l);
+    len += l;
+    label += l;
+    if (*label) {
+      label++;
+    }
+  }
+  buf[len++] = 0;
+  const uint8_t tail[] = {0, 1, 0, 1};  // type A, class IN
+  memcpy(buf + len, tail, sizeof(tail));
+  return len + sizeof(tail);
+}
+
+static void runLoad(const char *name, uint32_t *queries, uint32_t *answers) {
+  int sock = socket(AF_INET, SOCK_DGRAM, 0);
+  struct sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(DNS_PORT);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  struct timeval tv = {0, 100000};
+  setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+  uint8_t query[64];
+  uint8_t reply[128];
+  uint16_t id = 0;
+  *queries = 0;
+  *answers = 0;
+  unsigned long start = millis();
+  while (millis() - start < RUN_TIME_MS) {
+    for (int i = 0; i < WINDOW; i++) {
+      size_t len = buildQuery(query, id++, name);
+      if (sendto(sock, query, len, 0, (struct sockaddr *)&addr, sizeof(addr)) == (int)len) {
+        (*queries)++;
+      }
+    }
+    for (int i = 0; i < WINDOW; i++) {
+      int len = recv(sock, reply, sizeof(reply), 0);
+      if (len < 0) {
+        break;
+      }
+      // answer count must be 1 and the last 4 bytes must hold the address
+      if (len > 16 && reply[7] == 1 && reply[len - 1] == 1) {
+        (*answers)++;
+      }
+    }
+  }
+  close(sock);
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {
+    delay(10);
+  }
+
+  Network.begin();
+  dnsServer.addRecord("esp32.local", IPAddress(192, 168, 4, 1));
+  dnsServer.start(DNS_PORT, "*", IPAddress(10, 0, 0, 1));
+
+  Serial.printf("Runs: %d\n", N_RUNS);
+  Serial.printf("Window: %d\n", WINDOW);
+  Serial.flush();
+  for (int i = 0; i < N_RUNS; i++) {
+    uint32_t queries, answers;
+    Serial.printf("Run %d\n", i);
+    runLoad("esp32.local", &queries, &answers);
+    Serial.printf("Queries: %lu Answers: %lu\n", queries, answers);
+    Serial.printf("Rate: %lu q/s\n", answers * 1000 / RUN_TIME_MS);
+    Serial.flush();
+  }
+
+  log_d("DNSServer test done");
+}
+
+void loop() {
+  vTaskDelete(NULL);
+}
@@ -0,0 +1,61 @@
+import json
+import logging
+import os
+
+
+def test_dnsserver(dut, request):
+    LOGGER = logging.getLogger(__name__)
+
+    # Match "Runs: %d"
+    res = dut.expect(r"Runs: (\d+)", timeout=60)
+    runs = int(res.group(0).decode("utf-8").split(" ")[1])
+    LOGGER.info("Number of runs: {}".format(runs))
+    assert runs > 0, "Invalid number of runs"
+
+    # Match "Window: %d"
+    res = dut.expect(r"Window: (\d+)", timeout=60)
+    window = int(res.group(0).decode("utf-8").split(" ")[1])
+    LOGGER.info("Queries in flight: {}".format(window))
+
+    list_rate = []
+
+    for i in range(runs):
+        # Match "Run %d"
+        res = dut.expect(r"Run (\d+)", timeout=60)
+        run = int(res.group(0).decode("utf-8").split(" ")[1])
+        LOGGER.info("Run {}".format(run))
+        assert run == i, "Invalid run number"
+
+        # Match "Queries: %lu Answers: %lu"
+        res = dut.expect(r"Queries: (\d+) Answers: (\d+)", timeout=60)
+        queries = int(res.group(1))
+        answers = int(res.group(2))
+        LOGGER.info("Queries: {} Answers: {}".format(queries, answers))
+        assert answers > 0, "No answers received"
+        assert answers <= queries, "Invalid number of answers"
+
+        # Match "Rate: %lu q/s"
+        res = dut.expect(r"Rate: (\d+) q/s", timeout=60)
+        rate = int(res.group(1))
+        LOGGER.info("Rate on run {}: {} q/s".format(i, rate))
+        list_rate.append(rate)
+
+    avg_rate = round(sum(list_rate) / len(list_rate))
+
+    # Create JSON with results and write it to file
+    # Always create a JSON with this format (so it can be merged later on):
+    # { TEST_NAME_STR: TEST_RESULTS_DICT }
+    results = {"dnsserver": {"runs": runs, "window": window, "avg_rate": avg_rate}}
+
+    current_folder = os.path.dirname(request.path)
+    file_index = 0
+    report_file = os.path.join(current_folder, "result_dnsserver" + str(file_index) + ".json")
+    while os.path.exists(report_file):
+        report_file = report_file.replace(str(file_index) + ".json", str(file_index + 1) + ".json")
+        file_index += 1
+
+    with open(report_file, "w") as f:
+        try:
+            f.write(json.dumps(results))
+        except Exception as e:
+            LOGGER.warning("Failed to write results to file: {}".format(e))
@@ -0,0 +1,113 @@
+/*
+  GPIO toggle rate test.
+  Toggles a pin with digitalWrite() and with a GPIOBundle, then shifts a buffer out with
+  shiftOut() (three digitalWrite() per bit), with shiftOutFast() and with
+  GPIOBundle::shiftOut(). Reports the toggle rate and the shift throughput of each.
+  Nothing needs to be connected to the pins.
+*/
+
+#include <Arduino.h>
+
+// Number of runs to average
+#define N_RUNS 5
+
+#define TOGGLES     200000
+#define SHIFT_BYTES 4096
+
+#define DATA_PIN  4
+#define CLOCK_PIN 5
+
+static uint8_t buf[SHIFT_BYTES];
+
+static void report(const char *method, uint32_t elapsed_us, uint32_t toggles, uint32_t bytes) {
+  float khz = elapsed_us ? (float)toggles * 1000.0f / elapsed_us : 0;
+  float kbps = elapsed_us ? (float)bytes * 1000000.0f / 1024.0f / elapsed_us : 0;
+  Serial.printf("Method: %s Time: %lu us\n", method, elapsed_us);
+  Serial.printf("Toggle rate: %.1f kHz Shift rate: %.1f KB/s\n", khz, kbps);
+}
+
+static uint32_t timeDigitalWrite() {
+  pinMode(CLOCK_PIN, OUTPUT);
+  uint32_t start = micros();
+  for (uint32_t i = 0; i < TOGGLES / 2; i++) {
+    digitalWrite(CLOCK_PIN, HIGH);
+    digitalWrite(CLOCK_PIN, LOW);
+  }
+  return micros() - start;
+}
+
+static uint32_t timeBundle() {
+  const uint8_t pins[] = {CLOCK_PIN};
+  GPIOBundle bundle;
+  if (!bundle.begin(pins, 1, OUTPUT)) {
+    Serial.println("Bundle begin failed");
+    return 0;
+  }
+  uint32_t start = micros();
+  for (uint32_t i = 0; i < TOGGLES / 2; i++) {
+    bundle.set(1);
+    bundle.clear(1);
+  }
+  uint32_t elapsed = micros() - start;
+  bundle.end();
+  return elapsed;
+}
+
+static uint32_t timeShiftOut(bool fast) {
+  pinMode(DATA_PIN, OUTPUT);
+  pinMode(CLOCK_PIN, OUTPUT);
+  uint32_t start = micros();
+  for (size_t n = 0; n < SHIFT_BYTES; n++) {
+    if (fast) {
+      shiftOutFast(DATA_PIN, CLOCK_PIN, MSBFIRST, buf[n]);
+    } else {
+      shiftOut(DATA_PIN, CLOCK_PIN, MSBFIRST, buf[n]);
+    }
+  }
+  return micros() - start;
+}
+
+static uint32_t timeBundleShiftOut() {
+  const uint8_t pins[] = {DATA_PIN, CLOCK_PIN};
+  GPIOBundle bundle;
+  if (!bundle.begin(pins, 2, OUTPUT)) {
+    Serial.println("Bundle begin failed");
+    return 0;
+  }
+  uint32_t start = micros();
+  bundle.shiftOut(0, 1, MSBFIRST, buf, SHIFT_BYTES);
+  uint32_t elapsed = micros() - start;
+  bundle.end();
+  return elapsed;
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {
+    delay(10);
+  }
+
+  for (size_t i = 0; i < SHIFT_BYTES; i++) {
+    buf[i] = (uint8_t)(i * 37);
+  }
+
+  log_d("Starting GPIO toggle rate test");
+
+  Serial.printf("Runs: %d\n", N_RUNS);
+  Serial.printf("Toggles: %d Shift bytes: %d\n", TOGGLES, SHIFT_BYTES);
+
+  for (int i = 0; i < N_RUNS; i++) {
+    Serial.printf("Run %d\n", i);
+    report("digitalWrite", timeDigitalWrite(), TOGGLES, 0);
+    report("bundle", timeBundle(), TOGGLES, 0);
+    report("shiftOut", timeShiftOut(false), SHIFT_BYTES * 16, SHIFT_BYTES);
+    report("shiftOutFast", timeShiftOut(true), SHIFT_BYTES * 16, SHIFT_BYTES);
+    report("bundle_shiftOut", timeBundleShiftOut(), SHIFT_BYTES * 16, SHIFT_BYTES);
+  }
+
+  log_d("GPIO toggle rate test done");
+}
+
+void loop() {
+  vTaskDelete(NULL);
+}
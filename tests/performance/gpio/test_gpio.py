@@ -0,0 +1,67 @@
+import json
+import logging
+import os
+
+
+def test_gpio(dut, request):
+    LOGGER = logging.getLogger(__name__)
+
+    # Match "Runs: %d"
+    res = dut.expect(r"Runs: (\d+)", timeout=60)
+    runs = int(res.group(0).decode("utf-8").split(" ")[1])
+    LOGGER.info("Number of runs: {}".format(runs))
+    assert runs > 0, "Invalid number of runs"
+
+    # Match "Toggles: %d Shift bytes: %d"
+    res = dut.expect(r"Toggles: (\d+) Shift bytes: (\d+)", timeout=60)
+    toggles = int(res.group(1))
+    shift_bytes = int(res.group(2))
+    LOGGER.info("Toggles: {} Shift bytes: {}".format(toggles, shift_bytes))
+
+    methods = ["digitalWrite", "bundle", "shiftOut", "shiftOutFast", "bundle_shiftOut"]
+    list_khz = {method: [] for method in methods}
+    list_kbps = {method: [] for method in methods}
+
+    for i in range(runs):
+        # Match "Run %d"
+        res = dut.expect(r"Run (\d+)", timeout=60)
+        run = int(res.group(0).decode("utf-8").split(" ")[1])
+        LOGGER.info("Run {}".format(run))
+        assert run == i, "Invalid run number"
+
+        for method in methods:
+            # Match "Method: %s Time: %lu us"
+            res = dut.expect(r"Method: (\w+) Time: (\d+) us", timeout=60)
+            assert res.group(1).decode("utf-8") == method, "Invalid method"
+            assert int(res.group(2)) > 0, "Invalid time"
+
+            # Match "Toggle rate: %.1f kHz Shift rate: %.1f KB/s"
+            res = dut.expect(r"Toggle rate: (\d+\.\d) kHz Shift rate: (\d+\.\d) KB/s", timeout=60)
+            khz = float(res.group(1))
+            kbps = float(res.group(2))
+            LOGGER.info("{} on run {}: {} kHz, {} KB/s".format(method, i, khz, kbps))
+            list_khz[method].append(khz)
+            list_kbps[method].append(kbps)
+
+    # Create JSON with results and write it to file
+    # Always create a JSON with this format (so it can be merged later on):
+    # { TEST_NAME_STR: TEST_RESULTS_DICT }
+    results = {"gpio": {"runs": runs, "toggles": toggles, "shift_bytes": shift_bytes}}
+    for method in methods:
+        results["gpio"][method] = {
+            "avg_toggle_khz": round(sum(list_khz[method]) / runs, 1),
+            "avg_shift_kbps": round(sum(list_kbps[method]) / runs, 1),
+        }
+
+    current_folder = os.path.dirname(request.path)
+    file_index = 0
+    report_file = os.path.join(current_folder, "result_gpio" + str(file_index) + ".json")
+    while os.path.exists(report_file):
+        report_file = report_file.replace(str(file_index) + ".json", str(file_index + 1) + ".json")
+        file_index += 1
+
+    with open(report_file, "w") as f:
+        try:
+            f.write(json.dumps(results))
+        except Exception as e:
+            LOGGER.warning("Failed to write results to file: {}".format(e))
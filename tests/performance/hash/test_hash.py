@@ -0,0 +1,66 @@
+import json
+import logging
+import os
+
+from collections import defaultdict
+
+TESTS = ["MD5", "SHA1 software", "SHA1 accelerated", "SHA256", "SHA512"]
+
+
+def test_hash(dut, request):
+    LOGGER = logging.getLogger(__name__)
+
+    # Match "Runs: %d"
+    res = dut.expect(r"Runs: (\d+)", timeout=60)
+    runs = int(res.group(1))
+    LOGGER.info("Number of runs: {}".format(runs))
+    assert runs > 0, "Invalid number of runs"
+
+    rates = defaultdict(list)
+
+    for i in range(runs):
+        # Match "Run %d"
+        res = dut.expect(r"Run (\d+)", timeout=60)
+        run = int(res.group(1))
+        LOGGER.info("Run {}".format(run))
+        assert run == i, "Invalid run number"
+
+        for name in TESTS:
+            # Match "<name>: %.2f MB/s"
+            res = dut.expect(r"{}: (\d+\.\d+) MB/s".format(name), timeout=120)
+            rate = float(res.group(1))
+            LOGGER.info("{}: {} MB/s".format(name, rate))
+            assert rate > 0, "Invalid rate"
+            rates[name].append(rate)
+
+        # Match "SHA1 match: %d"
+        res = dut.expect(r"SHA1 match: (\d)", timeout=60)
+        assert int(res.group(1)) == 1, "SHA1 implementations differ"
+
+        # Match "SHA256 partition: %.2f MB/s"
+        res = dut.expect(r"SHA256 partition: (\d+\.\d+) MB/s", timeout=120)
+        rate = float(res.group(1))
+        LOGGER.info("SHA256 partition: {} MB/s".format(rate))
+        assert rate > 0, "Invalid rate"
+        rates["SHA256 partition"].append(rate)
+
+    results = {"hash": {"runs": runs}}
+    for name, values in rates.items():
+        key = name.lower().replace(" ", "_") + "_mbps"
+        results["hash"][key] = round(sum(values) / len(values), 2)
+
+    # Create JSON with results and write it to file
+    # Always create a JSON with this format (so it can be merged later on):
+    # { TEST_NAME_STR: TEST_RESULTS_DICT }
+    current_folder = os.path.dirname(request.path)
+    file_index = 0
+    report_file = os.path.join(current_folder, "result_hash" + str(file_index) + ".json")
+    while os.path.exists(report_file):
+        report_file = report_file.replace(str(file_index) + ".json", str(file_index + 1) + ".json")
+        file_index += 1
+
+    with open(report_file, "w") as f:
+        try:
+            f.write(json.dumps(results))
+        except Exception as e:
+            LOGGER.warning("Failed to write results to file: {}".format(e))
@@ -0,0 +1,180 @@
+/*
+  HTTPClient::writeToStream() throughput test.
+  A server task on the lwIP loopback interface sends a body of BODY_SIZE bytes. The client
+  writes it to a sink stream that either takes the data at once (fast) or behaves like a storage
+  write at SLOW_SINK_KBPS, blocking the caller like an SD card or flash write does (slow).
+  Each sink is run with the default writeToStream() and with setPipelined(true), where a reader
+  task fills one buffer while the sink writes the other. Reports the rate in MB/s and checks
+  every byte of the body.
+*/
+
+#include <Arduino.h>
+#include <Network.h>
+#include <HTTPClient.h>
+
+// Number of runs to average
+#define N_RUNS 3
+
+#define BODY_SIZE (2 * 1024 * 1024)
+
+// Simulated storage write speed
+#define SLOW_SINK_KBPS 1024
+
+#define SERVER_PORT 8080
+
+enum {
+  MODE_DIRECT,
+  MODE_PIPELINED,
+  MODE_MAX
+};
+
+static const char *mode_names[] = {"direct", "pipelined"};
+static const char *sink_names[] = {"fast", "slow"};
+
+static uint8_t patternByte(uint32_t offset) {
+  return (uint8_t)(offset * 7 + (offset >> 8));
+}
+
+class TestSink : public Stream {
+public:
+  TestSink(uint32_t kbps) : _kbps(kbps), _offset(0), _errors(0), _debt_us(0) {}
+
+  size_t write(const uint8_t *buf, size_t size) override {
+    for (size_t i = 0; i < size; i++) {
+      if (buf[i] != patternByte(_offset + i)) {
+        _errors++;
+      }
+    }
+    _offset += size;
+    if (_kbps) {
+      // sleep like a task waiting for the storage to finish
+      _debt_us += (uint64_t)size * 1000000 / (_kbps * 1024);
+      if (_debt_us >= 1000) {
+        delay(_debt_us / 1000);
+        _debt_us %= 1000;
+      }
+    }
+    return size;
+  }
+  size_t write(uint8_t c) override {
+    return write(&c, 1);
+  }
+  int available() override {
+    return 0;
+  }
+  int read() override {
+    return -1;
+  }
+  int peek() override {
+    return -1;
+  }
+
+  uint32_t received() const {
+    return _offset;
+  }
+  uint32_t errors() const {
+    return _errors;
+  }
+
+private:
+  uint32_t _kbps;
+  uint32_t _offset;
+  uint32_t _errors;
+  uint64_t _debt_us;
+};
+
+static void serve(NetworkClient &client) {
+  // skip the request
+  unsigned long start = millis();
+  while (client.connected() && millis() - start < 2000) {
+    String line = client.readStringUntil('\n');
+    line.trim();
+    if (!line.length()) {
+      break;
+    }
+  }
+  client.printf("HTTP/1.1 200 OK\r\nContent-Length: %d\r\nConnection: close\r\n\r\n", BODY_SIZE);
+  static uint8_t buf[1460];
+  uint32_t sent = 0;
+  while (sent < BODY_SIZE && client.connected()) {
+    size_t n = min((uint32_t)sizeof(buf), (uint32_t)(BODY_SIZE - sent));
+    for (size_t i = 0; i < n; i++) {
+      buf[i] = patternByte(sent + i);
+    }
+    size_t w = 0;
+    while (w < n && client.connected()) {
+      w += client.write(buf + w, n - w);
+    }
+    sent += w;
+  }
+  client.stop();
+}
+
+static void serverTask(void *arg) {
+  NetworkServer server(SERVER_PORT);
+  server.begin();
+  while (true) {
+    NetworkClient client = server.accept();
+    if (client) {
+      serve(client);
+    } else {
+      delay(1);
+    }
+  }
+}
+
+static void runMode(HTTPClient &http, int mode, TestSink &sink, uint32_t *time_ms, int *ret) {
+  NetworkClient client;
+  http.setPipelined(mode == MODE_PIPELINED);
+  http.begin(client, String("http://127.0.0.1:") + SERVER_PORT + "/body.bin");
+  unsigned long start = millis();
+  *ret = http.GET();
+  if (*ret == HTTP_CODE_OK) {
+    *ret = http.writeToStream(&sink);
+  }
+  *time_ms = millis() - start;
+  http.end();
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {
+    delay(10);
+  }
+
+  Network.begin();
+  // the server runs beside the client like a remote host would
+  xTaskCreatePinnedToCore(serverTask, "server", 4096, NULL, 1, NULL, portNUM_PROCESSORS - 1 - xPortGetCoreID());
+  delay(100);
+
+  Serial.printf("Runs: %d\n", N_RUNS);
+  Serial.printf("Body size: %d\n", BODY_SIZE);
+  Serial.printf("Slow sink: %d KB/s\n", SLOW_SINK_KBPS);
+  Serial.flush();
+
+  // one client for all runs, its buffers are kept across requests
+  HTTPClient http;
+  for (int i = 0; i < N_RUNS; i++) {
+    Serial.printf("Run %d\n", i);
+    for (int slow = 0; slow < 2; slow++) {
+      for (int mode = 0; mode < MODE_MAX; mode++) {
+        TestSink sink(slow ? SLOW_SINK_KBPS : 0);
+        uint32_t time_ms;
+        int ret;
+        runMode(http, mode, sink, &time_ms, &ret);
+        float rate = time_ms ? (float)sink.received() / time_ms / 1000.0f : 0.0f;
+        Serial.printf(
+          "Mode: %s Sink: %s Bytes: %lu Errors: %lu Result: %d Time: %lu ms Rate: %.2f MB/s\n", mode_names[mode], sink_names[slow], sink.received(),
+          sink.errors(), ret, time_ms, rate
+        );
+        Serial.flush();
+      }
+    }
+  }
+
+  log_d("HTTPClient test done");
+}
+
+void loop() {
+  vTaskDelete(NULL);
+}
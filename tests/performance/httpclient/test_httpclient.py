@@ -0,0 +1,77 @@
+import json
+import logging
+import os
+
+
+def test_httpclient(dut, request):
+    LOGGER = logging.getLogger(__name__)
+
+    # Match "Runs: %d"
+    res = dut.expect(r"Runs: (\d+)", timeout=60)
+    runs = int(res.group(1))
+    LOGGER.info("Number of runs: {}".format(runs))
+    assert runs > 0, "Invalid number of runs"
+
+    # Match "Body size: %d"
+    res = dut.expect(r"Body size: (\d+)", timeout=60)
+    body_size = int(res.group(1))
+    LOGGER.info("Body size: {}".format(body_size))
+
+    # Match "Slow sink: %d KB/s"
+    res = dut.expect(r"Slow sink: (\d+) KB/s", timeout=60)
+    slow_kbps = int(res.group(1))
+    LOGGER.info("Slow sink: {} KB/s".format(slow_kbps))
+
+    sinks = ["fast", "slow"]
+    modes = ["direct", "pipelined"]
+    list_rate = {sink: {mode: [] for mode in modes} for sink in sinks}
+
+    for i in range(runs):
+        # Match "Run %d"
+        res = dut.expect(r"Run (\d+)", timeout=60)
+        run = int(res.group(1))
+        LOGGER.info("Run {}".format(run))
+        assert run == i, "Invalid run number"
+
+        for sink in sinks:
+            for mode in modes:
+                # Match "Mode: %s Sink: %s Bytes: %lu Errors: %lu Result: %d Time: %lu ms Rate: %.2f MB/s"
+                res = dut.expect(
+                    r"Mode: (\w+) Sink: (\w+) Bytes: (\d+) Errors: (\d+) Result: (-?\d+) Time: (\d+) ms Rate: (\d+\.\d+) MB/s",
+                    timeout=120,
+                )
+                assert res.group(1).decode("utf-8") == mode, "Invalid mode"
+                assert res.group(2).decode("utf-8") == sink, "Invalid sink"
+                received = int(res.group(3))
+                errors = int(res.group(4))
+                result = int(res.group(5))
+                rate = float(res.group(7))
+                LOGGER.info("{} {} sink: {:.2f} MB/s".format(mode, sink, rate))
+                assert result == body_size, "writeToStream failed: {}".format(result)
+                assert received == body_size, "Body incomplete"
+                assert errors == 0, "Body corrupted"
+                list_rate[sink][mode].append(rate)
+
+    avg = {sink: {mode: sum(list_rate[sink][mode]) / runs for mode in modes} for sink in sinks}
+    # with a slow sink the network is read while the sink writes
+    assert avg["slow"]["pipelined"] >= avg["slow"]["direct"] * 0.95, "Pipelined download is slower"
+
+    # Create JSON with results and write it to file
+    # Always create a JSON with this format (so it can be merged later on):
+    # { TEST_NAME_STR: TEST_RESULTS_DICT }
+    results = {"httpclient": {"runs": runs, "body_size": body_size, "slow_sink_kbps": slow_kbps}}
+    for sink in sinks:
+        results["httpclient"][sink] = {mode: {"avg_rate_mbps": round(avg[sink][mode], 2)} for mode in modes}
+
+    current_folder = os.path.dirname(request.path)
+    file_index = 0
+    report_file = os.path.join(current_folder, "result_httpclient" + str(file_index) + ".json")
+    while os.path.exists(report_file):
+        report_file = report_file.replace(str(file_index) + ".json", str(file_index + 1) + ".json")
+        file_index += 1
+
+    with open(report_file, "w") as f:
+        try:
+            f.write(json.dumps(results))
+        except Exception as e:
+            LOGGER.warning("Failed to write results to file: {}".format(e))
@@ -0,0 +1,168 @@
+/*
+  HTTPUpdate resumable download test.
+  A server task on the lwIP loopback interface serves the running firmware with Range support
+  and drops connections on purpose. The image is downloaded to the OTA partition in three modes:
+  plain (one request, no drops), drops (Range requests, every connection cut after DROP_BYTES)
+  and reboot (the server refuses requests halfway so the update fails, the next update() continues
+  from the progress kept in NVS like after a reboot). Reports the bytes received against the
+  image size, the requests made and the time.
+*/
+
+#include <Arduino.h>
+#include <Network.h>
+#include <HTTPUpdate.h>
+#include <esp_ota_ops.h>
+
+#define SERVER_PORT 8080
+
+// Each connection is cut after this many body bytes in the drops mode
+#define DROP_BYTES (48 * 1024)
+
+#define CHUNK_SIZE (64 * 1024)
+
+enum {
+  MODE_PLAIN,
+  MODE_DROPS,
+  MODE_REBOOT,
+  MODE_MAX
+};
+
+static const char *mode_names[] = {"plain", "drops", "reboot"};
+
+static const esp_partition_t *running;
+static uint32_t image_size;
+static String image_md5;
+
+static volatile uint32_t drop_bytes;     // 0: never drop
+static volatile uint32_t refuse_after;   // answer 503 once this many bytes were served, 0: never
+static volatile uint32_t served;
+
+static void serve(NetworkClient &client) {
+  uint32_t from = 0;
+  uint32_t last = image_size - 1;
+  bool partial = false;
+  unsigned long start = millis();
+  while (client.connected() && millis() - start < 2000) {
+    String line = client.readStringUntil('\n');
+    line.trim();
+    if (!line.length()) {
+      break;
+    }
+    if (line.startsWith("Range:")) {
+      partial = sscanf(line.c_str(), "Range: bytes=%lu-%lu", &from, &last) == 2 && from < image_size;
+      if (last >= image_size) {
+        last = image_size - 1;
+      }
+    }
+  }
+
+  if (refuse_after && served >= refuse_after) {
+    client.print("HTTP/1.1 503 Service Unavailable\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+    client.stop();
+    return;
+  }
+  if (!partial) {
+    from = 0;
+    last = image_size - 1;
+  }
+  uint32_t len = last - from + 1;
+  if (partial) {
+    client.printf("HTTP/1.1 206 Partial Content\r\nContent-Range: bytes %lu-%lu/%lu\r\n", from, last, image_size);
+  } else {
+    client.print("HTTP/1.1 200 OK\r\n");
+  }
+  client.printf("Content-Length: %lu\r\nETag: \"%s\"\r\nx-MD5: %s\r\nConnection: close\r\n\r\n", len, image_md5.c_str(), image_md5.c_str());
+
+  static uint8_t buf[1460];
+  uint32_t sent = 0;
+  while (sent < len && client.connected()) {
+    if (drop_bytes && sent >= drop_bytes) {
+      break;  // cut the connection
+    }
+    size_t n = min((uint32_t)sizeof(buf), len - sent);
+    if (esp_partition_read(running, from + sent, buf, n) != ESP_OK) {
+      break;
+    }
+    size_t w = client.write(buf, n);
+    if (!w) {
+      break;
+    }
+    sent += w;
+    served += w;
+  }
+  client.stop();
+}
+
+static void serverTask(void *arg) {
+  NetworkServer server(SERVER_PORT);
+  server.begin();
+  while (true) {
+    NetworkClient client = server.accept();
+    if (client) {
+      serve(client);
+    } else {
+      delay(1);
+    }
+  }
+}
+
+static bool runMode(int mode, uint32_t *received, uint32_t *requests, uint32_t *time_ms) {
+  NetworkClient client;
+  httpUpdate.rebootOnUpdate(false);
+  httpUpdate.setResume(mode != MODE_PLAIN, CHUNK_SIZE, 3);
+  httpUpdate.clearResume();
+  drop_bytes = (mode == MODE_DROPS) ? DROP_BYTES : 0;
+  refuse_after = (mode == MODE_REBOOT) ? image_size / 2 : 0;
+  served = 0;
+
+  String url = String("http://127.0.0.1:") + SERVER_PORT + "/firmware.bin";
+  unsigned long start = millis();
+  t_httpUpdate_return ret = httpUpdate.update(client, url);
+  *received = httpUpdate.getReceivedBytes();
+  *requests = httpUpdate.getRequests();
+  if (mode == MODE_REBOOT) {
+    // the first attempt stops halfway, the second continues from NVS
+    if (ret != HTTP_UPDATE_FAILED) {
+      return false;
+    }
+    Serial.printf("Interrupted at %lu bytes: %s\n", *received, httpUpdate.getLastErrorString().c_str());
+    refuse_after = 0;
+    ret = httpUpdate.update(client, url);
+    *received += httpUpdate.getReceivedBytes();
+    *requests += httpUpdate.getRequests();
+  }
+  *time_ms = millis() - start;
+  if (ret != HTTP_UPDATE_OK) {
+    Serial.printf("Update failed: %s\n", httpUpdate.getLastErrorString().c_str());
+  }
+  return ret == HTTP_UPDATE_OK;
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {
+    delay(10);
+  }
+
+  Network.begin();
+  running = esp_ota_get_running_partition();
+  image_size = ESP.getSketchSize();
+  image_md5 = ESP.getSketchMD5();
+  xTaskCreate(serverTask, "server", 4096, NULL, 1, NULL);
+  delay(100);
+
+  Serial.printf("Image size: %lu\n", image_size);
+  Serial.flush();
+  for (int mode = 0; mode < MODE_MAX; mode++) {
+    uint32_t received, requests, time_ms;
+    bool ok = runMode(mode, &received, &requests, &time_ms);
+    Serial.printf("Mode: %s Received: %lu Requests: %lu Time: %lu ms Result: %s\n", mode_names[mode], received, requests, time_ms, ok ? "OK" : "FAIL");
+    Serial.flush();
+  }
+
+  log_d("HTTPUpdate test done");
+}
+
+void loop() {
+  vTaskDelete(NULL);
+}
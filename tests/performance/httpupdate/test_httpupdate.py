@@ -0,0 +1,62 @@
+import json
+import logging
+import os
+
+
+def test_httpupdate(dut, request):
+    LOGGER = logging.getLogger(__name__)
+
+    # Match "Image size: %lu"
+    res = dut.expect(r"Image size: (\d+)", timeout=60)
+    image_size = int(res.group(1))
+    LOGGER.info("Image size: {}".format(image_size))
+    assert image_size > 0, "Invalid image size"
+
+    chunk_size = 64 * 1024
+    modes = ["plain", "drops", "reboot"]
+    results = {"httpupdate": {"image_size": image_size}}
+
+    for mode in modes:
+        # Match "Mode: %s Received: %lu Requests: %lu Time: %lu ms Result: %s"
+        res = dut.expect(r"Mode: (\w+) Received: (\d+) Requests: (\d+) Time: (\d+) ms Result: (\w+)", timeout=300)
+        assert res.group(1).decode("utf-8") == mode, "Invalid mode"
+        received = int(res.group(2))
+        requests = int(res.group(3))
+        time_ms = int(res.group(4))
+        result = res.group(5).decode("utf-8")
+        LOGGER.info(
+            "{}: received {} of {} bytes ({:.1f}%) in {} requests, {} ms".format(
+                mode, received, image_size, 100.0 * received / image_size, requests, time_ms
+            )
+        )
+        assert result == "OK", "Update failed in mode {}".format(mode)
+        assert received >= image_size, "Image not received in mode {}".format(mode)
+        if mode == "drops":
+            # a dropped connection continues at the byte it stopped
+            assert received == image_size, "Bytes received twice after a drop"
+            assert requests > image_size // chunk_size, "The connections were not dropped"
+        if mode == "reboot":
+            # at most the part of a chunk that was not flashed yet comes again
+            assert received < image_size + chunk_size, "The download did not continue from NVS"
+        results["httpupdate"][mode] = {
+            "received": received,
+            "overhead_pct": round(100.0 * (received - image_size) / image_size, 2),
+            "requests": requests,
+            "time_ms": time_ms,
+        }
+
+    # Create JSON with results and write it to file
+    # Always create a JSON with this format (so it can be merged later on):
+    # { TEST_NAME_STR: TEST_RESULTS_DICT }
+    current_folder = os.path.dirname(request.path)
+    file_index = 0
+    report_file = os.path.join(current_folder, "result_httpupdate" + str(file_index) + ".json")
+    while os.path.exists(report_file):
+        report_file = report_file.replace(str(file_index) + ".json", str(file_index + 1) + ".json")
+        file_index += 1
+
+    with open(report_file, "w") as f:
+        try:
+            f.write(json.dumps(results))
+        except Exception as e:
+            LOGGER.warning("Failed to write results to file: {}".format(e))
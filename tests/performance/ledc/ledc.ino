@@ -0,0 +1,78 @@
+/*
+  LEDC frame update test.
+  Updates 1 to N channels sharing a timer, either with one ledcWrite() per channel or by
+  staging all the duties and applying them with ledcCommit(). Reports the time of one frame
+  for each channel count. Nothing needs to be connected to the pins.
+*/
+
+#include <Arduino.h>
+
+// Number of runs to average
+#define N_RUNS 5
+
+#define FRAMES 2000
+
+#define LEDC_FREQ       5000
+#define LEDC_RESOLUTION 10
+
+#if CONFIG_IDF_TARGET_ESP32
+static const uint8_t pins[] = {4, 5, 13, 14, 18, 19, 21, 22};
+#else
+static const uint8_t pins[] = {0, 1, 2, 3, 4, 5, 8, 9};
+#endif
+
+#define MAX_CHANNELS min((int)sizeof(pins), SOC_LEDC_CHANNEL_NUM)
+
+static float timeWrite(int channels) {
+  uint32_t start = micros();
+  for (uint32_t f = 0; f < FRAMES; f++) {
+    for (int c = 0; c < channels; c++) {
+      ledcWrite(pins[c], (f + c * 64) & 1023);
+    }
+  }
+  return (float)(micros() - start) / FRAMES;
+}
+
+static float timeCommit(int channels) {
+  uint32_t start = micros();
+  for (uint32_t f = 0; f < FRAMES; f++) {
+    for (int c = 0; c < channels; c++) {
+      ledcStage(pins[c], (f + c * 64) & 1023);
+    }
+    ledcCommit();
+  }
+  return (float)(micros() - start) / FRAMES;
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {
+    delay(10);
+  }
+
+  for (int c = 0; c < MAX_CHANNELS; c++) {
+    if (!ledcAttachChannel(pins[c], LEDC_FREQ, LEDC_RESOLUTION, c)) {
+      Serial.printf("Attach failed on pin %d\n", pins[c]);
+    }
+  }
+
+  log_d("Starting LEDC frame update test");
+
+  Serial.printf("Runs: %d\n", N_RUNS);
+  Serial.printf("Frames: %d Channels: %d\n", FRAMES, MAX_CHANNELS);
+
+  for (int i = 0; i < N_RUNS; i++) {
+    Serial.printf("Run %d\n", i);
+    for (int n = 1; n <= MAX_CHANNELS; n++) {
+      float write_us = timeWrite(n);
+      float commit_us = timeCommit(n);
+      Serial.printf("Channels: %d Write: %.2f us Commit: %.2f us\n", n, write_us, commit_us);
+    }
+  }
+
+  log_d("LEDC frame update test done");
+}
+
+void loop() {
+  vTaskDelete(NULL);
+}
@@ -0,0 +1,64 @@
+import json
+import logging
+import os
+
+
+def test_ledc(dut, request):
+    LOGGER = logging.getLogger(__name__)
+
+    # Match "Runs: %d"
+    res = dut.expect(r"Runs: (\d+)", timeout=60)
+    runs = int(res.group(0).decode("utf-8").split(" ")[1])
+    LOGGER.info("Number of runs: {}".format(runs))
+    assert runs > 0, "Invalid number of runs"
+
+    # Match "Frames: %d Channels: %d"
+    res = dut.expect(r"Frames: (\d+) Channels: (\d+)", timeout=60)
+    frames = int(res.group(1))
+    channels = int(res.group(2))
+    LOGGER.info("Frames: {} Channels: {}".format(frames, channels))
+    assert channels > 0, "Invalid number of channels"
+
+    list_write = {n: [] for n in range(1, channels + 1)}
+    list_commit = {n: [] for n in range(1, channels + 1)}
+
+    for i in range(runs):
+        # Match "Run %d"
+        res = dut.expect(r"Run (\d+)", timeout=60)
+        run = int(res.group(0).decode("utf-8").split(" ")[1])
+        LOGGER.info("Run {}".format(run))
+        assert run == i, "Invalid run number"
+
+        for n in range(1, channels + 1):
+            # Match "Channels: %d Write: %.2f us Commit: %.2f us"
+            res = dut.expect(r"Channels: (\d+) Write: (\d+\.\d+) us Commit: (\d+\.\d+) us", timeout=120)
+            assert int(res.group(1)) == n, "Invalid channel count"
+            write_us = float(res.group(2))
+            commit_us = float(res.group(3))
+            assert write_us > 0 and commit_us > 0, "Invalid time"
+            LOGGER.info("{} channels on run {}: write {} us, commit {} us".format(n, i, write_us, commit_us))
+            list_write[n].append(write_us)
+            list_commit[n].append(commit_us)
+
+    # Create JSON with results and write it to file
+    # Always create a JSON with this format (so it can be merged later on):
+    # { TEST_NAME_STR: TEST_RESULTS_DICT }
+    results = {"ledc": {"runs": runs, "frames": frames}}
+    for n in range(1, channels + 1):
+        results["ledc"]["channels_" + str(n)] = {
+            "avg_write_us": round(sum(list_write[n]) / runs, 2),
+            "avg_commit_us": round(sum(list_commit[n]) / runs, 2),
+        }
+
+    current_folder = os.path.dirname(request.path)
+    file_index = 0
+    report_file = os.path.join(current_folder, "result_ledc" + str(file_index) + ".json")
+    while os.path.exists(report_file):
+        report_file = report_file.replace(str(file_index) + ".json", str(file_index + 1) + ".json")
+        file_index += 1
+
+    with open(report_file, "w") as f:
+        try:
+            f.write(json.dumps(results))
+        except Exception as e:
+            LOGGER.warning("Failed to write results to file: {}".format(e))
@@ -0,0 +1,98 @@
+/*
+  LEDStrip frame rate and CPU load test.
+  A task sends frames back to back to a strip of 300 and then 1000 LEDs, while the loop task
+  counts as fast as it can on the same core. The CPU load of the driver is the share of the
+  count lost compared to an idle run. Nothing needs to be connected to the pin.
+*/
+
+#include <Arduino.h>
+#include <LEDStrip.h>
+
+// Number of runs to average
+#define N_RUNS 3
+
+// Duration of each measurement in milliseconds
+#define RUN_TIME_MS 3000
+
+#define LED_PIN 4
+
+static const size_t led_counts[] = {300, 1000};
+
+static volatile bool running;
+static volatile bool task_done;
+
+static void stripTask(void *arg) {
+  LEDStrip *strip = (LEDStrip *)arg;
+  while (running) {
+    strip->show(1000);
+  }
+  strip->wait(1000);
+  task_done = true;
+  vTaskDelete(NULL);
+}
+
+static uint32_t countFor(uint32_t ms) {
+  uint32_t n = 0;
+  uint32_t start = millis();
+  while (millis() - start < ms) {
+    n++;
+  }
+  return n;
+}
+
+static void runStrip(size_t leds, uint32_t idle_count) {
+  LEDStrip strip;
+  if (!strip.begin(LED_PIN, leds)) {
+    Serial.println("LEDStrip begin failed");
+    return;
+  }
+  for (size_t i = 0; i < leds; i++) {
+    strip.setPixel(i, i * 7, i * 13, i * 17);
+  }
+  strip.setGamma(2.2);
+
+  running = true;
+  task_done = false;
+  xTaskCreatePinnedToCore(stripTask, "strip", 4096, &strip, uxTaskPriorityGet(NULL) + 1, NULL, xPortGetCoreID());
+  uint32_t start = millis();
+  uint32_t busy_count = countFor(RUN_TIME_MS);
+  running = false;
+  while (!task_done) {
+    delay(1);
+  }
+  uint32_t elapsed = millis() - start;
+
+  led_strip_stats_t stats;
+  strip.getStats(&stats);
+  float fps = stats.frames * 1000.0f / elapsed;
+  float load = (idle_count > busy_count) ? (idle_count - busy_count) * 100.0f / idle_count : 0;
+  Serial.printf("LEDs: %u Frames: %lu Errors: %lu\n", leds, stats.frames, stats.errors);
+  Serial.printf("FPS: %.1f CPU: %.1f %% Encode: %lu us Frame: %lu us\n", fps, load, stats.encode_us, stats.frame_us);
+  strip.end();
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {
+    delay(10);
+  }
+
+  log_d("Starting LEDStrip test");
+
+  Serial.printf("Runs: %d\n", N_RUNS);
+  Serial.printf("Run time: %d ms\n", RUN_TIME_MS);
+
+  for (int i = 0; i < N_RUNS; i++) {
+    Serial.printf("Run %d\n", i);
+    uint32_t idle_count = countFor(RUN_TIME_MS);
+    for (size_t n = 0; n < sizeof(led_counts) / sizeof(led_counts[0]); n++) {
+      runStrip(led_counts[n], idle_count);
+    }
+  }
+
+  log_d("LEDStrip test done");
+}
+
+void loop() {
+  vTaskDelete(NULL);
+}
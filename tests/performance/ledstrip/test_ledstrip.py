@@ -0,0 +1,76 @@
+import json
+import logging
+import os
+
+
+def test_ledstrip(dut, request):
+    LOGGER = logging.getLogger(__name__)
+
+    # Match "Runs: %d"
+    res = dut.expect(r"Runs: (\d+)", timeout=60)
+    runs = int(res.group(0).decode("utf-8").split(" ")[1])
+    LOGGER.info("Number of runs: {}".format(runs))
+    assert runs > 0, "Invalid number of runs"
+
+    # Match "Run time: %d ms"
+    res = dut.expect(r"Run time: (\d+) ms", timeout=60)
+    run_time = int(res.group(1))
+    LOGGER.info("Run time: {} ms".format(run_time))
+
+    led_counts = [300, 1000]
+    list_fps = {leds: [] for leds in led_counts}
+    list_cpu = {leds: [] for leds in led_counts}
+    list_encode = {leds: [] for leds in led_counts}
+    frame_us = {}
+
+    for i in range(runs):
+        # Match "Run %d"
+        res = dut.expect(r"Run (\d+)", timeout=60)
+        run = int(res.group(0).decode("utf-8").split(" ")[1])
+        LOGGER.info("Run {}".format(run))
+        assert run == i, "Invalid run number"
+
+        for leds in led_counts:
+            # Match "LEDs: %u Frames: %lu Errors: %lu"
+            res = dut.expect(r"LEDs: (\d+) Frames: (\d+) Errors: (\d+)", timeout=60)
+            assert int(res.group(1)) == leds, "Invalid number of LEDs"
+            assert int(res.group(2)) > 0, "No frames sent"
+            assert int(res.group(3)) == 0, "Frames failed"
+
+            # Match "FPS: %.1f CPU: %.1f %% Encode: %lu us Frame: %lu us"
+            res = dut.expect(r"FPS: (\d+\.\d) CPU: (\d+\.\d) % Encode: (\d+) us Frame: (\d+) us", timeout=60)
+            fps = float(res.group(1))
+            cpu = float(res.group(2))
+            encode = int(res.group(3))
+            frame_us[leds] = int(res.group(4))
+            LOGGER.info("{} LEDs on run {}: {} FPS, {}% CPU, {} us encode".format(leds, i, fps, cpu, encode))
+            # the frames are sent back to back, the rate is bound by the wire time
+            assert fps > 1000000 / frame_us[leds] * 0.8, "Frame rate too low"
+            list_fps[leds].append(fps)
+            list_cpu[leds].append(cpu)
+            list_encode[leds].append(encode)
+
+    # Create JSON with results and write it to file
+    # Always create a JSON with this format (so it can be merged later on):
+    # { TEST_NAME_STR: TEST_RESULTS_DICT }
+    results = {"ledstrip": {"runs": runs, "run_time_ms": run_time}}
+    for leds in led_counts:
+        results["ledstrip"][str(leds)] = {
+            "avg_fps": round(sum(list_fps[leds]) / runs, 1),
+            "avg_cpu_percent": round(sum(list_cpu[leds]) / runs, 1),
+            "avg_encode_us": round(sum(list_encode[leds]) / runs),
+            "frame_us": frame_us[leds],
+        }
+
+    current_folder = os.path.dirname(request.path)
+    file_index = 0
+    report_file = os.path.join(current_folder, "result_ledstrip" + str(file_index) + ".json")
+    while os.path.exists(report_file):
+        report_file = report_file.replace(str(file_index) + ".json", str(file_index + 1) + ".json")
+        file_index += 1
+
+    with open(report_file, "w") as f:
+        try:
+            f.write(json.dumps(results))
+        except Exception as e:
+            LOGGER.warning("Failed to write results to file: {}".format(e))
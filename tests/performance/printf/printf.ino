@@ -0,0 +1,113 @@
+/*
+  Print::printf() and print() number formatting test.
+  Compares the streaming Print::printf() with the previous implementation
+  (vsnprintf into a 64 byte stack buffer, malloc and a second vsnprintf when larger).
+*/
+
+#include <Arduino.h>
+
+// Number of runs to average
+#define N_RUNS 3
+
+// Iterations per run
+#define N_ITER 10000
+
+// Print target that discards the data
+class NullPrint : public Print {
+public:
+  size_t total = 0;
+  size_t write(uint8_t) override {
+    total++;
+    return 1;
+  }
+  size_t write(const uint8_t *buffer, size_t size) override {
+    total += size;
+    return size;
+  }
+};
+
+// Previous Print::vprintf() implementation, kept for comparison
+static size_t legacyPrintf(Print &out, const char *format, ...) {
+  char loc_buf[64];
+  char *temp = loc_buf;
+  va_list arg;
+  va_list copy;
+  va_start(arg, format);
+  va_copy(copy, arg);
+  int len = vsnprintf(temp, sizeof(loc_buf), format, copy);
+  va_end(copy);
+  if (len < 0) {
+    va_end(arg);
+    return 0;
+  }
+  if (len >= (int)sizeof(loc_buf)) {
+    temp = (char *)malloc(len + 1);
+    if (temp == NULL) {
+      va_end(arg);
+      return 0;
+    }
+    len = vsnprintf(temp, len + 1, format, arg);
+  }
+  va_end(arg);
+  len = out.write((uint8_t *)temp, len);
+  if (temp != loc_buf) {
+    free(temp);
+  }
+  return len;
+}
+
+#define SHORT_FMT  "t=%lu v=%d\n"
+#define SHORT_ARGS (unsigned long)123456, -42
+#define LONG_FMT   "{\"id\":%lu,\"name\":\"%s\",\"temp\":%d,\"hum\":%u,\"rssi\":%d,\"mac\":\"%02X:%02X:%02X:%02X:%02X:%02X\",\"uptime\":%llu,\"status\":\"%s\"}\n"
+#define LONG_ARGS  (unsigned long)123456, "sensor-node-0042", 23, 55u, -67, 0x24, 0x6F, 0x28, 0xAB, 0xCD, 0xEF, 123456789ULL, "running normally"
+
+static NullPrint sink;
+
+static uint32_t bench(const char *name, void (*fn)()) {
+  uint32_t start = micros();
+  for (int i = 0; i < N_ITER; i++) {
+    fn();
+  }
+  uint32_t elapsed = micros() - start;
+  Serial.printf("%s: %lu us\n", name, elapsed);
+  return elapsed;
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {
+    delay(10);
+  }
+
+  Serial.printf("Runs: %d\n", N_RUNS);
+  Serial.printf("Iterations: %d\n", N_ITER);
+  Serial.flush();
+  for (int i = 0; i < N_RUNS; i++) {
+    Serial.printf("Run %d\n", i);
+    bench("Legacy short printf", [] {
+      legacyPrintf(sink, SHORT_FMT, SHORT_ARGS);
+    });
+    bench("Streaming short printf", [] {
+      sink.printf(SHORT_FMT, SHORT_ARGS);
+    });
+    bench("Legacy long printf", [] {
+      legacyPrintf(sink, LONG_FMT, LONG_ARGS);
+    });
+    bench("Streaming long printf", [] {
+      sink.printf(LONG_FMT, LONG_ARGS);
+    });
+    bench("Print integer", [] {
+      sink.print(4294967295UL);
+    });
+    bench("Print float", [] {
+      sink.print(-12345.6789, 4);
+    });
+    Serial.flush();
+  }
+
+  log_d("Printf test done");
+}
+
+void loop() {
+  vTaskDelete(NULL);
+}
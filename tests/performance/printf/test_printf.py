@@ -0,0 +1,68 @@
+import json
+import logging
+import os
+
+from collections import defaultdict
+
+TESTS = [
+    "Legacy short printf",
+    "Streaming short printf",
+    "Legacy long printf",
+    "Streaming long printf",
+    "Print integer",
+    "Print float",
+]
+
+
+def test_printf(dut, request):
+    LOGGER = logging.getLogger(__name__)
+
+    # Match "Runs: %d"
+    res = dut.expect(r"Runs: (\d+)", timeout=60)
+    runs = int(res.group(1))
+    LOGGER.info("Number of runs: {}".format(runs))
+    assert runs > 0, "Invalid number of runs"
+
+    # Match "Iterations: %d"
+    res = dut.expect(r"Iterations: (\d+)", timeout=60)
+    iterations = int(res.group(1))
+    LOGGER.info("Iterations per run: {}".format(iterations))
+    assert iterations > 0, "Invalid number of iterations"
+
+    times = defaultdict(list)
+
+    for i in range(runs):
+        # Match "Run %d"
+        res = dut.expect(r"Run (\d+)", timeout=60)
+        run = int(res.group(1))
+        LOGGER.info("Run {}".format(run))
+        assert run == i, "Invalid run number"
+
+        for name in TESTS:
+            # Match "<name>: %lu us"
+            res = dut.expect(r"{}: (\d+) us".format(name), timeout=120)
+            time = int(res.group(1))
+            LOGGER.info("{}: {} us".format(name, time))
+            assert time > 0, "Invalid time"
+            times[name].append(time)
+
+    results = {"printf": {"runs": runs, "iterations": iterations}}
+    for name in TESTS:
+        key = name.lower().replace(" ", "_")
+        results["printf"][key] = round(sum(times[name]) / len(times[name]))
+
+    # Create JSON with results and write it to file
+    # Always create a JSON with this format (so it can be merged later on):
+    # { TEST_NAME_STR: TEST_RESULTS_DICT }
+    current_folder = os.path.dirname(request.path)
+    file_index = 0
+    report_file = os.path.join(current_folder, "result_printf" + str(file_index) + ".json")
+    while os.path.exists(report_file):
+        report_file = report_file.replace(str(file_index) + ".json", str(file_index + 1) + ".json")
+        file_index += 1
+
+    with open(report_file, "w") as f:
+        try:
+            f.write(json.dumps(results))
+        except Exception as e:
+            LOGGER.warning("Failed to write results to file: {}".format(e))
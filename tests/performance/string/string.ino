@@ -0,0 +1,150 @@
+/*
+  String templating test.
+  Renders a 32 KB page template using the previous String::replace() algorithm,
+  the current String::replace(), String concatenation and StringBuilder.
+*/
+
+#include <Arduino.h>
+#include <StringBuilder.h>
+
+// Number of runs to average
+#define N_RUNS 3
+
+// Rows in the page, about 32 KB in total
+#define N_ROWS 448
+
+#define ROW_PREFIX  "<tr><td class=\"name\">sensor</td><td class=\"value\">"
+#define PLACEHOLDER "{{value}}"
+#define ROW_SUFFIX  "</td></tr>\n"
+#define VALUE       "1234.56 kPa"
+
+// Print target that discards the data
+class NullPrint : public Print {
+public:
+  size_t write(uint8_t) override {
+    return 1;
+  }
+  size_t write(const uint8_t *buffer, size_t size) override {
+    return size;
+  }
+};
+
+static String page_template;
+
+// Previous growing String::replace() algorithm on a plain buffer:
+// scan backwards with lastIndexOf() and move the tail once per match
+static int legacyLastIndexOf(const char *buf, const char *find, size_t fromIndex) {
+  int found = -1;
+  for (const char *p = buf; p <= buf + fromIndex; p++) {
+    p = strstr(p, find);
+    if (!p) {
+      break;
+    }
+    if ((size_t)(p - buf) <= fromIndex) {
+      found = p - buf;
+    }
+  }
+  return found;
+}
+
+static size_t legacyReplace(char *&buf, size_t len, const char *find, const char *replace) {
+  size_t find_len = strlen(find);
+  size_t replace_len = strlen(replace);
+  int diff = replace_len - find_len;
+  size_t size = len;
+  const char *readFrom = buf;
+  const char *foundAt;
+  while ((foundAt = strstr(readFrom, find)) != NULL) {
+    readFrom = foundAt + find_len;
+    size += diff;
+  }
+  char *grown = (char *)realloc(buf, size + 1);
+  if (!grown) {
+    return len;
+  }
+  buf = grown;
+  int index = len - 1;
+  while (index >= 0 && (index = legacyLastIndexOf(buf, find, index)) >= 0) {
+    char *tail = buf + index + find_len;
+    memmove(tail + diff, tail, len - (tail - buf));
+    len += diff;
+    memmove(buf + index, replace, replace_len);
+    buf[len] = 0;
+    index--;
+  }
+  return len;
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {
+    delay(10);
+  }
+
+  for (int i = 0; i < N_ROWS; i++) {
+    page_template += ROW_PREFIX PLACEHOLDER ROW_SUFFIX;
+  }
+
+  Serial.printf("Runs: %d\n", N_RUNS);
+  Serial.printf("Template size: %u\n", page_template.length());
+  Serial.flush();
+
+  for (int i = 0; i < N_RUNS; i++) {
+    uint32_t start, elapsed;
+    size_t rendered;
+
+    Serial.printf("Run %d\n", i);
+
+    start = micros();
+    char *buf = strdup(page_template.c_str());
+    rendered = legacyReplace(buf, page_template.length(), PLACEHOLDER, VALUE);
+    free(buf);
+    elapsed = micros() - start;
+    Serial.printf("Legacy replace: %lu us (%u bytes)\n", elapsed, rendered);
+
+    start = micros();
+    String page = page_template;
+    page.replace(PLACEHOLDER, VALUE);
+    rendered = page.length();
+    page = String();
+    elapsed = micros() - start;
+    Serial.printf("Replace: %lu us (%u bytes)\n", elapsed, rendered);
+
+    start = micros();
+    for (int row = 0; row < N_ROWS; row++) {
+      page += ROW_PREFIX;
+      page += 1234.56;
+      page += " kPa";
+      page += ROW_SUFFIX;
+    }
+    rendered = page.length();
+    page = String();
+    elapsed = micros() - start;
+    Serial.printf("Concat: %lu us (%u bytes)\n", elapsed, rendered);
+
+    start = micros();
+    StringBuilder builder(N_ROWS * 3);
+    for (int row = 0; row < N_ROWS; row++) {
+      builder << ROW_PREFIX << 1234.56 << " kPa" << ROW_SUFFIX;
+    }
+    page = builder.toString();
+    rendered = page.length();
+    page = String();
+    elapsed = micros() - start;
+    Serial.printf("Builder: %lu us (%u bytes)\n", elapsed, rendered);
+
+    NullPrint sink;
+    start = micros();
+    rendered = sink.print(builder);
+    elapsed = micros() - start;
+    Serial.printf("Builder print: %lu us (%u bytes)\n", elapsed, rendered);
+
+    Serial.flush();
+  }
+
+  log_d("String test done");
+}
+
+void loop() {
+  vTaskDelete(NULL);
+}
@@ -0,0 +1,67 @@
+import json
+import logging
+import os
+
+from collections import defaultdict
+
+TESTS = ["Legacy replace", "Replace", "Concat", "Builder", "Builder print"]
+
+
+def test_string(dut, request):
+    LOGGER = logging.getLogger(__name__)
+
+    # Match "Runs: %d"
+    res = dut.expect(r"Runs: (\d+)", timeout=60)
+    runs = int(res.group(1))
+    LOGGER.info("Number of runs: {}".format(runs))
+    assert runs > 0, "Invalid number of runs"
+
+    # Match "Template size: %u"
+    res = dut.expect(r"Template size: (\d+)", timeout=60)
+    size = int(res.group(1))
+    LOGGER.info("Template size: {}".format(size))
+    assert size > 0, "Invalid template size"
+
+    times = defaultdict(list)
+    lengths = {}
+
+    for i in range(runs):
+        # Match "Run %d"
+        res = dut.expect(r"Run (\d+)", timeout=60)
+        run = int(res.group(1))
+        LOGGER.info("Run {}".format(run))
+        assert run == i, "Invalid run number"
+
+        for name in TESTS:
+            # Match "<name>: %lu us (%u bytes)"
+            res = dut.expect(r"{}: (\d+) us \((\d+) bytes\)".format(name), timeout=120)
+            time = int(res.group(1))
+            length = int(res.group(2))
+            LOGGER.info("{}: {} us, {} bytes".format(name, time, length))
+            assert time > 0, "Invalid time"
+            times[name].append(time)
+            lengths[name] = length
+
+    assert lengths["Legacy replace"] == lengths["Replace"], "Replace results differ"
+    assert lengths["Concat"] == lengths["Builder"] == lengths["Builder print"], "Builder results differ"
+
+    results = {"string": {"runs": runs, "template_size": size, "page_size": lengths["Replace"]}}
+    for name in TESTS:
+        key = name.lower().replace(" ", "_") + "_us"
+        results["string"][key] = round(sum(times[name]) / len(times[name]))
+
+    # Create JSON with results and write it to file
+    # Always create a JSON with this format (so it can be merged later on):
+    # { TEST_NAME_STR: TEST_RESULTS_DICT }
+    current_folder = os.path.dirname(request.path)
+    file_index = 0
+    report_file = os.path.join(current_folder, "result_string" + str(file_index) + ".json")
+    while os.path.exists(report_file):
+        report_file = report_file.replace(str(file_index) + ".json", str(file_index + 1) + ".json")
+        file_index += 1
+
+    with open(report_file, "w") as f:
+        try:
+            f.write(json.dumps(results))
+        except Exception as e:
+            LOGGER.warning("Failed to write results to file: {}".format(e))
@@ -0,0 +1,79 @@
+import json
+import logging
+import os
+
+# bytes, integer rounding of the per packet lwIP release
+HEAP_TOLERANCE = 16
+
+
+def test_udp(dut, request):
+    LOGGER = logging.getLogger(__name__)
+
+    # Match "Runs: %d"
+    res = dut.expect(r"Runs: (\d+)", timeout=60)
+    runs = int(res.group(0).decode("utf-8").split(" ")[1])
+    LOGGER.info("Number of runs: {}".format(runs))
+    assert runs > 0, "Invalid number of runs"
+
+    # Match "Packet size: %d"
+    res = dut.expect(r"Packet size: (\d+)", timeout=60)
+    packet_size = int(res.group(1))
+    LOGGER.info("Packet size: {}".format(packet_size))
+
+    modes = ["cbuf", "ring", "ring_batch"]
+    list_rate = {mode: [] for mode in modes}
+    list_heap = {mode: [] for mode in modes}
+
+    for i in range(runs):
+        # Match "Run %d"
+        res = dut.expect(r"Run (\d+)", timeout=60)
+        run = int(res.group(0).decode("utf-8").split(" ")[1])
+        LOGGER.info("Run {}".format(run))
+        assert run == i, "Invalid run number"
+
+        for mode in modes:
+            # Match "Mode: %s Sent: %lu Received: %lu"
+            res = dut.expect(r"Mode: (\w+) Sent: (\d+) Received: (\d+)", timeout=60)
+            assert res.group(1).decode("utf-8") == mode, "Invalid mode"
+            sent = int(res.group(2))
+            received = int(res.group(3))
+            LOGGER.info("{}: sent {} received {}".format(mode, sent, received))
+            assert received > 0, "No packets received"
+            assert received <= sent, "Invalid number of packets"
+
+            # Match "Rate: %lu p/s Heap/packet: %ld"
+            res = dut.expect(r"Rate: (\d+) p/s Heap/packet: (-?\d+)", timeout=60)
+            rate = int(res.group(1))
+            heap = int(res.group(2))
+            LOGGER.info("{} rate on run {}: {} p/s, {} heap bytes held per packet".format(mode, i, rate, heap))
+            assert heap >= -HEAP_TOLERANCE, "No packets received for the heap measurement"
+            list_rate[mode].append(rate)
+            list_heap[mode].append(heap)
+
+    # the cbuf path copies every packet to the heap, which shows the measurement works
+    assert min(list_heap["cbuf"]) >= packet_size, "The heap measurement missed the cbuf copy"
+    for mode in ["ring", "ring_batch"]:
+        assert max(list_heap[mode]) <= HEAP_TOLERANCE, "The packet ring allocated memory per packet"
+
+    # Create JSON with results and write it to file
+    # Always create a JSON with this format (so it can be merged later on):
+    # { TEST_NAME_STR: TEST_RESULTS_DICT }
+    results = {"udp": {"runs": runs, "packet_size": packet_size}}
+    for mode in modes:
+        results["udp"][mode] = {
+            "avg_rate": round(sum(list_rate[mode]) / runs),
+            "avg_heap_per_packet": round(sum(list_heap[mode]) / runs),
+        }
+
+    current_folder = os.path.dirname(request.path)
+    file_index = 0
+    report_file = os.path.join(current_folder, "result_udp" + str(file_index) + ".json")
+    while os.path.exists(report_file):
+        report_file = report_file.replace(str(file_index) + ".json", str(file_index + 1) + ".json")
+        file_index += 1
+
+    with open(report_file, "w") as f:
+        try:
+            f.write(json.dumps(results))
+        except Exception as e:
+            LOGGER.warning("Failed to write results to file: {}".format(e))
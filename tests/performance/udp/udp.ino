@@ -0,0 +1,175 @@
+/*
+  NetworkUDP receive rate test.
+  A sender task floods the receiver with datagrams over the lwIP loopback interface, the
+  receiver drains them as fast as it can with the default cbuf path, the packet ring with
+  parsePacket() and the packet ring with parsePackets(). Reports the sustained receive rate
+  and the heap memory the receive path holds per packet, measured from the free heap while
+  nothing else is sending.
+*/
+
+#include <Arduino.h>
+#include <Network.h>
+#include "lwip/sockets.h"
+
+// Number of runs to average
+#define N_RUNS 3
+
+// Duration of each run in milliseconds
+#define RUN_TIME_MS 3000
+
+// Art-Net sized payload
+#define PACKET_SIZE 530
+
+#define RING_SLOTS 16
+
+#define UDP_PORT 6454
+
+// Datagrams queued for the heap measurement, fits the socket receive mailbox
+#define HEAP_PROBE_PACKETS 4
+
+enum {
+  MODE_CBUF,
+  MODE_RING,
+  MODE_RING_BATCH,
+  MODE_MAX
+};
+
+static const char *mode_names[] = {"cbuf", "ring", "ring_batch"};
+
+static volatile bool sending;
+static volatile bool sender_done;
+static volatile uint32_t sent;
+
+static int sendPacket(int sock) {
+  static uint8_t packet[PACKET_SIZE];
+  memset(packet, 0x55, sizeof(packet));
+  struct sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(UDP_PORT);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  return sendto(sock, packet, sizeof(packet), 0, (struct sockaddr *)&addr, sizeof(addr));
+}
+
+static void senderTask(void *arg) {
+  int sock = socket(AF_INET, SOCK_DGRAM, 0);
+  while (sending) {
+    if (sendPacket(sock) == PACKET_SIZE) {
+      sent++;
+    } else {
+      vTaskDelay(1);  // out of pbufs
+    }
+  }
+  close(sock);
+  sender_done = true;
+  vTaskDelete(NULL);
+}
+
+// Heap bytes the receive path holds while a packet is being read.
+// Receiving a datagram also releases the lwIP buffers it was queued in. All datagrams have the
+// same size, so that amount is the same for each and is known from the heap once all are read.
+static int32_t heapPerPacket(NetworkUDP &udp, int mode, uint8_t *buf) {
+  int sock = socket(AF_INET, SOCK_DGRAM, 0);
+  for (int i = 0; i < HEAP_PROBE_PACKETS; i++) {
+    sendPacket(sock);
+  }
+  close(sock);
+  delay(50);  // let the tcpip task queue them on the receiving socket
+
+  int32_t samples[HEAP_PROBE_PACKETS];
+  int n = 0;
+  int32_t before = ESP.getFreeHeap();
+  if (mode == MODE_RING_BATCH) {
+    udp.parsePackets();
+  }
+  while (n < HEAP_PROBE_PACKETS && udp.parsePacket() > 0) {
+    samples[n++] = ESP.getFreeHeap();
+    udp.read(buf, PACKET_SIZE);
+  }
+  int32_t after = ESP.getFreeHeap();
+  if (n == 0) {
+    return -1;
+  }
+
+  int32_t released = (after - before) / n;  // lwIP memory freed per datagram
+  int32_t held = 0;
+  for (int k = 0; k < n; k++) {
+    // parsePackets() receives all of them before the first sample
+    int32_t expected = before + released * ((mode == MODE_RING_BATCH) ? n : k + 1);
+    held += expected - samples[k];
+  }
+  return held / n;
+}
+
+static void runMode(int mode, uint32_t *received, int32_t *heap) {
+  static uint8_t buf[PACKET_SIZE];
+  NetworkUDP udp;
+  if (mode != MODE_CBUF) {
+    udp.setRxRing(RING_SLOTS, PACKET_SIZE);
+  }
+  udp.begin(UDP_PORT);
+  udp.resetRxStats();
+
+  sent = 0;
+  sending = true;
+  sender_done = false;
+  xTaskCreatePinnedToCore(senderTask, "sender", 4096, NULL, 1, NULL, portNUM_PROCESSORS - 1 - xPortGetCoreID());
+
+  unsigned long start = millis();
+  while (millis() - start < RUN_TIME_MS) {
+    if (mode == MODE_RING_BATCH) {
+      udp.parsePackets();
+    }
+    while (udp.parsePacket() > 0) {
+      udp.read(buf, sizeof(buf));
+    }
+  }
+  udp_rx_stats_t stats;
+  udp.getRxStats(&stats);
+
+  sending = false;
+  while (!sender_done) {
+    delay(1);
+  }
+  // drain what is left before measuring the heap
+  delay(50);
+  if (mode == MODE_RING_BATCH) {
+    udp.parsePackets();
+  }
+  while (udp.parsePacket() > 0) {
+    udp.read(buf, sizeof(buf));
+  }
+  *heap = heapPerPacket(udp, mode, buf);
+  udp.stop();
+
+  *received = stats.packets;
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {
+    delay(10);
+  }
+
+  Network.begin();
+
+  Serial.printf("Runs: %d\n", N_RUNS);
+  Serial.printf("Packet size: %d\n", PACKET_SIZE);
+  Serial.flush();
+  for (int i = 0; i < N_RUNS; i++) {
+    Serial.printf("Run %d\n", i);
+    for (int mode = 0; mode < MODE_MAX; mode++) {
+      uint32_t received;
+      int32_t heap;
+      runMode(mode, &received, &heap);
+      Serial.printf("Mode: %s Sent: %lu Received: %lu\n", mode_names[mode], sent, received);
+      Serial.printf("Rate: %lu p/s Heap/packet: %ld\n", received * 1000 / RUN_TIME_MS, heap);
+      Serial.flush();
+    }
+  }
+
+  log_d("UDP test done");
+}
+
+void loop() {
+  vTaskDelete(NULL);
+}
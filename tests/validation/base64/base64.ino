@@ -0,0 +1,182 @@
+/* base64 codec test
+ * Compares the core base64 encoder and decoder with libb64 and reports the throughput of both.
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include <base64.h>
+extern "C" {
+#include "libb64/cdecode.h"
+#include "libb64/cencode.h"
+}
+
+#define MAX_LEN    300
+#define BENCH_SIZE 16384
+#define BENCH_RUNS 20
+
+// Print target that keeps what is written to it
+class BufferPrint : public Print {
+public:
+  uint8_t data[2 * MAX_LEN];
+  size_t len = 0;
+  size_t write(uint8_t c) override {
+    return write(&c, 1);
+  }
+  size_t write(const uint8_t *buffer, size_t size) override {
+    if (len + size > sizeof(data)) {
+      size = sizeof(data) - len;
+    }
+    memcpy(data + len, buffer, size);
+    len += size;
+    return size;
+  }
+};
+
+static uint8_t input[MAX_LEN];
+static char reference[2 * MAX_LEN];
+static char encoded[2 * MAX_LEN];
+static char spaced[3 * MAX_LEN];
+static char reference_decoded[2 * MAX_LEN];
+static uint8_t decoded[2 * MAX_LEN];
+
+/* These functions are intended to be called before and after each test. */
+void setUp(void) {
+  for (size_t i = 0; i < MAX_LEN; i++) {
+    input[i] = esp_random();
+  }
+}
+
+void tearDown(void) {}
+
+void test_encode_matches_libb64(void) {
+  for (size_t len = 0; len < MAX_LEN; len++) {
+    int ref_len = base64_encode_chars((const char *)input, len, reference);
+
+    TEST_ASSERT_EQUAL(ref_len, base64::encodedLength(len));
+    TEST_ASSERT_EQUAL(ref_len, base64::encode(input, len, encoded, sizeof(encoded)));
+    TEST_ASSERT_EQUAL_STRING(reference, encoded);
+    TEST_ASSERT_EQUAL(0, base64::encode(input, len, encoded, ref_len));
+    TEST_ASSERT_EQUAL_STRING(reference, base64::encode(input, len).c_str());
+
+    String appended = "x";
+    TEST_ASSERT_TRUE(base64::encode(input, len, appended));
+    TEST_ASSERT_EQUAL_STRING(reference, appended.c_str() + 1);
+
+    BufferPrint out;
+    TEST_ASSERT_EQUAL(ref_len, base64::encode(input, len, out));
+    TEST_ASSERT_EQUAL_MEMORY(reference, out.data, ref_len);
+  }
+}
+
+void test_encoder_split_writes(void) {
+  for (size_t len = 0; len < MAX_LEN; len += 7) {
+    int ref_len = base64_encode_chars((const char *)input, len, reference);
+    BufferPrint out;
+    base64::Encoder encoder(out);
+    size_t pos = 0, step = 1;
+    while (pos < len) {
+      size_t n = min(step, len - pos);
+      TEST_ASSERT_EQUAL(n, encoder.write(input + pos, n));
+      pos += n;
+      step = step % 5 + 1;
+    }
+    TEST_ASSERT_EQUAL(ref_len, encoder.end());
+    TEST_ASSERT_EQUAL_MEMORY(reference, out.data, ref_len);
+  }
+}
+
+void test_decode_matches_libb64(void) {
+  for (size_t len = 0; len < MAX_LEN; len++) {
+    int enc_len = base64_encode_chars((const char *)input, len, reference);
+
+    int ref_len = base64_decode_chars(reference, enc_len, reference_decoded);
+    TEST_ASSERT_EQUAL(len, ref_len);
+    TEST_ASSERT_EQUAL(len, base64::decode(reference, enc_len, decoded, sizeof(decoded)));
+    TEST_ASSERT_EQUAL_MEMORY(input, decoded, len);
+    TEST_ASSERT_EQUAL(len, base64::decode(reference, enc_len, decoded, len));
+    if (len) {
+      TEST_ASSERT_EQUAL(-1, base64::decode(reference, enc_len, decoded, len - 1));
+    }
+
+    String text = base64::decode(String(reference));
+    TEST_ASSERT_EQUAL(len, text.length());
+    TEST_ASSERT_EQUAL_MEMORY(input, text.c_str(), len);
+
+    // line breaks and truncated padding are skipped like in libb64
+    size_t spaced_len = 0;
+    for (int i = 0; i < enc_len - 1; i++) {
+      spaced[spaced_len++] = reference[i];
+      if (i % 19 == 18) {
+        spaced[spaced_len++] = '\r';
+        spaced[spaced_len++] = '\n';
+      }
+    }
+    ref_len = base64_decode_chars(spaced, spaced_len, reference_decoded);
+    TEST_ASSERT_EQUAL(ref_len, base64::decode(spaced, spaced_len, decoded, sizeof(decoded)));
+    TEST_ASSERT_EQUAL_MEMORY(reference_decoded, decoded, ref_len);
+
+    BufferPrint out;
+    TEST_ASSERT_EQUAL(ref_len, base64::decode(spaced, spaced_len, out));
+    TEST_ASSERT_EQUAL_MEMORY(reference_decoded, out.data, ref_len);
+  }
+}
+
+void test_throughput(void) {
+  uint8_t *data = (uint8_t *)malloc(BENCH_SIZE + 1);  // libb64 terminates the decoded data
+  char *text = (char *)malloc(base64::encodedLength(BENCH_SIZE) + 1);
+  TEST_ASSERT_NOT_NULL(data);
+  TEST_ASSERT_NOT_NULL(text);
+  for (size_t i = 0; i < BENCH_SIZE; i++) {
+    data[i] = esp_random();
+  }
+  size_t text_len = base64::encodedLength(BENCH_SIZE);
+  uint32_t start;
+  float libb64_encode, core_encode, libb64_decode, core_decode;
+
+  start = micros();
+  for (int i = 0; i < BENCH_RUNS; i++) {
+    base64_encode_chars((const char *)data, BENCH_SIZE, text);
+  }
+  libb64_encode = (float)BENCH_SIZE * BENCH_RUNS / (micros() - start);
+
+  start = micros();
+  for (int i = 0; i < BENCH_RUNS; i++) {
+    base64::encode(data, BENCH_SIZE, text, text_len + 1);
+  }
+  core_encode = (float)BENCH_SIZE * BENCH_RUNS / (micros() - start);
+
+  start = micros();
+  for (int i = 0; i < BENCH_RUNS; i++) {
+    base64_decode_chars(text, text_len, (char *)data);
+  }
+  libb64_decode = (float)BENCH_SIZE * BENCH_RUNS / (micros() - start);
+
+  start = micros();
+  for (int i = 0; i < BENCH_RUNS; i++) {
+    base64::decode(text, text_len, data, BENCH_SIZE);
+  }
+  core_decode = (float)BENCH_SIZE * BENCH_RUNS / (micros() - start);
+
+  Serial.printf("Encode: libb64 %.2f MB/s, base64 %.2f MB/s\n", libb64_encode, core_encode);
+  Serial.printf("Decode: libb64 %.2f MB/s, base64 %.2f MB/s\n", libb64_decode, core_decode);
+
+  free(text);
+  free(data);
+  TEST_ASSERT_GREATER_THAN(libb64_encode, core_encode);
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {
+    delay(10);
+  }
+
+  UNITY_BEGIN();
+  RUN_TEST(test_encode_matches_libb64);
+  RUN_TEST(test_encoder_split_writes);
+  RUN_TEST(test_decode_matches_libb64);
+  RUN_TEST(test_throughput);
+  UNITY_END();
+}
+
+void loop() {}
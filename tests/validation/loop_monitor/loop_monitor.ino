@@ -0,0 +1,123 @@
+/* Loop monitor test
+ * Drives loopMonitorIteration() by hand to check the loop statistics and the micro task scheduler.
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+
+static volatile uint32_t fast_runs;
+static volatile uint32_t slow_runs;
+
+static void fast_task(void *arg) {
+  fast_runs++;
+}
+
+static void slow_task(void *arg) {
+  slow_runs++;
+  delayMicroseconds(*(uint32_t *)arg);
+}
+
+void setUp(void) {
+  fast_runs = 0;
+  slow_runs = 0;
+  resetLoopStats();
+  microTaskSetBudget(1000);
+}
+
+void tearDown(void) {
+  disableLoopStats();
+  for (int i = 0; i < MICRO_TASK_MAX; i++) {
+    microTaskRemove(i);
+  }
+}
+
+void test_histogram_and_max(void) {
+  enableLoopStats();
+  loopMonitorIteration();
+  for (int i = 0; i < 100; i++) {
+    delayMicroseconds(100);
+    loopMonitorIteration();
+  }
+  delay(20);
+  loopMonitorIteration();
+
+  loop_stats_t stats;
+  TEST_ASSERT_TRUE(getLoopStats(&stats));
+  TEST_ASSERT_EQUAL(101, stats.iterations);
+  TEST_ASSERT_UINT32_WITHIN(2000, 20000, stats.max_us);
+  TEST_ASSERT_EQUAL(0, stats.near_misses);
+
+  uint32_t total = 0;
+  for (int i = 0; i < LOOP_STATS_BUCKETS; i++) {
+    total += stats.histogram[i];
+  }
+  TEST_ASSERT_EQUAL(stats.iterations, total);
+  // 100 us iterations land in [64, 128) and [128, 256)
+  TEST_ASSERT_GREATER_OR_EQUAL(90, stats.histogram[3] + stats.histogram[4]);
+}
+
+void test_near_miss(void) {
+  setLoopStallThreshold(10);
+  enableLoopStats();
+  loopMonitorIteration();
+  delay(15);
+  loopMonitorIteration();
+
+  loop_stats_t stats;
+  getLoopStats(&stats);
+  TEST_ASSERT_EQUAL(1, stats.near_misses);
+  TEST_ASSERT_EQUAL(10, stats.threshold_ms);
+  setLoopStallThreshold(CONFIG_ESP_TASK_WDT_TIMEOUT_S * 1000 / 2);
+}
+
+void test_micro_task_period(void) {
+  int id = microTaskAdd("fast", fast_task, 10);
+  TEST_ASSERT_GREATER_OR_EQUAL(0, id);
+  uint32_t start = millis();
+  while (millis() - start < 105) {
+    loopMonitorIteration();
+    delay(1);
+  }
+  TEST_ASSERT_UINT32_WITHIN(1, 10, fast_runs);
+
+  micro_task_stats_t stats;
+  TEST_ASSERT_TRUE(microTaskGetStats(id, &stats));
+  TEST_ASSERT_EQUAL(fast_runs, stats.runs);
+  TEST_ASSERT_EQUAL_STRING("fast", stats.name);
+
+  TEST_ASSERT_TRUE(microTaskRemove(id));
+  TEST_ASSERT_FALSE(microTaskRemove(id));
+  uint32_t runs = fast_runs;
+  delay(20);
+  loopMonitorIteration();
+  TEST_ASSERT_EQUAL(runs, fast_runs);
+}
+
+void test_micro_task_budget(void) {
+  static uint32_t busy_us = 1200;
+  microTaskAdd("slow", slow_task, 0, &busy_us);
+  microTaskAdd("fast", fast_task, 0);
+
+  // the slow task overruns the budget on its own, the fast one is not starved by it
+  for (int i = 0; i < 10; i++) {
+    loopMonitorIteration();
+  }
+  TEST_ASSERT_GREATER_OR_EQUAL(5, fast_runs);
+  TEST_ASSERT_GREATER_OR_EQUAL(5, slow_runs);
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {
+    delay(10);
+  }
+
+  UNITY_BEGIN();
+  RUN_TEST(test_histogram_and_max);
+  RUN_TEST(test_near_miss);
+  RUN_TEST(test_micro_task_period);
+  RUN_TEST(test_micro_task_budget);
+  UNITY_END();
+}
+
+void loop() {}
@@ -0,0 +1,172 @@
+/* Print::printf() and print(n, base) output test
+ * Compares the streaming Print::printf() with vsnprintf() and print(n, base) with a reference conversion.
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include <stdarg.h>
+
+#define MAX_LEN 512
+
+// Print target that keeps what is written to it
+class BufferPrint : public Print {
+public:
+  char data[MAX_LEN];
+  size_t len = 0;
+  size_t write(uint8_t c) override {
+    return write(&c, 1);
+  }
+  size_t write(const uint8_t *buffer, size_t size) override {
+    if (len + size > sizeof(data) - 1) {
+      size = sizeof(data) - 1 - len;
+    }
+    memcpy(data + len, buffer, size);
+    len += size;
+    data[len] = 0;
+    return size;
+  }
+  void clear() {
+    len = 0;
+    data[0] = 0;
+  }
+};
+
+static BufferPrint out;
+static char expected[MAX_LEN];
+
+// Formats with both implementations and compares the text and the returned length
+static void checkFormat(const char *format, ...) {
+  va_list arg;
+  va_list copy;
+  va_start(arg, format);
+  va_copy(copy, arg);
+  int len = vsnprintf(expected, sizeof(expected), format, copy);
+  va_end(copy);
+  out.clear();
+  size_t written = out.vprintf(format, arg);
+  va_end(arg);
+  TEST_ASSERT_EQUAL_STRING_MESSAGE(expected, out.data, format);
+  TEST_ASSERT_EQUAL_MESSAGE(len, (int)written, format);
+}
+
+static const char *referenceNumber(char *buf, size_t size, unsigned long long n, uint8_t base) {
+  char *p = buf + size;
+  *--p = 0;
+  do {
+    unsigned c = n % base;
+    n /= base;
+    *--p = (c < 10) ? '0' + c : 'A' + c - 10;
+  } while (n);
+  return p;
+}
+
+void setUp(void) {
+  out.clear();
+}
+
+void tearDown(void) {}
+
+void test_signed(void) {
+  static const int values[] = {0, 1, -1, 7, -42, 12345, -98765, INT32_MAX, INT32_MIN};
+  static const char *formats[] = {"%d", "%i", "%5d", "%-5d|", "%05d", "%+d", "% d", "%.3d", "%8.3d", "%-+8.3d|", "%.0d", "%+05d", "% 05d"};
+  for (const char *f : formats) {
+    for (int v : values) {
+      checkFormat(f, v);
+    }
+  }
+  checkFormat("%*d|%-*d|%.*d", 6, -12, 6, 34, 4, 5);
+  checkFormat("%*d|", -6, 12);
+  checkFormat("%hhd %hd", 300, 70000);
+  checkFormat("%ld %ld", (long)LONG_MAX, (long)LONG_MIN);
+  checkFormat("%lld %lld %lld", (long long)LLONG_MAX, (long long)LLONG_MIN, -1234567890123LL);
+  checkFormat("%zd %jd %td", (ssize_t)-5, (intmax_t)INT64_MIN, (ptrdiff_t)-77);
+}
+
+void test_unsigned(void) {
+  static const unsigned values[] = {0, 1, 7, 8, 15, 16, 255, 4096, 0xDEADBEEF, UINT32_MAX};
+  static const char *formats[] = {"%u", "%x", "%X", "%o", "%#x", "%#X", "%#o", "%8x", "%-8X|", "%08x", "%#010x", "%.6o", "%#.0o", "%.0x", "%#8.4x"};
+  for (const char *f : formats) {
+    for (unsigned v : values) {
+      checkFormat(f, v);
+    }
+  }
+  checkFormat("%hhu %hhx %hu %ho", 0x1FF, 0x1AB, 0x12345, 0x12345);
+  checkFormat("%lu %lx", (unsigned long)ULONG_MAX, (unsigned long)0xCAFEUL);
+  checkFormat("%llu %llx %llX %llo", (unsigned long long)ULLONG_MAX, 0x0123456789ABCDEFULL, 0xFEDCBA9876543210ULL, 01234567012345670ULL);
+  checkFormat("%zu %zx", (size_t)SIZE_MAX, (size_t)0x1234);
+}
+
+void test_pointer_char_string(void) {
+  int local = 0;
+  checkFormat("%p", (void *)&local);
+  checkFormat("%20p|%-20p|", (void *)&local, (void *)0x1234);
+  checkFormat("%c%c%c", 'a', 'B', '0');
+  checkFormat("%5c|%-5c|", 'x', 'y');
+  checkFormat("%s", "hello");
+  checkFormat("%10s|%-10s|%.3s|%8.2s|", "right", "left", "truncate", "ab");
+  checkFormat("%*s|%-*.*s|", 7, "abc", 7, 2, "abc");
+  checkFormat("%s", "");
+  checkFormat("100%% %s", "done");
+}
+
+void test_delegated(void) {
+  checkFormat("%f %.2f %10.3f %-10.1f|", 3.14159, -2.5, 1e3, 0.05);
+  checkFormat("%e %E %g %G", 12345.678, 0.000123, 1e-10, 1e20);
+  checkFormat("%+08.2f % .1f %#.0f", 1.5, 2.25, 3.0);
+}
+
+void test_long_output(void) {
+  char text[300];
+  memset(text, 'z', sizeof(text) - 1);
+  text[sizeof(text) - 1] = 0;
+  checkFormat("[%s] %d [%s]", text, 42, "tail");
+  checkFormat("%400d|", 7);
+}
+
+void test_print_base(void) {
+  static const unsigned long long values[] = {0, 1, 9, 10, 35, 36, 255, 1295, 1296, 0xDEADBEEF, ULLONG_MAX};
+  char ref[70];
+  for (uint8_t base = 2; base <= 36; base++) {
+    for (unsigned long long v : values) {
+      out.clear();
+      out.print(v, base);
+      TEST_ASSERT_EQUAL_STRING(referenceNumber(ref, sizeof(ref), v, base), out.data);
+      if (v <= ULONG_MAX) {
+        out.clear();
+        out.print((unsigned long)v, base);
+        TEST_ASSERT_EQUAL_STRING(referenceNumber(ref, sizeof(ref), v, base), out.data);
+      }
+    }
+  }
+  out.clear();
+  out.print(-42L, 10);
+  TEST_ASSERT_EQUAL_STRING("-42", out.data);
+  out.clear();
+  out.print(35, 36);
+  TEST_ASSERT_EQUAL_STRING("Z", out.data);
+  // bases without digits fall back to 10
+  out.clear();
+  out.print(1295, 37);
+  TEST_ASSERT_EQUAL_STRING("1295", out.data);
+  out.clear();
+  out.print(1295, 255);
+  TEST_ASSERT_EQUAL_STRING("1295", out.data);
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {
+    delay(10);
+  }
+
+  UNITY_BEGIN();
+  RUN_TEST(test_signed);
+  RUN_TEST(test_unsigned);
+  RUN_TEST(test_pointer_char_string);
+  RUN_TEST(test_delegated);
+  RUN_TEST(test_long_output);
+  RUN_TEST(test_print_base);
+  UNITY_END();
+}
+
+void loop() {}
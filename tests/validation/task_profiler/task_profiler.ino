@@ -0,0 +1,161 @@
+/* Task profiler test
+ * Checks sampling, reading, both export formats and that stopping the profiler releases everything.
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include "freertos_stats.h"
+
+#define MAX_TASKS 32
+#define DEPTH     4
+
+// Print target that keeps what is written to it
+class BufferPrint : public Print {
+public:
+  uint8_t data[8192];
+  size_t len = 0;
+  size_t write(uint8_t c) override {
+    return write(&c, 1);
+  }
+  size_t write(const uint8_t *buffer, size_t size) override {
+    if (len + size > sizeof(data)) {
+      size = sizeof(data) - len;
+    }
+    memcpy(data + len, buffer, size);
+    len += size;
+    return size;
+  }
+};
+
+static BufferPrint out;
+static task_profile_entry_t entries[MAX_TASKS];
+
+template<typename T> static T readValue(const uint8_t *&p) {
+  T value;
+  memcpy(&value, p, sizeof(value));
+  p += sizeof(value);
+  return value;
+}
+
+void setUp(void) {
+  out.len = 0;
+}
+
+void tearDown(void) {
+  taskProfilerEnd();
+}
+
+void test_invalid_parameters(void) {
+  TEST_ASSERT_FALSE(taskProfilerBegin(0));
+  TEST_ASSERT_FALSE(taskProfilerBegin(10, 0));
+  TEST_ASSERT_FALSE(taskProfilerBegin(10, MAX_TASKS, 0));
+  TEST_ASSERT_TRUE(taskProfilerBegin(10, MAX_TASKS, DEPTH));
+  TEST_ASSERT_FALSE(taskProfilerBegin(10, MAX_TASKS, DEPTH));
+}
+
+void test_read(void) {
+  TEST_ASSERT_TRUE(taskProfilerBegin(20, MAX_TASKS, DEPTH));
+  delay(200);
+  TEST_ASSERT_EQUAL(DEPTH, taskProfilerAvailable());
+  TEST_ASSERT_GREATER_THAN(0, taskProfilerDropped());
+
+  task_profile_sample_t sample;
+  TEST_ASSERT_TRUE(taskProfilerRead(&sample, entries, MAX_TASKS));
+  TEST_ASSERT_LESS_OR_EQUAL(DEPTH, taskProfilerAvailable());
+  TEST_ASSERT_GREATER_THAN(0, sample.task_count);
+  TEST_ASSERT_UINT32_WITHIN(10000, 20000, sample.period_us);
+  bool loop_task = false;
+  bool idle_task = false;
+  for (uint16_t i = 0; i < sample.task_count; i++) {
+    loop_task |= strcmp(entries[i].name, "loopTask") == 0;
+    idle_task |= strncmp(entries[i].name, "IDLE", 4) == 0;
+  }
+  TEST_ASSERT_TRUE(loop_task);
+  TEST_ASSERT_TRUE(idle_task);
+
+  // fewer entries than tasks are truncated
+  TEST_ASSERT_TRUE(taskProfilerRead(&sample, entries, 1));
+  TEST_ASSERT_EQUAL(1, sample.task_count);
+}
+
+void test_export_csv(void) {
+  TEST_ASSERT_TRUE(taskProfilerBegin(20, MAX_TASKS, DEPTH));
+  delay(100);
+  size_t pending = taskProfilerAvailable();
+  TEST_ASSERT_GREATER_THAN(0, pending);
+  size_t exported = taskProfilerExport(out, TASK_PROFILE_CSV);
+  TEST_ASSERT_GREATER_OR_EQUAL(pending, exported);
+  TEST_ASSERT_EQUAL(0, taskProfilerAvailable());
+
+  const char *header = "ms,task,name,load,stack,prio,core\r\n";
+  TEST_ASSERT_EQUAL_MEMORY(header, out.data, strlen(header));
+  TEST_ASSERT_NOT_NULL(memmem(out.data, out.len, ",loopTask,", 10));
+}
+
+void test_export_binary(void) {
+  TEST_ASSERT_TRUE(taskProfilerBegin(20, MAX_TASKS, DEPTH));
+  delay(100);
+  size_t exported = taskProfilerExport(out, TASK_PROFILE_BINARY);
+  TEST_ASSERT_GREATER_THAN(0, exported);
+  TEST_ASSERT_LESS_THAN(sizeof(out.data), out.len);
+
+  // the records are packed, walking them must end exactly at the end of the output
+  const uint8_t *p = out.data;
+  const uint8_t *end = out.data + out.len;
+  size_t records = 0;
+  while (p < end) {
+    TEST_ASSERT_EQUAL_UINT8('T', p[0]);
+    TEST_ASSERT_EQUAL_UINT8('P', p[1]);
+    TEST_ASSERT_EQUAL_UINT8(1, p[2]);
+    TEST_ASSERT_EQUAL_UINT8(portNUM_PROCESSORS, p[3]);
+    p += 4;
+    readValue<uint32_t>(p);  // timestamp
+    uint32_t period_us = readValue<uint32_t>(p);
+    uint16_t task_count = readValue<uint16_t>(p);
+    TEST_ASSERT_UINT32_WITHIN(10000, 20000, period_us);
+    TEST_ASSERT_GREATER_THAN(0, task_count);
+    TEST_ASSERT_LESS_OR_EQUAL(MAX_TASKS, task_count);
+    p += portNUM_PROCESSORS * (sizeof(uint16_t) + sizeof(uint32_t));
+    for (uint16_t i = 0; i < task_count; i++) {
+      p += sizeof(uint16_t) + sizeof(uint16_t) + sizeof(uint32_t) + 2;  // number, load, stack, priority, core
+      uint8_t name_len = *p++;
+      TEST_ASSERT_LESS_THAN(configMAX_TASK_NAME_LEN, name_len);
+      p += name_len;
+    }
+    records++;
+  }
+  TEST_ASSERT_TRUE(p == end);
+  TEST_ASSERT_EQUAL(exported, records);
+}
+
+void test_restart_releases_memory(void) {
+  // let the heap settle after the previous test
+  delay(50);
+  uint32_t free_before = ESP.getFreeHeap();
+  for (int i = 0; i < 50; i++) {
+    TEST_ASSERT_TRUE(taskProfilerBegin(1, MAX_TASKS, DEPTH));
+    delay(i % 4);
+    taskProfilerEnd();
+  }
+  TEST_ASSERT_EQUAL(0, taskProfilerAvailable());
+  TEST_ASSERT_FALSE(taskProfilerRead(NULL, NULL, 0));
+  TEST_ASSERT_EQUAL(0, taskProfilerExport(out));
+  TEST_ASSERT_UINT32_WITHIN(512, free_before, ESP.getFreeHeap());
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {
+    delay(10);
+  }
+
+  UNITY_BEGIN();
+  RUN_TEST(test_invalid_parameters);
+  RUN_TEST(test_read);
+  RUN_TEST(test_export_csv);
+  RUN_TEST(test_export_binary);
+  RUN_TEST(test_restart_releases_memory);
+  UNITY_END();
+}
+
+void loop() {}
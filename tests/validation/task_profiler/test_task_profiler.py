@@ -0,0 +1,2 @@
+def test_task_profiler(dut):
+    dut.expect_unity_test_output(timeout=240)
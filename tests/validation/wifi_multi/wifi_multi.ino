@@ -0,0 +1,124 @@
+/* WiFiMulti fast connect test
+ * Connects to the Wokwi-GUEST network once with a full scan, then checks that run() connects
+ * to the cached AP without scanning, and that when the cached AP fails it falls back to a scan
+ * of its channel, a scan for its SSID and a full scan, in that order.
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include <WiFi.h>
+#include <WiFiMulti.h>
+
+#define SSID            "Wokwi-GUEST"
+#define CONNECT_TIMEOUT 10000
+#define MAX_SCANS       8
+
+// Scan source that finds nothing and records the scans it was asked for
+class RecordingScanSource : public WiFiMultiScanSource {
+public:
+  struct {
+    uint8_t channel;
+    char ssid[33];
+  } scans[MAX_SCANS];
+  int count = 0;
+
+  int16_t scan(bool show_hidden, uint8_t channel, const char *ssid) override {
+    if (count < MAX_SCANS) {
+      scans[count].channel = channel;
+      strlcpy(scans[count].ssid, ssid ? ssid : "", sizeof(scans[count].ssid));
+    }
+    count++;
+    return 0;
+  }
+  bool result(int16_t index, wifi_multi_scan_result_t *result) override {
+    return false;
+  }
+  void clear() override {}
+};
+
+static uint8_t cached_channel;
+
+static void disconnect() {
+  WiFi.disconnect();
+  while (WiFi.status() == WL_CONNECTED) {
+    delay(10);
+  }
+}
+
+void setUp(void) {
+  disconnect();
+}
+
+void tearDown(void) {}
+
+void test_full_scan_without_cache(void) {
+  WiFiMulti multi;
+  multi.addAP(SSID);
+  multi.setFastConnect(true);
+  multi.clearFastConnect();
+  TEST_ASSERT_EQUAL(WL_CONNECTED, multi.run(CONNECT_TIMEOUT));
+  TEST_ASSERT_EQUAL(WIFI_MULTI_PATH_FULL_SCAN, multi.lastConnectPath());
+  cached_channel = WiFi.channel();
+  TEST_ASSERT_NOT_EQUAL(0, cached_channel);
+}
+
+void test_direct_connect(void) {
+  RecordingScanSource source;
+  WiFiMulti multi;
+  multi.addAP(SSID);
+  multi.setFastConnect(true);
+  multi.setScanSource(&source);
+  TEST_ASSERT_EQUAL(WL_CONNECTED, multi.run(CONNECT_TIMEOUT));
+  TEST_ASSERT_EQUAL(WIFI_MULTI_PATH_DIRECT, multi.lastConnectPath());
+  TEST_ASSERT_EQUAL(0, source.count);
+}
+
+void test_fallback_order(void) {
+  RecordingScanSource source;
+  WiFiMulti multi;
+  // a passphrase for the open network makes the direct connect to the cached AP fail
+  multi.addAP(SSID, "wrong-passphrase");
+  multi.setFastConnect(true);
+  multi.setScanSource(&source);
+  TEST_ASSERT_NOT_EQUAL(WL_CONNECTED, multi.run(3000));
+
+  wifi_multi_path_stats_t stats;
+  TEST_ASSERT_TRUE(multi.getPathStats(WIFI_MULTI_PATH_DIRECT, &stats));
+  TEST_ASSERT_EQUAL(1, stats.attempts);
+  TEST_ASSERT_EQUAL(0, stats.connects);
+
+  TEST_ASSERT_EQUAL(3, source.count);
+  // the channel the AP was last seen on
+  TEST_ASSERT_EQUAL(cached_channel, source.scans[0].channel);
+  TEST_ASSERT_EQUAL_STRING("", source.scans[0].ssid);
+  // its SSID on all channels
+  TEST_ASSERT_EQUAL(0, source.scans[1].channel);
+  TEST_ASSERT_EQUAL_STRING(SSID, source.scans[1].ssid);
+  // everything
+  TEST_ASSERT_EQUAL(0, source.scans[2].channel);
+  TEST_ASSERT_EQUAL_STRING("", source.scans[2].ssid);
+
+  // the failed direct connect forgets the cached AP, the next run only does the full scan
+  source.count = 0;
+  multi.run(3000);
+  TEST_ASSERT_EQUAL(1, source.count);
+  TEST_ASSERT_EQUAL(0, source.scans[0].channel);
+  TEST_ASSERT_EQUAL_STRING("", source.scans[0].ssid);
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {
+    delay(10);
+  }
+
+  WiFi.mode(WIFI_STA);
+
+  UNITY_BEGIN();
+  RUN_TEST(test_full_scan_without_cache);
+  RUN_TEST(test_direct_connect);
+  RUN_TEST(test_fallback_order);
+  UNITY_END();
+}
+
+void loop() {}
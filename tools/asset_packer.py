@@ -0,0 +1,207 @@
+#!/usr/bin/env python
+#
+# AssetFS image packer
+#
+# Packs a directory into a read-only image for the AssetFS library. The image is
+# flashed to a data partition and served by the device straight from mapped flash:
+#
+#   python asset_packer.py data/ assets.bin --size 0x100000
+#   esptool.py write_flash <partition offset> assets.bin
+#
+# Compressible files are stored gzipped (as "<name>.gz") when that makes them smaller.
+# Every file gets its content type and a quoted base64 MD5 ETag, the same ETag that
+# WebServer computes for serveStatic(), so caches stay valid when switching.
+#
+# SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+# SPDX-License-Identifier: Apache-2.0
+import argparse
+import base64
+import fnmatch
+import gzip
+import hashlib
+import os
+import struct
+import sys
+import time
+
+MAGIC = 0x31545341  # "AST1"
+VERSION = 1
+FLAG_GZIP = 0x01
+
+HEADER_FMT = "<IHHIIII8x"
+ENTRY_FMT = "<IIIIIIHBBI"
+HEADER_SIZE = struct.calcsize(HEADER_FMT)
+ENTRY_SIZE = struct.calcsize(ENTRY_FMT)
+DATA_ALIGN = 4
+
+# Same table as libraries/WebServer/src/detail/mimetable.cpp
+MIME_TYPES = [
+    (".html", "text/html"),
+    (".htm", "text/html"),
+    (".css", "text/css"),
+    (".txt", "text/plain"),
+    (".js", "application/javascript"),
+    (".json", "application/json"),
+    (".png", "image/png"),
+    (".gif", "image/gif"),
+    (".jpg", "image/jpeg"),
+    (".ico", "image/x-icon"),
+    (".svg", "image/svg+xml"),
+    (".ttf", "application/x-font-ttf"),
+    (".otf", "application/x-font-opentype"),
+    (".woff", "application/font-woff"),
+    (".woff2", "application/font-woff2"),
+    (".eot", "application/vnd.ms-fontobject"),
+    (".sfnt", "application/font-sfnt"),
+    (".xml", "text/xml"),
+    (".pdf", "application/pdf"),
+    (".zip", "application/zip"),
+    (".gz", "application/x-gzip"),
+    (".appcache", "text/cache-manifest"),
+]
+DEFAULT_MIME = "application/octet-stream"
+
+# Already compressed formats are stored as they are
+COMPRESSIBLE = {".html", ".htm", ".css", ".txt", ".js", ".json", ".svg", ".xml", ".ico", ".ttf", ".otf", ".eot", ".sfnt", ".appcache"}
+
+
+def content_type(path):
+    for ext, mime in MIME_TYPES:
+        if path.endswith(ext):
+            return mime
+    return DEFAULT_MIME
+
+
+def etag(data):
+    return '"' + base64.b64encode(hashlib.md5(data).digest()).decode("ascii") + '"'
+
+
+def parse_size(value):
+    value = value.strip().upper()
+    for suffix, mult in (("K", 1024), ("M", 1024 * 1024)):
+        if value.endswith(suffix):
+            return int(value[:-1], 0) * mult
+    return int(value, 0)
+
+
+def collect(source, excludes):
+    files = []
+    for root, dirs, names in os.walk(source):
+        dirs.sort()
+        for name in sorted(names):
+            full = os.path.join(root, name)
+            rel = "/" + os.path.relpath(full, source).replace(os.sep, "/")
+            if any(fnmatch.fnmatch(rel, pattern) or fnmatch.fnmatch(name, pattern) for pattern in excludes):
+                continue
+            files.append((rel, full))
+    return files
+
+
+def build_image(files, use_gzip=True, level=9, build_time=None, verbose=False):
+    assets = []
+    for rel, full in files:
+        with open(full, "rb") as f:
+            data = f.read()
+        mime = content_type(rel)
+        path = rel
+        flags = 0
+        ext = os.path.splitext(rel)[1].lower()
+        if use_gzip and ext in COMPRESSIBLE and data:
+            # mtime=0 keeps the output, and with it the ETag, reproducible
+            packed = gzip.compress(data, compresslevel=level, mtime=0)
+            if len(packed) < len(data):
+                if verbose:
+                    print("  %-40s %8d -> %8d gzip" % (rel, len(data), len(packed)))
+                path = rel + ".gz"
+                flags |= FLAG_GZIP
+                assets.append((path, packed, len(data), mime, flags))
+                continue
+        if verbose:
+            print("  %-40s %8d" % (rel, len(data)))
+        assets.append((path, data, len(data), mime, flags))
+
+    # the device looks files up with a binary search over the byte order of the paths
+    assets.sort(key=lambda a: a[0].encode("utf-8"))
+    paths = [a[0] for a in assets]
+    if len(set(paths)) != len(paths):
+        raise ValueError("Duplicate paths, a file and its .gz copy can not both be packed")
+
+    entries_offset = HEADER_SIZE
+    strings = bytearray()
+    string_base = entries_offset + ENTRY_SIZE * len(assets)
+
+    def add_string(s):
+        raw = s.encode("utf-8")
+        if len(raw) > 0xFFFF:
+            raise ValueError("String too long: %s" % s)
+        offset = string_base + len(strings)
+        strings.extend(raw + b"\0")
+        return offset, len(raw)
+
+    refs = []
+    for path, data, orig_size, mime, flags in assets:
+        path_ref = add_string(path)
+        etag_ref = add_string(etag(data))
+        mime_ref = add_string(mime)
+        if etag_ref[1] > 0xFF or mime_ref[1] > 0xFF:
+            raise ValueError("ETag or content type too long for %s" % path)
+        refs.append((path_ref, etag_ref, mime_ref))
+
+    data_offset = string_base + len(strings)
+    blob = bytearray()
+    entries = bytearray()
+    for (path, data, orig_size, mime, flags), (path_ref, etag_ref, mime_ref) in zip(assets, refs):
+        pad = (-(data_offset + len(blob))) % DATA_ALIGN
+        blob.extend(b"\0" * pad)
+        offset = data_offset + len(blob)
+        blob.extend(data)
+        entries.extend(
+            struct.pack(
+                ENTRY_FMT, path_ref[0], offset, len(data), orig_size, etag_ref[0], mime_ref[0], path_ref[1], etag_ref[1], mime_ref[1], flags
+            )
+        )
+
+    image_size = data_offset + len(blob)
+    if build_time is None:
+        build_time = int(os.environ.get("SOURCE_DATE_EPOCH", time.time()))
+    header = struct.pack(HEADER_FMT, MAGIC, VERSION, ENTRY_SIZE, len(assets), entries_offset, image_size, build_time)
+    return bytes(header + entries + strings + blob), len(assets)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Pack a directory into an AssetFS image")
+    parser.add_argument("source", help="Directory with the files to serve")
+    parser.add_argument("output", help="Image file to write")
+    parser.add_argument("--size", help="Size of the target partition, fails if the image does not fit (e.g. 0x100000 or 1M)")
+    parser.add_argument("--no-gzip", action="store_true", help="Store every file uncompressed")
+    parser.add_argument("--level", type=int, default=9, choices=range(1, 10), help="gzip compression level (default 9)")
+    parser.add_argument("--exclude", action="append", default=[], help="Glob of files to leave out, can be repeated")
+    parser.add_argument("--pad", action="store_true", help="Pad the image with 0xFF up to --size")
+    parser.add_argument("-v", "--verbose", action="store_true")
+    args = parser.parse_args()
+
+    if not os.path.isdir(args.source):
+        print("Source %s is not a directory" % args.source, file=sys.stderr)
+        return 1
+    try:
+        image, count = build_image(collect(args.source, args.exclude), not args.no_gzip, args.level, verbose=args.verbose)
+    except ValueError as e:
+        print(str(e), file=sys.stderr)
+        return 1
+
+    if args.size:
+        size = parse_size(args.size)
+        if len(image) > size:
+            print("Image is %d bytes, the partition only has %d" % (len(image), size), file=sys.stderr)
+            return 1
+        if args.pad:
+            image += b"\xff" * (size - len(image))
+
+    with open(args.output, "wb") as f:
+        f.write(image)
+    print("Packed %d files, %d bytes" % (count, len(image)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
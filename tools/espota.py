@@ -36,6 +36,11 @@
 # - Incorporated exception handling to catch and handle potential errors.
 # - Made variable names more descriptive for better readability.
 # - Introduced constants for better code maintainability.
+#
+# Changes
+# 2025-06-02:
+# - Added --compress to send the image compressed (see ota_compress.py).
+# - Report the bytes sent and the upload time.
 
 from __future__ import print_function
 import socket
@@ -44,7 +49,9 @@ import os
 import argparse
 import logging
 import hashlib
+import io
 import random
+import time
 
 # Commands
 FLASH = 0
@@ -81,7 +88,16 @@ def update_progress(progress):
         sys.stderr.flush()
 
 
-def serve(remote_addr, local_addr, remote_port, local_port, password, filename, command=FLASH):  # noqa: C901
+def report_upload(sent, image_size, start_time):
+    elapsed = time.time() - start_time
+    sys.stderr.write(
+        "\nSent %d bytes for a %d bytes image (%.1f%%) in %.2f s, %.1f KB/s\n"
+        % (sent, image_size, 100.0 * sent / max(image_size, 1), elapsed, sent / 1024.0 / max(elapsed, 0.001))
+    )
+    sys.stderr.flush()
+
+
+def serve(remote_addr, local_addr, remote_port, local_port, password, filename, command=FLASH, compress=False):  # noqa: C901
     # Create a TCP/IP socket
     sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
     server_address = (local_addr, local_port)
@@ -93,9 +109,17 @@ def serve(remote_addr, local_addr, remote_port, local_port, password, filename,
         logging.error("Listen Failed: %s", str(e))
         return 1
 
-    content_size = os.path.getsize(filename)
-    file_md5 = hashlib.md5(open(filename, "rb").read()).hexdigest()
-    logging.info("Upload size: %d", content_size)
+    with open(filename, "rb") as f:
+        content = f.read()
+    image_size = len(content)
+    if compress:
+        from ota_compress import compress_image, is_compressed
+
+        if not is_compressed(content):
+            content = compress_image(content)
+    content_size = len(content)
+    file_md5 = hashlib.md5(content).hexdigest()
+    logging.info("Upload size: %d (image %d)", content_size, image_size)
     message = "%d %d %d %s\n" % (command, local_port, content_size, file_md5)
 
     # Wait for a connection
@@ -173,7 +197,8 @@ def serve(remote_addr, local_addr, remote_port, local_port, password, filename,
         sock.close()
         return 1
     try:
-        with open(filename, "rb") as f:
+        start_time = time.time()
+        with io.BytesIO(content) as f:
             if PROGRESS:
                 update_progress(0)
             else:
@@ -198,6 +223,7 @@ def serve(remote_addr, local_addr, remote_port, local_port, password, filename,
                     return 1
 
             if last_response_contained_ok:
+                report_upload(content_size, image_size, start_time)
                 logging.info("Success")
                 connection.close()
                 return 0
@@ -213,6 +239,7 @@ def serve(remote_addr, local_addr, remote_port, local_port, password, filename,
                     logging.info("Result: %s", data)
 
                     if "OK" in data:
+                        report_upload(content_size, image_size, start_time)
                         logging.info("Success")
                         connection.close()
                         return 0
@@ -262,6 +289,14 @@ def parse_args(unparsed_args):
         help="Transmit a SPIFFS image and do not flash the module.",
         default=False,
     )
+    parser.add_argument(
+        "-z",
+        "--compress",
+        dest="compress",
+        action="store_true",
+        help="Compress the image before sending it. The device inflates it while writing.",
+        default=False,
+    )
 
     # output
     parser.add_argument(
@@ -317,7 +352,14 @@ def main(args):
         command = SPIFFS
 
     return serve(
-        options.esp_ip, options.host_ip, options.esp_port, options.host_port, options.auth, options.image, command
+        options.esp_ip,
+        options.host_ip,
+        options.esp_port,
+        options.host_port,
+        options.auth,
+        options.image,
+        command,
+        options.compress,
     )
 
 
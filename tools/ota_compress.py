@@ -0,0 +1,102 @@
+#!/usr/bin/env python3
+#
+# Compress an application or filesystem image for OTA
+#
+# The Update library recognizes the header and inflates the image while it is written,
+# so ArduinoOTA, HTTPUpdate, the web updaters and Update.write() accept the output as is.
+# Only the compressed bytes go over the network.
+#
+# use it like:
+# python ota_compress.py [-w window_bits] sketch.bin [sketch.bin.z]
+#
+# Header, little endian, 16 bytes:
+#   magic "ESPZ", version 1, format 1 (zlib), window bits, content (0 image, 1 delta patch),
+#   inflated size (uint32), size of the zlib stream that follows (uint32)
+#
+# The window bounds the RAM used on the device to inflate: 1 << window_bits bytes plus
+# about 11 KB of decoder state and one flash sector.
+
+import argparse
+import struct
+import sys
+import zlib
+
+MAGIC = b"ESPZ"
+VERSION = 1
+FORMAT_ZLIB = 1
+CONTENT_IMAGE = 0
+CONTENT_DELTA = 1
+HEADER = struct.Struct("<4sBBBBII")
+
+DEFAULT_WINDOW_BITS = 12
+MIN_WINDOW_BITS = 9
+MAX_WINDOW_BITS = 15
+
+
+def compress_image(data, window_bits=DEFAULT_WINDOW_BITS, level=9, content=CONTENT_IMAGE):
+    if not MIN_WINDOW_BITS <= window_bits <= MAX_WINDOW_BITS:
+        raise ValueError("window_bits must be between %d and %d" % (MIN_WINDOW_BITS, MAX_WINDOW_BITS))
+    compressor = zlib.compressobj(level, zlib.DEFLATED, window_bits, 9)
+    stream = compressor.compress(data) + compressor.flush()
+    return HEADER.pack(MAGIC, VERSION, FORMAT_ZLIB, window_bits, content, len(data), len(stream)) + stream
+
+
+def is_compressed(data):
+    return len(data) >= HEADER.size and data[:4] == MAGIC
+
+
+def decompress_image(data):
+    magic, version, fmt, window_bits, _, image_size, stream_size = HEADER.unpack_from(data)
+    if magic != MAGIC or version != VERSION or fmt != FORMAT_ZLIB:
+        raise ValueError("not a compressed image")
+    image = zlib.decompress(data[HEADER.size : HEADER.size + stream_size], window_bits)
+    if len(image) != image_size:
+        raise ValueError("size mismatch: %d != %d" % (len(image), image_size))
+    return image
+
+
+def parse_args(unparsed_args):
+    parser = argparse.ArgumentParser(description="Compress an image for OTA updates of the ESP32.")
+    parser.add_argument("input", help="Image file (application .bin, SPIFFS/LittleFS/FAT image).")
+    parser.add_argument("output", nargs="?", help="Compressed file. Default: <input>.z")
+    parser.add_argument(
+        "-w",
+        "--window",
+        dest="window_bits",
+        type=int,
+        default=DEFAULT_WINDOW_BITS,
+        help="Window size in bits (%d-%d), RAM needed on the device. Default: %d (4 KB)"
+        % (MIN_WINDOW_BITS, MAX_WINDOW_BITS, DEFAULT_WINDOW_BITS),
+    )
+    parser.add_argument("-l", "--level", dest="level", type=int, default=9, help="zlib level (1-9). Default: 9")
+    return parser.parse_args(unparsed_args)
+
+
+def main(args):
+    options = parse_args(args)
+    with open(options.input, "rb") as f:
+        data = f.read()
+    if is_compressed(data):
+        sys.stderr.write("%s is already compressed\n" % options.input)
+        return 1
+    try:
+        out = compress_image(data, options.window_bits, options.level)
+    except ValueError as e:
+        sys.stderr.write("%s\n" % str(e))
+        return 1
+    # check the output before it is sent to a device
+    if decompress_image(out) != data:
+        sys.stderr.write("Verification failed\n")
+        return 1
+    output = options.output or options.input + ".z"
+    with open(output, "wb") as f:
+        f.write(out)
+    print(
+        "%s: %d -> %d bytes (%.1f%%), window %d bytes"
+        % (output, len(data), len(out), 100.0 * len(out) / max(len(data), 1), 1 << options.window_bits)
+    )
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
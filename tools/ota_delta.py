@@ -0,0 +1,203 @@
+#!/usr/bin/env python3
+#
+# Make a delta patch for an OTA update of the ESP32
+#
+# The device rebuilds the new firmware from the one it runs and the patch, so only the patch
+# goes over the network. The Update library recognizes the patch like any image: send it with
+# ArduinoOTA (espota.py), HTTPUpdate, a web updater or Update.write().
+#
+# use it like:
+# python ota_delta.py old.bin new.bin [patch.bin]
+#
+# old.bin must be the exact image the devices run (the previous OTA image): the patch carries
+# its MD5 and the device refuses it otherwise. The patch is compressed (see ota_compress.py)
+# unless --raw is given.
+#
+# Patch format, little endian (see libraries/Update/src/UpdateDelta.h):
+#   header, 32 bytes: magic "ESPD", version 1, 3 reserved bytes, old size (uint32),
+#                     new size (uint32), MD5 of the old image (16 bytes)
+#   records: diff_len (uint32), extra_len (uint32), seek (int32)
+#            diff_len bytes added to the old bytes at the old position (bsdiff style)
+#            extra_len bytes copied as they are
+#            then the old position moves by seek
+
+import argparse
+import hashlib
+import struct
+import sys
+
+from ota_compress import CONTENT_DELTA, DEFAULT_WINDOW_BITS, compress_image
+
+MAGIC = b"ESPD"
+VERSION = 1
+HEADER = struct.Struct("<4sB3sII16s")
+CONTROL = struct.Struct("<IIi")
+
+# Length of the strings indexed in the old image to find where a new block comes from
+KEY_LEN = 8
+# Shortest block worth a record
+MIN_MATCH = 16
+# An approximate match stops when it is this much worse than the best point seen
+GIVE_UP_SCORE = 64
+
+
+def index_old(old):
+    index = {}
+    for pos in range(len(old) - KEY_LEN + 1):
+        # first occurrence, runs of a single byte are left out
+        key = old[pos : pos + KEY_LEN]
+        if key not in index and key.count(key[0]) != KEY_LEN:
+            index[key] = pos
+    return index
+
+
+def exact_length(old, new, o, n):
+    length = 0
+    step = 256
+    while o + length < len(old) and n + length < len(new):
+        if old[o + length : o + length + step] == new[n + length : n + length + step]:
+            length += min(step, len(old) - o - length, len(new) - n - length)
+        elif step > 1:
+            step //= 16
+        else:
+            break
+    return length
+
+
+def approx_length(old, new, o, n):
+    # bsdiff forward extension: keep the length where 2 * matches - length is best
+    length = exact_length(old, new, o, n)
+    best_score = score = length
+    best = length
+    i = length
+    while o + i < len(old) and n + i < len(new):
+        if old[o + i] == new[n + i]:
+            run = exact_length(old, new, o + i, n + i)
+            score += run
+            i += run
+            if score > best_score:
+                best_score = score
+                best = i
+        else:
+            score -= 1
+            i += 1
+            if score < best_score - GIVE_UP_SCORE:
+                break
+    return best
+
+
+def find_blocks(old, new):
+    # blocks of new taken from old with small differences: (new position, old position, length)
+    index = index_old(old)
+    blocks = []
+    shift = 0
+    n = 0
+    while n < len(new):
+        # first continue with the current alignment, code moved by a constant offset
+        o = n + shift
+        if 0 <= o < len(old) and old[o] == new[n]:
+            length = approx_length(old, new, o, n)
+            if length >= MIN_MATCH:
+                blocks.append((n, o, length))
+                n += length
+                continue
+        o = index.get(new[n : n + KEY_LEN])
+        if o is not None:
+            length = approx_length(old, new, o, n)
+            if length >= MIN_MATCH:
+                blocks.append((n, o, length))
+                shift = o - n
+                n += length
+                continue
+        n += 1
+    return blocks
+
+
+def make_patch(old, new):
+    out = [HEADER.pack(MAGIC, VERSION, b"\0\0\0", len(old), len(new), hashlib.md5(old).digest())]
+    blocks = find_blocks(old, new)
+    old_pos = 0
+    new_pos = 0
+    if not blocks or blocks[0][0] > 0 or blocks[0][1] != 0:
+        # literal bytes before the first block, if any, and the seek to where it starts in old
+        first = blocks[0][0] if blocks else len(new)
+        next_old = blocks[0][1] if blocks else 0
+        out.append(CONTROL.pack(0, first, next_old))
+        out.append(new[:first])
+        old_pos = next_old
+        new_pos = first
+    for i, (n, o, length) in enumerate(blocks):
+        assert n == new_pos and o == old_pos
+        end = blocks[i + 1][0] if i + 1 < len(blocks) else len(new)
+        next_old = blocks[i + 1][1] if i + 1 < len(blocks) else o + length
+        diff = bytes((new[n + k] - old[o + k]) & 0xFF for k in range(length))
+        out.append(CONTROL.pack(length, end - n - length, next_old - (o + length)))
+        out.append(diff)
+        out.append(new[n + length : end])
+        old_pos = next_old
+        new_pos = end
+    return b"".join(out)
+
+
+def apply_patch(old, patch):
+    # reference decoder, same checks as the device
+    magic, version, _, old_size, new_size, old_md5 = HEADER.unpack_from(patch)
+    if magic != MAGIC or version != VERSION:
+        raise ValueError("not a delta patch")
+    if old_size > len(old) or hashlib.md5(old[:old_size]).digest() != old_md5:
+        raise ValueError("the patch was made for another image")
+    pos = HEADER.size
+    old_pos = 0
+    new = bytearray()
+    while len(new) < new_size:
+        diff_len, extra_len, seek = CONTROL.unpack_from(patch, pos)
+        pos += CONTROL.size
+        if old_pos + diff_len > old_size or len(new) + diff_len + extra_len > new_size:
+            raise ValueError("corrupt patch")
+        new += bytes((old[old_pos + k] + patch[pos + k]) & 0xFF for k in range(diff_len))
+        pos += diff_len
+        new += patch[pos : pos + extra_len]
+        pos += extra_len
+        old_pos += diff_len + seek
+        if not 0 <= old_pos <= old_size:
+            raise ValueError("corrupt patch")
+    return bytes(new)
+
+
+def parse_args(unparsed_args):
+    parser = argparse.ArgumentParser(description="Make a delta patch for an OTA update of the ESP32.")
+    parser.add_argument("old", help="Image the devices run.")
+    parser.add_argument("new", help="New image.")
+    parser.add_argument("patch", nargs="?", help="Patch file. Default: <new>.patch")
+    parser.add_argument("--raw", dest="raw", action="store_true", help="Do not compress the patch.", default=False)
+    parser.add_argument(
+        "-w",
+        "--window",
+        dest="window_bits",
+        type=int,
+        default=DEFAULT_WINDOW_BITS,
+        help="Window size in bits of the compression, see ota_compress.py. Default: %d" % DEFAULT_WINDOW_BITS,
+    )
+    return parser.parse_args(unparsed_args)
+
+
+def main(args):
+    options = parse_args(args)
+    with open(options.old, "rb") as f:
+        old = f.read()
+    with open(options.new, "rb") as f:
+        new = f.read()
+    patch = make_patch(old, new)
+    if apply_patch(old, patch) != new:
+        sys.stderr.write("Verification failed\n")
+        return 1
+    out = patch if options.raw else compress_image(patch, options.window_bits, content=CONTENT_DELTA)
+    output = options.patch or options.new + ".patch"
+    with open(output, "wb") as f:
+        f.write(out)
+    print("%s: %d bytes for a %d bytes image (%.1f%%)" % (output, len(out), len(new), 100.0 * len(out) / max(len(new), 1)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))